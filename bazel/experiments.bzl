@@ -22,6 +22,7 @@ EXPERIMENTS = {
     "off": {
         "core_end2end_test": [
             "promise_based_client_call",
+            "ssl_zero_copy_frame_protector",
         ],
         "endpoint_test": [
             "tcp_frame_size_tuning",
@@ -43,6 +44,9 @@ EXPERIMENTS = {
             "memory_pressure_controller",
             "unconstrained_max_quota_buffer_size",
         ],
+        "tsi_test": [
+            "ssl_zero_copy_frame_protector",
+        ],
     },
     "on": {
         "core_end2end_tests": [
@@ -219,6 +219,10 @@
         'test/core/end2end/tests/filtered_metadata.cc',
         'test/core/end2end/tests/graceful_server_shutdown.cc',
         'test/core/end2end/tests/grpc_authz.cc',
+        'test/core/end2end/tests/hedging.cc',
+        'test/core/end2end/tests/hedging_server_pushback.cc',
+        'test/core/end2end/tests/hedging_streaming.cc',
+        'test/core/end2end/tests/hedging_throttled.cc',
         'test/core/end2end/tests/high_initial_seqno.cc',
         'test/core/end2end/tests/hpack_size.cc',
         'test/core/end2end/tests/invoke_large_request.cc',
@@ -250,6 +254,7 @@
         'test/core/end2end/tests/retry_exceeds_buffer_size_in_subsequent_batch.cc',
         'test/core/end2end/tests/retry_lb_drop.cc',
         'test/core/end2end/tests/retry_lb_fail.cc',
+        'test/core/end2end/tests/retry_memory_pressure.cc',
         'test/core/end2end/tests/retry_non_retriable_status.cc',
         'test/core/end2end/tests/retry_non_retriable_status_before_recv_trailing_metadata_started.cc',
         'test/core/end2end/tests/retry_per_attempt_recv_timeout.cc',
@@ -370,6 +375,9 @@
         'upb',
       ],
       'sources': [
+        'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.cc',
+        'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_service_config_parser.cc',
+        'src/core/ext/filters/adaptive_concurrency/concurrency_limiter.cc',
         'src/core/ext/filters/census/grpc_context.cc',
         'src/core/ext/filters/channel_idle/channel_idle_filter.cc',
         'src/core/ext/filters/channel_idle/idle_filter_state.cc',
@@ -393,13 +401,19 @@
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_balancer_addresses.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
+        'src/core/ext/filters/client_channel/lb_policy/least_request/least_request.cc',
+        'src/core/ext/filters/client_channel/lb_policy/maglev/maglev.cc',
         'src/core/ext/filters/client_channel/lb_policy/oob_backend_metric.cc',
+        'src/core/ext/filters/client_channel/lb_policy/outlier_detection/latency_sketch.cc',
         'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
         'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
+        'src/core/ext/filters/client_channel/lb_policy/ring_hash/consistent_hash.cc',
         'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
         'src/core/ext/filters/client_channel/lb_policy/rls/rls.cc',
         'src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.cc',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/static_stride_scheduler.cc',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.cc',
         'src/core/ext/filters/client_channel/lb_policy/weighted_target/weighted_target.cc',
         'src/core/ext/filters/client_channel/lb_policy/xds/cds.cc',
         'src/core/ext/filters/client_channel/lb_policy/xds/xds_attributes.cc',
@@ -934,6 +948,7 @@
         'src/core/lib/load_balancing/lb_policy.cc',
         'src/core/lib/load_balancing/lb_policy_registry.cc',
         'src/core/lib/matchers/matchers.cc',
+        'src/core/lib/matchers/string_matcher_set.cc',
         'src/core/lib/promise/activity.cc',
         'src/core/lib/promise/pipe.cc',
         'src/core/lib/promise/sleep.cc',
@@ -990,6 +1005,7 @@
         'src/core/lib/security/credentials/tls/grpc_tls_credentials_options.cc',
         'src/core/lib/security/credentials/tls/tls_credentials.cc',
         'src/core/lib/security/credentials/tls/tls_utils.cc',
+        'src/core/lib/security/credentials/tls/tls_verification_result_cache.cc',
         'src/core/lib/security/credentials/xds/xds_credentials.cc',
         'src/core/lib/security/security_connector/alts/alts_security_connector.cc',
         'src/core/lib/security/security_connector/fake/fake_security_connector.cc',
@@ -1007,6 +1023,7 @@
         'src/core/lib/security/transport/security_handshaker.cc',
         'src/core/lib/security/transport/server_auth_filter.cc',
         'src/core/lib/security/transport/tsi_error.cc',
+        'src/core/lib/security/transport/tsi_handshake_executor.cc',
         'src/core/lib/security/util/json_util.cc',
         'src/core/lib/service_config/service_config_impl.cc',
         'src/core/lib/service_config/service_config_parser.cc',
@@ -1044,6 +1061,7 @@
         'src/core/lib/transport/handshaker_registry.cc',
         'src/core/lib/transport/http_connect_handshaker.cc',
         'src/core/lib/transport/metadata_batch.cc',
+        'src/core/lib/transport/metadata_key_table.cc',
         'src/core/lib/transport/parsed_metadata.cc',
         'src/core/lib/transport/pid_controller.cc',
         'src/core/lib/transport/status_conversion.cc',
@@ -1149,6 +1167,9 @@
         'upb',
       ],
       'sources': [
+        'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.cc',
+        'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_service_config_parser.cc',
+        'src/core/ext/filters/adaptive_concurrency/concurrency_limiter.cc',
         'src/core/ext/filters/census/grpc_context.cc',
         'src/core/ext/filters/channel_idle/channel_idle_filter.cc',
         'src/core/ext/filters/channel_idle/idle_filter_state.cc',
@@ -1172,13 +1193,19 @@
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_balancer_addresses.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
         'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
+        'src/core/ext/filters/client_channel/lb_policy/least_request/least_request.cc',
+        'src/core/ext/filters/client_channel/lb_policy/maglev/maglev.cc',
         'src/core/ext/filters/client_channel/lb_policy/oob_backend_metric.cc',
+        'src/core/ext/filters/client_channel/lb_policy/outlier_detection/latency_sketch.cc',
         'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
         'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
         'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
+        'src/core/ext/filters/client_channel/lb_policy/ring_hash/consistent_hash.cc',
         'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
         'src/core/ext/filters/client_channel/lb_policy/rls/rls.cc',
         'src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.cc',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/static_stride_scheduler.cc',
+        'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.cc',
         'src/core/ext/filters/client_channel/lb_policy/weighted_target/weighted_target.cc',
         'src/core/ext/filters/client_channel/local_subchannel_pool.cc',
         'src/core/ext/filters/client_channel/resolver/binder/binder_resolver.cc',
@@ -1443,6 +1470,7 @@
         'src/core/lib/security/transport/security_handshaker.cc',
         'src/core/lib/security/transport/server_auth_filter.cc',
         'src/core/lib/security/transport/tsi_error.cc',
+        'src/core/lib/security/transport/tsi_handshake_executor.cc',
         'src/core/lib/security/util/json_util.cc',
         'src/core/lib/service_config/service_config_impl.cc',
         'src/core/lib/service_config/service_config_parser.cc',
@@ -1480,6 +1508,7 @@
         'src/core/lib/transport/handshaker_registry.cc',
         'src/core/lib/transport/http_connect_handshaker.cc',
         'src/core/lib/transport/metadata_batch.cc',
+        'src/core/lib/transport/metadata_key_table.cc',
         'src/core/lib/transport/parsed_metadata.cc',
         'src/core/lib/transport/pid_controller.cc',
         'src/core/lib/transport/status_conversion.cc',
@@ -1895,6 +1924,7 @@
         'src/core/lib/load_balancing/lb_policy.cc',
         'src/core/lib/load_balancing/lb_policy_registry.cc',
         'src/core/lib/matchers/matchers.cc',
+        'src/core/lib/matchers/string_matcher_set.cc',
         'src/core/lib/promise/activity.cc',
         'src/core/lib/promise/pipe.cc',
         'src/core/lib/resolver/resolver.cc',
@@ -1937,6 +1967,7 @@
         'src/core/lib/security/transport/security_handshaker.cc',
         'src/core/lib/security/transport/server_auth_filter.cc',
         'src/core/lib/security/transport/tsi_error.cc',
+        'src/core/lib/security/transport/tsi_handshake_executor.cc',
         'src/core/lib/security/util/json_util.cc',
         'src/core/lib/service_config/service_config_parser.cc',
         'src/core/lib/slice/b64.cc',
@@ -1970,6 +2001,7 @@
         'src/core/lib/transport/handshaker.cc',
         'src/core/lib/transport/handshaker_registry.cc',
         'src/core/lib/transport/metadata_batch.cc',
+        'src/core/lib/transport/metadata_key_table.cc',
         'src/core/lib/transport/parsed_metadata.cc',
         'src/core/lib/transport/status_conversion.cc',
         'src/core/lib/transport/timeout_encoding.cc',
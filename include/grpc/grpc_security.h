@@ -887,6 +887,20 @@ GRPCAPI void grpc_tls_credentials_options_set_cert_request_type(
 GRPCAPI void grpc_tls_credentials_options_set_crl_directory(
     grpc_tls_credentials_options* options, const char* crl_directory);
 
+/**
+ * EXPERIMENTAL API - Subject to change
+ *
+ * Sets the maximum number of client certificate chains whose custom
+ * verification results are cached, so that clients reconnecting with the same
+ * chain skip the certificate verifier. Cached results are dropped whenever
+ * the root certificates change. The default value of 0 disables the cache.
+ * It should only be used with certificate verifiers whose result depends on
+ * nothing but the certificate chain, and shall only be called on the server
+ * side.
+ */
+GRPCAPI void grpc_tls_credentials_options_set_verification_result_cache_size(
+    grpc_tls_credentials_options* options, size_t cache_size);
+
 /**
  * EXPERIMENTAL API - Subject to change
  *
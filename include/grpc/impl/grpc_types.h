@@ -401,21 +401,28 @@ typedef struct {
     retries are enabled when they are configured via the service config.
     For details, see:
       https://github.com/grpc/proposal/blob/master/A6-client-retries.md
-    NOTE: Hedging functionality is not yet implemented, so those
-          fields in the service config will currently be ignored.  See
-          also the GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING arg below.
+    NOTE: The hedgingPolicy field in the service config is ignored
+          unless the GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING arg below is
+          also set.
  */
 #define GRPC_ARG_ENABLE_RETRIES "grpc.enable_retries"
 /** Enables hedging functionality, as described in:
       https://github.com/grpc/proposal/blob/master/A6-client-retries.md
-    Default is currently false, since this functionality is not yet
-    fully implemented.
+    Default is currently false, since this functionality is still new.
     NOTE: This channel arg is experimental and will eventually be removed.
           Once hedging functionality has been implemented and proves stable,
           this arg will be removed, and the hedging functionality will
           be enabled via the GRPC_ARG_ENABLE_RETRIES arg above. */
 #define GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING "grpc.experimental.enable_hedging"
-/** Per-RPC retry buffer size, in bytes. Default is 256 KiB. */
+/** Maximum number of finished calls whose memory a channel keeps around for
+    reuse by new calls, so that creating a call does not need to allocate in
+    steady state. Default is 0 (no reuse).
+    NOTE: This channel arg is experimental. */
+#define GRPC_ARG_EXPERIMENTAL_CALL_ARENA_POOL_SIZE \
+  "grpc.experimental.call_arena_pool_size"
+/** Per-RPC retry buffer size, in bytes. Default is 256 KiB. Buffered
+    messages are charged to the channel's resource quota, and calls stop
+    buffering early when the quota's memory pressure is high. */
 #define GRPC_ARG_PER_RPC_RETRY_BUFFER_SIZE "grpc.per_rpc_retry_buffer_size"
 /** Channel arg that carries the bridged objective c object for custom metrics
  * logging filter. */
@@ -453,6 +460,22 @@ typedef struct {
 /** If set, uses a local subchannel pool within the channel. Otherwise, uses the
  * global subchannel pool. */
 #define GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL "grpc.use_local_subchannel_pool"
+/** EXPERIMENTAL. Maximum number of connections a subchannel may open to its
+ * address. When every connection has at least
+ * GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION calls in flight, the subchannel
+ * opens another connection when a call starts, and it closes an idle
+ * connection when a call ends and the remaining connections would be at most
+ * half loaded. Load balancing policies still see a single subchannel. Int
+ * valued, defaults to 1. */
+#define GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS \
+  "grpc.experimental.subchannel_max_connections"
+/** EXPERIMENTAL. Number of calls in flight on a connection at which a
+ * subchannel considers the connection saturated. Only used if
+ * GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS is greater than 1. This should usually
+ * not exceed the server's MAX_CONCURRENT_STREAMS setting. Int valued,
+ * defaults to 100. */
+#define GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION \
+  "grpc.experimental.subchannel_streams_per_connection"
 /** gRPC Objective-C channel pooling domain string. */
 #define GRPC_ARG_CHANNEL_POOL_DOMAIN "grpc.channel_pooling_domain"
 /** gRPC Objective-C channel pooling id. */
@@ -467,6 +490,38 @@ typedef struct {
  * channel arg. Int valued, milliseconds. Defaults to 10 minutes.*/
 #define GRPC_ARG_SERVER_CONFIG_CHANGE_DRAIN_GRACE_TIME_MS \
   "grpc.experimental.server_config_change_drain_grace_time_ms"
+/** EXPERIMENTAL. If set on a server, limits the number of calls the server
+ * processes at once to a limit that adapts to their latency, and fails calls
+ * above the limit with UNAVAILABLE. String valued: a JSON object with the same
+ * fields as the "adaptiveConcurrency" object in the service config. The
+ * limit covers all of the server's connections. */
+#define GRPC_ARG_EXPERIMENTAL_ADAPTIVE_CONCURRENCY_CONFIG \
+  "grpc.experimental.adaptive_concurrency_config"
+/** EXPERIMENTAL. If non-zero, a TLS connection hands the encryption of
+ * outgoing records to the kernel (Linux kTLS) once the handshake completes,
+ * so that data is written to the socket as plaintext and may use the TCP
+ * zero-copy send path. Setting it selects the zero-copy frame protector that
+ * offload needs, whether or not the ssl_zero_copy_frame_protector experiment
+ * is enabled. TLS 1.2 and TLS 1.3 are offloaded; falls back to user space
+ * encryption when the platform, the TLS library or the negotiated cipher does
+ * not support it. Incoming records are still decrypted in user space.
+ * Boolean valued, defaults to false. */
+#define GRPC_ARG_EXPERIMENTAL_ENABLE_KTLS "grpc.experimental.enable_ktls"
+/** EXPERIMENTAL. If non-zero and no GRPC_SSL_SESSION_CACHE_ARG is given, TLS
+ * sessions are cached in a process-wide cache that is shared by all channels
+ * with equivalent credentials, so that reconnects may resume sessions even
+ * when each channel has its own credentials object. Boolean valued, defaults
+ * to false. */
+#define GRPC_ARG_EXPERIMENTAL_SHARED_SSL_SESSION_CACHE \
+  "grpc.experimental.shared_ssl_session_cache"
+/** EXPERIMENTAL. If non-zero, the steps of security handshakes run on a
+ * process-wide pool of handshake threads, rather than on the thread that
+ * received the peer's data, so that a burst of handshakes does not hold up
+ * established connections. Handshakes fail instead of queueing when the pool
+ * is saturated or the resource quota is under memory pressure. Boolean
+ * valued, defaults to false. */
+#define GRPC_ARG_EXPERIMENTAL_OFFLOAD_TSI_HANDSHAKES \
+  "grpc.experimental.offload_tsi_handshakes"
 /** \} */
 
 /** Result of a grpc call. If the caller satisfies the prerequisites of a
@@ -148,6 +148,12 @@ class TlsServerCredentialsOptions final : public TlsCredentialsOptions {
   void set_cert_request_type(
       grpc_ssl_client_certificate_request_type cert_request_type);
 
+  // Sets the maximum number of client certificate chains whose results from
+  // the certificate verifier are cached. Cached results are dropped when the
+  // root certificates change. The default is 0, which disables the cache.
+  // Only use it with verifiers that depend on nothing but the chain.
+  void set_verification_result_cache_size(size_t cache_size);
+
  private:
 };
 
@@ -0,0 +1,322 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.h"
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+#include "absl/types/optional.h"
+
+#include <grpc/impl/grpc_types.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#include "src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_service_config_parser.h"
+#include "src/core/ext/filters/client_channel/client_channel.h"
+#include "src/core/lib/channel/channel_stack.h"
+#include "src/core/lib/channel/channel_args_preconditioning.h"
+#include "src/core/lib/channel/channel_stack_builder.h"
+#include "src/core/lib/channel/channel_trace.h"
+#include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/json/json_object_loader.h"
+#include "src/core/lib/promise/activity.h"
+#include "src/core/lib/promise/context.h"
+#include "src/core/lib/promise/latch.h"
+#include "src/core/lib/promise/map.h"
+#include "src/core/lib/promise/poll.h"
+#include "src/core/lib/promise/promise.h"
+#include "src/core/lib/promise/race.h"
+#include "src/core/lib/promise/seq.h"
+#include "src/core/lib/promise/sleep.h"
+#include "src/core/lib/promise/try_concurrently.h"
+#include "src/core/lib/promise/try_seq.h"
+#include "src/core/lib/resource_quota/arena.h"
+#include "src/core/lib/service_config/service_config.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/surface/channel_init.h"
+#include "src/core/lib/surface/channel_stack_type.h"
+#include "src/core/lib/uri/uri_parser.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_adaptive_concurrency_trace(false, "adaptive_concurrency");
+
+namespace {
+
+absl::StatusOr<ConcurrencyLimiter::Config> ParseServerConfig(
+    const ChannelArgs& args) {
+  absl::optional<absl::string_view> config_json =
+      args.GetString(GRPC_ARG_EXPERIMENTAL_ADAPTIVE_CONCURRENCY_CONFIG);
+  if (!config_json.has_value()) {
+    return absl::InvalidArgumentError(
+        "adaptive concurrency config channel arg missing or wrong type");
+  }
+  absl::StatusOr<Json> json = Json::Parse(*config_json);
+  if (!json.ok()) return json.status();
+  return LoadFromJson<ConcurrencyLimiter::Config>(
+      *json, JsonArgs(), "errors validating adaptive concurrency config");
+}
+
+// Gives each server its own limiter.  Server channels take their args from
+// the server's, so all of a server's connections share the limiter, and it
+// goes away along with the server and its connections.
+ChannelArgs EnsureConcurrencyLimiterInChannelArgs(const ChannelArgs& args) {
+  if (args.GetObject<ConcurrencyLimiter>() != nullptr ||
+      !args.GetString(GRPC_ARG_EXPERIMENTAL_ADAPTIVE_CONCURRENCY_CONFIG)
+           .has_value()) {
+    return args;
+  }
+  auto config = ParseServerConfig(args);
+  // Leave invalid configs for the filter to report when the server creates
+  // its first channel.
+  if (!config.ok()) return args;
+  return args.SetObject(MakeRefCounted<ConcurrencyLimiter>(*config, nullptr));
+}
+
+}  // namespace
+
+//
+// AdaptiveConcurrencyFilter::AdmittedCall
+//
+
+// Owns a slot in the limiter for one call.  If the call completes,
+// Complete() returns the slot along with the call's RTT, measured up to
+// end_time; if the call is dropped first, the destructor returns the slot
+// without a sample.
+class AdaptiveConcurrencyFilter::AdmittedCall {
+ public:
+  explicit AdmittedCall(AdaptiveConcurrencyFilter* filter)
+      : filter_(filter), start_time_(gpr_get_cycle_counter()) {}
+
+  ~AdmittedCall() {
+    if (filter_ != nullptr) filter_->limiter_->Release(absl::nullopt);
+  }
+
+  AdmittedCall(const AdmittedCall&) = delete;
+  AdmittedCall& operator=(const AdmittedCall&) = delete;
+  AdmittedCall(AdmittedCall&& other) noexcept
+      : filter_(std::exchange(other.filter_, nullptr)),
+        start_time_(other.start_time_) {}
+  AdmittedCall& operator=(AdmittedCall&& other) noexcept {
+    std::swap(filter_, other.filter_);
+    std::swap(start_time_, other.start_time_);
+    return *this;
+  }
+
+  void Complete(gpr_cycle_counter end_time) {
+    AdaptiveConcurrencyFilter* filter = std::exchange(filter_, nullptr);
+    gpr_timespec rtt = gpr_cycle_counter_sub(end_time, start_time_);
+    absl::optional<uint32_t> new_limit = filter->limiter_->Release(
+        rtt.tv_sec * GPR_US_PER_SEC + rtt.tv_nsec / GPR_NS_PER_US);
+    if (new_limit.has_value()) {
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_adaptive_concurrency_trace)) {
+        gpr_log(GPR_INFO, "chand=%p limiter=%p: limit changed to %u", filter,
+                filter->limiter_.get(), *new_limit);
+      }
+      filter->ReportLimit(*new_limit);
+    }
+  }
+
+ private:
+  AdaptiveConcurrencyFilter* filter_;
+  gpr_cycle_counter start_time_;
+};
+
+//
+// AdaptiveConcurrencyFilter
+//
+
+ArenaPromise<ServerMetadataHandle> AdaptiveConcurrencyFilter::MakeCallPromise(
+    CallArgs call_args, NextPromiseFactory next_promise_factory) {
+  if (limiter_ == nullptr) return next_promise_factory(std::move(call_args));
+  if (limiter_->TryAcquire()) {
+    return RunAdmittedCall(std::move(call_args), next_promise_factory);
+  }
+  const Duration max_queue_time = limiter_->config().max_queue_time;
+  if (max_queue_time == Duration::Zero()) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_adaptive_concurrency_trace)) {
+      gpr_log(GPR_INFO, "chand=%p limiter=%p: rejecting call above limit %u",
+              this, limiter_.get(), limiter_->limit());
+    }
+    return Immediate(ServerMetadataFromStatus(RejectionStatus()));
+  }
+  // Wait for a slot, but give up after max_queue_time.
+  return TrySeq(
+      Race(
+          [limiter = limiter_]() -> Poll<absl::Status> {
+            if (limiter->TryAcquireOrWait(
+                    Activity::current()->MakeOwningWaker())) {
+              return absl::OkStatus();
+            }
+            return Pending();
+          },
+          Map(Sleep(Timestamp::Now() + max_queue_time),
+              [this](absl::Status) { return RejectionStatus(); })),
+      [this, call_args = std::move(call_args),
+       next_promise_factory = std::move(next_promise_factory)]() mutable {
+        return RunAdmittedCall(std::move(call_args), next_promise_factory);
+      });
+}
+
+ArenaPromise<ServerMetadataHandle> AdaptiveConcurrencyFilter::RunAdmittedCall(
+    CallArgs call_args, const NextPromiseFactory& next_promise_factory) {
+  // Intercept server initial metadata to note when the first response
+  // arrives (client) or is sent (server).
+  auto* arena = GetContext<Arena>();
+  auto* first_response_time =
+      arena->New<absl::optional<gpr_cycle_counter>>();
+  auto* read_latch = arena->New<Latch<ServerMetadata*>>();
+  auto* write_latch =
+      std::exchange(call_args.server_initial_metadata, read_latch);
+  auto call = Map(next_promise_factory(std::move(call_args)),
+                  [admitted_call = AdmittedCall(this), first_response_time](
+                      ServerMetadataHandle trailing_metadata) mutable {
+                    admitted_call.Complete(first_response_time->value_or(
+                        gpr_get_cycle_counter()));
+                    return trailing_metadata;
+                  });
+  auto on_initial_metadata = Seq(
+      read_latch->Wait(),
+      [write_latch, first_response_time](ServerMetadata** md) -> absl::Status {
+        // A null value means that the call got a Trailers-Only response,
+        // which is timed when the call completes.
+        if (*md != nullptr) *first_response_time = gpr_get_cycle_counter();
+        write_latch->Set(*md);
+        return absl::OkStatus();
+      });
+  if (endpoint_ == FilterEndpoint::kClient) {
+    return TryConcurrently(std::move(call))
+        .NecessaryPull(std::move(on_initial_metadata));
+  }
+  return TryConcurrently(std::move(call)).Push(std::move(on_initial_metadata));
+}
+
+absl::Status AdaptiveConcurrencyFilter::RejectionStatus() const {
+  return absl::Status(rejection_code_, "adaptive concurrency limit reached");
+}
+
+//
+// ClientAdaptiveConcurrencyFilter
+//
+
+const grpc_channel_filter ClientAdaptiveConcurrencyFilter::kFilter =
+    MakePromiseBasedFilter<ClientAdaptiveConcurrencyFilter,
+                           FilterEndpoint::kClient>(
+        "client_adaptive_concurrency");
+
+absl::StatusOr<ClientAdaptiveConcurrencyFilter>
+ClientAdaptiveConcurrencyFilter::Create(const ChannelArgs& args,
+                                        ChannelFilter::Args) {
+  auto* channelz_node = args.GetObject<channelz::ChannelNode>();
+  auto* service_config = args.GetObject<ServiceConfig>();
+  auto* parsed_config =
+      service_config == nullptr
+          ? nullptr
+          : static_cast<const AdaptiveConcurrencyParsedConfig*>(
+                service_config->GetGlobalParsedConfig(
+                    AdaptiveConcurrencyServiceConfigParser::ParserIndex()));
+  if (parsed_config == nullptr) {
+    return ClientAdaptiveConcurrencyFilter(nullptr, channelz_node);
+  }
+  // Share the limiter among all channels to the same server name, like
+  // retry throttling does.
+  absl::optional<absl::string_view> server_uri =
+      args.GetString(GRPC_ARG_SERVER_URI);
+  if (!server_uri.has_value()) {
+    return absl::InvalidArgumentError(
+        "server URI channel arg missing or wrong type in adaptive concurrency "
+        "filter");
+  }
+  absl::StatusOr<URI> uri = URI::Parse(*server_uri);
+  if (!uri.ok() || uri->path().empty()) {
+    return absl::InvalidArgumentError(
+        "could not extract server name from target URI");
+  }
+  std::string server_name(absl::StripPrefix(uri->path(), "/"));
+  return ClientAdaptiveConcurrencyFilter(
+      ConcurrencyLimiterMap::Get()->GetLimiter(
+          absl::StrCat("client:", server_name), parsed_config->config()),
+      channelz_node);
+}
+
+void ClientAdaptiveConcurrencyFilter::ReportLimit(uint32_t limit) {
+  if (channelz_node_ == nullptr) return;
+  channelz_node_->AddTraceEvent(
+      channelz::ChannelTrace::Severity::Info,
+      grpc_slice_from_cpp_string(
+          absl::StrCat("Adaptive concurrency limit changed to ", limit)));
+}
+
+//
+// ServerAdaptiveConcurrencyFilter
+//
+
+const grpc_channel_filter ServerAdaptiveConcurrencyFilter::kFilter =
+    MakePromiseBasedFilter<ServerAdaptiveConcurrencyFilter,
+                           FilterEndpoint::kServer>(
+        "server_adaptive_concurrency");
+
+absl::StatusOr<ServerAdaptiveConcurrencyFilter>
+ServerAdaptiveConcurrencyFilter::Create(const ChannelArgs& args,
+                                        ChannelFilter::Args) {
+  auto limiter = args.GetObjectRef<ConcurrencyLimiter>();
+  if (limiter == nullptr) {
+    // The server's args were not preconditioned, or the config is invalid.
+    auto config = ParseServerConfig(args);
+    if (!config.ok()) return config.status();
+    return absl::InvalidArgumentError(
+        "adaptive concurrency limiter missing from server channel args");
+  }
+  return ServerAdaptiveConcurrencyFilter(
+      std::move(limiter), args.GetObjectRef<channelz::ServerNode>());
+}
+
+void ServerAdaptiveConcurrencyFilter::ReportLimit(uint32_t limit) {
+  if (channelz_node_ == nullptr) return;
+  channelz_node_->AddTraceEvent(
+      channelz::ChannelTrace::Severity::Info,
+      grpc_slice_from_cpp_string(
+          absl::StrCat("Adaptive concurrency limit changed to ", limit)));
+}
+
+void RegisterAdaptiveConcurrencyFilter(CoreConfiguration::Builder* builder) {
+  AdaptiveConcurrencyServiceConfigParser::Register(builder);
+  builder->channel_args_preconditioning()->RegisterStage(
+      EnsureConcurrencyLimiterInChannelArgs);
+  builder->channel_init()->RegisterStage(
+      GRPC_SERVER_CHANNEL, GRPC_CHANNEL_INIT_BUILTIN_PRIORITY,
+      [](ChannelStackBuilder* builder) {
+        auto channel_args = builder->channel_args();
+        if (!channel_args.WantMinimalStack() &&
+            channel_args
+                .GetString(GRPC_ARG_EXPERIMENTAL_ADAPTIVE_CONCURRENCY_CONFIG)
+                .has_value()) {
+          builder->PrependFilter(&ServerAdaptiveConcurrencyFilter::kFilter);
+        }
+        return true;
+      });
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,129 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_EXT_FILTERS_ADAPTIVE_CONCURRENCY_ADAPTIVE_CONCURRENCY_FILTER_H
+#define GRPC_CORE_EXT_FILTERS_ADAPTIVE_CONCURRENCY_ADAPTIVE_CONCURRENCY_FILTER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+
+#include "src/core/ext/filters/adaptive_concurrency/concurrency_limiter.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/channel/channel_fwd.h"
+#include "src/core/lib/channel/channelz.h"
+#include "src/core/lib/channel/promise_based_filter.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/promise/arena_promise.h"
+#include "src/core/lib/transport/transport.h"
+
+namespace grpc_core {
+
+// Limits the number of calls in flight with a ConcurrencyLimiter.  Calls
+// above the limit either fail immediately or wait up to the configured
+// maxQueueTime for a slot.  Each call holds its slot until its trailing
+// metadata arrives.  The time until the server's initial metadata (or, for
+// a Trailers-Only response, its trailing metadata) feeds the limiter as the
+// call's RTT, so that long-lived streams do not look like slow calls.
+class AdaptiveConcurrencyFilter : public ChannelFilter {
+ public:
+  // Construct a promise for one call.
+  ArenaPromise<ServerMetadataHandle> MakeCallPromise(
+      CallArgs call_args, NextPromiseFactory next_promise_factory) override;
+
+ protected:
+  AdaptiveConcurrencyFilter(RefCountedPtr<ConcurrencyLimiter> limiter,
+                            FilterEndpoint endpoint,
+                            absl::StatusCode rejection_code)
+      : limiter_(std::move(limiter)),
+        endpoint_(endpoint),
+        rejection_code_(rejection_code) {}
+
+  // Records a significant change of the limit in channelz.
+  virtual void ReportLimit(uint32_t limit) = 0;
+
+ private:
+  class AdmittedCall;
+
+  ArenaPromise<ServerMetadataHandle> RunAdmittedCall(
+      CallArgs call_args, const NextPromiseFactory& next_promise_factory);
+  absl::Status RejectionStatus() const;
+
+  // May be null if the channel has no adaptive concurrency config, in which
+  // case calls pass through.
+  RefCountedPtr<ConcurrencyLimiter> limiter_;
+  FilterEndpoint endpoint_;
+  absl::StatusCode rejection_code_;
+};
+
+// Client variant, used by the dynamic filters when the service config has an
+// adaptiveConcurrency object.  Calls above the limit fail with
+// RESOURCE_EXHAUSTED.  The limit is shared by all channels to the same
+// target.
+class ClientAdaptiveConcurrencyFilter final
+    : public AdaptiveConcurrencyFilter {
+ public:
+  static const grpc_channel_filter kFilter;
+
+  static absl::StatusOr<ClientAdaptiveConcurrencyFilter> Create(
+      const ChannelArgs& args, ChannelFilter::Args filter_args);
+
+ private:
+  ClientAdaptiveConcurrencyFilter(RefCountedPtr<ConcurrencyLimiter> limiter,
+                                  channelz::ChannelNode* channelz_node)
+      : AdaptiveConcurrencyFilter(std::move(limiter), FilterEndpoint::kClient,
+                                  absl::StatusCode::kResourceExhausted),
+        channelz_node_(channelz_node) {}
+
+  void ReportLimit(uint32_t limit) override;
+
+  channelz::ChannelNode* channelz_node_;
+};
+
+// Server variant, enabled by GRPC_ARG_EXPERIMENTAL_ADAPTIVE_CONCURRENCY_CONFIG.
+// Calls above the limit fail with UNAVAILABLE, so that clients may retry them
+// elsewhere.  The limit is shared by all of the server's connections: the
+// server's channel args carry a limiter created when the server is.
+class ServerAdaptiveConcurrencyFilter final
+    : public AdaptiveConcurrencyFilter {
+ public:
+  static const grpc_channel_filter kFilter;
+
+  static absl::StatusOr<ServerAdaptiveConcurrencyFilter> Create(
+      const ChannelArgs& args, ChannelFilter::Args filter_args);
+
+ private:
+  ServerAdaptiveConcurrencyFilter(
+      RefCountedPtr<ConcurrencyLimiter> limiter,
+      RefCountedPtr<channelz::ServerNode> channelz_node)
+      : AdaptiveConcurrencyFilter(std::move(limiter), FilterEndpoint::kServer,
+                                  absl::StatusCode::kUnavailable),
+        channelz_node_(std::move(channelz_node)) {}
+
+  void ReportLimit(uint32_t limit) override;
+
+  // The server may go away before its channels do, so hold a ref.
+  RefCountedPtr<channelz::ServerNode> channelz_node_;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_EXT_FILTERS_ADAPTIVE_CONCURRENCY_ADAPTIVE_CONCURRENCY_FILTER_H
@@ -0,0 +1,220 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/adaptive_concurrency/concurrency_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "src/core/lib/gpr/useful.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Until this many samples have been seen, the long-window RTT is a plain
+// average, so that the first few samples are not swamped by the zero it
+// starts from.
+constexpr uint64_t kWarmupSamples = 10;
+
+// When the long-window RTT is more than this many times the latest RTT, it
+// is decayed faster, so that it recovers quickly after a period of overload
+// has inflated it.
+constexpr double kLongRttRecoveryRatio = 2.0;
+constexpr double kLongRttRecoveryDecay = 0.95;
+
+// Bounds on how much a single sample may shrink the limit.
+constexpr double kMinGradient = 0.5;
+constexpr double kMaxGradient = 1.0;
+
+}  // namespace
+
+//
+// ConcurrencyLimiter::Config
+//
+
+const JsonLoaderInterface* ConcurrencyLimiter::Config::JsonLoader(
+    const JsonArgs&) {
+  static const auto* loader =
+      JsonObjectLoader<Config>()
+          .OptionalField("minLimit", &Config::min_limit)
+          .OptionalField("maxLimit", &Config::max_limit)
+          .OptionalField("initialLimit", &Config::initial_limit)
+          .OptionalField("smoothing", &Config::smoothing)
+          .OptionalField("rttTolerance", &Config::rtt_tolerance)
+          .OptionalField("longWindow", &Config::long_window)
+          .OptionalField("maxQueueTime", &Config::max_queue_time)
+          .Finish();
+  return loader;
+}
+
+void ConcurrencyLimiter::Config::JsonPostLoad(const Json& /*json*/,
+                                              const JsonArgs& /*args*/,
+                                              ValidationErrors* errors) {
+  if (min_limit == 0) {
+    ValidationErrors::ScopedField field(errors, ".minLimit");
+    errors->AddError("must be greater than 0");
+  }
+  if (max_limit < min_limit) {
+    ValidationErrors::ScopedField field(errors, ".maxLimit");
+    errors->AddError("must be greater than or equal to minLimit");
+  }
+  if (initial_limit < min_limit || initial_limit > max_limit) {
+    ValidationErrors::ScopedField field(errors, ".initialLimit");
+    errors->AddError("must be between minLimit and maxLimit");
+  }
+  if (!(smoothing > 0 && smoothing <= 1)) {
+    ValidationErrors::ScopedField field(errors, ".smoothing");
+    errors->AddError("must be in the range (0, 1]");
+  }
+  if (!(rtt_tolerance >= 1)) {
+    ValidationErrors::ScopedField field(errors, ".rttTolerance");
+    errors->AddError("must be greater than or equal to 1");
+  }
+  if (long_window == 0) {
+    ValidationErrors::ScopedField field(errors, ".longWindow");
+    errors->AddError("must be greater than 0");
+  }
+  if (max_queue_time < Duration::Zero()) {
+    ValidationErrors::ScopedField field(errors, ".maxQueueTime");
+    errors->AddError("must not be negative");
+  }
+}
+
+//
+// ConcurrencyLimiter
+//
+
+ConcurrencyLimiter::ConcurrencyLimiter(const Config& config,
+                                       ConcurrencyLimiter* old_limiter)
+    : config_(config), limit_(config.initial_limit) {
+  if (old_limiter != nullptr) {
+    MutexLock lock(&old_limiter->mu_);
+    limit_ = Clamp(old_limiter->limit_, static_cast<double>(config_.min_limit),
+                   static_cast<double>(config_.max_limit));
+    long_rtt_ = old_limiter->long_rtt_;
+    num_samples_ = old_limiter->num_samples_;
+  }
+  last_reported_limit_ = static_cast<uint32_t>(limit_);
+}
+
+bool ConcurrencyLimiter::TryAcquire() {
+  MutexLock lock(&mu_);
+  if (in_flight_ >= static_cast<uint32_t>(limit_)) return false;
+  ++in_flight_;
+  return true;
+}
+
+bool ConcurrencyLimiter::TryAcquireOrWait(Waker waker) {
+  MutexLock lock(&mu_);
+  if (in_flight_ >= static_cast<uint32_t>(limit_)) {
+    waiters_.AddPending(std::move(waker));
+    return false;
+  }
+  ++in_flight_;
+  return true;
+}
+
+absl::optional<uint32_t> ConcurrencyLimiter::Release(
+    absl::optional<int64_t> rtt_micros) {
+  absl::optional<uint32_t> new_limit;
+  WaitSet::WakeupSet wakeups = [&]() {
+    MutexLock lock(&mu_);
+    GPR_ASSERT(in_flight_ > 0);
+    if (rtt_micros.has_value()) {
+      UpdateLimitLocked(static_cast<double>(std::max<int64_t>(*rtt_micros, 1)),
+                        in_flight_);
+      const uint32_t limit = static_cast<uint32_t>(limit_);
+      const uint32_t delta = limit > last_reported_limit_
+                                 ? limit - last_reported_limit_
+                                 : last_reported_limit_ - limit;
+      if (delta * 10 >= last_reported_limit_ && delta > 0) {
+        last_reported_limit_ = limit;
+        new_limit = limit;
+      }
+    }
+    --in_flight_;
+    return waiters_.TakeWakeupSet();
+  }();
+  // Wake waiters outside of the lock, since they may try to acquire it.
+  wakeups.Wakeup();
+  return new_limit;
+}
+
+void ConcurrencyLimiter::UpdateLimitLocked(double rtt_micros,
+                                           uint32_t in_flight) {
+  // Update the long-window average.
+  ++num_samples_;
+  if (num_samples_ <= std::min<uint64_t>(kWarmupSamples, config_.long_window)) {
+    long_rtt_ += (rtt_micros - long_rtt_) / static_cast<double>(num_samples_);
+  } else {
+    const double factor = 2.0 / (static_cast<double>(config_.long_window) + 1);
+    long_rtt_ = long_rtt_ * (1 - factor) + rtt_micros * factor;
+  }
+  if (long_rtt_ / rtt_micros > kLongRttRecoveryRatio) {
+    long_rtt_ *= kLongRttRecoveryDecay;
+  }
+  // Don't grow the limit while the caller is not using it; the samples say
+  // nothing about whether the peer could take more.
+  if (static_cast<double>(in_flight) < limit_ / 2) return;
+  const double gradient =
+      Clamp(config_.rtt_tolerance * long_rtt_ / rtt_micros, kMinGradient,
+            kMaxGradient);
+  // The square root term lets the limit grow when latency is flat, and
+  // leaves room for some queueing at the peer.
+  double new_limit = limit_ * gradient + std::sqrt(limit_);
+  new_limit =
+      limit_ * (1 - config_.smoothing) + new_limit * config_.smoothing;
+  limit_ = Clamp(new_limit, static_cast<double>(config_.min_limit),
+                 static_cast<double>(config_.max_limit));
+}
+
+uint32_t ConcurrencyLimiter::limit() const {
+  MutexLock lock(&mu_);
+  return static_cast<uint32_t>(limit_);
+}
+
+uint32_t ConcurrencyLimiter::in_flight() const {
+  MutexLock lock(&mu_);
+  return in_flight_;
+}
+
+//
+// ConcurrencyLimiterMap
+//
+
+ConcurrencyLimiterMap* ConcurrencyLimiterMap::Get() {
+  static ConcurrencyLimiterMap* m = new ConcurrencyLimiterMap();
+  return m;
+}
+
+RefCountedPtr<ConcurrencyLimiter> ConcurrencyLimiterMap::GetLimiter(
+    const std::string& key, const ConcurrencyLimiter::Config& config) {
+  MutexLock lock(&mu_);
+  RefCountedPtr<ConcurrencyLimiter>& limiter = map_[key];
+  if (limiter == nullptr || limiter->config() != config) {
+    // Entry not found, or found with an old config.  Replace it.  Calls that
+    // were admitted by the old limiter hold a ref to it and release their
+    // slots there.
+    limiter = MakeRefCounted<ConcurrencyLimiter>(config, limiter.get());
+  }
+  return limiter;
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,167 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_EXT_FILTERS_ADAPTIVE_CONCURRENCY_CONCURRENCY_LIMITER_H
+#define GRPC_CORE_EXT_FILTERS_ADAPTIVE_CONCURRENCY_CONCURRENCY_LIMITER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/gprpp/validation_errors.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/json/json_args.h"
+#include "src/core/lib/json/json_object_loader.h"
+#include "src/core/lib/promise/activity.h"
+#include "src/core/lib/promise/wait_set.h"
+
+// Channel arg key for the limiter of the server that owns a server channel.
+#define GRPC_ARG_ADAPTIVE_CONCURRENCY_LIMITER \
+  "grpc.internal.adaptive_concurrency_limiter"
+
+namespace grpc_core {
+
+// Bounds the number of calls in flight to a limit that adapts to the
+// round-trip times of completed calls, using the gradient algorithm from
+// Netflix's concurrency-limits library ("gradient2").
+//
+// The limiter keeps an exponentially weighted average of the RTT over a long
+// window, which tracks the latency the peer delivers when it is not
+// overloaded.  When a call's RTT rises above that average by more than the
+// configured tolerance, the limit shrinks in proportion; otherwise it grows
+// by about sqrt(limit), which probes for more capacity.  The limit only grows
+// while at least half of it is in use, so an idle limiter does not drift up.
+//
+// All methods are thread-safe.
+class ConcurrencyLimiter : public RefCounted<ConcurrencyLimiter> {
+ public:
+  struct Config {
+    uint32_t min_limit = 20;
+    uint32_t max_limit = 200;
+    uint32_t initial_limit = 20;
+    // Weight given to each new limit estimate, in (0, 1].
+    double smoothing = 0.2;
+    // How far the RTT may rise above the long-window average before the
+    // limit starts shrinking, as a ratio >= 1.
+    double rtt_tolerance = 1.5;
+    // Number of samples the long-window RTT average spans.
+    uint32_t long_window = 600;
+    // How long a call may wait for a slot before it fails.  Zero means that
+    // calls above the limit fail immediately.
+    Duration max_queue_time;
+
+    bool operator==(const Config& other) const {
+      return min_limit == other.min_limit && max_limit == other.max_limit &&
+             initial_limit == other.initial_limit &&
+             smoothing == other.smoothing &&
+             rtt_tolerance == other.rtt_tolerance &&
+             long_window == other.long_window &&
+             max_queue_time == other.max_queue_time;
+    }
+    bool operator!=(const Config& other) const { return !(*this == other); }
+
+    static const JsonLoaderInterface* JsonLoader(const JsonArgs&);
+    void JsonPostLoad(const Json& json, const JsonArgs& args,
+                      ValidationErrors* errors);
+  };
+
+  // If old_limiter is non-null, the new limiter starts from its current
+  // limit instead of config.initial_limit, so that a config update does not
+  // undo what has been learned about the peer.
+  ConcurrencyLimiter(const Config& config, ConcurrencyLimiter* old_limiter);
+
+  // Takes a slot if one is free.  Returns true on success, in which case
+  // the caller must eventually call Release().
+  bool TryAcquire();
+
+  // As TryAcquire(), but if no slot is free, arranges for waker to be woken
+  // the next time one is released.  Wakeups are broadcast to all waiters,
+  // which must call TryAcquireOrWait() again.
+  bool TryAcquireOrWait(Waker waker);
+
+  // Releases a slot taken by TryAcquire() or TryAcquireOrWait().  If the
+  // call completed, rtt_micros is its round-trip time, which is used to
+  // update the limit; calls that were abandoned pass nullopt.
+  // Returns the new limit if it has moved by at least 10% since the last
+  // time a limit was returned, so that callers can report significant
+  // changes without logging every sample.
+  absl::optional<uint32_t> Release(absl::optional<int64_t> rtt_micros);
+
+  static absl::string_view ChannelArgName() {
+    return GRPC_ARG_ADAPTIVE_CONCURRENCY_LIMITER;
+  }
+  static int ChannelArgsCompare(const ConcurrencyLimiter* a,
+                                const ConcurrencyLimiter* b) {
+    return QsortCompare(a, b);
+  }
+
+  const Config& config() const { return config_; }
+  uint32_t limit() const;
+  uint32_t in_flight() const;
+
+ private:
+  // Folds one RTT sample into the estimate.  in_flight is the number of
+  // calls in flight when the sampled call completed, including itself.
+  void UpdateLimitLocked(double rtt_micros, uint32_t in_flight)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const Config config_;
+  mutable Mutex mu_;
+  double limit_ ABSL_GUARDED_BY(mu_);
+  uint32_t in_flight_ ABSL_GUARDED_BY(mu_) = 0;
+  // Long-window average RTT, in microseconds, and the number of samples it
+  // has seen.
+  double long_rtt_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t num_samples_ ABSL_GUARDED_BY(mu_) = 0;
+  uint32_t last_reported_limit_ ABSL_GUARDED_BY(mu_);
+  WaitSet waiters_ ABSL_GUARDED_BY(mu_);
+};
+
+// Global map of limiters, so that all channels to the same target share one
+// limit, as they share retry throttling.  Servers do not use the map: each
+// server's channel args carry its own limiter.
+class ConcurrencyLimiterMap {
+ public:
+  static ConcurrencyLimiterMap* Get();
+
+  // Returns the limiter for key, creating a new one if there is none or if
+  // the existing one was created with a different config.
+  RefCountedPtr<ConcurrencyLimiter> GetLimiter(
+      const std::string& key, const ConcurrencyLimiter::Config& config);
+
+ private:
+  using StringToLimiterMap =
+      std::map<std::string, RefCountedPtr<ConcurrencyLimiter>>;
+
+  Mutex mu_;
+  StringToLimiterMap map_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_EXT_FILTERS_ADAPTIVE_CONCURRENCY_CONCURRENCY_LIMITER_H
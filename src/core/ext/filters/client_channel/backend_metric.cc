@@ -68,6 +68,14 @@ const BackendMetricData* ParseBackendMetricData(
       xds_data_orca_v3_OrcaLoadReport_cpu_utilization(msg);
   backend_metric_data->mem_utilization =
       xds_data_orca_v3_OrcaLoadReport_mem_utilization(msg);
+  // rps_fractional supersedes rps; the latter is only read from servers
+  // that do not send the fractional value.
+  backend_metric_data->qps =
+      xds_data_orca_v3_OrcaLoadReport_rps_fractional(msg);
+  if (backend_metric_data->qps == 0) {
+    backend_metric_data->qps =
+        static_cast<double>(xds_data_orca_v3_OrcaLoadReport_rps(msg));
+  }
   backend_metric_data->request_cost =
       ParseMap<xds_data_orca_v3_OrcaLoadReport_RequestCostEntry>(
           msg, xds_data_orca_v3_OrcaLoadReport_request_cost_next,
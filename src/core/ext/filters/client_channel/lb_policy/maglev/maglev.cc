@@ -0,0 +1,229 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/consistent_hash.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/validation_errors.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/json/json_args.h"
+#include "src/core/lib/json/json_object_loader.h"
+#include "src/core/lib/load_balancing/lb_policy.h"
+#include "src/core/lib/load_balancing/lb_policy_factory.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_lb_maglev_trace(false, "maglev_lb");
+
+namespace {
+
+constexpr absl::string_view kMaglev = "maglev_experimental";
+
+// The table size must be prime, so that every address's permutation
+// visits every entry.  These bounds match Envoy's.
+constexpr uint64_t kDefaultTableSize = 65537;
+constexpr uint64_t kMaxTableSize = 5000011;
+
+struct MaglevConfig {
+  uint64_t table_size = kDefaultTableSize;
+
+  static const JsonLoaderInterface* JsonLoader(const JsonArgs&) {
+    static const auto* loader =
+        JsonObjectLoader<MaglevConfig>()
+            .OptionalField("tableSize", &MaglevConfig::table_size)
+            .Finish();
+    return loader;
+  }
+
+  void JsonPostLoad(const Json&, const JsonArgs&, ValidationErrors* errors) {
+    ValidationErrors::ScopedField field(errors, ".tableSize");
+    if (!errors->FieldHasErrors() &&
+        (table_size > kMaxTableSize || !IsPrime(table_size))) {
+      errors->AddError(absl::StrCat("must be a prime number no larger than ",
+                                    kMaxTableSize));
+    }
+  }
+};
+
+class MaglevLbConfig : public LoadBalancingPolicy::Config {
+ public:
+  explicit MaglevLbConfig(size_t table_size) : table_size_(table_size) {}
+  absl::string_view name() const override { return kMaglev; }
+  size_t table_size() const { return table_size_; }
+
+ private:
+  size_t table_size_;
+};
+
+//
+// MaglevTable
+//
+
+// An immutable Maglev lookup table, as described in "Maglev: A Fast and
+// Reliable Software Network Load Balancer" (NSDI '16).  A request hash h
+// is served by entry h % size().
+//
+// Each address fills entries in the order of its own permutation of the
+// table, derived from hashes of the address alone, so adding or removing
+// an address only moves the entries that it gains or gives up.  Unlike a
+// ring, the table has a fixed size independent of the number of
+// addresses, and every address gets a share of the entries that is within
+// a small fraction of its weight.
+class MaglevTable : public ConsistentHashTable {
+ public:
+  // Returns the table for the given inputs, building it if no table with
+  // the same inputs is currently in use.
+  static RefCountedPtr<ConsistentHashTable> GetOrCreate(
+      const std::vector<AddressWeight>& address_weights, size_t table_size) {
+    return ConsistentHashTable::GetOrCreate(
+        address_weights, absl::StrCat("maglev:", table_size),
+        [&]() { return new MaglevTable(address_weights, table_size); });
+  }
+
+  size_t FindEntry(uint64_t h) const override { return h % size(); }
+
+ private:
+  MaglevTable(const std::vector<AddressWeight>& address_weights,
+              size_t table_size);
+};
+
+MaglevTable::MaglevTable(const std::vector<AddressWeight>& address_weights,
+                         size_t table_size) {
+  constexpr uint32_t kEmpty = UINT32_MAX;
+  address_indices_.assign(table_size, kEmpty);
+  if (address_weights.empty()) return;
+  // Each address walks its permutation (offset + j * skip) % table_size,
+  // claiming the first entry not yet claimed whenever it gets a turn.
+  // position steps by skip without a division, since skip < table_size.
+  //
+  // The table is rebuilt from scratch rather than patched from the
+  // previous one, so that it stays a function of its inputs alone: a table
+  // patched on each update would depend on each client's update history,
+  // and clients would disagree about which address serves a hash.
+  struct Builder {
+    uint64_t position;
+    uint64_t skip;
+    uint64_t weight;
+    // Weighted Maglev: on each round, an address only gets a turn once
+    // round * weight has reached target, which advances by the largest
+    // weight every time it takes one, so the heaviest addresses take a
+    // turn every round and the others proportionally less often.
+    uint64_t target = 0;
+  };
+  std::vector<Builder> builders;
+  builders.reserve(address_weights.size());
+  uint64_t max_weight = 0;
+  for (const auto& address_weight : address_weights) {
+    const std::string& address = address_weight.address;
+    Builder builder;
+    builder.position = XXH64(address.data(), address.size(), 0) % table_size;
+    builder.skip =
+        XXH64(address.data(), address.size(), 1) % (table_size - 1) + 1;
+    builder.weight = address_weight.weight;
+    builders.push_back(builder);
+    max_weight = std::max(max_weight, builder.weight);
+  }
+  size_t filled = 0;
+  for (uint64_t round = 1; filled < table_size; ++round) {
+    for (size_t i = 0; i < builders.size() && filled < table_size; ++i) {
+      Builder& builder = builders[i];
+      if (round * builder.weight < builder.target) continue;
+      builder.target += max_weight;
+      size_t position;
+      do {
+        position = builder.position;
+        builder.position += builder.skip;
+        if (builder.position >= table_size) builder.position -= table_size;
+      } while (address_indices_[position] != kEmpty);
+      address_indices_[position] = static_cast<uint32_t>(i);
+      ++filled;
+    }
+  }
+}
+
+//
+// maglev LB policy
+//
+
+class Maglev : public ConsistentHashLbPolicy {
+ public:
+  explicit Maglev(Args args)
+      : ConsistentHashLbPolicy(std::move(args), &grpc_lb_maglev_trace,
+                               "maglev") {}
+
+  absl::string_view name() const override { return kMaglev; }
+
+ private:
+  RefCountedPtr<ConsistentHashTable> CreateTable(
+      const std::vector<ConsistentHashTable::AddressWeight>& address_weights,
+      const ChannelArgs& /*args*/) override {
+    return MaglevTable::GetOrCreate(
+        address_weights,
+        static_cast<const MaglevLbConfig*>(config())->table_size());
+  }
+};
+
+//
+// factory
+//
+
+class MaglevFactory : public LoadBalancingPolicyFactory {
+ public:
+  OrphanablePtr<LoadBalancingPolicy> CreateLoadBalancingPolicy(
+      LoadBalancingPolicy::Args args) const override {
+    return MakeOrphanable<Maglev>(std::move(args));
+  }
+
+  absl::string_view name() const override { return kMaglev; }
+
+  absl::StatusOr<RefCountedPtr<LoadBalancingPolicy::Config>>
+  ParseLoadBalancingConfig(const Json& json) const override {
+    auto config = LoadFromJson<MaglevConfig>(
+        json, JsonArgs(), "errors validating maglev LB policy config");
+    if (!config.ok()) return config.status();
+    return MakeRefCounted<MaglevLbConfig>(config->table_size);
+  }
+};
+
+}  // namespace
+
+void RegisterMaglevLbPolicy(CoreConfiguration::Builder* builder) {
+  builder->lb_policy_registry()->RegisterLoadBalancingPolicyFactory(
+      std::make_unique<MaglevFactory>());
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,94 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/outlier_detection/latency_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "src/core/lib/gpr/useful.h"
+
+namespace grpc_core {
+
+constexpr int64_t LatencySketch::kMaxLatencyMicros;
+
+namespace {
+
+// Returns the number of bits needed to represent x.
+uint32_t BitWidth(uint32_t x) {
+  x |= x >> 1;
+  x |= x >> 2;
+  x |= x >> 4;
+  x |= x >> 8;
+  x |= x >> 16;
+  return BitCount(x);
+}
+
+}  // namespace
+
+size_t LatencySketch::BucketForLatency(int64_t latency_micros) {
+  const uint32_t latency = static_cast<uint32_t>(
+      Clamp(latency_micros, int64_t{0}, kMaxLatencyMicros));
+  if (latency < kSubBuckets) return latency;
+  // The top kSubBucketBits + 1 bits of the latency select the bucket within
+  // its power of two.
+  const size_t shift = BitWidth(latency) - 1 - kSubBucketBits;
+  return kSubBuckets * shift + (latency >> shift);
+}
+
+int64_t LatencySketch::LatencyForBucket(size_t bucket) {
+  if (bucket < kSubBuckets) return bucket;
+  const size_t shift = bucket / kSubBuckets - 1;
+  const int64_t lower = static_cast<int64_t>(bucket % kSubBuckets + kSubBuckets)
+                        << shift;
+  const int64_t width = int64_t{1} << shift;
+  return lower + width / 2;
+}
+
+uint64_t LatencySketch::Count() const {
+  uint64_t count = 0;
+  for (const auto& bucket : buckets_) {
+    count += bucket.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+absl::optional<int64_t> LatencySketch::Quantile(double q) const {
+  uint64_t counts[kNumBuckets];
+  uint64_t total = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) return absl::nullopt;
+  // The rank of the sample we are looking for, counting from 1.
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) return LatencyForBucket(i);
+  }
+  return LatencyForBucket(kNumBuckets - 1);
+}
+
+void LatencySketch::Reset() {
+  for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,82 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_OUTLIER_DETECTION_LATENCY_SKETCH_H
+#define GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_OUTLIER_DETECTION_LATENCY_SKETCH_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "absl/types/optional.h"
+
+namespace grpc_core {
+
+// LatencySketch estimates quantiles of a stream of latencies.
+//
+// Latencies are counted in a fixed set of buckets, four per power of two
+// microseconds, so an estimate is within 12.5% of a latency that was actually
+// recorded.  Latencies above kMaxLatencyMicros (about 35 minutes) are counted
+// as kMaxLatencyMicros.
+//
+// Record() is a single relaxed atomic increment and may be called
+// concurrently with everything else.  Count() and Quantile() see a
+// consistent result only if no Record() runs concurrently; otherwise they
+// may miss samples that are in flight.
+class LatencySketch {
+ public:
+  static constexpr int64_t kMaxLatencyMicros = (int64_t{1} << 31) - 1;
+
+  LatencySketch() { Reset(); }
+
+  LatencySketch(const LatencySketch&) = delete;
+  LatencySketch& operator=(const LatencySketch&) = delete;
+
+  void Record(int64_t latency_micros) {
+    buckets_[BucketForLatency(latency_micros)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  // Returns the number of latencies recorded since the last Reset().
+  uint64_t Count() const;
+
+  // Returns the estimated quantile q of the recorded latencies, in
+  // microseconds, where 0 < q <= 1.  Returns nullopt if nothing has been
+  // recorded.
+  absl::optional<int64_t> Quantile(double q) const;
+
+  void Reset();
+
+ private:
+  static constexpr size_t kSubBucketBits = 2;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+  // Latencies below kSubBuckets microseconds have one bucket each; every
+  // power of two above that has kSubBuckets buckets.
+  static constexpr size_t kNumBuckets = kSubBuckets * (31 - kSubBucketBits + 1);
+
+  static size_t BucketForLatency(int64_t latency_micros);
+  // Returns the midpoint of the latencies counted in bucket.
+  static int64_t LatencyForBucket(size_t bucket);
+
+  std::atomic<uint64_t> buckets_[kNumBuckets];
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_OUTLIER_DETECTION_LATENCY_SKETCH_H
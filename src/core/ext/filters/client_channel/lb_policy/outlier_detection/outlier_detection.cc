@@ -41,8 +41,10 @@
 #include <grpc/event_engine/event_engine.h>
 #include <grpc/impl/connectivity_state.h>
 #include <grpc/support/log.h>
+#include <grpc/support/time.h>
 
 #include "src/core/ext/filters/client_channel/lb_policy/child_policy_handler.h"
+#include "src/core/ext/filters/client_channel/lb_policy/outlier_detection/latency_sketch.h"
 #include "src/core/lib/address_utils/sockaddr_utils.h"
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/config/core_configuration.h"
@@ -88,7 +90,12 @@ class OutlierDetectionLbConfig : public LoadBalancingPolicy::Config {
 
   bool CountingEnabled() const {
     return outlier_detection_config_.success_rate_ejection.has_value() ||
-           outlier_detection_config_.failure_percentage_ejection.has_value();
+           outlier_detection_config_.failure_percentage_ejection.has_value() ||
+           outlier_detection_config_.latency_ejection.has_value();
+  }
+
+  bool LatencyTrackingEnabled() const {
+    return outlier_detection_config_.latency_ejection.has_value();
   }
 
   const OutlierDetectionConfig& outlier_detection_config() const {
@@ -218,11 +225,13 @@ class OutlierDetectionLb : public LoadBalancingPolicy {
     struct Bucket {
       std::atomic<uint64_t> successes;
       std::atomic<uint64_t> failures;
+      LatencySketch latencies;
     };
 
     void RotateBucket() {
       backup_bucket_->successes = 0;
       backup_bucket_->failures = 0;
+      backup_bucket_->latencies.Reset();
       current_bucket_.swap(backup_bucket_);
       active_bucket_.store(current_bucket_.get());
     }
@@ -240,6 +249,17 @@ class OutlierDetectionLb : public LoadBalancingPolicy {
           {success_rate, backup_bucket_->successes + backup_bucket_->failures}};
     }
 
+    // Returns the given latency quantile, in microseconds, and the number
+    // of calls it was computed from.
+    absl::optional<std::pair<int64_t, uint64_t>> GetLatencyQuantileAndVolume(
+        double quantile) {
+      uint64_t total_request = backup_bucket_->latencies.Count();
+      absl::optional<int64_t> latency =
+          backup_bucket_->latencies.Quantile(quantile);
+      if (!latency.has_value()) return absl::nullopt;
+      return {{*latency, total_request}};
+    }
+
     void AddSubchannel(SubchannelWrapper* wrapper) {
       subchannels_.insert(wrapper);
     }
@@ -252,6 +272,10 @@ class OutlierDetectionLb : public LoadBalancingPolicy {
 
     void AddFailureCount() { active_bucket_.load()->failures.fetch_add(1); }
 
+    void AddLatency(int64_t latency_micros) {
+      active_bucket_.load()->latencies.Record(latency_micros);
+    }
+
     absl::optional<Timestamp> ejection_time() const { return ejection_time_; }
 
     void Eject(const Timestamp& time) {
@@ -310,7 +334,8 @@ class OutlierDetectionLb : public LoadBalancingPolicy {
   class Picker : public SubchannelPicker {
    public:
     Picker(OutlierDetectionLb* outlier_detection_lb,
-           RefCountedPtr<SubchannelPicker> picker, bool counting_enabled);
+           RefCountedPtr<SubchannelPicker> picker, bool counting_enabled,
+           bool latency_tracking_enabled);
 
     PickResult Pick(PickArgs args) override;
 
@@ -318,6 +343,7 @@ class OutlierDetectionLb : public LoadBalancingPolicy {
     class SubchannelCallTracker;
     RefCountedPtr<SubchannelPicker> picker_;
     bool counting_enabled_;
+    bool latency_tracking_enabled_;
   };
 
   class Helper : public ChannelControlHelper {
@@ -433,17 +459,21 @@ class OutlierDetectionLb::Picker::SubchannelCallTracker
   SubchannelCallTracker(
       std::unique_ptr<LoadBalancingPolicy::SubchannelCallTrackerInterface>
           original_subchannel_call_tracker,
-      RefCountedPtr<SubchannelState> subchannel_state)
+      RefCountedPtr<SubchannelState> subchannel_state,
+      bool latency_tracking_enabled)
       : original_subchannel_call_tracker_(
             std::move(original_subchannel_call_tracker)),
-        subchannel_state_(std::move(subchannel_state)) {}
+        subchannel_state_(std::move(subchannel_state)),
+        latency_tracking_enabled_(latency_tracking_enabled) {}
 
   ~SubchannelCallTracker() override {
     subchannel_state_.reset(DEBUG_LOCATION, "SubchannelCallTracker");
   }
 
   void Start() override {
-    // This tracker does not care about started calls only finished calls.
+    // Apart from timing the call for latency ejection, this tracker does not
+    // care about started calls only finished calls.
+    if (latency_tracking_enabled_) start_time_ = gpr_now(GPR_CLOCK_MONOTONIC);
     // Delegate if needed.
     if (original_subchannel_call_tracker_ != nullptr) {
       original_subchannel_call_tracker_->Start();
@@ -463,6 +493,12 @@ class OutlierDetectionLb::Picker::SubchannelCallTracker
       } else {
         subchannel_state_->AddFailureCount();
       }
+      if (latency_tracking_enabled_) {
+        gpr_timespec latency =
+            gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start_time_);
+        subchannel_state_->AddLatency(latency.tv_sec * GPR_US_PER_SEC +
+                                      latency.tv_nsec / GPR_NS_PER_US);
+      }
     }
   }
 
@@ -470,6 +506,8 @@ class OutlierDetectionLb::Picker::SubchannelCallTracker
   std::unique_ptr<LoadBalancingPolicy::SubchannelCallTrackerInterface>
       original_subchannel_call_tracker_;
   RefCountedPtr<SubchannelState> subchannel_state_;
+  const bool latency_tracking_enabled_;
+  gpr_timespec start_time_;
 };
 
 //
@@ -478,14 +516,18 @@ class OutlierDetectionLb::Picker::SubchannelCallTracker
 
 OutlierDetectionLb::Picker::Picker(OutlierDetectionLb* outlier_detection_lb,
                                    RefCountedPtr<SubchannelPicker> picker,
-                                   bool counting_enabled)
-    : picker_(std::move(picker)), counting_enabled_(counting_enabled) {
+                                   bool counting_enabled,
+                                   bool latency_tracking_enabled)
+    : picker_(std::move(picker)),
+      counting_enabled_(counting_enabled),
+      latency_tracking_enabled_(latency_tracking_enabled) {
   if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
     gpr_log(GPR_INFO,
             "[outlier_detection_lb %p] constructed new picker %p and counting "
-            "is %s",
+            "is %s, latency tracking is %s",
             outlier_detection_lb, this,
-            (counting_enabled ? "enabled" : "disabled"));
+            (counting_enabled ? "enabled" : "disabled"),
+            (latency_tracking_enabled ? "enabled" : "disabled"));
   }
 }
 
@@ -503,12 +545,13 @@ LoadBalancingPolicy::PickResult OutlierDetectionLb::Picker::Pick(
     auto* subchannel_wrapper =
         static_cast<SubchannelWrapper*>(complete_pick->subchannel.get());
     // Inject subchannel call tracker to record call completion as long as
-    // not both success_rate_ejection and failure_percentage_ejection are unset.
+    // at least one ejection algorithm is configured.
     if (counting_enabled_) {
       complete_pick->subchannel_call_tracker =
           std::make_unique<SubchannelCallTracker>(
               std::move(complete_pick->subchannel_call_tracker),
-              subchannel_wrapper->subchannel_state());
+              subchannel_wrapper->subchannel_state(),
+              latency_tracking_enabled_);
     }
     complete_pick->subchannel = subchannel_wrapper->wrapped_subchannel();
   }
@@ -669,7 +712,8 @@ absl::Status OutlierDetectionLb::UpdateLocked(UpdateArgs args) {
 void OutlierDetectionLb::MaybeUpdatePickerLocked() {
   if (picker_ != nullptr) {
     auto outlier_detection_picker =
-        MakeRefCounted<Picker>(this, picker_, config_->CountingEnabled());
+        MakeRefCounted<Picker>(this, picker_, config_->CountingEnabled(),
+                               config_->LatencyTrackingEnabled());
     if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
       gpr_log(GPR_INFO,
               "[outlier_detection_lb %p] updating connectivity: state=%s "
@@ -808,6 +852,7 @@ void OutlierDetectionLb::EjectionTimer::OnTimerLocked() {
   }
   std::map<SubchannelState*, double> success_rate_ejection_candidates;
   std::map<SubchannelState*, double> failure_percentage_ejection_candidates;
+  std::map<SubchannelState*, int64_t> latency_ejection_candidates;
   size_t ejected_host_count = 0;
   double success_rate_sum = 0;
   auto time_now = Timestamp::Now();
@@ -822,6 +867,17 @@ void OutlierDetectionLb::EjectionTimer::OnTimerLocked() {
     if (subchannel_state->ejection_time().has_value()) {
       ++ejected_host_count;
     }
+    if (config.latency_ejection.has_value()) {
+      auto host_latency_and_volume =
+          subchannel_state->GetLatencyQuantileAndVolume(
+              config.latency_ejection->percentile / 100.0);
+      if (host_latency_and_volume.has_value() &&
+          host_latency_and_volume->second >=
+              config.latency_ejection->request_volume) {
+        latency_ejection_candidates[subchannel_state] =
+            host_latency_and_volume->first;
+      }
+    }
     absl::optional<std::pair<double, uint64_t>> host_success_rate_and_volume =
         subchannel_state->GetSuccessRateAndVolume();
     if (!host_success_rate_and_volume.has_value()) {
@@ -845,11 +901,13 @@ void OutlierDetectionLb::EjectionTimer::OnTimerLocked() {
   if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
     gpr_log(GPR_INFO,
             "[outlier_detection_lb %p] found %" PRIuPTR
-            " success rate candidates and %" PRIuPTR
-            " failure percentage candidates; ejected_host_count=%" PRIuPTR
+            " success rate candidates, %" PRIuPTR
+            " failure percentage candidates and %" PRIuPTR
+            " latency candidates; ejected_host_count=%" PRIuPTR
             "; success_rate_sum=%.3f",
             parent_.get(), success_rate_ejection_candidates.size(),
-            failure_percentage_ejection_candidates.size(), ejected_host_count,
+            failure_percentage_ejection_candidates.size(),
+            latency_ejection_candidates.size(), ejected_host_count,
             success_rate_sum);
   }
   // success rate algorithm
@@ -958,6 +1016,64 @@ void OutlierDetectionLb::EjectionTimer::OnTimerLocked() {
       }
     }
   }
+  // latency algorithm
+  if (!latency_ejection_candidates.empty() &&
+      latency_ejection_candidates.size() >=
+          config.latency_ejection->minimum_hosts) {
+    // calculate ejection threshold: (median *
+    // (latency_ejection.threshold_factor / 1000))
+    std::vector<int64_t> latencies;
+    latencies.reserve(latency_ejection_candidates.size());
+    for (const auto& p : latency_ejection_candidates) {
+      latencies.push_back(p.second);
+    }
+    auto median = latencies.begin() + latencies.size() / 2;
+    std::nth_element(latencies.begin(), median, latencies.end());
+    const double ejection_threshold =
+        *median *
+        (static_cast<double>(config.latency_ejection->threshold_factor) / 1000);
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+      gpr_log(GPR_INFO,
+              "[outlier_detection_lb %p] running latency algorithm: "
+              "median=%" PRId64 "us, ejection_threshold=%.0fus",
+              parent_.get(), *median, ejection_threshold);
+    }
+    for (auto& candidate : latency_ejection_candidates) {
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+        gpr_log(GPR_INFO,
+                "[outlier_detection_lb %p] checking candidate %p: "
+                "latency=%" PRId64 "us",
+                parent_.get(), candidate.first, candidate.second);
+      }
+      // Extra check to make sure another algorithm didn't already eject
+      // this backend.
+      if (candidate.first->ejection_time().has_value()) continue;
+      if (candidate.second > ejection_threshold) {
+        uint32_t random_key = absl::Uniform(bit_gen_, 1, 100);
+        double current_percent =
+            100.0 * ejected_host_count / parent_->subchannel_state_map_.size();
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+          gpr_log(GPR_INFO,
+                  "[outlier_detection_lb %p] random_key=%d "
+                  "ejected_host_count=%" PRIuPTR " current_percent=%.3f",
+                  parent_.get(), random_key, ejected_host_count,
+                  current_percent);
+        }
+        if (random_key < config.latency_ejection->enforcement_percentage &&
+            (ejected_host_count == 0 ||
+             (current_percent < config.max_ejection_percent))) {
+          // Eject and record the timestamp for use when ejecting addresses in
+          // this iteration.
+          if (GRPC_TRACE_FLAG_ENABLED(grpc_outlier_detection_lb_trace)) {
+            gpr_log(GPR_INFO, "[outlier_detection_lb %p] ejecting candidate",
+                    parent_.get());
+          }
+          candidate.first->Eject(time_now);
+          ++ejected_host_count;
+        }
+      }
+    }
+  }
   // For each address in the map:
   //   If the address is not ejected and the multiplier is greater than 0,
   //   decrease the multiplier by 1. If the address is ejected, and the
@@ -1087,6 +1203,36 @@ void OutlierDetectionConfig::FailurePercentageEjection::JsonPostLoad(
   }
 }
 
+const JsonLoaderInterface* OutlierDetectionConfig::LatencyEjection::JsonLoader(
+    const JsonArgs&) {
+  static const auto* loader =
+      JsonObjectLoader<LatencyEjection>()
+          .OptionalField("percentile", &LatencyEjection::percentile)
+          .OptionalField("thresholdFactor", &LatencyEjection::threshold_factor)
+          .OptionalField("enforcementPercentage",
+                         &LatencyEjection::enforcement_percentage)
+          .OptionalField("minimumHosts", &LatencyEjection::minimum_hosts)
+          .OptionalField("requestVolume", &LatencyEjection::request_volume)
+          .Finish();
+  return loader;
+}
+
+void OutlierDetectionConfig::LatencyEjection::JsonPostLoad(
+    const Json&, const JsonArgs&, ValidationErrors* errors) {
+  if (percentile == 0 || percentile > 100) {
+    ValidationErrors::ScopedField field(errors, ".percentile");
+    errors->AddError("value must be in the range [1, 100]");
+  }
+  if (threshold_factor < 1000) {
+    ValidationErrors::ScopedField field(errors, ".threshold_factor");
+    errors->AddError("value must be >= 1000");
+  }
+  if (enforcement_percentage > 100) {
+    ValidationErrors::ScopedField field(errors, ".enforcement_percentage");
+    errors->AddError("value must be <= 100");
+  }
+}
+
 const JsonLoaderInterface* OutlierDetectionConfig::JsonLoader(const JsonArgs&) {
   static const auto* loader =
       JsonObjectLoader<OutlierDetectionConfig>()
@@ -1101,6 +1247,8 @@ const JsonLoaderInterface* OutlierDetectionConfig::JsonLoader(const JsonArgs&) {
                          &OutlierDetectionConfig::success_rate_ejection)
           .OptionalField("failurePercentageEjection",
                          &OutlierDetectionConfig::failure_percentage_ejection)
+          .OptionalField("latencyEjection",
+                         &OutlierDetectionConfig::latency_ejection)
           .Finish();
   return loader;
 }
@@ -0,0 +1,737 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/consistent_hash.h"
+
+#include <inttypes.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+
+#include <grpc/impl/connectivity_state.h>
+#include <grpc/support/log.h>
+
+#include "src/core/ext/filters/client_channel/lb_call_state_internal.h"
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/gprpp/debug_location.h"
+#include "src/core/lib/gprpp/no_destruct.h"
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/work_serializer.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/iomgr/error.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/load_balancing/subchannel_interface.h"
+#include "src/core/lib/resolver/server_address.h"
+#include "src/core/lib/transport/connectivity_state.h"
+
+namespace grpc_core {
+
+//
+// ConsistentHashTable
+//
+
+struct ConsistentHashTable::Cache {
+  Mutex mu;
+  std::map<std::string, ConsistentHashTable*, std::less<>> tables
+      ABSL_GUARDED_BY(&mu);
+};
+
+ConsistentHashTable::Cache* ConsistentHashTable::GetCache() {
+  static NoDestruct<Cache> cache;
+  return cache.get();
+}
+
+RefCountedPtr<ConsistentHashTable> ConsistentHashTable::GetOrCreate(
+    const std::vector<AddressWeight>& address_weights,
+    absl::string_view params,
+    absl::FunctionRef<ConsistentHashTable*()> create) {
+  std::string key;
+  for (const auto& address_weight : address_weights) {
+    absl::StrAppend(&key, address_weight.address, "/", address_weight.weight,
+                    ";");
+  }
+  absl::StrAppend(&key, params);
+  Cache* cache = GetCache();
+  {
+    MutexLock lock(&cache->mu);
+    auto it = cache->tables.find(key);
+    if (it != cache->tables.end()) {
+      auto table = it->second->RefIfNonZero();
+      if (table != nullptr) return table;
+    }
+  }
+  RefCountedPtr<ConsistentHashTable> table(create());
+  table->key_ = key;
+  MutexLock lock(&cache->mu);
+  ConsistentHashTable*& entry = cache->tables[std::move(key)];
+  if (entry != nullptr) {
+    // Another channel built the same table in the meantime; use that one.
+    auto existing = entry->RefIfNonZero();
+    if (existing != nullptr) return existing;
+  }
+  entry = table.get();
+  return table;
+}
+
+ConsistentHashTable::~ConsistentHashTable() {
+  if (key_.empty()) return;
+  Cache* cache = GetCache();
+  MutexLock lock(&cache->mu);
+  auto it = cache->tables.find(key_);
+  if (it != cache->tables.end() && it->second == this) {
+    cache->tables.erase(it);
+  }
+}
+
+//
+// ConsistentHashLbPolicy::ConsistentHashSubchannelData
+//
+
+// Data for a particular subchannel in a subchannel list.
+// This subclass adds the following functionality:
+// - Tracks the previous connectivity state of the subchannel, so that
+//   we know how many subchannels are in each state.
+class ConsistentHashLbPolicy::ConsistentHashSubchannelData
+    : public SubchannelData<ConsistentHashSubchannelList,
+                            ConsistentHashSubchannelData> {
+ public:
+  ConsistentHashSubchannelData(
+      SubchannelList<ConsistentHashSubchannelList,
+                     ConsistentHashSubchannelData>* subchannel_list,
+      const ServerAddress& address,
+      RefCountedPtr<SubchannelInterface> subchannel)
+      : SubchannelData(subchannel_list, address, std::move(subchannel)),
+        address_(address) {}
+
+  const ServerAddress& address() const { return address_; }
+
+  grpc_connectivity_state GetConnectivityState() const {
+    return connectivity_state_.load(std::memory_order_relaxed);
+  }
+
+  absl::Status GetConnectivityStatus() const {
+    MutexLock lock(&mu_);
+    return connectivity_status_;
+  }
+
+ private:
+  // Performs connectivity state updates that need to be done only
+  // after we have started watching.
+  void ProcessConnectivityChangeLocked(
+      absl::optional<grpc_connectivity_state> old_state,
+      grpc_connectivity_state new_state) override;
+
+  ServerAddress address_;
+
+  // Last logical connectivity state seen.
+  // Note that this may differ from the state actually reported by the
+  // subchannel in some cases; for example, once this is set to
+  // TRANSIENT_FAILURE, we do not change it again until we get READY,
+  // so we skip any interim stops in CONNECTING.
+  // Uses an atomic so that it can be accessed outside of the WorkSerializer.
+  std::atomic<grpc_connectivity_state> connectivity_state_{GRPC_CHANNEL_IDLE};
+
+  mutable Mutex mu_;
+  absl::Status connectivity_status_ ABSL_GUARDED_BY(&mu_);
+};
+
+//
+// ConsistentHashLbPolicy::ConsistentHashSubchannelList
+//
+
+// A list of subchannels and the table containing those subchannels.
+class ConsistentHashLbPolicy::ConsistentHashSubchannelList
+    : public SubchannelList<ConsistentHashSubchannelList,
+                            ConsistentHashSubchannelData> {
+ public:
+  ConsistentHashSubchannelList(ConsistentHashLbPolicy* policy,
+                               ServerAddressList addresses,
+                               const ChannelArgs& args);
+
+  ~ConsistentHashSubchannelList() override {
+    policy()->Unref(DEBUG_LOCATION, "subchannel_list");
+  }
+
+  ConsistentHashLbPolicy* policy() const {
+    return static_cast<ConsistentHashLbPolicy*>(SubchannelList::policy());
+  }
+
+  const ConsistentHashTable& table() const { return *table_; }
+
+  // Returns the subchannel for the table entry at position.
+  ConsistentHashSubchannelData* table_subchannel(size_t position) {
+    return subchannel(table_->address_index(position));
+  }
+
+  // Updates the counters of subchannels in each state when a
+  // subchannel transitions from old_state to new_state.
+  void UpdateStateCountersLocked(grpc_connectivity_state old_state,
+                                 grpc_connectivity_state new_state);
+
+  // Updates the policy's connectivity state based on the subchannel
+  // list's state counters, creating new picker.
+  // The index parameter indicates the index into the list of the subchannel
+  // whose status report triggered the call to
+  // UpdateConnectivityStateLocked().
+  // connection_attempt_complete is true if the subchannel just
+  // finished a connection attempt.
+  void UpdateConnectivityStateLocked(size_t index,
+                                     bool connection_attempt_complete,
+                                     absl::Status status);
+
+ private:
+  size_t num_idle_;
+  size_t num_ready_ = 0;
+  size_t num_connecting_ = 0;
+  size_t num_transient_failure_ = 0;
+
+  RefCountedPtr<ConsistentHashTable> table_;
+
+  // The index of the subchannel currently doing an internally
+  // triggered connection attempt, if any.
+  absl::optional<size_t> internally_triggered_connection_index_;
+
+  // TODO(roth): If we ever change the helper UpdateState() API to not
+  // need the status reported for TRANSIENT_FAILURE state (because
+  // it's not currently actually used for anything outside of the picker),
+  // then we will no longer need this data member.
+  absl::Status last_failure_;
+};
+
+//
+// ConsistentHashLbPolicy::Picker
+//
+
+class ConsistentHashLbPolicy::Picker : public SubchannelPicker {
+ public:
+  explicit Picker(RefCountedPtr<ConsistentHashSubchannelList> subchannel_list)
+      : subchannel_list_(std::move(subchannel_list)) {}
+
+  ~Picker() override {
+    // Hop into WorkSerializer to unref the subchannel list, since that may
+    // trigger the unreffing of the underlying subchannels.
+    MakeOrphanable<WorkSerializerRunner>(std::move(subchannel_list_));
+  }
+
+  PickResult Pick(PickArgs args) override;
+
+ private:
+  // An interface for running a callback in the control plane WorkSerializer.
+  class WorkSerializerRunner : public Orphanable {
+   public:
+    explicit WorkSerializerRunner(
+        RefCountedPtr<ConsistentHashSubchannelList> subchannel_list)
+        : subchannel_list_(std::move(subchannel_list)) {
+      GRPC_CLOSURE_INIT(&closure_, RunInExecCtx, this, nullptr);
+    }
+
+    void Orphan() override {
+      // Hop into ExecCtx, so that we don't run control-plane code from
+      // inside a pick.
+      ExecCtx::Run(DEBUG_LOCATION, &closure_, absl::OkStatus());
+    }
+
+    // Will be invoked inside of the WorkSerializer.
+    virtual void Run() {}
+
+   protected:
+    ConsistentHashLbPolicy* lb_policy() const {
+      return subchannel_list_->policy();
+    }
+
+   private:
+    static void RunInExecCtx(void* arg, grpc_error_handle /*error*/) {
+      auto* self = static_cast<WorkSerializerRunner*>(arg);
+      self->lb_policy()->work_serializer()->Run(
+          [self]() {
+            self->Run();
+            delete self;
+          },
+          DEBUG_LOCATION);
+    }
+
+    RefCountedPtr<ConsistentHashSubchannelList> subchannel_list_;
+    grpc_closure closure_;
+  };
+
+  // A fire-and-forget class that schedules subchannel connection attempts
+  // on the control plane WorkSerializer.
+  class SubchannelConnectionAttempter : public WorkSerializerRunner {
+   public:
+    explicit SubchannelConnectionAttempter(
+        RefCountedPtr<ConsistentHashSubchannelList> subchannel_list)
+        : WorkSerializerRunner(std::move(subchannel_list)) {}
+
+    void AddSubchannel(RefCountedPtr<SubchannelInterface> subchannel) {
+      subchannels_.push_back(std::move(subchannel));
+    }
+
+    void Run() override {
+      if (!lb_policy()->shutdown_) {
+        for (auto& subchannel : subchannels_) {
+          subchannel->RequestConnection();
+        }
+      }
+    }
+
+   private:
+    std::vector<RefCountedPtr<SubchannelInterface>> subchannels_;
+  };
+
+  RefCountedPtr<ConsistentHashSubchannelList> subchannel_list_;
+};
+
+ConsistentHashLbPolicy::PickResult ConsistentHashLbPolicy::Picker::Pick(
+    PickArgs args) {
+  auto* call_state = static_cast<LbCallStateInternal*>(args.call_state);
+  auto hash = call_state->GetCallAttribute(RequestHashAttributeName());
+  const char* display_name = subchannel_list_->policy()->display_name_;
+  uint64_t h;
+  if (!absl::SimpleAtoi(hash, &h)) {
+    return PickResult::Fail(absl::InternalError(
+        absl::StrCat(display_name, " value is not a number")));
+  }
+  const ConsistentHashTable& table = subchannel_list_->table();
+  const size_t first_index = table.FindEntry(h);
+  ConsistentHashSubchannelData* first_subchannel =
+      subchannel_list_->table_subchannel(first_index);
+  OrphanablePtr<SubchannelConnectionAttempter> subchannel_connection_attempter;
+  auto ScheduleSubchannelConnectionAttempt =
+      [&](RefCountedPtr<SubchannelInterface> subchannel) {
+        if (subchannel_connection_attempter == nullptr) {
+          subchannel_connection_attempter =
+              MakeOrphanable<SubchannelConnectionAttempter>(
+                  subchannel_list_->Ref(DEBUG_LOCATION,
+                                        "SubchannelConnectionAttempter"));
+        }
+        subchannel_connection_attempter->AddSubchannel(std::move(subchannel));
+      };
+  switch (first_subchannel->GetConnectivityState()) {
+    case GRPC_CHANNEL_READY:
+      return PickResult::Complete(first_subchannel->subchannel()->Ref());
+    case GRPC_CHANNEL_IDLE:
+      ScheduleSubchannelConnectionAttempt(
+          first_subchannel->subchannel()->Ref());
+      ABSL_FALLTHROUGH_INTENDED;
+    case GRPC_CHANNEL_CONNECTING:
+      return PickResult::Queue();
+    default:  // GRPC_CHANNEL_TRANSIENT_FAILURE
+      break;
+  }
+  ScheduleSubchannelConnectionAttempt(first_subchannel->subchannel()->Ref());
+  // Loop through remaining subchannels to find one in READY.
+  // On the way, we make sure the right set of connection attempts
+  // will happen.
+  bool found_second_subchannel = false;
+  bool found_first_non_failed = false;
+  for (size_t i = 1; i < table.size(); ++i) {
+    ConsistentHashSubchannelData* entry_subchannel =
+        subchannel_list_->table_subchannel((first_index + i) % table.size());
+    if (entry_subchannel == first_subchannel) {
+      continue;
+    }
+    grpc_connectivity_state connectivity_state =
+        entry_subchannel->GetConnectivityState();
+    if (connectivity_state == GRPC_CHANNEL_READY) {
+      return PickResult::Complete(entry_subchannel->subchannel()->Ref());
+    }
+    if (!found_second_subchannel) {
+      switch (connectivity_state) {
+        case GRPC_CHANNEL_IDLE:
+          ScheduleSubchannelConnectionAttempt(
+              entry_subchannel->subchannel()->Ref());
+          ABSL_FALLTHROUGH_INTENDED;
+        case GRPC_CHANNEL_CONNECTING:
+          return PickResult::Queue();
+        default:
+          break;
+      }
+      found_second_subchannel = true;
+    }
+    if (!found_first_non_failed) {
+      if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+        ScheduleSubchannelConnectionAttempt(
+            entry_subchannel->subchannel()->Ref());
+      } else {
+        if (connectivity_state == GRPC_CHANNEL_IDLE) {
+          ScheduleSubchannelConnectionAttempt(
+              entry_subchannel->subchannel()->Ref());
+        }
+        found_first_non_failed = true;
+      }
+    }
+  }
+  return PickResult::Fail(absl::UnavailableError(absl::StrCat(
+      display_name, " cannot find a connected subchannel; first failure: ",
+      first_subchannel->GetConnectivityStatus().ToString())));
+}
+
+//
+// ConsistentHashLbPolicy::ConsistentHashSubchannelList
+//
+
+ConsistentHashLbPolicy::ConsistentHashSubchannelList::
+    ConsistentHashSubchannelList(ConsistentHashLbPolicy* policy,
+                                 ServerAddressList addresses,
+                                 const ChannelArgs& args)
+    : SubchannelList(policy,
+                     (GRPC_TRACE_FLAG_ENABLED(*policy->tracer_)
+                          ? "ConsistentHashSubchannelList"
+                          : nullptr),
+                     std::move(addresses), policy->channel_control_helper(),
+                     args),
+      num_idle_(num_subchannels()) {
+  // Need to maintain a ref to the LB policy as long as we maintain
+  // any references to subchannels, since the subchannels'
+  // pollset_sets will include the LB policy's pollset_set.
+  policy->Ref(DEBUG_LOCATION, "subchannel_list").release();
+  // Construct the table, or reuse one built from the same addresses.
+  std::vector<ConsistentHashTable::AddressWeight> address_weights;
+  address_weights.reserve(num_subchannels());
+  for (size_t i = 0; i < num_subchannels(); ++i) {
+    ConsistentHashSubchannelData* sd = subchannel(i);
+    const ServerAddressWeightAttribute* weight_attribute = static_cast<
+        const ServerAddressWeightAttribute*>(sd->address().GetAttribute(
+        ServerAddressWeightAttribute::kServerAddressWeightAttributeKey));
+    ConsistentHashTable::AddressWeight address_weight;
+    address_weight.address =
+        grpc_sockaddr_to_string(&sd->address().address(), false).value();
+    // Weight should never be zero, but ignore it just in case, since
+    // that value would screw up the table-building algorithms.
+    if (weight_attribute != nullptr && weight_attribute->weight() > 0) {
+      address_weight.weight = weight_attribute->weight();
+    }
+    address_weights.push_back(std::move(address_weight));
+  }
+  table_ = policy->CreateTable(address_weights, args);
+  if (GRPC_TRACE_FLAG_ENABLED(*policy->tracer_)) {
+    gpr_log(GPR_INFO,
+            "[%s %p] created subchannel list %p with %" PRIuPTR
+            " table entries (table %p)",
+            policy->display_name_, policy, this, table_->size(), table_.get());
+  }
+}
+
+void ConsistentHashLbPolicy::ConsistentHashSubchannelList::
+    UpdateStateCountersLocked(grpc_connectivity_state old_state,
+                              grpc_connectivity_state new_state) {
+  if (old_state == GRPC_CHANNEL_IDLE) {
+    GPR_ASSERT(num_idle_ > 0);
+    --num_idle_;
+  } else if (old_state == GRPC_CHANNEL_READY) {
+    GPR_ASSERT(num_ready_ > 0);
+    --num_ready_;
+  } else if (old_state == GRPC_CHANNEL_CONNECTING) {
+    GPR_ASSERT(num_connecting_ > 0);
+    --num_connecting_;
+  } else if (old_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    GPR_ASSERT(num_transient_failure_ > 0);
+    --num_transient_failure_;
+  }
+  GPR_ASSERT(new_state != GRPC_CHANNEL_SHUTDOWN);
+  if (new_state == GRPC_CHANNEL_IDLE) {
+    ++num_idle_;
+  } else if (new_state == GRPC_CHANNEL_READY) {
+    ++num_ready_;
+  } else if (new_state == GRPC_CHANNEL_CONNECTING) {
+    ++num_connecting_;
+  } else if (new_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    ++num_transient_failure_;
+  }
+}
+
+void ConsistentHashLbPolicy::ConsistentHashSubchannelList::
+    UpdateConnectivityStateLocked(size_t index,
+                                  bool connection_attempt_complete,
+                                  absl::Status status) {
+  ConsistentHashLbPolicy* p = policy();
+  // If this is latest_pending_subchannel_list_, then swap it into
+  // subchannel_list_ as soon as we get the initial connectivity state
+  // report for every subchannel in the list.
+  if (p->latest_pending_subchannel_list_.get() == this &&
+      AllSubchannelsSeenInitialState()) {
+    if (GRPC_TRACE_FLAG_ENABLED(*p->tracer_)) {
+      gpr_log(GPR_INFO, "[%s %p] replacing subchannel list %p with %p",
+              p->display_name_, p, p->subchannel_list_.get(), this);
+    }
+    p->subchannel_list_ = std::move(p->latest_pending_subchannel_list_);
+  }
+  // Only set connectivity state if this is the current subchannel list.
+  if (p->subchannel_list_.get() != this) return;
+  // The overall aggregation rules here are:
+  // 1. If there is at least one subchannel in READY state, report READY.
+  // 2. If there are 2 or more subchannels in TRANSIENT_FAILURE state, report
+  //    TRANSIENT_FAILURE.
+  // 3. If there is at least one subchannel in CONNECTING state, report
+  //    CONNECTING.
+  // 4. If there is one subchannel in TRANSIENT_FAILURE state and there is
+  //    more than one subchannel, report CONNECTING.
+  // 5. If there is at least one subchannel in IDLE state, report IDLE.
+  // 6. Otherwise, report TRANSIENT_FAILURE.
+  //
+  // We set start_connection_attempt to true if we match rules 2, 3, or 6.
+  grpc_connectivity_state state;
+  bool start_connection_attempt = false;
+  if (num_ready_ > 0) {
+    state = GRPC_CHANNEL_READY;
+  } else if (num_transient_failure_ >= 2) {
+    state = GRPC_CHANNEL_TRANSIENT_FAILURE;
+    start_connection_attempt = true;
+  } else if (num_connecting_ > 0) {
+    state = GRPC_CHANNEL_CONNECTING;
+  } else if (num_transient_failure_ == 1 && num_subchannels() > 1) {
+    state = GRPC_CHANNEL_CONNECTING;
+    start_connection_attempt = true;
+  } else if (num_idle_ > 0) {
+    state = GRPC_CHANNEL_IDLE;
+  } else {
+    state = GRPC_CHANNEL_TRANSIENT_FAILURE;
+    start_connection_attempt = true;
+  }
+  // In TRANSIENT_FAILURE, report the last reported failure.
+  // Otherwise, report OK.
+  if (state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    if (!status.ok()) {
+      last_failure_ = absl::UnavailableError(absl::StrCat(
+          "no reachable subchannels; last error: ", status.ToString()));
+    }
+    status = last_failure_;
+  } else {
+    status = absl::OkStatus();
+  }
+  // Generate new picker and return it to the channel.
+  // Note that we use our own picker regardless of connectivity state.
+  p->channel_control_helper()->UpdateState(
+      state, status,
+      MakeRefCounted<Picker>(Ref(DEBUG_LOCATION, "ConsistentHashPicker")));
+  // While the policy is reporting TRANSIENT_FAILURE, it will
+  // not be getting any pick requests from the priority policy.
+  // However, because the policy does not attempt to
+  // reconnect to subchannels unless it is getting pick requests,
+  // it will need special handling to ensure that it will eventually
+  // recover from TRANSIENT_FAILURE state once the problem is resolved.
+  // Specifically, it will make sure that it is attempting to connect to
+  // at least one subchannel at any given time.  After a given subchannel
+  // fails a connection attempt, it will move on to the next subchannel
+  // in the list.  It will keep doing this until one of the subchannels
+  // successfully connects, at which point it will report READY and stop
+  // proactively trying to connect.  The policy will remain in
+  // TRANSIENT_FAILURE until at least one subchannel becomes connected,
+  // even if subchannels are in state CONNECTING during that time.
+  //
+  // Note that we do the same thing when the policy is in state
+  // CONNECTING, just to ensure that we don't remain in CONNECTING state
+  // indefinitely if there are no new picks coming in.
+  if (internally_triggered_connection_index_.has_value() &&
+      *internally_triggered_connection_index_ == index &&
+      connection_attempt_complete) {
+    internally_triggered_connection_index_.reset();
+  }
+  if (start_connection_attempt &&
+      !internally_triggered_connection_index_.has_value()) {
+    size_t next_index = (index + 1) % num_subchannels();
+    if (GRPC_TRACE_FLAG_ENABLED(*p->tracer_)) {
+      gpr_log(GPR_INFO,
+              "[%s %p] triggering internal connection attempt for subchannel "
+              "%p, subchannel_list %p (index %" PRIuPTR " of %" PRIuPTR ")",
+              p->display_name_, p, subchannel(next_index)->subchannel(), this,
+              next_index, num_subchannels());
+    }
+    internally_triggered_connection_index_ = next_index;
+    subchannel(next_index)->subchannel()->RequestConnection();
+  }
+}
+
+//
+// ConsistentHashLbPolicy::ConsistentHashSubchannelData
+//
+
+void ConsistentHashLbPolicy::ConsistentHashSubchannelData::
+    ProcessConnectivityChangeLocked(
+        absl::optional<grpc_connectivity_state> old_state,
+        grpc_connectivity_state new_state) {
+  ConsistentHashLbPolicy* p = subchannel_list()->policy();
+  grpc_connectivity_state last_connectivity_state = GetConnectivityState();
+  if (GRPC_TRACE_FLAG_ENABLED(*p->tracer_)) {
+    gpr_log(
+        GPR_INFO,
+        "[%s %p] connectivity changed for subchannel %p, subchannel_list %p "
+        "(index %" PRIuPTR " of %" PRIuPTR "): prev_state=%s new_state=%s",
+        p->display_name_, p, subchannel(), subchannel_list(), Index(),
+        subchannel_list()->num_subchannels(),
+        ConnectivityStateName(last_connectivity_state),
+        ConnectivityStateName(new_state));
+  }
+  GPR_ASSERT(subchannel() != nullptr);
+  // If this is not the initial state notification and the new state is
+  // TRANSIENT_FAILURE or IDLE, re-resolve.
+  // Note that we don't want to do this on the initial state notification,
+  // because that would result in an endless loop of re-resolution.
+  if (old_state.has_value() && (new_state == GRPC_CHANNEL_TRANSIENT_FAILURE ||
+                                new_state == GRPC_CHANNEL_IDLE)) {
+    if (GRPC_TRACE_FLAG_ENABLED(*p->tracer_)) {
+      gpr_log(GPR_INFO,
+              "[%s %p] Subchannel %p reported %s; requesting re-resolution",
+              p->display_name_, p, subchannel(),
+              ConnectivityStateName(new_state));
+    }
+    p->channel_control_helper()->RequestReresolution();
+  }
+  const bool connection_attempt_complete = new_state != GRPC_CHANNEL_CONNECTING;
+  // Decide what state to report for the purposes of aggregation and
+  // picker behavior.
+  // If the last recorded state was TRANSIENT_FAILURE, ignore the update
+  // unless the new state is READY.
+  bool update_status = true;
+  absl::Status status = connectivity_status();
+  if (last_connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE &&
+      new_state != GRPC_CHANNEL_READY &&
+      new_state != GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    new_state = GRPC_CHANNEL_TRANSIENT_FAILURE;
+    {
+      MutexLock lock(&mu_);
+      status = connectivity_status_;
+    }
+    update_status = false;
+  }
+  // Update state counters used for aggregation.
+  subchannel_list()->UpdateStateCountersLocked(last_connectivity_state,
+                                               new_state);
+  // Update status seen by picker if needed.
+  if (update_status) {
+    MutexLock lock(&mu_);
+    connectivity_status_ = connectivity_status();
+  }
+  // Update last seen state, also used by picker.
+  connectivity_state_.store(new_state, std::memory_order_relaxed);
+  // Update the policy's connectivity state, creating new picker.
+  subchannel_list()->UpdateConnectivityStateLocked(
+      Index(), connection_attempt_complete, status);
+}
+
+//
+// ConsistentHashLbPolicy
+//
+
+ConsistentHashLbPolicy::ConsistentHashLbPolicy(Args args, TraceFlag* tracer,
+                                               const char* display_name)
+    : LoadBalancingPolicy(std::move(args)),
+      tracer_(tracer),
+      display_name_(display_name) {
+  if (GRPC_TRACE_FLAG_ENABLED(*tracer_)) {
+    gpr_log(GPR_INFO, "[%s %p] Created", display_name_, this);
+  }
+}
+
+ConsistentHashLbPolicy::~ConsistentHashLbPolicy() {
+  if (GRPC_TRACE_FLAG_ENABLED(*tracer_)) {
+    gpr_log(GPR_INFO, "[%s %p] Destroying %s policy", display_name_, this,
+            display_name_);
+  }
+  GPR_ASSERT(subchannel_list_ == nullptr);
+  GPR_ASSERT(latest_pending_subchannel_list_ == nullptr);
+}
+
+void ConsistentHashLbPolicy::ShutdownLocked() {
+  if (GRPC_TRACE_FLAG_ENABLED(*tracer_)) {
+    gpr_log(GPR_INFO, "[%s %p] Shutting down", display_name_, this);
+  }
+  shutdown_ = true;
+  subchannel_list_.reset();
+  latest_pending_subchannel_list_.reset();
+}
+
+void ConsistentHashLbPolicy::ResetBackoffLocked() {
+  subchannel_list_->ResetBackoffLocked();
+  if (latest_pending_subchannel_list_ != nullptr) {
+    latest_pending_subchannel_list_->ResetBackoffLocked();
+  }
+}
+
+absl::Status ConsistentHashLbPolicy::UpdateLocked(UpdateArgs args) {
+  config_ = std::move(args.config);
+  ServerAddressList addresses;
+  if (args.addresses.ok()) {
+    if (GRPC_TRACE_FLAG_ENABLED(*tracer_)) {
+      gpr_log(GPR_INFO, "[%s %p] received update with %" PRIuPTR " addresses",
+              display_name_, this, args.addresses->size());
+    }
+    addresses = *std::move(args.addresses);
+  } else {
+    if (GRPC_TRACE_FLAG_ENABLED(*tracer_)) {
+      gpr_log(GPR_INFO, "[%s %p] received update with addresses error: %s",
+              display_name_, this, args.addresses.status().ToString().c_str());
+    }
+    // If we already have a subchannel list, then keep using the existing
+    // list, but still report back that the update was not accepted.
+    if (subchannel_list_ != nullptr) return args.addresses.status();
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(*tracer_) &&
+      latest_pending_subchannel_list_ != nullptr) {
+    gpr_log(GPR_INFO, "[%s %p] replacing latest pending subchannel list %p",
+            display_name_, this, latest_pending_subchannel_list_.get());
+  }
+  latest_pending_subchannel_list_ =
+      MakeRefCounted<ConsistentHashSubchannelList>(this, std::move(addresses),
+                                                   args.args);
+  latest_pending_subchannel_list_->StartWatchingLocked();
+  // If we have no existing list or the new list is empty, immediately
+  // promote the new list.
+  // Otherwise, do nothing; the new list will be promoted when the
+  // initial subchannel states are reported.
+  if (subchannel_list_ == nullptr ||
+      latest_pending_subchannel_list_->num_subchannels() == 0) {
+    if (GRPC_TRACE_FLAG_ENABLED(*tracer_) && subchannel_list_ != nullptr) {
+      gpr_log(GPR_INFO,
+              "[%s %p] empty address list, replacing subchannel list %p",
+              display_name_, this, subchannel_list_.get());
+    }
+    subchannel_list_ = std::move(latest_pending_subchannel_list_);
+    // If the new list is empty, report TRANSIENT_FAILURE.
+    if (subchannel_list_->num_subchannels() == 0) {
+      absl::Status status =
+          args.addresses.ok()
+              ? absl::UnavailableError(
+                    absl::StrCat("empty address list: ", args.resolution_note))
+              : args.addresses.status();
+      channel_control_helper()->UpdateState(
+          GRPC_CHANNEL_TRANSIENT_FAILURE, status,
+          MakeRefCounted<TransientFailurePicker>(status));
+      return status;
+    }
+    // Otherwise, report IDLE.
+    subchannel_list_->UpdateConnectivityStateLocked(
+        /*index=*/0, /*connection_attempt_complete=*/false, absl::OkStatus());
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,139 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_RING_HASH_CONSISTENT_HASH_H
+#define GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_RING_HASH_CONSISTENT_HASH_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/load_balancing/lb_policy.h"
+
+namespace grpc_core {
+
+// An immutable table that maps request hashes to addresses, as built by
+// ring_hash (a ring) or maglev (a Maglev lookup table).  Each entry holds
+// the index of an address in the list the table was built from.
+//
+// A table depends only on its addresses (in order), their weights and the
+// policy's sizing parameters, so channels with the same inputs share one
+// table through a process-wide cache.
+class ConsistentHashTable : public RefCounted<ConsistentHashTable> {
+ public:
+  struct AddressWeight {
+    std::string address;
+    // Default weight is 1 for the cases where a weight is not provided,
+    // each occurrence of the address will be counted a weight value of 1.
+    uint32_t weight = 1;
+  };
+
+  ~ConsistentHashTable() override;
+
+  size_t size() const { return address_indices_.size(); }
+
+  // Returns the position of the entry that serves the request hash h.
+  virtual size_t FindEntry(uint64_t h) const = 0;
+
+  // Returns the index of the address for the entry at position.
+  size_t address_index(size_t position) const {
+    return address_indices_[position];
+  }
+
+ protected:
+  ConsistentHashTable() = default;
+
+  // Returns the table for address_weights and params, calling create() to
+  // build one if no such table is currently in use.  params must identify
+  // the kind of table as well as its sizing parameters, since tables of
+  // every kind share one cache.  create() is called without holding the
+  // cache lock, since large tables take a while to build.
+  static RefCountedPtr<ConsistentHashTable> GetOrCreate(
+      const std::vector<AddressWeight>& address_weights,
+      absl::string_view params,
+      absl::FunctionRef<ConsistentHashTable*()> create);
+
+  std::vector<uint32_t> address_indices_;
+
+ private:
+  struct Cache;
+
+  static Cache* GetCache();
+
+  std::string key_;
+};
+
+// The parts of the ring_hash and maglev policies that do not depend on how
+// their table is built.  Picks look up the request hash (see
+// RequestHashAttributeName()) in the table, connect to subchannels lazily,
+// and fail over to subchannels of later entries when the one serving the
+// hash is not READY.
+class ConsistentHashLbPolicy : public LoadBalancingPolicy {
+ public:
+  absl::Status UpdateLocked(UpdateArgs args) override;
+  void ResetBackoffLocked() override;
+
+ protected:
+  // display_name names the policy in trace logs and pick failures, e.g.
+  // "ring hash".
+  ConsistentHashLbPolicy(Args args, TraceFlag* tracer,
+                         const char* display_name);
+  ~ConsistentHashLbPolicy() override;
+
+  // Returns the config from the latest update.
+  const Config* config() const { return config_.get(); }
+
+  // Returns the table for a new subchannel list.  Called from within
+  // UpdateLocked(), after config() has been updated.
+  virtual RefCountedPtr<ConsistentHashTable> CreateTable(
+      const std::vector<ConsistentHashTable::AddressWeight>& address_weights,
+      const ChannelArgs& args) = 0;
+
+ private:
+  class ConsistentHashSubchannelData;
+  class ConsistentHashSubchannelList;
+  class Picker;
+
+  void ShutdownLocked() override;
+
+  TraceFlag* const tracer_;
+  const char* const display_name_;
+
+  // Current config from resolver.
+  RefCountedPtr<Config> config_;
+
+  // list of subchannels.
+  RefCountedPtr<ConsistentHashSubchannelList> subchannel_list_;
+  RefCountedPtr<ConsistentHashSubchannelList> latest_pending_subchannel_list_;
+  // indicating if we are shutting down.
+  bool shutdown_ = false;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_EXT_FILTERS_CLIENT_CHANNEL_LB_POLICY_RING_HASH_CONSISTENT_HASH_H
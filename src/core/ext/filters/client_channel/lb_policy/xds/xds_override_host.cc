@@ -178,8 +178,8 @@ class XdsOverrideHostLb : public LoadBalancingPolicy {
           RefCountedPtr<SubchannelWrapper> subchannel)
           : subchannel_(std::move(subchannel)) {
         GRPC_CLOSURE_INIT(&closure_, RunInExecCtx, this, nullptr);
-        // Hop into ExecCtx, so that we're not holding the data plane mutex
-        // while we run control-plane code.
+        // Hop into ExecCtx, so that we don't run control-plane code from
+        // inside a pick.
         ExecCtx::Run(DEBUG_LOCATION, &closure_, absl::OkStatus());
       }
 
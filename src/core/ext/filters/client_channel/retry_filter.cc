@@ -22,6 +22,7 @@
 #include <limits.h>
 #include <stddef.h>
 
+#include <algorithm>
 #include <memory>
 #include <new>
 #include <string>
@@ -35,6 +36,8 @@
 #include "absl/strings/strip.h"
 #include "absl/types/optional.h"
 
+#include <grpc/event_engine/memory_allocator.h>
+#include <grpc/event_engine/memory_request.h>
 #include <grpc/grpc.h>
 #include <grpc/slice.h>
 #include <grpc/status.h>
@@ -65,7 +68,10 @@
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/polling_entity.h"
 #include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/resource_quota/api.h"
 #include "src/core/lib/resource_quota/arena.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
 #include "src/core/lib/service_config/service_config.h"
 #include "src/core/lib/service_config/service_config_call_data.h"
 #include "src/core/lib/slice/slice.h"
@@ -116,9 +122,13 @@
 // When constructing the "child" batches, we compare the state in the
 // CallAttempt object against the state in the CallData object to see
 // which batches need to be sent on the LB call for a given attempt.
-
-// TODO(roth): In subsequent PRs:
-// - implement hedging
+//
+// When the method has a hedging policy instead of a retry policy, several
+// call attempts may be in flight at once: a new attempt is started every
+// hedgingDelay (or immediately when an attempt fails with a non-fatal
+// status), each replaying the cached send ops on its own LB call.  The
+// first attempt to get a response from the server (or to fail with a
+// fatal status) is committed, and all of the others are cancelled.
 
 // By default, we buffer 256 KiB per RPC for retries.
 // TODO(roth): Do we have any data to suggest a better value?
@@ -178,6 +188,7 @@ class RetryFilter {
       : client_channel_(grpc_channel_args_find_pointer<ClientChannel>(
             args, GRPC_ARG_CLIENT_CHANNEL)),
         per_rpc_retry_buffer_size_(GetMaxPerRpcRetryBufferSize(args)),
+        memory_quota_(ResourceQuotaFromChannelArgs(args)->memory_quota()),
         service_config_parser_index_(
             internal::RetryServiceConfigParser::ParserIndex()) {
     // Get retry throttling parameters from service config.
@@ -211,11 +222,20 @@ class RetryFilter {
             config->milli_token_ratio());
   }
 
+  const RetryMethodConfig* GetMethodConfig(
+      const grpc_call_context_element* context);
+  // Returns null if the method has no retry policy (which includes the
+  // case where it has a hedging policy instead).
   const RetryMethodConfig* GetRetryPolicy(
       const grpc_call_context_element* context);
+  const RetryMethodConfig::HedgingPolicy* GetHedgingPolicy(
+      const grpc_call_context_element* context);
 
   ClientChannel* client_channel_;
   size_t per_rpc_retry_buffer_size_;
+  // Calls stop caching messages for retries when this quota's memory
+  // pressure is high.
+  MemoryQuotaRefPtr memory_quota_;
   RefCountedPtr<ServerRetryThrottleData> retry_throttle_data_;
   const size_t service_config_parser_index_;
 };
@@ -253,11 +273,17 @@ class RetryFilter::CallData {
     ~CallAttempt() override;
 
     bool lb_call_committed() const { return lb_call_committed_; }
+    size_t started_send_message_count() const {
+      return started_send_message_count_;
+    }
 
     // Constructs and starts whatever batches are needed on this call
     // attempt.
     void StartRetriableBatches();
 
+    // Adds whatever batches are needed on this attempt to closures.
+    void AddRetriableBatches(CallCombinerClosureList* closures);
+
     // Frees cached send ops that have already been completed after
     // committing the call.
     void FreeCachedSendOpDataAfterCommit();
@@ -265,6 +291,10 @@ class RetryFilter::CallData {
     // Cancels the call attempt.
     void CancelFromSurface(grpc_transport_stream_op_batch* cancel_batch);
 
+    // Cancels and abandons a hedged attempt after the call has been
+    // committed to a different attempt.
+    void CancelAndAbandon(grpc_error_handle error);
+
    private:
     // State used for starting a retryable batch on the call attempt's LB call.
     // This provides its own grpc_transport_stream_op_batch and other data
@@ -423,9 +453,6 @@ class RetryFilter::CallData {
     // Adds batches for pending batches to closures.
     void AddBatchesForPendingBatches(CallCombinerClosureList* closures);
 
-    // Adds whatever batches are needed on this attempt to closures.
-    void AddRetriableBatches(CallCombinerClosureList* closures);
-
     // Returns true if any send op in the batch was not yet started on this
     // attempt.
     bool PendingBatchContainsUnstartedSendOps(PendingBatch* pending);
@@ -442,6 +469,12 @@ class RetryFilter::CallData {
     bool ShouldRetry(absl::optional<grpc_status_code> status,
                      absl::optional<Duration> server_pushback_ms);
 
+    // When hedging, returns true if this attempt should be dropped in
+    // favor of other attempts, either already in flight or yet to be
+    // started, instead of committing the call to it.
+    bool ShouldContinueHedging(grpc_status_code status,
+                               absl::optional<Duration> server_pushback);
+
     // Abandons the call attempt.  Unrefs any deferred batches.
     void Abandon();
 
@@ -450,6 +483,8 @@ class RetryFilter::CallData {
     void MaybeCancelPerAttemptRecvTimer();
 
     CallData* calld_;
+    // Value of the grpc-previous-rpc-attempts header sent on this attempt.
+    const int num_previous_attempts_;
     AttemptDispatchController attempt_dispatch_controller_;
     OrphanablePtr<ClientChannel::LoadBalancedCall> lb_call_;
     bool lb_call_committed_ = false;
@@ -558,16 +593,33 @@ class RetryFilter::CallData {
   void AddClosureToStartTransparentRetry(CallCombinerClosureList* closures);
   static void StartTransparentRetry(void* arg, grpc_error_handle error);
 
+  // Returns true if another hedged attempt may be started now.
+  bool CanStartHedgedAttempt();
+  // Starts as many hedged attempts as the hedging policy allows right
+  // now, adding their batches to closures.  If hedgingDelay is non-zero,
+  // starts only one attempt and a timer for the next one.
+  void AddHedgedAttempts(CallCombinerClosureList* closures);
+  // Starts a timer to add the next hedged attempt after delay.
+  void StartHedgingTimer(Duration delay);
+  void MaybeCancelHedgingTimer();
+  static void OnHedgingTimer(void* arg, grpc_error_handle error);
+  static void OnHedgingTimerLocked(void* arg, grpc_error_handle error);
+
   OrphanablePtr<ClientChannel::LoadBalancedCall> CreateLoadBalancedCall(
       ConfigSelector::CallDispatchController* call_dispatch_controller,
       bool is_transparent_retry);
 
   void CreateCallAttempt(bool is_transparent_retry);
+  // Creates a new call attempt and adds its batches to closures.
+  void AddCallAttempt(bool is_transparent_retry,
+                      CallCombinerClosureList* closures);
+  void RemoveCallAttempt(CallAttempt* call_attempt);
 
   RetryFilter* chand_;
   grpc_polling_entity* pollent_;
   RefCountedPtr<ServerRetryThrottleData> retry_throttle_data_;
   const RetryMethodConfig* retry_policy_ = nullptr;
+  const RetryMethodConfig::HedgingPolicy* hedging_policy_ = nullptr;
   BackOff retry_backoff_;
 
   grpc_slice path_;  // Request path.
@@ -581,10 +633,8 @@ class RetryFilter::CallData {
 
   RefCountedPtr<CallStackDestructionBarrier> call_stack_destruction_barrier_;
 
-  // TODO(roth): As part of implementing hedging, we will need to maintain a
-  // list of all pending attempts, so that we can cancel them all if the call
-  // gets cancelled.
-  RefCountedPtr<CallAttempt> call_attempt_;
+  // The call attempts in flight.  Without hedging, there is at most one.
+  absl::InlinedVector<RefCountedPtr<CallAttempt>, 1> call_attempts_;
 
   // LB call used when we've committed to a call attempt and the retry
   // state for that attempt is no longer needed.  This provides a fast
@@ -611,6 +661,19 @@ class RetryFilter::CallData {
   grpc_timer retry_timer_;
   grpc_closure retry_closure_;
 
+  // Hedging state.
+  // Set when the server tells us not to start any more hedged attempts.
+  bool hedging_stopped_ = false;
+  int num_hedged_attempts_started_ = 0;
+  // Allocated on the arena each time the timer is started, so that a
+  // callback for a timer that was cancelled can tell that it is stale.
+  struct HedgingTimer {
+    CallData* calld;
+    grpc_timer timer;
+    grpc_closure closure;
+  };
+  HedgingTimer* hedging_timer_ = nullptr;
+
   // Cached data for retrying send ops.
   // send_initial_metadata
   bool seen_send_initial_metadata_ = false;
@@ -625,15 +688,17 @@ class RetryFilter::CallData {
   // transport API to return this with the recv_initial_metadata op.)
   gpr_atm* peer_string_;
   // send_message
-  // When we get a send_message op, we replace the original byte stream
-  // with a CachingByteStream that caches the slices to a local buffer for
-  // use in retries.
+  // When we get a send_message op, we take ownership of its slices, which
+  // are refcounted, so every attempt sends the same slices without copying
+  // them.  The cached bytes are charged to the call's memory allocator until
+  // the message is freed.
   // Note: We inline the cache for the first 3 send_message ops and use
   // dynamic allocation after that.  This number was essentially picked
   // at random; it could be changed in the future to tune performance.
   struct CachedSendMessage {
     SliceBuffer* slices;
     uint32_t flags;
+    size_t charged_bytes;
   };
   absl::InlinedVector<CachedSendMessage, 3> send_messages_;
   // send_trailing_metadata
@@ -703,6 +768,9 @@ RetryFilter::CallData::CallAttempt::CallAttempt(CallData* calld,
     : RefCounted(GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace) ? "CallAttempt"
                                                            : nullptr),
       calld_(calld),
+      num_previous_attempts_(calld->hedging_policy_ != nullptr
+                                 ? calld->num_hedged_attempts_started_
+                                 : calld->num_attempts_completed_),
       attempt_dispatch_controller_(this),
       batch_payload_(calld->call_context_),
       started_send_initial_metadata_(false),
@@ -754,10 +822,9 @@ RetryFilter::CallData::CallAttempt::~CallAttempt() {
 }
 
 void RetryFilter::CallData::CallAttempt::FreeCachedSendOpDataAfterCommit() {
-  // TODO(roth): When we implement hedging, this logic will need to get
-  // a bit more complex, because there may be other (now abandoned) call
-  // attempts still using this data.  We may need to do some sort of
-  // ref-counting instead.
+  // When hedging, the attempts we abandoned may still be using this data,
+  // so we keep it until the call is destroyed.
+  if (calld_->hedging_policy_ != nullptr) return;
   if (completed_send_initial_metadata_) {
     calld_->FreeCachedSendInitialMetadata();
   }
@@ -797,12 +864,9 @@ bool RetryFilter::CallData::CallAttempt::HaveSendOpsToReplay() {
 }
 
 void RetryFilter::CallData::CallAttempt::MaybeSwitchToFastPath() {
-  // If we're not yet committed, we can't switch yet.
-  // TODO(roth): As part of implementing hedging, this logic needs to
-  // check that *this* call attempt is the one that we've committed to.
-  // Might need to replace abandoned_ with an enum indicating whether we're
-  // in flight, abandoned, or the winning call attempt.
-  if (!calld_->retry_committed_) return;
+  // If we're not yet committed, we can't switch yet.  When hedging, an
+  // abandoned attempt is one that the call was not committed to.
+  if (!calld_->retry_committed_ || abandoned_) return;
   // If we've already switched to fast path, there's nothing to do here.
   if (calld_->committed_call_ != nullptr) return;
   // If the perAttemptRecvTimeout timer is pending, we can't switch yet.
@@ -820,7 +884,7 @@ void RetryFilter::CallData::CallAttempt::MaybeSwitchToFastPath() {
             calld_->chand_, calld_, this);
   }
   calld_->committed_call_ = std::move(lb_call_);
-  calld_->call_attempt_.reset(DEBUG_LOCATION, "MaybeSwitchToFastPath");
+  calld_->call_attempts_.clear();
 }
 
 // If there are any cached send ops that need to be replayed on the
@@ -1125,6 +1189,22 @@ void RetryFilter::CallData::CallAttempt::CancelFromSurface(
   lb_call_->StartTransportStreamOpBatch(cancel_batch);
 }
 
+void RetryFilter::CallData::CallAttempt::CancelAndAbandon(
+    grpc_error_handle error) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+    gpr_log(GPR_INFO,
+            "chand=%p calld=%p attempt=%p: cancelling hedged attempt: %s",
+            calld_->chand_, calld_, this, StatusToString(error).c_str());
+  }
+  MaybeCancelPerAttemptRecvTimer();
+  CallCombinerClosureList closures;
+  MaybeAddBatchForCancelOp(error, &closures);
+  Abandon();
+  // We are being called from another attempt's callback, which still
+  // holds the call combiner.
+  closures.RunClosuresWithoutYielding(calld_->call_combiner_);
+}
+
 bool RetryFilter::CallData::CallAttempt::ShouldRetry(
     absl::optional<grpc_status_code> status,
     absl::optional<Duration> server_pushback) {
@@ -1226,6 +1306,44 @@ bool RetryFilter::CallData::CallAttempt::ShouldRetry(
   return true;
 }
 
+bool RetryFilter::CallData::CallAttempt::ShouldContinueHedging(
+    grpc_status_code status, absl::optional<Duration> server_pushback) {
+  if (status == GRPC_STATUS_OK) {
+    if (calld_->retry_throttle_data_ != nullptr) {
+      calld_->retry_throttle_data_->RecordSuccess();
+    }
+    return false;
+  }
+  // A fatal status commits the call, even if other attempts are in flight.
+  if (!calld_->hedging_policy_->non_fatal_status_codes.Contains(status)) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO,
+              "chand=%p calld=%p attempt=%p: status %s is fatal for hedging",
+              calld_->chand_, calld_, this,
+              grpc_status_code_to_string(status));
+    }
+    return false;
+  }
+  // As with retries, only failures with non-fatal status codes count
+  // towards throttling.  If we are throttled, CanStartHedgedAttempt()
+  // will refuse any further attempts.
+  if (calld_->retry_throttle_data_ != nullptr) {
+    calld_->retry_throttle_data_->RecordFailure();
+  }
+  if (calld_->retry_committed_) return false;
+  if (server_pushback.has_value() && *server_pushback < Duration::Zero()) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO,
+              "chand=%p calld=%p attempt=%p: server push-back: no more "
+              "hedged attempts",
+              calld_->chand_, calld_, this);
+    }
+    calld_->hedging_stopped_ = true;
+  }
+  // Keep going if another attempt may still succeed.
+  return calld_->call_attempts_.size() > 1 || calld_->CanStartHedgedAttempt();
+}
+
 void RetryFilter::CallData::CallAttempt::Abandon() {
   abandoned_ = true;
   // Unref batches for deferred completion callbacks that will now never
@@ -1276,9 +1394,8 @@ void RetryFilter::CallData::CallAttempt::OnPerAttemptRecvTimerLocked(
   CallCombinerClosureList closures;
   if (error.ok() && call_attempt->per_attempt_recv_timer_pending_) {
     call_attempt->per_attempt_recv_timer_pending_ = false;
-    // Cancel this attempt.
-    // TODO(roth): When implementing hedging, we should not cancel the
-    // current attempt.
+    // Cancel this attempt.  Note that perAttemptRecvTimeout is part of the
+    // retry policy, so this is never a hedged attempt.
     call_attempt->MaybeAddBatchForCancelOp(
         grpc_error_set_int(
             GRPC_ERROR_CREATE("retry perAttemptRecvTimeout exceeded"),
@@ -1289,6 +1406,7 @@ void RetryFilter::CallData::CallAttempt::OnPerAttemptRecvTimerLocked(
                                   /*server_pushback_ms=*/absl::nullopt)) {
       // Mark current attempt as abandoned.
       call_attempt->Abandon();
+      calld->RemoveCallAttempt(call_attempt);
       // We are retrying.  Start backoff timer.
       calld->StartRetryTimer(/*server_pushback=*/absl::nullopt);
     } else {
@@ -1361,10 +1479,9 @@ RetryFilter::CallData::CallAttempt::BatchData::~BatchData() {
 void RetryFilter::CallData::CallAttempt::BatchData::
     FreeCachedSendOpDataForCompletedBatch() {
   auto* calld = call_attempt_->calld_;
-  // TODO(roth): When we implement hedging, this logic will need to get
-  // a bit more complex, because there may be other (now abandoned) call
-  // attempts still using this data.  We may need to do some sort of
-  // ref-counting instead.
+  // When hedging, the attempts we abandoned may still be using this data,
+  // so we keep it until the call is destroyed.
+  if (calld->hedging_policy_ != nullptr) return;
   if (batch_.send_initial_metadata) {
     calld->FreeCachedSendInitialMetadata();
   }
@@ -1755,7 +1872,12 @@ void RetryFilter::CallData::CallAttempt::BatchData::RecvTrailingMetadataReady(
   }
   // Check if we should retry.
   if (!is_lb_drop) {  // Never retry on LB drops.
-    enum { kNoRetry, kTransparentRetry, kConfigurableRetry } retry = kNoRetry;
+    enum {
+      kNoRetry,
+      kTransparentRetry,
+      kConfigurableRetry,
+      kHedge
+    } retry = kNoRetry;
     // Handle transparent retries.
     if (stream_network_state.has_value() && !calld->retry_committed_) {
       // If not sent on wire, then always retry.
@@ -1769,10 +1891,16 @@ void RetryFilter::CallData::CallAttempt::BatchData::RecvTrailingMetadataReady(
         retry = kTransparentRetry;
       }
     }
-    // If not transparently retrying, check for configurable retry.
-    if (retry == kNoRetry &&
-        call_attempt->ShouldRetry(status, server_pushback)) {
-      retry = kConfigurableRetry;
+    // If not transparently retrying, check for configurable retry or,
+    // when hedging, whether to leave it to the other attempts.
+    if (retry == kNoRetry) {
+      if (calld->hedging_policy_ != nullptr) {
+        if (call_attempt->ShouldContinueHedging(status, server_pushback)) {
+          retry = kHedge;
+        }
+      } else if (call_attempt->ShouldRetry(status, server_pushback)) {
+        retry = kConfigurableRetry;
+      }
     }
     // If we're retrying, do so.
     if (retry != kNoRetry) {
@@ -1784,16 +1912,30 @@ void RetryFilter::CallData::CallAttempt::BatchData::RecvTrailingMetadataReady(
                            StatusIntProperty::kRpcStatus, GRPC_STATUS_CANCELLED)
                      : error,
           &closures);
-      // For transparent retries, add a closure to immediately start a new
-      // call attempt.
+      // Record that this attempt has been abandoned.
+      call_attempt->Abandon();
+      calld->RemoveCallAttempt(call_attempt);
+      // For transparent retries, immediately start a new call attempt.
+      // Without hedging, this is done from a closure, since it is the only
+      // attempt; when hedging, it joins any attempts still in flight.
       // For configurable retries, start retry timer.
+      // When hedging, start the next hedged attempt right away, or after
+      // the server's push-back delay, if the policy still allows one.
       if (retry == kTransparentRetry) {
-        calld->AddClosureToStartTransparentRetry(&closures);
-      } else {
+        if (calld->hedging_policy_ != nullptr) {
+          calld->AddCallAttempt(/*is_transparent_retry=*/true, &closures);
+        } else {
+          calld->AddClosureToStartTransparentRetry(&closures);
+        }
+      } else if (retry == kConfigurableRetry) {
         calld->StartRetryTimer(server_pushback);
+      } else if (calld->CanStartHedgedAttempt()) {
+        if (server_pushback.has_value()) {
+          calld->StartHedgingTimer(*server_pushback);
+        } else {
+          calld->AddHedgedAttempts(&closures);
+        }
       }
-      // Record that this attempt has been abandoned.
-      call_attempt->Abandon();
       // Yields call combiner.
       closures.RunClosures(calld->call_combiner_);
       return;
@@ -1975,12 +2117,13 @@ void RetryFilter::CallData::CallAttempt::BatchData::
   // the filters in the subchannel stack may modify this batch, and we don't
   // want those modifications to be passed forward to subsequent attempts.
   //
-  // If we've already completed one or more attempts, add the
-  // grpc-retry-attempts header.
+  // If we've already completed (or, when hedging, started) one or more
+  // attempts, add the grpc-retry-attempts header.
   call_attempt_->send_initial_metadata_ = calld->send_initial_metadata_.Copy();
-  if (GPR_UNLIKELY(calld->num_attempts_completed_ > 0)) {
-    call_attempt_->send_initial_metadata_.Set(GrpcPreviousRpcAttemptsMetadata(),
-                                              calld->num_attempts_completed_);
+  if (GPR_UNLIKELY(call_attempt_->num_previous_attempts_ > 0)) {
+    call_attempt_->send_initial_metadata_.Set(
+        GrpcPreviousRpcAttemptsMetadata(),
+        call_attempt_->num_previous_attempts_);
   } else {
     call_attempt_->send_initial_metadata_.Remove(
         GrpcPreviousRpcAttemptsMetadata());
@@ -2124,7 +2267,7 @@ void RetryFilter::CallData::SetPollent(grpc_call_element* elem,
 // CallData implementation
 //
 
-const RetryMethodConfig* RetryFilter::GetRetryPolicy(
+const RetryMethodConfig* RetryFilter::GetMethodConfig(
     const grpc_call_context_element* context) {
   if (context == nullptr) return nullptr;
   auto* svc_cfg_call_data = static_cast<ServiceConfigCallData*>(
@@ -2134,11 +2277,30 @@ const RetryMethodConfig* RetryFilter::GetRetryPolicy(
       svc_cfg_call_data->GetMethodParsedConfig(service_config_parser_index_));
 }
 
+const RetryMethodConfig* RetryFilter::GetRetryPolicy(
+    const grpc_call_context_element* context) {
+  const RetryMethodConfig* config = GetMethodConfig(context);
+  if (config == nullptr || config->hedging_policy().has_value()) {
+    return nullptr;
+  }
+  return config;
+}
+
+const RetryMethodConfig::HedgingPolicy* RetryFilter::GetHedgingPolicy(
+    const grpc_call_context_element* context) {
+  const RetryMethodConfig* config = GetMethodConfig(context);
+  if (config == nullptr || !config->hedging_policy().has_value()) {
+    return nullptr;
+  }
+  return &*config->hedging_policy();
+}
+
 RetryFilter::CallData::CallData(RetryFilter* chand,
                                 const grpc_call_element_args& args)
     : chand_(chand),
       retry_throttle_data_(chand->retry_throttle_data_),
       retry_policy_(chand->GetRetryPolicy(args.context)),
+      hedging_policy_(chand->GetHedgingPolicy(args.context)),
       retry_backoff_(
           BackOff::Options()
               .set_initial_backoff(retry_policy_ == nullptr
@@ -2209,17 +2371,14 @@ void RetryFilter::CallData::StartTransportStreamOpBatch(
     PendingBatchesFail(cancelled_from_surface_);
     // If we have a current call attempt, commit the call, then send
     // the cancellation down to that attempt.  When the call fails, it
-    // will not be retried, because we have committed it here.
-    if (call_attempt_ != nullptr) {
-      RetryCommit(call_attempt_.get());
-      // TODO(roth): When implementing hedging, this will get more
-      // complex, because instead of just passing the batch down to a
-      // single call attempt, we'll need to cancel multiple call
-      // attempts and wait for the cancellation on_complete from each call
-      // attempt before we propagate the on_complete from this batch
-      // back to the surface.
+    // will not be retried, because we have committed it here.  When
+    // hedging, committing to the first attempt cancels all of the others,
+    // so the surface's cancellation only needs to go down to that one.
+    if (!call_attempts_.empty()) {
+      CallAttempt* call_attempt = call_attempts_.front().get();
+      RetryCommit(call_attempt);
       // Note: This will release the call combiner.
-      call_attempt_->CancelFromSurface(batch);
+      call_attempt->CancelFromSurface(batch);
       return;
     }
     // Cancel retry timer if needed.
@@ -2232,6 +2391,7 @@ void RetryFilter::CallData::StartTransportStreamOpBatch(
       grpc_timer_cancel(&retry_timer_);
       FreeAllCachedSendOpData();
     }
+    MaybeCancelHedgingTimer();
     // We have no call attempt, so there's nowhere to send the cancellation
     // batch.  Return it back to the surface immediately.
     // Note: This will release the call combiner.
@@ -2243,13 +2403,15 @@ void RetryFilter::CallData::StartTransportStreamOpBatch(
   PendingBatch* pending = PendingBatchesAdd(batch);
   // If the timer is pending, yield the call combiner and wait for it to
   // run, since we don't want to start another call attempt until it does.
-  if (retry_timer_pending_) {
+  // The same goes for the hedging timer if every attempt so far has failed.
+  if (retry_timer_pending_ ||
+      (hedging_timer_ != nullptr && call_attempts_.empty())) {
     GRPC_CALL_COMBINER_STOP(call_combiner_,
                             "added pending batch while retry timer pending");
     return;
   }
   // If we do not yet have a call attempt, create one.
-  if (call_attempt_ == nullptr) {
+  if (call_attempts_.empty()) {
     // If this is the first batch and retries are already committed
     // (e.g., if this batch put the call above the buffer size limit), then
     // immediately create an LB call and delegate the batch to it.  This
@@ -2295,12 +2457,27 @@ void RetryFilter::CallData::StartTransportStreamOpBatch(
     CreateCallAttempt(/*is_transparent_retry=*/false);
     return;
   }
-  // Send batches to call attempt.
+  // Send batches to call attempts.
+  if (call_attempts_.size() == 1) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p: starting batch on attempt=%p",
+              chand_, this, call_attempts_.front().get());
+    }
+    call_attempts_.front()->StartRetriableBatches();
+    return;
+  }
   if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
-    gpr_log(GPR_INFO, "chand=%p calld=%p: starting batch on attempt=%p", chand_,
-            this, call_attempt_.get());
+    gpr_log(GPR_INFO,
+            "chand=%p calld=%p: starting batch on %" PRIuPTR
+            " hedged attempts",
+            chand_, this, call_attempts_.size());
+  }
+  CallCombinerClosureList closures;
+  for (auto& call_attempt : call_attempts_) {
+    call_attempt->AddRetriableBatches(&closures);
   }
-  call_attempt_->StartRetriableBatches();
+  // Note: This will yield the call combiner.
+  closures.RunClosures(call_combiner_);
 }
 
 OrphanablePtr<ClientChannel::LoadBalancedCall>
@@ -2319,8 +2496,35 @@ RetryFilter::CallData::CreateLoadBalancedCall(
 }
 
 void RetryFilter::CallData::CreateCallAttempt(bool is_transparent_retry) {
-  call_attempt_ = MakeRefCounted<CallAttempt>(this, is_transparent_retry);
-  call_attempt_->StartRetriableBatches();
+  // When hedging, this starts the first attempt and possibly more.
+  // Transparent retries of hedged attempts go through AddCallAttempt().
+  if (hedging_policy_ != nullptr) {
+    GPR_DEBUG_ASSERT(!is_transparent_retry);
+    CallCombinerClosureList closures;
+    AddHedgedAttempts(&closures);
+    // Note: This will yield the call combiner.
+    closures.RunClosures(call_combiner_);
+    return;
+  }
+  call_attempts_.push_back(
+      MakeRefCounted<CallAttempt>(this, is_transparent_retry));
+  call_attempts_.back()->StartRetriableBatches();
+}
+
+void RetryFilter::CallData::AddCallAttempt(bool is_transparent_retry,
+                                           CallCombinerClosureList* closures) {
+  call_attempts_.push_back(
+      MakeRefCounted<CallAttempt>(this, is_transparent_retry));
+  call_attempts_.back()->AddRetriableBatches(closures);
+}
+
+void RetryFilter::CallData::RemoveCallAttempt(CallAttempt* call_attempt) {
+  for (auto it = call_attempts_.begin(); it != call_attempts_.end(); ++it) {
+    if (it->get() == call_attempt) {
+      call_attempts_.erase(it);
+      return;
+    }
+  }
 }
 
 //
@@ -2343,7 +2547,13 @@ void RetryFilter::CallData::MaybeCacheSendOpsForBatch(PendingBatch* pending) {
   if (batch->send_message) {
     SliceBuffer* cache = arena_->New<SliceBuffer>(std::move(
         *std::exchange(batch->payload->send_message.send_message, nullptr)));
-    send_messages_.push_back({cache, batch->payload->send_message.flags});
+    size_t charged_bytes = 0;
+    if (cache->Length() > 0) {
+      charged_bytes = arena_->memory_allocator()->Reserve(std::min(
+          cache->Length(), MemoryRequest::max_allowed_size()));
+    }
+    send_messages_.push_back(
+        {cache, batch->payload->send_message.flags, charged_bytes});
   }
   // Save metadata batch for send_trailing_metadata ops.
   if (batch->send_trailing_metadata) {
@@ -2370,6 +2580,7 @@ void RetryFilter::CallData::FreeCachedSendMessage(size_t idx) {
               chand_, this, idx);
     }
     Destruct(std::exchange(send_messages_[idx].slices, nullptr));
+    arena_->memory_allocator()->Release(send_messages_[idx].charged_bytes);
   }
 }
 
@@ -2438,17 +2649,29 @@ RetryFilter::CallData::PendingBatch* RetryFilter::CallData::PendingBatchesAdd(
   if (batch->send_trailing_metadata) {
     pending_send_trailing_metadata_ = true;
   }
-  // TODO(roth): When we implement hedging, if there are currently attempts
-  // in flight, we will need to pick the one on which the max number of send
-  // ops have already been sent, and we commit to that attempt.
+  // Also commit when buffering another message would add to memory
+  // pressure that is already high.
   if (GPR_UNLIKELY(bytes_buffered_for_retry_ >
-                   chand_->per_rpc_retry_buffer_size_)) {
+                       chand_->per_rpc_retry_buffer_size_ ||
+                   (batch->send_message &&
+                    chand_->memory_quota_->IsMemoryPressureHigh()))) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
       gpr_log(GPR_INFO,
-              "chand=%p calld=%p: exceeded retry buffer size, committing",
+              "chand=%p calld=%p: exceeded retry buffer size or memory "
+              "quota, committing",
               chand_, this);
     }
-    RetryCommit(call_attempt_.get());
+    // If there are hedged attempts in flight, commit to the one that has
+    // sent the most messages.
+    CallAttempt* call_attempt = nullptr;
+    for (auto& attempt : call_attempts_) {
+      if (call_attempt == nullptr ||
+          attempt->started_send_message_count() >
+              call_attempt->started_send_message_count()) {
+        call_attempt = attempt.get();
+      }
+    }
+    RetryCommit(call_attempt);
   }
   return pending;
 }
@@ -2570,13 +2793,30 @@ void RetryFilter::CallData::RetryCommit(CallAttempt* call_attempt) {
     }
     // Free cached send ops.
     call_attempt->FreeCachedSendOpDataAfterCommit();
+    // When hedging, cancel all of the other attempts.
+    if (hedging_policy_ != nullptr) {
+      MaybeCancelHedgingTimer();
+      const grpc_error_handle error = grpc_error_set_int(
+          GRPC_ERROR_CREATE("call committed to another hedged attempt"),
+          StatusIntProperty::kRpcStatus, GRPC_STATUS_CANCELLED);
+      RefCountedPtr<CallAttempt> committed_attempt;
+      for (auto& attempt : call_attempts_) {
+        if (attempt.get() == call_attempt) {
+          committed_attempt = std::move(attempt);
+        } else {
+          attempt->CancelAndAbandon(error);
+        }
+      }
+      call_attempts_.clear();
+      if (committed_attempt != nullptr) {
+        call_attempts_.push_back(std::move(committed_attempt));
+      }
+    }
   }
 }
 
 void RetryFilter::CallData::StartRetryTimer(
     absl::optional<Duration> server_pushback) {
-  // Reset call attempt.
-  call_attempt_.reset(DEBUG_LOCATION, "StartRetryTimer");
   // Compute backoff delay.
   Timestamp next_attempt_time;
   if (server_pushback.has_value()) {
@@ -2640,6 +2880,102 @@ void RetryFilter::CallData::StartTransparentRetry(void* arg,
   GRPC_CALL_STACK_UNREF(calld->owning_call_, "OnRetryTimer");
 }
 
+bool RetryFilter::CallData::CanStartHedgedAttempt() {
+  if (retry_committed_ || hedging_stopped_ || !cancelled_from_surface_.ok() ||
+      num_hedged_attempts_started_ >= hedging_policy_->max_attempts) {
+    return false;
+  }
+  if (num_hedged_attempts_started_ == 0) return true;
+  // Like retries, hedged attempts after the first are subject to
+  // throttling and to the call dispatch controller.
+  if (retry_throttle_data_ != nullptr && retry_throttle_data_->IsThrottled()) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p: hedged attempts throttled", chand_,
+              this);
+    }
+    return false;
+  }
+  auto* service_config_call_data =
+      static_cast<ClientChannelServiceConfigCallData*>(
+          call_context_[GRPC_CONTEXT_SERVICE_CONFIG_CALL_DATA].value);
+  return service_config_call_data->call_dispatch_controller()->ShouldRetry();
+}
+
+void RetryFilter::CallData::AddHedgedAttempts(
+    CallCombinerClosureList* closures) {
+  MaybeCancelHedgingTimer();
+  // If every attempt so far has failed, we dropped the last failure
+  // expecting another attempt, so start one even if the policy no longer
+  // allows it (e.g., because we got throttled or committed meanwhile).
+  bool must_start = call_attempts_.empty() && cancelled_from_surface_.ok();
+  while (must_start || CanStartHedgedAttempt()) {
+    must_start = false;
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p: starting hedged attempt %d",
+              chand_, this, num_hedged_attempts_started_ + 1);
+    }
+    AddCallAttempt(/*is_transparent_retry=*/false, closures);
+    ++num_hedged_attempts_started_;
+    if (hedging_policy_->hedging_delay > Duration::Zero()) {
+      if (CanStartHedgedAttempt()) {
+        StartHedgingTimer(hedging_policy_->hedging_delay);
+      }
+      break;
+    }
+  }
+}
+
+void RetryFilter::CallData::StartHedgingTimer(Duration delay) {
+  MaybeCancelHedgingTimer();
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+    gpr_log(GPR_INFO,
+            "chand=%p calld=%p: next hedged attempt in %" PRId64 " ms", chand_,
+            this, delay.millis());
+  }
+  hedging_timer_ = arena_->New<HedgingTimer>();
+  hedging_timer_->calld = this;
+  GRPC_CLOSURE_INIT(&hedging_timer_->closure, OnHedgingTimer, hedging_timer_,
+                    nullptr);
+  GRPC_CALL_STACK_REF(owning_call_, "OnHedgingTimer");
+  grpc_timer_init(&hedging_timer_->timer, Timestamp::Now() + delay,
+                  &hedging_timer_->closure);
+}
+
+void RetryFilter::CallData::MaybeCancelHedgingTimer() {
+  if (hedging_timer_ != nullptr) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p: cancelling hedging timer", chand_,
+              this);
+    }
+    grpc_timer_cancel(&std::exchange(hedging_timer_, nullptr)->timer);
+  }
+}
+
+void RetryFilter::CallData::OnHedgingTimer(void* arg, grpc_error_handle error) {
+  auto* hedging_timer = static_cast<HedgingTimer*>(arg);
+  GRPC_CLOSURE_INIT(&hedging_timer->closure, OnHedgingTimerLocked,
+                    hedging_timer, nullptr);
+  GRPC_CALL_COMBINER_START(hedging_timer->calld->call_combiner_,
+                           &hedging_timer->closure, error,
+                           "hedging timer fired");
+}
+
+void RetryFilter::CallData::OnHedgingTimerLocked(void* arg,
+                                                 grpc_error_handle error) {
+  auto* hedging_timer = static_cast<HedgingTimer*>(arg);
+  auto* calld = hedging_timer->calld;
+  // A cancelled or replaced timer is no longer calld->hedging_timer_.
+  if (error.ok() && calld->hedging_timer_ == hedging_timer) {
+    calld->hedging_timer_ = nullptr;
+    CallCombinerClosureList closures;
+    calld->AddHedgedAttempts(&closures);
+    closures.RunClosures(calld->call_combiner_);
+  } else {
+    GRPC_CALL_COMBINER_STOP(calld->call_combiner_, "hedging timer cancelled");
+  }
+  GRPC_CALL_STACK_UNREF(calld->owning_call_, "OnHedgingTimer");
+}
+
 }  // namespace
 
 const grpc_channel_filter kRetryFilterVtable = {
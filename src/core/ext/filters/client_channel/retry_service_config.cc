@@ -25,6 +25,7 @@
 
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 #include <grpc/grpc.h>
@@ -42,6 +43,31 @@
 namespace grpc_core {
 namespace internal {
 
+namespace {
+
+// Adds the status codes listed in the named field of json to status_codes.
+void ParseStatusCodes(const Json& json, const JsonArgs& args,
+                      absl::string_view field_name, ValidationErrors* errors,
+                      StatusCodeSet* status_codes) {
+  auto status_code_list = LoadJsonObjectField<std::vector<std::string>>(
+      json.object_value(), args, field_name, errors,
+      /*required=*/false);
+  if (!status_code_list.has_value()) return;
+  for (size_t i = 0; i < status_code_list->size(); ++i) {
+    ValidationErrors::ScopedField field(
+        errors, absl::StrCat(".", field_name, "[", i, "]"));
+    grpc_status_code status;
+    if (!grpc_status_code_from_string((*status_code_list)[i].c_str(),
+                                      &status)) {
+      errors->AddError("failed to parse status code");
+    } else {
+      status_codes->Add(status);
+    }
+  }
+}
+
+}  // namespace
+
 //
 // RetryGlobalConfig
 //
@@ -170,22 +196,8 @@ void RetryMethodConfig::JsonPostLoad(const Json& json, const JsonArgs& args,
     }
   }
   // Parse retryableStatusCodes.
-  auto status_code_list = LoadJsonObjectField<std::vector<std::string>>(
-      json.object_value(), args, "retryableStatusCodes", errors,
-      /*required=*/false);
-  if (status_code_list.has_value()) {
-    for (size_t i = 0; i < status_code_list->size(); ++i) {
-      ValidationErrors::ScopedField field(
-          errors, absl::StrCat(".retryableStatusCodes[", i, "]"));
-      grpc_status_code status;
-      if (!grpc_status_code_from_string((*status_code_list)[i].c_str(),
-                                        &status)) {
-        errors->AddError("failed to parse status code");
-      } else {
-        retryable_status_codes_.Add(status);
-      }
-    }
-  }
+  ParseStatusCodes(json, args, "retryableStatusCodes", errors,
+                   &retryable_status_codes_);
   // Validate perAttemptRecvTimeout.
   if (args.IsEnabled(GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING)) {
     if (per_attempt_recv_timeout_.has_value()) {
@@ -215,6 +227,44 @@ void RetryMethodConfig::JsonPostLoad(const Json& json, const JsonArgs& args,
   }
 }
 
+//
+// RetryMethodConfig::HedgingPolicy
+//
+
+const JsonLoaderInterface* RetryMethodConfig::HedgingPolicy::JsonLoader(
+    const JsonArgs&) {
+  static const auto* loader =
+      JsonObjectLoader<HedgingPolicy>()
+          // Note: The "nonFatalStatusCodes" field requires custom parsing,
+          // so it's handled in JsonPostLoad() instead.
+          .Field("maxAttempts", &HedgingPolicy::max_attempts)
+          .OptionalField("hedgingDelay", &HedgingPolicy::hedging_delay)
+          .Finish();
+  return loader;
+}
+
+void RetryMethodConfig::HedgingPolicy::JsonPostLoad(const Json& json,
+                                                    const JsonArgs& args,
+                                                    ValidationErrors* errors) {
+  // Validate maxAttempts.
+  {
+    ValidationErrors::ScopedField field(errors, ".maxAttempts");
+    if (!errors->FieldHasErrors()) {
+      if (max_attempts <= 1) {
+        errors->AddError("must be at least 2");
+      } else if (max_attempts > MAX_MAX_RETRY_ATTEMPTS) {
+        gpr_log(GPR_ERROR,
+                "service config: clamped hedgingPolicy.maxAttempts at %d",
+                MAX_MAX_RETRY_ATTEMPTS);
+        max_attempts = MAX_MAX_RETRY_ATTEMPTS;
+      }
+    }
+  }
+  // Parse nonFatalStatusCodes.
+  ParseStatusCodes(json, args, "nonFatalStatusCodes", errors,
+                   &non_fatal_status_codes);
+}
+
 //
 // RetryServiceConfigParser
 //
@@ -257,14 +307,25 @@ namespace {
 
 struct MethodConfig {
   std::unique_ptr<RetryMethodConfig> retry_policy;
+  absl::optional<RetryMethodConfig::HedgingPolicy> hedging_policy;
 
   static const JsonLoaderInterface* JsonLoader(const JsonArgs&) {
     static const auto* loader =
         JsonObjectLoader<MethodConfig>()
             .OptionalField("retryPolicy", &MethodConfig::retry_policy)
+            .OptionalField("hedgingPolicy", &MethodConfig::hedging_policy,
+                           GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING)
             .Finish();
     return loader;
   }
+
+  void JsonPostLoad(const Json& /*json*/, const JsonArgs& /*args*/,
+                    ValidationErrors* errors) {
+    if (retry_policy != nullptr && hedging_policy.has_value()) {
+      ValidationErrors::ScopedField field(errors, ".hedgingPolicy");
+      errors->AddError("may not be set together with retryPolicy");
+    }
+  }
 };
 
 }  // namespace
@@ -275,6 +336,10 @@ RetryServiceConfigParser::ParsePerMethodParams(const ChannelArgs& args,
                                                ValidationErrors* errors) {
   auto method_params =
       LoadFromJson<MethodConfig>(json, JsonChannelArgs(args), errors);
+  if (method_params.hedging_policy.has_value()) {
+    return std::make_unique<RetryMethodConfig>(
+        std::move(*method_params.hedging_policy));
+  }
   return std::move(method_params.retry_policy);
 }
 
@@ -23,6 +23,7 @@
 #include <stdint.h>
 
 #include <memory>
+#include <utility>
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -56,6 +57,22 @@ class RetryGlobalConfig : public ServiceConfigParser::ParsedConfig {
 
 class RetryMethodConfig : public ServiceConfigParser::ParsedConfig {
  public:
+  // A hedgingPolicy from the method config.  A method has either a
+  // retryPolicy or a hedgingPolicy, never both.
+  struct HedgingPolicy {
+    int max_attempts = 0;
+    Duration hedging_delay;
+    StatusCodeSet non_fatal_status_codes;
+
+    static const JsonLoaderInterface* JsonLoader(const JsonArgs&);
+    void JsonPostLoad(const Json& json, const JsonArgs& args,
+                      ValidationErrors* errors);
+  };
+
+  RetryMethodConfig() = default;
+  explicit RetryMethodConfig(HedgingPolicy hedging_policy)
+      : hedging_policy_(std::move(hedging_policy)) {}
+
   int max_attempts() const { return max_attempts_; }
   Duration initial_backoff() const { return initial_backoff_; }
   Duration max_backoff() const { return max_backoff_; }
@@ -66,6 +83,11 @@ class RetryMethodConfig : public ServiceConfigParser::ParsedConfig {
   absl::optional<Duration> per_attempt_recv_timeout() const {
     return per_attempt_recv_timeout_;
   }
+  // Set if the method uses hedging, in which case none of the retry
+  // fields above are set.
+  const absl::optional<HedgingPolicy>& hedging_policy() const {
+    return hedging_policy_;
+  }
 
   static const JsonLoaderInterface* JsonLoader(const JsonArgs&);
   void JsonPostLoad(const Json& json, const JsonArgs& args,
@@ -78,6 +100,7 @@ class RetryMethodConfig : public ServiceConfigParser::ParsedConfig {
   float backoff_multiplier_ = 0;
   StatusCodeSet retryable_status_codes_;
   absl::optional<Duration> per_attempt_recv_timeout_;
+  absl::optional<HedgingPolicy> hedging_policy_;
 };
 
 class RetryServiceConfigParser : public ServiceConfigParser::Parser {
@@ -22,6 +22,8 @@
 #include <limits.h>
 
 #include <algorithm>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <new>
 #include <utility>
@@ -57,6 +59,7 @@
 #include "src/core/lib/gprpp/status_helper.h"
 #include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/handshaker/proxy_mapper_registry.h"
+#include "src/core/lib/iomgr/closure.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/pollset_set.h"
 #include "src/core/lib/slice/slice_internal.h"
@@ -73,6 +76,10 @@
 #define GRPC_SUBCHANNEL_RECONNECT_MAX_BACKOFF_SECONDS 120
 #define GRPC_SUBCHANNEL_RECONNECT_JITTER 0.2
 
+// Connection set parameters.
+#define GRPC_SUBCHANNEL_DEFAULT_MAX_CONNECTIONS 1
+#define GRPC_SUBCHANNEL_DEFAULT_STREAMS_PER_CONNECTION 100
+
 // Conversion between subchannel call and call stack.
 #define SUBCHANNEL_CALL_TO_CALL_STACK(call) \
   (grpc_call_stack*)((char*)(call) +        \
@@ -94,14 +101,17 @@ DebugOnlyTraceFlag grpc_trace_subchannel_refcount(false, "subchannel_refcount");
 
 ConnectedSubchannel::ConnectedSubchannel(
     grpc_channel_stack* channel_stack, const ChannelArgs& args,
-    RefCountedPtr<channelz::SubchannelNode> channelz_subchannel)
+    RefCountedPtr<channelz::SubchannelNode> channelz_subchannel,
+    WeakRefCountedPtr<Subchannel> subchannel, size_t streams_per_connection)
     : RefCounted<ConnectedSubchannel>(
           GRPC_TRACE_FLAG_ENABLED(grpc_trace_subchannel_refcount)
               ? "ConnectedSubchannel"
               : nullptr),
       channel_stack_(channel_stack),
       args_(args),
-      channelz_subchannel_(std::move(channelz_subchannel)) {}
+      channelz_subchannel_(std::move(channelz_subchannel)),
+      subchannel_(std::move(subchannel)),
+      streams_per_connection_(streams_per_connection) {}
 
 ConnectedSubchannel::~ConnectedSubchannel() {
   GRPC_CHANNEL_STACK_UNREF(channel_stack_, "connected_subchannel_dtor");
@@ -133,6 +143,20 @@ size_t ConnectedSubchannel::GetInitialCallSizeEstimate() const {
          channel_stack_->call_stack_size;
 }
 
+void ConnectedSubchannel::OnCallStarted() {
+  const size_t calls = active_calls_.fetch_add(1, std::memory_order_relaxed);
+  if (subchannel_ != nullptr && calls + 1 >= streams_per_connection_) {
+    subchannel_->OnConnectionLoadChanged();
+  }
+}
+
+void ConnectedSubchannel::OnCallFinished() {
+  const size_t calls = active_calls_.fetch_sub(1, std::memory_order_relaxed);
+  if (subchannel_ != nullptr && calls == 1) {
+    subchannel_->OnConnectionLoadChanged();
+  }
+}
+
 //
 // SubchannelCall
 //
@@ -149,6 +173,7 @@ RefCountedPtr<SubchannelCall> SubchannelCall::Create(Args args,
 SubchannelCall::SubchannelCall(Args args, grpc_error_handle* error)
     : connected_subchannel_(std::move(args.connected_subchannel)),
       deadline_(args.deadline) {
+  connected_subchannel_->OnCallStarted();
   grpc_call_stack* callstk = SUBCHANNEL_CALL_TO_CALL_STACK(this);
   const grpc_call_element_args call_args = {
       callstk,              // call_stack
@@ -218,6 +243,7 @@ void SubchannelCall::Destroy(void* arg, grpc_error_handle /*error*/) {
   grpc_closure* after_call_stack_destroy = self->after_call_stack_destroy_;
   RefCountedPtr<ConnectedSubchannel> connected_subchannel =
       std::move(self->connected_subchannel_);
+  connected_subchannel->OnCallFinished();
   // Destroy the subchannel call.
   self->~SubchannelCall();
   // Destroy the call stack. This should be after destroying the subchannel
@@ -300,8 +326,9 @@ class Subchannel::ConnectedSubchannelStateWatcher
     : public AsyncConnectivityStateWatcherInterface {
  public:
   // Must be instantiated while holding c->mu.
-  explicit ConnectedSubchannelStateWatcher(WeakRefCountedPtr<Subchannel> c)
-      : subchannel_(std::move(c)) {}
+  ConnectedSubchannelStateWatcher(WeakRefCountedPtr<Subchannel> c,
+                                  uint64_t connection_id)
+      : subchannel_(std::move(c)), connection_id_(connection_id) {}
 
   ~ConnectedSubchannelStateWatcher() override {
     subchannel_.reset(DEBUG_LOCATION, "state_watcher");
@@ -314,32 +341,41 @@ class Subchannel::ConnectedSubchannelStateWatcher
     {
       MutexLock lock(&c->mu_);
       // If we're either shutting down or have already seen this connection
-      // failure (i.e., c->connected_subchannel_ is null), do nothing.
+      // failure or drained the connection (i.e., it is no longer in
+      // c->connected_subchannels_), do nothing.
       //
       // The transport reports TRANSIENT_FAILURE upon GOAWAY but SHUTDOWN
       // upon connection close.  So if the server gracefully shuts down,
       // we will see TRANSIENT_FAILURE followed by SHUTDOWN, but if not, we
       // will see only SHUTDOWN.  Either way, we react to the first one we
       // see, ignoring anything that happens after that.
-      if (c->connected_subchannel_ == nullptr) return;
+      auto it = c->connected_subchannels_.find(connection_id_);
+      if (it == c->connected_subchannels_.end()) return;
       if (new_state == GRPC_CHANNEL_TRANSIENT_FAILURE ||
           new_state == GRPC_CHANNEL_SHUTDOWN) {
         if (GRPC_TRACE_FLAG_ENABLED(grpc_trace_subchannel)) {
           gpr_log(GPR_INFO,
                   "subchannel %p %s: Connected subchannel %p reports %s: %s", c,
-                  c->key_.ToString().c_str(), c->connected_subchannel_.get(),
+                  c->key_.ToString().c_str(),
+                  it->second.connected_subchannel.get(),
                   ConnectivityStateName(new_state), status.ToString().c_str());
         }
-        c->connected_subchannel_.reset();
-        if (c->channelz_node() != nullptr) {
-          c->channelz_node()->SetChildSocket(nullptr);
+        const bool was_primary = it == c->connected_subchannels_.begin();
+        c->connected_subchannels_.erase(it);
+        // The subchannel stays READY as long as any connection is left.
+        if (!c->connected_subchannels_.empty()) {
+          if (was_primary) c->OnPrimaryConnectionChangedLocked();
+        } else {
+          if (c->channelz_node() != nullptr) {
+            c->channelz_node()->SetChildSocket(nullptr);
+          }
+          // Even though we're reporting IDLE instead of TRANSIENT_FAILURE
+          // here, pass along the status from the transport, since it may have
+          // keepalive info attached to it that the channel needs.
+          // TODO(roth): Consider whether there's a cleaner way to do this.
+          c->SetConnectivityStateLocked(GRPC_CHANNEL_IDLE, status);
+          c->backoff_.Reset();
         }
-        // Even though we're reporting IDLE instead of TRANSIENT_FAILURE here,
-        // pass along the status from the transport, since it may have
-        // keepalive info attached to it that the channel needs.
-        // TODO(roth): Consider whether there's a cleaner way to do this.
-        c->SetConnectivityStateLocked(GRPC_CHANNEL_IDLE, status);
-        c->backoff_.Reset();
       }
     }
     // Drain any connectivity state notifications after releasing the mutex.
@@ -347,6 +383,7 @@ class Subchannel::ConnectedSubchannelStateWatcher
   }
 
   WeakRefCountedPtr<Subchannel> subchannel_;
+  const uint64_t connection_id_;
 };
 
 //
@@ -445,6 +482,13 @@ class Subchannel::HealthWatcherMap::HealthWatcher
     }
   }
 
+  void RestartHealthCheckingLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(subchannel_->mu_) {
+    if (health_check_client_ == nullptr) return;
+    health_check_client_.reset();
+    StartHealthCheckingLocked();
+  }
+
   void Orphan() override {
     watcher_list_.Clear();
     health_check_client_.reset();
@@ -470,8 +514,11 @@ class Subchannel::HealthWatcherMap::HealthWatcher
   void StartHealthCheckingLocked()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(subchannel_->mu_) {
     GPR_ASSERT(health_check_client_ == nullptr);
+    // Health checks run on the primary connection.
     health_check_client_ = MakeHealthCheckClient(
-        health_check_service_name_, subchannel_->connected_subchannel_,
+        health_check_service_name_,
+        subchannel_->connected_subchannels_.begin()
+            ->second.connected_subchannel,
         subchannel_->pollset_set_, subchannel_->channelz_node_, Ref());
   }
 
@@ -542,6 +589,12 @@ Subchannel::HealthWatcherMap::CheckConnectivityStateLocked(
   return health_watcher->state();
 }
 
+void Subchannel::HealthWatcherMap::RestartHealthCheckingLocked() {
+  for (const auto& p : map_) {
+    p.second->RestartHealthCheckingLocked();
+  }
+}
+
 void Subchannel::HealthWatcherMap::ShutdownLocked() { map_.clear(); }
 
 //
@@ -597,9 +650,17 @@ Subchannel::Subchannel(SubchannelKey key,
       key_(std::move(key)),
       args_(args),
       pollset_set_(grpc_pollset_set_create()),
+      max_connections_(std::max(
+          1, args_.GetInt(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS)
+                 .value_or(GRPC_SUBCHANNEL_DEFAULT_MAX_CONNECTIONS))),
+      streams_per_connection_(std::max(
+          1, args_.GetInt(GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION)
+                 .value_or(GRPC_SUBCHANNEL_DEFAULT_STREAMS_PER_CONNECTION))),
       connector_(std::move(connector)),
       watcher_list_(this),
       backoff_(ParseArgsForBackoffValues(args_, &min_connect_timeout_)),
+      additional_backoff_(
+          ParseArgsForBackoffValues(args_, &min_connect_timeout_)),
       event_engine_(args_.GetObjectRef<EventEngine>()) {
   // A grpc_init is added here to ensure that grpc_shutdown does not happen
   // until the subchannel is destroyed. Subchannels can persist longer than
@@ -735,6 +796,19 @@ void Subchannel::CancelConnectivityStateWatch(
   work_serializer_.DrainQueue();
 }
 
+RefCountedPtr<ConnectedSubchannel> Subchannel::connected_subchannel() {
+  MutexLock lock(&mu_);
+  if (connected_subchannels_.empty()) return nullptr;
+  auto best = connected_subchannels_.begin();
+  for (auto it = std::next(best); it != connected_subchannels_.end(); ++it) {
+    if (it->second.connected_subchannel->active_calls() <
+        best->second.connected_subchannel->active_calls()) {
+      best = it;
+    }
+  }
+  return best->second.connected_subchannel;
+}
+
 void Subchannel::RequestConnection() {
   {
     MutexLock lock(&mu_);
@@ -754,6 +828,8 @@ void Subchannel::ResetBackoff() {
   {
     MutexLock lock(&mu_);
     backoff_.Reset();
+    additional_backoff_.Reset();
+    next_additional_attempt_time_ = Timestamp::InfPast();
     if (state_ == GRPC_CHANNEL_TRANSIENT_FAILURE &&
         event_engine_->Cancel(retry_timer_handle_)) {
       OnRetryTimerLocked();
@@ -777,7 +853,7 @@ void Subchannel::Orphan() {
     GPR_ASSERT(!shutdown_);
     shutdown_ = true;
     connector_.reset();
-    connected_subchannel_.reset();
+    connected_subchannels_.clear();
     health_watcher_map_.ShutdownLocked();
   }
   // Drain any connectivity state notifications after releasing the mutex.
@@ -856,6 +932,12 @@ void Subchannel::StartConnectingLocked() {
   next_attempt_time_ = backoff_.NextAttemptTime();
   // Report CONNECTING.
   SetConnectivityStateLocked(GRPC_CHANNEL_CONNECTING, absl::OkStatus());
+  // If an attempt to add a connection is still in flight from when we
+  // were READY, the connector is busy; adopt that attempt instead.
+  if (connecting_additional_) {
+    connecting_additional_ = false;
+    return;
+  }
   // Start connection attempt.
   SubchannelConnector::Args args;
   args.address = &address_for_connect_;
@@ -866,6 +948,103 @@ void Subchannel::StartConnectingLocked() {
   connector_->Connect(args, &connecting_result_, &on_connecting_finished_);
 }
 
+void Subchannel::MaybeStartAdditionalConnectionLocked() {
+  // The connector handles one attempt at a time, so wait for any attempt
+  // in flight to finish.
+  if (shutdown_ || state_ != GRPC_CHANNEL_READY || connecting_additional_ ||
+      connected_subchannels_.size() >= max_connections_ ||
+      Timestamp::Now() < next_additional_attempt_time_) {
+    return;
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_trace_subchannel)) {
+    gpr_log(GPR_INFO,
+            "subchannel %p %s: all %" PRIuPTR
+            " connections saturated, starting another",
+            this, key_.ToString().c_str(), connected_subchannels_.size());
+  }
+  connecting_additional_ = true;
+  const Timestamp now = Timestamp::Now();
+  next_additional_attempt_time_ = additional_backoff_.NextAttemptTime();
+  SubchannelConnector::Args args;
+  args.address = &address_for_connect_;
+  args.interested_parties = pollset_set_;
+  args.deadline = std::max(next_additional_attempt_time_,
+                           min_connect_timeout_ + now);
+  args.channel_args = args_;
+  WeakRef(DEBUG_LOCATION, "Connect").release();  // Ref held by callback.
+  connector_->Connect(args, &connecting_result_, &on_connecting_finished_);
+}
+
+void Subchannel::OnConnectionLoadChanged() {
+  if (resize_pending_.exchange(true, std::memory_order_acq_rel)) return;
+  ExecCtx::Run(
+      DEBUG_LOCATION,
+      NewClosure([self = WeakRef(DEBUG_LOCATION, "ResizeConnections")](
+                     grpc_error_handle /*error*/) {
+        self->ResizeConnections();
+      }),
+      absl::OkStatus());
+}
+
+void Subchannel::ResizeConnections() {
+  MutexLock lock(&mu_);
+  resize_pending_.store(false, std::memory_order_release);
+  if (shutdown_ || connected_subchannels_.empty()) return;
+  size_t min_calls = std::numeric_limits<size_t>::max();
+  size_t total_calls = 0;
+  for (const auto& p : connected_subchannels_) {
+    const size_t calls = p.second.connected_subchannel->active_calls();
+    min_calls = std::min(min_calls, calls);
+    total_calls += calls;
+  }
+  const size_t num_connections = connected_subchannels_.size();
+  if (min_calls >= streams_per_connection_) {
+    MaybeStartAdditionalConnectionLocked();
+    return;
+  }
+  // Only shrink once the other connections would be at most half loaded,
+  // so that load hovering around a connection boundary does not keep
+  // opening and closing connections.
+  if (num_connections == 1 ||
+      total_calls > (num_connections - 1) * streams_per_connection_ / 2) {
+    return;
+  }
+  // Close the most recently added idle connection.  The primary connection
+  // is kept, since health checks run on it.  A pick may have just handed
+  // out the connection we drop; that call holds a ref to it, so the
+  // transport stays open until the call is done.
+  for (auto it = std::prev(connected_subchannels_.end());
+       it != connected_subchannels_.begin(); --it) {
+    if (it->second.connected_subchannel->active_calls() == 0) {
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_trace_subchannel)) {
+        gpr_log(GPR_INFO,
+                "subchannel %p %s: draining idle connected subchannel %p "
+                "(%" PRIuPTR " calls on %" PRIuPTR " connections)",
+                this, key_.ToString().c_str(),
+                it->second.connected_subchannel.get(), total_calls,
+                num_connections);
+      }
+      connected_subchannels_.erase(it);
+      return;
+    }
+  }
+}
+
+void Subchannel::OnPrimaryConnectionChangedLocked() {
+  const Connection& primary = connected_subchannels_.begin()->second;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_trace_subchannel)) {
+    gpr_log(GPR_INFO,
+            "subchannel %p %s: moving health checks to connected "
+            "subchannel %p",
+            this, key_.ToString().c_str(),
+            primary.connected_subchannel.get());
+  }
+  if (channelz_node_ != nullptr) {
+    channelz_node_->SetChildSocket(primary.socket_node);
+  }
+  health_watcher_map_.RestartHealthCheckingLocked();
+}
+
 void Subchannel::OnConnectingFinished(void* arg, grpc_error_handle error) {
   WeakRefCountedPtr<Subchannel> c(static_cast<Subchannel*>(arg));
   {
@@ -881,6 +1060,22 @@ void Subchannel::OnConnectingFinishedLocked(grpc_error_handle error) {
   if (shutdown_) {
     return;
   }
+  // An attempt to add a connection does not affect the connectivity state.
+  // If it fails, we simply keep using the connections we have, and
+  // additional_backoff_ delays the next attempt.
+  if (connecting_additional_) {
+    connecting_additional_ = false;
+    if (connecting_result_.transport == nullptr || !PublishTransportLocked()) {
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_trace_subchannel)) {
+        gpr_log(GPR_INFO, "subchannel %p %s: failed to add connection (%s)",
+                this, key_.ToString().c_str(), StatusToString(error).c_str());
+      }
+    } else {
+      additional_backoff_.Reset();
+      next_additional_attempt_time_ = Timestamp::InfPast();
+    }
+    return;
+  }
   // If we didn't get a transport or we fail to publish it, report
   // TRANSIENT_FAILURE and start the retry timer.
   // Note that if the connection attempt took longer than the backoff
@@ -937,19 +1132,31 @@ bool Subchannel::PublishTransportLocked() {
   connecting_result_.Reset();
   if (shutdown_) return false;
   // Publish.
-  connected_subchannel_.reset(
-      new ConnectedSubchannel(stk->release(), args_, channelz_node_));
+  const uint64_t connection_id = next_connection_id_++;
+  Connection& connection = connected_subchannels_[connection_id];
+  // Only a subchannel that may open more connections needs to hear about
+  // the load on each one.
+  connection.connected_subchannel = MakeRefCounted<ConnectedSubchannel>(
+      stk->release(), args_, channelz_node_,
+      max_connections_ > 1 ? WeakRef(DEBUG_LOCATION, "ConnectedSubchannel")
+                           : nullptr,
+      streams_per_connection_);
+  connection.socket_node = std::move(socket);
   if (GRPC_TRACE_FLAG_ENABLED(grpc_trace_subchannel)) {
     gpr_log(GPR_INFO, "subchannel %p %s: new connected subchannel at %p", this,
-            key_.ToString().c_str(), connected_subchannel_.get());
+            key_.ToString().c_str(), connection.connected_subchannel.get());
   }
+  // Start watching connected subchannel.
+  connection.connected_subchannel->StartWatch(
+      pollset_set_,
+      MakeOrphanable<ConnectedSubchannelStateWatcher>(
+          WeakRef(DEBUG_LOCATION, "state_watcher"), connection_id));
+  // Additional connections do not change the state, and channelz tracks
+  // only the primary connection's socket.
+  if (state_ == GRPC_CHANNEL_READY) return true;
   if (channelz_node_ != nullptr) {
-    channelz_node_->SetChildSocket(std::move(socket));
+    channelz_node_->SetChildSocket(connection.socket_node);
   }
-  // Start watching connected subchannel.
-  connected_subchannel_->StartWatch(
-      pollset_set_, MakeOrphanable<ConnectedSubchannelStateWatcher>(
-                        WeakRef(DEBUG_LOCATION, "state_watcher")));
   // Report initial state.
   SetConnectivityStateLocked(GRPC_CHANNEL_READY, absl::Status());
   return true;
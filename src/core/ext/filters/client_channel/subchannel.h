@@ -20,7 +20,9 @@
 #include <grpc/support/port_platform.h>
 
 #include <stddef.h>
+#include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
@@ -64,13 +66,19 @@
 
 namespace grpc_core {
 
+class Subchannel;
 class SubchannelCall;
 
 class ConnectedSubchannel : public RefCounted<ConnectedSubchannel> {
  public:
+  // If subchannel is non-null, it is told when this connection reaches
+  // streams_per_connection calls in flight or goes idle, so that it can
+  // grow or shrink its set of connections.
   ConnectedSubchannel(
       grpc_channel_stack* channel_stack, const ChannelArgs& args,
-      RefCountedPtr<channelz::SubchannelNode> channelz_subchannel);
+      RefCountedPtr<channelz::SubchannelNode> channelz_subchannel,
+      WeakRefCountedPtr<Subchannel> subchannel,
+      size_t streams_per_connection);
   ~ConnectedSubchannel() override;
 
   void StartWatch(grpc_pollset_set* interested_parties,
@@ -86,12 +94,27 @@ class ConnectedSubchannel : public RefCounted<ConnectedSubchannel> {
 
   size_t GetInitialCallSizeEstimate() const;
 
+  // Number of subchannel calls currently using this connection.
+  size_t active_calls() const {
+    return active_calls_.load(std::memory_order_relaxed);
+  }
+
  private:
+  friend class SubchannelCall;
+
+  // Called by SubchannelCall when a call starts or ends on this connection.
+  void OnCallStarted();
+  void OnCallFinished();
+
   grpc_channel_stack* channel_stack_;
   ChannelArgs args_;
   // ref counted pointer to the channelz node in this connected subchannel's
   // owning subchannel.
   RefCountedPtr<channelz::SubchannelNode> channelz_subchannel_;
+  // Owning subchannel, set only if it may open more than one connection.
+  WeakRefCountedPtr<Subchannel> subchannel_;
+  const size_t streams_per_connection_;
+  std::atomic<size_t> active_calls_{0};
 };
 
 // Implements the interface of RefCounted<>.
@@ -231,11 +254,10 @@ class Subchannel : public DualRefCounted<Subchannel> {
       const absl::optional<std::string>& health_check_service_name,
       ConnectivityStateWatcherInterface* watcher) ABSL_LOCKS_EXCLUDED(mu_);
 
+  // Returns the connection with the fewest calls in flight, or null if
+  // the subchannel is not connected.
   RefCountedPtr<ConnectedSubchannel> connected_subchannel()
-      ABSL_LOCKS_EXCLUDED(mu_) {
-    MutexLock lock(&mu_);
-    return connected_subchannel_;
-  }
+      ABSL_LOCKS_EXCLUDED(mu_);
 
   // Attempt to connect to the backend.  Has no effect if already connected.
   void RequestConnection() ABSL_LOCKS_EXCLUDED(mu_);
@@ -322,6 +344,10 @@ class Subchannel : public DualRefCounted<Subchannel> {
         Subchannel* subchannel, const std::string& health_check_service_name)
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&Subchannel::mu_);
 
+    // Moves health checking to the subchannel's current primary connection.
+    void RestartHealthCheckingLocked()
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&Subchannel::mu_);
+
     void ShutdownLocked();
 
    private:
@@ -330,8 +356,17 @@ class Subchannel : public DualRefCounted<Subchannel> {
     std::map<std::string, OrphanablePtr<HealthWatcher>> map_;
   };
 
+  friend class ConnectedSubchannel;
   class ConnectedSubchannelStateWatcher;
 
+  // A connection to the address.
+  struct Connection {
+    RefCountedPtr<ConnectedSubchannel> connected_subchannel;
+    // Reported to channelz as the subchannel's socket while this is the
+    // primary connection.
+    RefCountedPtr<channelz::SocketNode> socket_node;
+  };
+
   // Sets the subchannel's connectivity state to \a state.
   void SetConnectivityStateLocked(grpc_connectivity_state state,
                                   const absl::Status& status)
@@ -341,6 +376,16 @@ class Subchannel : public DualRefCounted<Subchannel> {
   void OnRetryTimer() ABSL_LOCKS_EXCLUDED(mu_);
   void OnRetryTimerLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   void StartConnectingLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void MaybeStartAdditionalConnectionLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Called when a connection reaches streams_per_connection_ calls in
+  // flight or goes idle.  May be called with mu_ held, so it schedules
+  // ResizeConnections() instead of resizing inline.
+  void OnConnectionLoadChanged();
+  void ResizeConnections() ABSL_LOCKS_EXCLUDED(mu_);
+  // Moves health checking and the channelz socket to the primary
+  // connection after the previous primary connection went away.
+  void OnPrimaryConnectionChangedLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   static void OnConnectingFinished(void* arg, grpc_error_handle error)
       ABSL_LOCKS_EXCLUDED(mu_);
   void OnConnectingFinishedLocked(grpc_error_handle error)
@@ -362,6 +407,11 @@ class Subchannel : public DualRefCounted<Subchannel> {
   RefCountedPtr<channelz::SubchannelNode> channelz_node_;
   // Minimum connection timeout.
   Duration min_connect_timeout_;
+  // Maximum number of connections to the address.
+  const size_t max_connections_;
+  // Number of calls in flight on every connection above which another
+  // connection is started.
+  const size_t streams_per_connection_;
 
   // Connection state.
   OrphanablePtr<SubchannelConnector> connector_;
@@ -378,7 +428,7 @@ class Subchannel : public DualRefCounted<Subchannel> {
   // Subchannel object:
   // - IDLE: no retry timer pending, can start a connection attempt at any time
   // - CONNECTING: connection attempt in progress
-  // - READY: connection attempt succeeded, connected_subchannel_ created
+  // - READY: connection attempt succeeded, connected_subchannels_ non-empty
   // - TRANSIENT_FAILURE: connection attempt failed, retry timer pending
   grpc_connectivity_state state_ ABSL_GUARDED_BY(mu_) = GRPC_CHANNEL_IDLE;
   absl::Status status_ ABSL_GUARDED_BY(mu_);
@@ -389,14 +439,26 @@ class Subchannel : public DualRefCounted<Subchannel> {
   // Used for sending connectivity state notifications.
   WorkSerializer work_serializer_;
 
-  // Active connection, or null.
-  RefCountedPtr<ConnectedSubchannel> connected_subchannel_ ABSL_GUARDED_BY(mu_);
+  // Active connections, keyed by the order in which they were established.
+  // Holds more than one connection only if max_connections_ > 1.  The
+  // oldest connection is the primary one, which runs the health checks
+  // and is reported to channelz.
+  std::map<uint64_t, Connection> connected_subchannels_ ABSL_GUARDED_BY(mu_);
+  uint64_t next_connection_id_ ABSL_GUARDED_BY(mu_) = 0;
+  // True while an attempt to add a connection to a READY subchannel is
+  // in flight.
+  bool connecting_additional_ ABSL_GUARDED_BY(mu_) = false;
+  // True while a ResizeConnections() call is scheduled.
+  std::atomic<bool> resize_pending_{false};
 
   // Backoff state.
   BackOff backoff_ ABSL_GUARDED_BY(mu_);
   Timestamp next_attempt_time_ ABSL_GUARDED_BY(mu_);
   grpc_event_engine::experimental::EventEngine::TaskHandle retry_timer_handle_
       ABSL_GUARDED_BY(mu_);
+  // Backoff state for additional connections.
+  BackOff additional_backoff_ ABSL_GUARDED_BY(mu_);
+  Timestamp next_additional_attempt_time_ ABSL_GUARDED_BY(mu_);
 
   // Keepalive time period (-1 for unset)
   int keepalive_time_ ABSL_GUARDED_BY(mu_) = -1;
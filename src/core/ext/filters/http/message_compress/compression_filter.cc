@@ -124,8 +124,8 @@ MessageHandle CompressionFilter::CompressMessage(
   // Try to compress the payload.
   SliceBuffer tmp;
   SliceBuffer* payload = message->payload();
-  bool did_compress = grpc_msg_compress(algorithm, payload->c_slice_buffer(),
-                                        tmp.c_slice_buffer());
+  bool did_compress = grpc_msg_try_compress(
+      algorithm, payload->c_slice_buffer(), tmp.c_slice_buffer());
   // If we achieved compression send it as compressed, otherwise send it as (to
   // avoid spending cycles on the receiver decompressing).
   if (did_compress) {
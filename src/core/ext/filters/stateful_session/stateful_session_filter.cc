@@ -103,7 +103,7 @@ void MaybeUpdateServerInitialMetadata(
       parts.emplace_back(
           absl::StrCat("Max-Age=", cookie_config->ttl.as_timespec().tv_sec));
     }
-    server_initial_metadata->Append(
+    server_initial_metadata->AppendStaticKey(
         "set-cookie", Slice::FromCopiedString(absl::StrJoin(parts, "; ")),
         [](absl::string_view error, const Slice&) {
           gpr_log(GPR_ERROR, "ERROR ADDING set-cookie METADATA: %s",
@@ -136,12 +136,15 @@ static void AssignMetadata(grpc_metadata_batch* mb,
                            const grpc_binder::Metadata& md) {
   mb->Clear();
   for (auto& p : md) {
-    mb->Append(p.first, grpc_core::Slice::FromCopiedString(p.second),
-               [&](absl::string_view error, const grpc_core::Slice&) {
-                 gpr_log(
-                     GPR_DEBUG, "Failed to parse metadata: %s",
-                     absl::StrCat("key=", p.first, " error=", error).c_str());
-               });
+    // Parse rather than Append, so that header names chosen by the peer are
+    // not interned.
+    mb->Set(grpc_metadata_batch::Parse(
+        p.first, grpc_core::Slice::FromCopiedString(p.second),
+        static_cast<uint32_t>(p.first.size() + p.second.size() + 32),
+        [&](absl::string_view error, const grpc_core::Slice&) {
+          gpr_log(GPR_DEBUG, "Failed to parse metadata: %s",
+                  absl::StrCat("key=", p.first, " error=", error).c_str());
+        }));
   }
 }
 
@@ -428,14 +428,19 @@ static void convert_cronet_array_to_metadata(
     } else {
       value = grpc_slice_from_static_string(header_array->headers[i].value);
     }
-    mds->Append(header_array->headers[i].key, grpc_core::Slice(value),
-                [&](absl::string_view error, const grpc_core::Slice& value) {
-                  gpr_log(GPR_DEBUG, "Failed to parse metadata: %s",
-                          absl::StrCat("key=", header_array->headers[i].key,
-                                       " error=", error,
-                                       " value=", value.as_string_view())
-                              .c_str());
-                });
+    // Parse rather than Append, so that header names chosen by the server are
+    // not interned.
+    absl::string_view key = header_array->headers[i].key;
+    mds->Set(grpc_metadata_batch::Parse(
+        key, grpc_core::Slice(value),
+        static_cast<uint32_t>(key.size() + GRPC_SLICE_LENGTH(value) + 32),
+        [&](absl::string_view error, const grpc_core::Slice& value) {
+          gpr_log(GPR_DEBUG, "Failed to parse metadata: %s",
+                  absl::StrCat("key=", header_array->headers[i].key,
+                               " error=", error,
+                               " value=", value.as_string_view())
+                      .c_str());
+        }));
   }
 }
 
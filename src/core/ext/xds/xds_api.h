@@ -68,15 +68,21 @@ class XdsApi {
 
     // Called to parse each individual resource in the ADS response.
     // Note that resource_name is non-empty only when the resource was
-    // wrapped in a Resource wrapper proto.
+    // wrapped in a Resource wrapper proto.  resource_version is the
+    // version of the individual resource, which is set only in delta
+    // ADS responses.
     virtual void ParseResource(upb_Arena* arena, size_t idx,
                                absl::string_view type_url,
                                absl::string_view resource_name,
+                               absl::string_view resource_version,
                                absl::string_view serialized_resource) = 0;
 
     // Called when a resource is wrapped in a Resource wrapper proto but
     // we fail to deserialize the wrapper proto.
     virtual void ResourceWrapperParsingFailed(size_t idx) = 0;
+
+    // Called for each resource that a delta ADS response removes.
+    virtual void ProcessRemovedResource(absl::string_view resource_name) = 0;
   };
 
   struct ClusterLoadReport {
@@ -157,11 +163,24 @@ class XdsApi {
                                const std::vector<std::string>& resource_names,
                                absl::Status status, bool populate_node);
 
+  // Creates a delta ADS request.  initial_resource_versions is sent only
+  // in the first request for a resource type on a stream.
+  std::string CreateDeltaAdsRequest(
+      absl::string_view type_url, absl::string_view nonce,
+      const std::vector<std::string>& resource_names_subscribe,
+      const std::vector<std::string>& resource_names_unsubscribe,
+      const std::map<std::string, std::string>& initial_resource_versions,
+      absl::Status status, bool populate_node);
+
   // Returns non-OK when failing to deserialize response message.
   // Otherwise, all events are reported to the parser.
   absl::Status ParseAdsResponse(absl::string_view encoded_response,
                                 AdsResponseParserInterface* parser);
 
+  // Same as ParseAdsResponse(), but for a delta ADS response.
+  absl::Status ParseDeltaAdsResponse(absl::string_view encoded_response,
+                                     AdsResponseParserInterface* parser);
+
   // Creates an initial LRS request.
   std::string CreateLrsInitialRequest();
 
@@ -47,6 +47,9 @@ class XdsBootstrap {
 
     virtual const std::string& server_uri() const = 0;
     virtual bool IgnoreResourceDeletion() const = 0;
+    // Returns true if the incremental (delta) variant of ADS should be
+    // used with this server instead of the state-of-the-world variant.
+    virtual bool UseDeltaProtocol() const = 0;
 
     virtual bool Equals(const XdsServer& other) const = 0;
 
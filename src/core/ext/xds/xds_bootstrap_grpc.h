@@ -79,6 +79,8 @@ class GrpcXdsBootstrap : public XdsBootstrap {
 
     bool IgnoreResourceDeletion() const override;
 
+    bool UseDeltaProtocol() const override;
+
     bool Equals(const XdsServer& other) const override;
 
     const std::string& channel_creds_type() const {
@@ -22,6 +22,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <iterator>
 #include <type_traits>
 
 #include "absl/strings/match.h"
@@ -149,16 +150,29 @@ class XdsClient::ChannelState::AdsCallState
 
     void ParseResource(upb_Arena* arena, size_t idx, absl::string_view type_url,
                        absl::string_view resource_name,
+                       absl::string_view resource_version,
                        absl::string_view serialized_resource) override
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
 
     void ResourceWrapperParsingFailed(size_t idx) override;
 
+    void ProcessRemovedResource(absl::string_view resource_name) override
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
     Result TakeResult() { return std::move(result_); }
 
    private:
     XdsClient* xds_client() const { return ads_call_state_->xds_client(); }
 
+    // Cancels the resource-does-not-exist timer for the resource, if any.
+    void MarkResourceSeen(const XdsResourceName& name)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
+    // Returns the cached state of the resource, or null if we don't have
+    // a subscription for it.
+    ResourceState* FindResourceState(const XdsResourceName& name)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
     AdsCallState* ads_call_state_;
     const Timestamp update_time_ = Timestamp::Now();
     Result result_;
@@ -305,11 +319,23 @@ class XdsClient::ChannelState::AdsCallState
     std::map<std::string /*authority*/,
              std::map<XdsResourceKey, OrphanablePtr<ResourceTimer>>>
         subscribed_resources;
+
+    // Delta ADS only: the names of the resources that the server has been
+    // told we are subscribed to on this stream, and whether a request for
+    // this type has been sent on this stream yet.
+    std::set<std::string> delta_subscribed_resource_names;
+    bool delta_request_sent = false;
   };
 
   void SendMessageLocked(const XdsResourceType* type)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
 
+  // Creates a delta ADS request that subscribes to and unsubscribes from
+  // the resources of a given type that changed since the last request.
+  std::string CreateDeltaAdsRequestLocked(const XdsResourceType* type,
+                                          ResourceTypeState* state)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
   void OnRequestSent(bool ok);
   void OnRecvMessage(absl::string_view payload);
   void OnStatusReceived(absl::Status status);
@@ -324,6 +350,9 @@ class XdsClient::ChannelState::AdsCallState
   // The owning RetryableCall<>.
   RefCountedPtr<RetryableCall<AdsCallState>> parent_;
 
+  // True if this stream uses the incremental (delta) variant of ADS.
+  const bool delta_;
+
   OrphanablePtr<XdsTransportFactory::XdsTransport::StreamingCall> call_;
 
   bool sent_initial_message_ = false;
@@ -734,9 +763,43 @@ void UpdateResourceMetadataNacked(const std::string& version,
 
 }  // namespace
 
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    MarkResourceSeen(const XdsResourceName& name) {
+  auto timer_it = ads_call_state_->state_map_.find(result_.type);
+  if (timer_it != ads_call_state_->state_map_.end()) {
+    auto it = timer_it->second.subscribed_resources.find(name.authority);
+    if (it != timer_it->second.subscribed_resources.end()) {
+      auto res_it = it->second.find(name.key);
+      if (res_it != it->second.end()) {
+        res_it->second->MarkSeen();
+      }
+    }
+  }
+}
+
+XdsClient::ResourceState*
+XdsClient::ChannelState::AdsCallState::AdsResponseParser::FindResourceState(
+    const XdsResourceName& name) {
+  // Lookup the authority in the cache.
+  auto authority_it = xds_client()->authority_state_map_.find(name.authority);
+  if (authority_it == xds_client()->authority_state_map_.end()) {
+    return nullptr;
+  }
+  // Found authority, so look up type.
+  AuthorityState& authority_state = authority_it->second;
+  auto type_it = authority_state.resource_map.find(result_.type);
+  if (type_it == authority_state.resource_map.end()) return nullptr;
+  auto& type_map = type_it->second;
+  // Found type, so look up resource key.
+  auto it = type_map.find(name.key);
+  if (it == type_map.end()) return nullptr;
+  return &it->second;
+}
+
 void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
     upb_Arena* arena, size_t idx, absl::string_view type_url,
-    absl::string_view resource_name, absl::string_view serialized_resource) {
+    absl::string_view resource_name, absl::string_view resource_version,
+    absl::string_view serialized_resource) {
   std::string error_prefix = absl::StrCat(
       "resource index ", idx, ": ",
       resource_name.empty() ? "" : absl::StrCat(resource_name, ": "));
@@ -747,6 +810,33 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
                      " (should be ", result_.type_url, ")"));
     return;
   }
+  // In delta ADS, each resource carries its own version, so a resource
+  // whose version we have already accepted does not need to be decoded
+  // again.  The server may resend such resources after a stream restart.
+  if (!resource_version.empty()) {
+    auto parsed_resource_name =
+        xds_client()->ParseXdsResourceName(resource_name, result_.type);
+    if (parsed_resource_name.ok()) {
+      ResourceState* resource_state = FindResourceState(*parsed_resource_name);
+      if (resource_state != nullptr && resource_state->resource != nullptr &&
+          !resource_state->ignored_deletion &&
+          resource_state->meta.client_status ==
+              XdsApi::ResourceMetadata::ACKED &&
+          resource_state->meta.version == resource_version) {
+        MarkResourceSeen(*parsed_resource_name);
+        result_.have_valid_resources = true;
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
+          gpr_log(GPR_INFO,
+                  "[xds_client %p] %s resource %s version %s unchanged, "
+                  "ignoring.",
+                  xds_client(), result_.type_url.c_str(),
+                  std::string(resource_name).c_str(),
+                  std::string(resource_version).c_str());
+        }
+        return;
+      }
+    }
+  }
   // Parse the resource.
   XdsResourceType::DecodeContext context = {
       xds_client(), ads_call_state_->chand()->server_, &grpc_xds_client_trace,
@@ -783,36 +873,17 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
     return;
   }
   // Cancel resource-does-not-exist timer, if needed.
-  auto timer_it = ads_call_state_->state_map_.find(result_.type);
-  if (timer_it != ads_call_state_->state_map_.end()) {
-    auto it = timer_it->second.subscribed_resources.find(
-        parsed_resource_name->authority);
-    if (it != timer_it->second.subscribed_resources.end()) {
-      auto res_it = it->second.find(parsed_resource_name->key);
-      if (res_it != it->second.end()) {
-        res_it->second->MarkSeen();
-      }
-    }
-  }
-  // Lookup the authority in the cache.
-  auto authority_it =
-      xds_client()->authority_state_map_.find(parsed_resource_name->authority);
-  if (authority_it == xds_client()->authority_state_map_.end()) {
-    return;  // Skip resource -- we don't have a subscription for it.
-  }
-  // Found authority, so look up type.
-  AuthorityState& authority_state = authority_it->second;
-  auto type_it = authority_state.resource_map.find(result_.type);
-  if (type_it == authority_state.resource_map.end()) {
-    return;  // Skip resource -- we don't have a subscription for it.
-  }
-  auto& type_map = type_it->second;
-  // Found type, so look up resource key.
-  auto it = type_map.find(parsed_resource_name->key);
-  if (it == type_map.end()) {
+  MarkResourceSeen(*parsed_resource_name);
+  ResourceState* resource_state_ptr = FindResourceState(*parsed_resource_name);
+  if (resource_state_ptr == nullptr) {
     return;  // Skip resource -- we don't have a subscription for it.
   }
-  ResourceState& resource_state = it->second;
+  ResourceState& resource_state = *resource_state_ptr;
+  // The version of the resource is its own version in delta ADS, and the
+  // version of the response in state-of-the-world ADS.
+  const std::string version = resource_version.empty()
+                                  ? result_.version
+                                  : std::string(resource_version);
   // If needed, record that we've seen this resource.
   if (result_.type->AllResourcesRequiredInSotW()) {
     result_.resources_seen[parsed_resource_name->authority].insert(
@@ -836,7 +907,7 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
         resource_state.watchers,
         absl::UnavailableError(
             absl::StrCat("invalid resource: ", decode_status.ToString())));
-    UpdateResourceMetadataNacked(result_.version, decode_status.ToString(),
+    UpdateResourceMetadataNacked(version, decode_status.ToString(),
                                  update_time_, &resource_state.meta);
     return;
   }
@@ -852,12 +923,15 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
               xds_client(), result_.type_url.c_str(),
               std::string(resource_name).c_str());
     }
+    // Remember the new version, so that we report it to the server when
+    // the delta ADS stream is restarted.
+    if (!resource_version.empty()) resource_state.meta.version = version;
     return;
   }
   // Update the resource state.
   resource_state.resource = std::move(*decode_result.resource);
   resource_state.meta = CreateResourceMetadataAcked(
-      std::string(serialized_resource), result_.version, update_time_);
+      std::string(serialized_resource), version, update_time_);
   // Notify watchers.
   auto& watchers_list = resource_state.watchers;
   auto* value =
@@ -879,6 +953,41 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
       "resource index ", idx, ": Can't decode Resource proto wrapper"));
 }
 
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    ProcessRemovedResource(absl::string_view resource_name) {
+  auto parsed_resource_name =
+      xds_client()->ParseXdsResourceName(resource_name, result_.type);
+  if (!parsed_resource_name.ok()) {
+    result_.errors.emplace_back(absl::StrCat(
+        "removed resource ", resource_name, ": Cannot parse xDS resource name"));
+    return;
+  }
+  // The server told us that the resource does not exist, so there is no
+  // need to wait for the does-not-exist timer.
+  MarkResourceSeen(*parsed_resource_name);
+  ResourceState* resource_state = FindResourceState(*parsed_resource_name);
+  if (resource_state == nullptr) {
+    return;  // Skip resource -- we don't have a subscription for it.
+  }
+  if (resource_state->resource != nullptr &&
+      ads_call_state_->chand()->server_.IgnoreResourceDeletion()) {
+    if (!resource_state->ignored_deletion) {
+      gpr_log(GPR_ERROR,
+              "[xds_client %p] xds server %s: ignoring deletion for resource "
+              "type %s name %s",
+              xds_client(),
+              ads_call_state_->chand()->server_.server_uri().c_str(),
+              result_.type_url.c_str(), std::string(resource_name).c_str());
+      resource_state->ignored_deletion = true;
+    }
+    return;
+  }
+  resource_state->resource.reset();
+  resource_state->meta.client_status =
+      XdsApi::ResourceMetadata::DOES_NOT_EXIST;
+  xds_client()->NotifyWatchersOnResourceDoesNotExist(resource_state->watchers);
+}
+
 //
 // XdsClient::ChannelState::AdsCallState
 //
@@ -889,12 +998,15 @@ XdsClient::ChannelState::AdsCallState::AdsCallState(
           GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_refcount_trace)
               ? "AdsCallState"
               : nullptr),
-      parent_(std::move(parent)) {
+      parent_(std::move(parent)),
+      delta_(parent_->chand()->server_.UseDeltaProtocol()) {
   GPR_ASSERT(xds_client() != nullptr);
   // Init the ADS call.
   const char* method =
-      "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
-      "StreamAggregatedResources";
+      delta_ ? "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
+               "DeltaAggregatedResources"
+             : "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
+               "StreamAggregatedResources";
   call_ = chand()->transport_->CreateStreamingCall(
       method, std::make_unique<StreamEventHandler>(
                   // Passing the initial ref here.  This ref will go away when
@@ -946,9 +1058,12 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
     return;
   }
   auto& state = state_map_[type];
-  std::string serialized_message = xds_client()->api_.CreateAdsRequest(
-      type->type_url(), chand()->resource_type_version_map_[type], state.nonce,
-      ResourceNamesForRequest(type), state.status, !sent_initial_message_);
+  std::string serialized_message =
+      delta_ ? CreateDeltaAdsRequestLocked(type, &state)
+             : xds_client()->api_.CreateAdsRequest(
+                   type->type_url(), chand()->resource_type_version_map_[type],
+                   state.nonce, ResourceNamesForRequest(type), state.status,
+                   !sent_initial_message_);
   sent_initial_message_ = true;
   if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
     gpr_log(GPR_INFO,
@@ -964,6 +1079,53 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
   send_message_pending_ = type;
 }
 
+std::string XdsClient::ChannelState::AdsCallState::CreateDeltaAdsRequestLocked(
+    const XdsResourceType* type, ResourceTypeState* state) {
+  std::vector<std::string> resource_names = ResourceNamesForRequest(type);
+  std::set<std::string> subscribed_resource_names(resource_names.begin(),
+                                                  resource_names.end());
+  std::vector<std::string> resource_names_subscribe;
+  std::set_difference(subscribed_resource_names.begin(),
+                      subscribed_resource_names.end(),
+                      state->delta_subscribed_resource_names.begin(),
+                      state->delta_subscribed_resource_names.end(),
+                      std::back_inserter(resource_names_subscribe));
+  std::vector<std::string> resource_names_unsubscribe;
+  std::set_difference(state->delta_subscribed_resource_names.begin(),
+                      state->delta_subscribed_resource_names.end(),
+                      subscribed_resource_names.begin(),
+                      subscribed_resource_names.end(),
+                      std::back_inserter(resource_names_unsubscribe));
+  state->delta_subscribed_resource_names = std::move(subscribed_resource_names);
+  // In the first request for this type on the stream, tell the server
+  // which versions of the resources we already have cached, so that it
+  // only sends the resources that changed since then.
+  std::map<std::string, std::string> initial_resource_versions;
+  if (!state->delta_request_sent) {
+    state->delta_request_sent = true;
+    for (const auto& a : state->subscribed_resources) {
+      const std::string& authority = a.first;
+      for (const auto& p : a.second) {
+        const XdsResourceKey& resource_key = p.first;
+        auto& authority_state = xds_client()->authority_state_map_[authority];
+        ResourceState& resource_state =
+            authority_state.resource_map[type][resource_key];
+        if (resource_state.resource == nullptr ||
+            resource_state.meta.version.empty()) {
+          continue;
+        }
+        initial_resource_versions[XdsClient::ConstructFullXdsResourceName(
+            authority, type->type_url(), resource_key)] =
+            resource_state.meta.version;
+      }
+    }
+  }
+  return xds_client()->api_.CreateDeltaAdsRequest(
+      type->type_url(), state->nonce, resource_names_subscribe,
+      resource_names_unsubscribe, initial_resource_versions, state->status,
+      !sent_initial_message_);
+}
+
 void XdsClient::ChannelState::AdsCallState::SubscribeLocked(
     const XdsResourceType* type, const XdsResourceName& name, bool delay_send) {
   auto& state = state_map_[type].subscribed_resources[name.authority][name.key];
@@ -1031,7 +1193,9 @@ void XdsClient::ChannelState::AdsCallState::OnRecvMessage(
     if (!IsCurrentCallOnChannel()) return;
     // Parse and validate the response.
     AdsResponseParser parser(this);
-    absl::Status status = xds_client()->api_.ParseAdsResponse(payload, &parser);
+    absl::Status status =
+        delta_ ? xds_client()->api_.ParseDeltaAdsResponse(payload, &parser)
+               : xds_client()->api_.ParseAdsResponse(payload, &parser);
     if (!status.ok()) {
       // Ignore unparsable response.
       gpr_log(GPR_ERROR,
@@ -1059,8 +1223,9 @@ void XdsClient::ChannelState::AdsCallState::OnRecvMessage(
                 result.type_url.c_str(), result.version.c_str(),
                 state.nonce.c_str(), state.status.ToString().c_str());
       }
-      // Delete resources not seen in update if needed.
-      if (result.type->AllResourcesRequiredInSotW()) {
+      // Delete resources not seen in update if needed.  Delta responses
+      // list the deleted resources explicitly instead.
+      if (!delta_ && result.type->AllResourcesRequiredInSotW()) {
         for (auto& a : xds_client()->authority_state_map_) {
           const std::string& authority = a.first;
           AuthorityState& authority_state = a.second;
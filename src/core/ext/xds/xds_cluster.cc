@@ -56,6 +56,7 @@
 #include "src/core/lib/config/core_configuration.h"
 #include "src/core/lib/debug/trace.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/env.h"
 #include "src/core/lib/gprpp/host_port.h"
 #include "src/core/lib/gprpp/match.h"
@@ -85,6 +86,25 @@ bool XdsHostOverrideEnabled() {
   return parse_succeeded && parsed_value;
 }
 
+// TODO(roth): Remove once least_request and maglev are no longer
+// experimental.
+bool XdsExperimentalLbPolicyEnabled(const char* env_var) {
+  auto value = GetEnv(env_var);
+  if (!value.has_value()) return false;
+  bool parsed_value;
+  bool parse_succeeded = gpr_parse_bool_value(value->c_str(), &parsed_value);
+  return parse_succeeded && parsed_value;
+}
+
+bool XdsLeastRequestLbPolicyEnabled() {
+  return XdsExperimentalLbPolicyEnabled(
+      "GRPC_EXPERIMENTAL_ENABLE_LEAST_REQUEST");
+}
+
+bool XdsMaglevLbPolicyEnabled() {
+  return XdsExperimentalLbPolicyEnabled("GRPC_EXPERIMENTAL_ENABLE_MAGLEV");
+}
+
 //
 // XdsClusterResource
 //
@@ -406,6 +426,34 @@ void ParseLbPolicyConfig(const XdsResourceType::DecodeContext& context,
              }},
         },
     };
+  } else if (XdsMaglevLbPolicyEnabled() &&
+             envoy_config_cluster_v3_Cluster_lb_policy(cluster) ==
+                 envoy_config_cluster_v3_Cluster_MAGLEV) {
+    // Record maglev lb config
+    auto* maglev_config =
+        envoy_config_cluster_v3_Cluster_maglev_lb_config(cluster);
+    uint64_t table_size = 65537;
+    if (maglev_config != nullptr) {
+      const google_protobuf_UInt64Value* uint64_value =
+          envoy_config_cluster_v3_Cluster_MaglevLbConfig_table_size(
+              maglev_config);
+      if (uint64_value != nullptr) {
+        ValidationErrors::ScopedField field(errors,
+                                            ".maglev_lb_config.table_size");
+        table_size = google_protobuf_UInt64Value_value(uint64_value);
+        if (table_size > 5000011 || !IsPrime(table_size)) {
+          errors->AddError("must be a prime number no larger than 5000011");
+        }
+      }
+    }
+    cds_update->lb_policy_config = {
+        Json::Object{
+            {"maglev_experimental",
+             Json::Object{
+                 {"tableSize", table_size},
+             }},
+        },
+    };
   } else {
     ValidationErrors::ScopedField field(errors, ".lb_policy");
     errors->AddError("LB policy is not supported");
@@ -49,6 +49,8 @@ namespace grpc_core {
 
 bool XdsCustomLbPolicyEnabled();
 bool XdsHostOverrideEnabled();
+bool XdsLeastRequestLbPolicyEnabled();
+bool XdsMaglevLbPolicyEnabled();
 
 struct XdsClusterResource : public XdsResourceType::ResourceData {
   struct Eds {
@@ -27,13 +27,16 @@
 #include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
+#include "envoy/config/cluster/v3/cluster.upb.h"
 #include "envoy/config/core/v3/extension.upb.h"
 #include "envoy/extensions/load_balancing_policies/ring_hash/v3/ring_hash.upb.h"
 #include "envoy/extensions/load_balancing_policies/wrr_locality/v3/wrr_locality.upb.h"
 #include "google/protobuf/wrappers.upb.h"
 
+#include "src/core/ext/xds/xds_cluster.h"
 #include "src/core/ext/xds/xds_common_types.h"
 #include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/validation_errors.h"
 #include "src/core/lib/load_balancing/lb_policy_registry.h"
 
@@ -124,6 +127,84 @@ class RingHashLbPolicyConfigFactory
   }
 };
 
+class LeastRequestLbPolicyConfigFactory
+    : public XdsLbPolicyRegistry::ConfigFactory {
+ public:
+  Json::Object ConvertXdsLbPolicyConfig(
+      const XdsLbPolicyRegistry* /*registry*/,
+      const XdsResourceType::DecodeContext& context,
+      absl::string_view configuration, ValidationErrors* errors,
+      int /*recursion_depth*/) override {
+    // The LeastRequest extension shares its field numbers and types with
+    // Cluster.LeastRequestLbConfig, so decode it with that message's parser.
+    const auto* resource =
+        envoy_config_cluster_v3_Cluster_LeastRequestLbConfig_parse(
+            configuration.data(), configuration.size(), context.arena);
+    if (resource == nullptr) {
+      errors->AddError("can't decode LeastRequest LB policy config");
+      return {};
+    }
+    uint32_t choice_count = 2;
+    const auto* uint32_value =
+        envoy_config_cluster_v3_Cluster_LeastRequestLbConfig_choice_count(
+            resource);
+    if (uint32_value != nullptr) {
+      choice_count = google_protobuf_UInt32Value_value(uint32_value);
+      if (choice_count < 2) {
+        ValidationErrors::ScopedField field(errors, ".choice_count");
+        errors->AddError("must be at least 2");
+      }
+    }
+    return Json::Object{
+        {"least_request", Json::Object{{"choiceCount", choice_count}}},
+    };
+  }
+
+  absl::string_view type() override { return Type(); }
+
+  static absl::string_view Type() {
+    return "envoy.extensions.load_balancing_policies.least_request.v3."
+           "LeastRequest";
+  }
+};
+
+class MaglevLbPolicyConfigFactory : public XdsLbPolicyRegistry::ConfigFactory {
+ public:
+  Json::Object ConvertXdsLbPolicyConfig(
+      const XdsLbPolicyRegistry* /*registry*/,
+      const XdsResourceType::DecodeContext& context,
+      absl::string_view configuration, ValidationErrors* errors,
+      int /*recursion_depth*/) override {
+    // The Maglev extension shares its table_size field with
+    // Cluster.MaglevLbConfig, so decode it with that message's parser.
+    const auto* resource = envoy_config_cluster_v3_Cluster_MaglevLbConfig_parse(
+        configuration.data(), configuration.size(), context.arena);
+    if (resource == nullptr) {
+      errors->AddError("can't decode Maglev LB policy config");
+      return {};
+    }
+    uint64_t table_size = 65537;
+    const auto* uint64_value =
+        envoy_config_cluster_v3_Cluster_MaglevLbConfig_table_size(resource);
+    if (uint64_value != nullptr) {
+      table_size = google_protobuf_UInt64Value_value(uint64_value);
+      if (table_size > 5000011 || !IsPrime(table_size)) {
+        ValidationErrors::ScopedField field(errors, ".table_size");
+        errors->AddError("must be a prime number no larger than 5000011");
+      }
+    }
+    return Json::Object{
+        {"maglev_experimental", Json::Object{{"tableSize", table_size}}},
+    };
+  }
+
+  absl::string_view type() override { return Type(); }
+
+  static absl::string_view Type() {
+    return "envoy.extensions.load_balancing_policies.maglev.v3.Maglev";
+  }
+};
+
 class WrrLocalityLbPolicyConfigFactory
     : public XdsLbPolicyRegistry::ConfigFactory {
  public:
@@ -169,6 +250,16 @@ class WrrLocalityLbPolicyConfigFactory
 //
 
 XdsLbPolicyRegistry::XdsLbPolicyRegistry() {
+  if (XdsLeastRequestLbPolicyEnabled()) {
+    policy_config_factories_.emplace(
+        LeastRequestLbPolicyConfigFactory::Type(),
+        std::make_unique<LeastRequestLbPolicyConfigFactory>());
+  }
+  if (XdsMaglevLbPolicyEnabled()) {
+    policy_config_factories_.emplace(
+        MaglevLbPolicyConfigFactory::Type(),
+        std::make_unique<MaglevLbPolicyConfigFactory>());
+  }
   policy_config_factories_.emplace(
       RingHashLbPolicyConfigFactory::Type(),
       std::make_unique<RingHashLbPolicyConfigFactory>());
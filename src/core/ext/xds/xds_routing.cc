@@ -27,16 +27,19 @@
 #include <cctype>
 #include <utility>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 
 #include <grpc/support/log.h>
 
 #include "src/core/ext/xds/xds_http_filters.h"
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/matchers/matchers.h"
+#include "src/core/lib/matchers/string_matcher_set.h"
 
 namespace grpc_core {
 
@@ -137,6 +140,76 @@ absl::optional<size_t> XdsRouting::FindVirtualHostForDomain(
   return target_index;
 }
 
+//
+// XdsRouting::VirtualHostListMatcher
+//
+
+XdsRouting::VirtualHostListMatcher::VirtualHostListMatcher(
+    const VirtualHostListIterator& vhost_iterator) {
+  std::vector<StringMatcher> string_matchers;
+  for (size_t i = 0; i < vhost_iterator.Size(); ++i) {
+    for (const std::string& domain_pattern :
+         vhost_iterator.GetDomainsForVirtualHost(i)) {
+      const MatchType match_type = DomainPatternMatchType(domain_pattern);
+      // This should be caught by RouteConfigParse().
+      GPR_ASSERT(match_type != INVALID_MATCH);
+      absl::string_view value = domain_pattern;
+      StringMatcher::Type type;
+      switch (match_type) {
+        case EXACT_MATCH:
+          type = StringMatcher::Type::kExact;
+          break;
+        case SUFFIX_MATCH:
+          type = StringMatcher::Type::kSuffix;
+          value.remove_prefix(1);
+          break;
+        case PREFIX_MATCH:
+          type = StringMatcher::Type::kPrefix;
+          value.remove_suffix(1);
+          break;
+        default:
+          if (!universe_vhost_.has_value()) universe_vhost_ = i;
+          continue;
+      }
+      // Domain matching is case-insensitive.
+      string_matchers.push_back(std::move(
+          *StringMatcher::Create(type, value, /*case_sensitive=*/false)));
+      patterns_.push_back(Pattern{i, match_type, domain_pattern.size()});
+    }
+  }
+  std::vector<const StringMatcher*> matchers;
+  matchers.reserve(string_matchers.size());
+  for (const StringMatcher& matcher : string_matchers) {
+    matchers.push_back(&matcher);
+  }
+  matchers_ = StringMatcherSet(matchers);
+}
+
+absl::optional<size_t>
+XdsRouting::VirtualHostListMatcher::FindVirtualHostForDomain(
+    absl::string_view domain) const {
+  StringMatcherSet::IdList ids;
+  matchers_.Match(domain, &ids);
+  // Same order as FindVirtualHostForDomain(): the best match type, then the
+  // longest pattern, then the first virtual host.
+  const Pattern* best = nullptr;
+  for (size_t id : ids) {
+    const Pattern& pattern = patterns_[id];
+    // Asterisk must match at least one char.
+    if (pattern.match_type != EXACT_MATCH && domain.size() < pattern.size) {
+      continue;
+    }
+    if (best == nullptr || pattern.match_type < best->match_type ||
+        (pattern.match_type == best->match_type &&
+         (pattern.size > best->size ||
+          (pattern.size == best->size && pattern.vhost < best->vhost)))) {
+      best = &pattern;
+    }
+  }
+  if (best != nullptr) return best->vhost;
+  return universe_vhost_;
+}
+
 namespace {
 
 bool HeadersMatch(const std::vector<HeaderMatcher>& header_matchers,
@@ -175,6 +248,69 @@ absl::optional<size_t> XdsRouting::GetRouteForRequest(
   return absl::nullopt;
 }
 
+//
+// XdsRouting::RouteListMatcher
+//
+
+XdsRouting::RouteListMatcher::RouteListMatcher(
+    const RouteListIterator& route_list_iterator) {
+  std::vector<const StringMatcher*> path_matchers;
+  std::vector<const HeaderMatcher*> header_matchers;
+  for (size_t i = 0; i < route_list_iterator.Size(); ++i) {
+    const XdsRouteConfigResource::Route::Matchers& matchers =
+        route_list_iterator.GetMatchersForRoute(i);
+    path_matchers.push_back(&matchers.path_matcher);
+    header_matchers_begin_.push_back(header_matchers.size());
+    for (const HeaderMatcher& header_matcher : matchers.header_matchers) {
+      header_matchers.push_back(&header_matcher);
+    }
+    fraction_per_million_.push_back(matchers.fraction_per_million);
+  }
+  header_matchers_begin_.push_back(header_matchers.size());
+  path_matchers_ = StringMatcherSet(path_matchers);
+  header_matchers_ = HeaderMatcherSet(header_matchers);
+}
+
+absl::optional<size_t> XdsRouting::RouteListMatcher::GetRouteForRequest(
+    absl::string_view path, grpc_metadata_batch* initial_metadata) const {
+  StringMatcherSet::IdList routes;
+  path_matchers_.Match(path, &routes);
+  std::sort(routes.begin(), routes.end());
+  // Each header is looked up and matched the first time a route whose path
+  // matches needs it. Typical route lists fit in the inline storage, so a
+  // request allocates nothing here.
+  absl::InlinedVector<bool, 16> header_matched(header_matchers_.num_headers(),
+                                               false);
+  absl::InlinedVector<bool, 64> header_matcher_results(header_matchers_.size(),
+                                                       false);
+  for (size_t route : routes) {
+    bool headers_match = true;
+    for (size_t id = header_matchers_begin_[route];
+         id < header_matchers_begin_[route + 1]; ++id) {
+      size_t header = header_matchers_.header_of(id);
+      if (!header_matched[header]) {
+        std::string concatenated_value;
+        header_matchers_.Match(
+            header,
+            GetHeaderValue(initial_metadata,
+                           header_matchers_.header_name(header),
+                           &concatenated_value),
+            absl::MakeSpan(header_matcher_results));
+        header_matched[header] = true;
+      }
+      if (!header_matcher_results[id]) {
+        headers_match = false;
+        break;
+      }
+    }
+    if (headers_match && (!fraction_per_million_[route].has_value() ||
+                          UnderFraction(*fraction_per_million_[route]))) {
+      return route;
+    }
+  }
+  return absl::nullopt;
+}
+
 bool XdsRouting::IsValidDomainPattern(absl::string_view domain_pattern) {
   return DomainPatternMatchType(domain_pattern) != INVALID_MATCH;
 }
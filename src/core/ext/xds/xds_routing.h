@@ -22,6 +22,7 @@
 #include <grpc/support/port_platform.h>
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <map>
 #include <string>
@@ -35,6 +36,7 @@
 #include "src/core/ext/xds/xds_listener.h"
 #include "src/core/ext/xds/xds_route_config.h"
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/matchers/string_matcher_set.h"
 #include "src/core/lib/transport/metadata_batch.h"
 
 namespace grpc_core {
@@ -61,6 +63,64 @@ class XdsRouting {
         size_t index) const = 0;
   };
 
+  // The domain patterns of a list of virtual hosts, compiled so that the
+  // exact, suffix and prefix patterns of all virtual hosts are matched in a
+  // single StringMatcherSet lookup instead of one by one.
+  class VirtualHostListMatcher {
+   public:
+    VirtualHostListMatcher() = default;
+    explicit VirtualHostListMatcher(
+        const VirtualHostListIterator& vhost_iterator);
+
+    VirtualHostListMatcher(VirtualHostListMatcher&& other) noexcept = default;
+    VirtualHostListMatcher& operator=(VirtualHostListMatcher&& other) noexcept =
+        default;
+
+    // Returns the index of the selected virtual host in the list. Selects the
+    // same virtual host as XdsRouting::FindVirtualHostForDomain().
+    absl::optional<size_t> FindVirtualHostForDomain(
+        absl::string_view domain) const;
+
+   private:
+    struct Pattern {
+      size_t vhost;
+      int match_type;
+      size_t size;
+    };
+
+    StringMatcherSet matchers_;
+    // Pattern of each matcher in matchers_.
+    std::vector<Pattern> patterns_;
+    // The first virtual host with the universe pattern "*", if any.
+    absl::optional<size_t> universe_vhost_;
+  };
+
+  // The matchers of a list of routes, compiled so that the path matchers of
+  // all routes are evaluated in a single pass over the path, and the header
+  // matchers that refer to the same header in a single pass over its value.
+  class RouteListMatcher {
+   public:
+    RouteListMatcher() = default;
+    explicit RouteListMatcher(const RouteListIterator& route_list_iterator);
+
+    RouteListMatcher(RouteListMatcher&& other) noexcept = default;
+    RouteListMatcher& operator=(RouteListMatcher&& other) noexcept = default;
+
+    // Returns the index of the route to use for a request with the specified
+    // path and metadata, or nullopt if no route matches. Selects the same
+    // route as XdsRouting::GetRouteForRequest().
+    absl::optional<size_t> GetRouteForRequest(
+        absl::string_view path, grpc_metadata_batch* initial_metadata) const;
+
+   private:
+    StringMatcherSet path_matchers_;
+    HeaderMatcherSet header_matchers_;
+    // The header matchers of route i are the ones with ids in
+    // [header_matchers_begin_[i], header_matchers_begin_[i + 1]).
+    std::vector<size_t> header_matchers_begin_;
+    std::vector<absl::optional<uint32_t>> fraction_per_million_;
+  };
+
   // Returns the index of the selected virtual host in the list.
   static absl::optional<size_t> FindVirtualHostForDomain(
       const VirtualHostListIterator& vhost_iterator, absl::string_view domain);
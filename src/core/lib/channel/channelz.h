@@ -49,6 +49,10 @@
 // Channel arg key for channelz node.
 #define GRPC_ARG_CHANNELZ_CHANNEL_NODE "grpc.internal.channelz_channel_node"
 
+// Channel arg key for the channelz node of the server that owns a server
+// channel.
+#define GRPC_ARG_CHANNELZ_SERVER_NODE "grpc.internal.channelz_server_node"
+
 // Channel arg key for indicating an internal channel.
 #define GRPC_ARG_CHANNELZ_IS_INTERNAL_CHANNEL \
   "grpc.channelz_is_internal_channel"
@@ -243,6 +247,14 @@ class ServerNode : public BaseNode {
 
   ~ServerNode() override;
 
+  static absl::string_view ChannelArgName() {
+    return GRPC_ARG_CHANNELZ_SERVER_NODE;
+  }
+
+  static int ChannelArgsCompare(const ServerNode* a, const ServerNode* b) {
+    return QsortCompare(a, b);
+  }
+
   Json RenderJson() override;
 
   std::string RenderServerSockets(intptr_t start_socket_id,
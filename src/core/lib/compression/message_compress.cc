@@ -168,6 +168,11 @@ static int compress_inner(grpc_compression_algorithm algorithm,
   return 0;
 }
 
+int grpc_msg_try_compress(grpc_compression_algorithm algorithm,
+                          grpc_slice_buffer* input, grpc_slice_buffer* output) {
+  return compress_inner(algorithm, input, output);
+}
+
 int grpc_msg_compress(grpc_compression_algorithm algorithm,
                       grpc_slice_buffer* input, grpc_slice_buffer* output) {
   if (!compress_inner(algorithm, input, output)) {
@@ -30,6 +30,14 @@
 int grpc_msg_compress(grpc_compression_algorithm algorithm,
                       grpc_slice_buffer* input, grpc_slice_buffer* output);
 
+// compress 'input' to 'output' using 'algorithm'.
+// On success, appends compressed slices to output and returns 1.
+// On failure (including when compressing would not shrink the input), output
+// is unchanged and returns 0: callers that keep sending 'input' as-is avoid
+// taking and dropping a ref on each of its slices.
+int grpc_msg_try_compress(grpc_compression_algorithm algorithm,
+                          grpc_slice_buffer* input, grpc_slice_buffer* output);
+
 // decompress 'input' to 'output' using 'algorithm'.
 // On success, appends slices to output and returns 1.
 // On failure, output is unchanged, and returns 0.
@@ -90,6 +90,15 @@ const absl::string_view
         "cq_pluck_creates",
         "cq_next_creates",
         "cq_callback_creates",
+        "ssl_session_cache_hits",
+        "ssl_session_cache_misses",
+        "ssl_sessions_resumed",
+        "tls_verification_cache_hits",
+        "tls_verification_cache_misses",
+        "tsi_handshake_steps_offloaded",
+        "tsi_handshakes_rejected",
+        "call_arena_pool_hits",
+        "call_arena_pool_misses",
 };
 const absl::string_view GlobalStats::counter_doc[static_cast<int>(
     Counter::COUNT)] = {
@@ -116,12 +125,27 @@ const absl::string_view GlobalStats::counter_doc[static_cast<int>(
     "usage)",
     "Number of completion queues created for cq_callback (indicates callback "
     "api usage)",
+    "Number of client TLS handshakes that offered a cached session for "
+    "resumption",
+    "Number of client TLS handshakes that found no cached session",
+    "Number of client TLS handshakes that resumed a session",
+    "Number of TLS peer certificate chains whose verification result was "
+    "found in a server's verification result cache",
+    "Number of TLS peer certificate chains that were not found in a server's "
+    "verification result cache",
+    "Number of TSI handshake steps run on the handshake executor",
+    "Number of handshakes failed by the admission control of the handshake "
+    "executor",
+    "Number of calls whose arena reused storage cached by their channel",
+    "Number of calls on a channel with a call arena pool that found no cached "
+    "storage to reuse",
 };
 const absl::string_view
     GlobalStats::histogram_name[static_cast<int>(Histogram::COUNT)] = {
-        "call_initial_size",       "tcp_write_size", "tcp_write_iov_size",
-        "tcp_read_size",           "tcp_read_offer", "tcp_read_offer_iov_size",
-        "http2_send_message_size",
+        "call_initial_size",       "tcp_write_size",
+        "tcp_write_iov_size",      "tcp_read_size",
+        "tcp_read_offer",          "tcp_read_offer_iov_size",
+        "http2_send_message_size", "tsi_handshake_queue_depth",
 };
 const absl::string_view
     GlobalStats::histogram_doc[static_cast<int>(Histogram::COUNT)] = {
@@ -132,6 +156,8 @@ const absl::string_view
         "Number of bytes offered to each syscall_read",
         "Number of byte segments offered to each syscall_read",
         "Size of messages received by HTTP2 transport",
+        "Number of TSI handshake steps already waiting when one is queued on "
+        "the handshake executor",
 };
 namespace {
 const int kStatsTable0[25] = {
@@ -228,7 +254,16 @@ GlobalStats::GlobalStats()
       http2_stream_stalls{0},
       cq_pluck_creates{0},
       cq_next_creates{0},
-      cq_callback_creates{0} {}
+      cq_callback_creates{0},
+      ssl_session_cache_hits{0},
+      ssl_session_cache_misses{0},
+      ssl_sessions_resumed{0},
+      tls_verification_cache_hits{0},
+      tls_verification_cache_misses{0},
+      tsi_handshake_steps_offloaded{0},
+      tsi_handshakes_rejected{0},
+      call_arena_pool_hits{0},
+      call_arena_pool_misses{0} {}
 HistogramView GlobalStats::histogram(Histogram which) const {
   switch (which) {
     default:
@@ -254,6 +289,9 @@ HistogramView GlobalStats::histogram(Histogram which) const {
     case Histogram::kHttp2SendMessageSize:
       return HistogramView{&Histogram_16777216_20::BucketFor, kStatsTable2, 20,
                            http2_send_message_size.buckets()};
+    case Histogram::kTsiHandshakeQueueDepth:
+      return HistogramView{&Histogram_32768_24::BucketFor, kStatsTable0, 24,
+                           tsi_handshake_queue_depth.buckets()};
   }
 }
 std::unique_ptr<GlobalStats> GlobalStatsCollector::Collect() const {
@@ -291,6 +329,24 @@ std::unique_ptr<GlobalStats> GlobalStatsCollector::Collect() const {
         data.cq_next_creates.load(std::memory_order_relaxed);
     result->cq_callback_creates +=
         data.cq_callback_creates.load(std::memory_order_relaxed);
+    result->ssl_session_cache_hits +=
+        data.ssl_session_cache_hits.load(std::memory_order_relaxed);
+    result->ssl_session_cache_misses +=
+        data.ssl_session_cache_misses.load(std::memory_order_relaxed);
+    result->ssl_sessions_resumed +=
+        data.ssl_sessions_resumed.load(std::memory_order_relaxed);
+    result->tls_verification_cache_hits +=
+        data.tls_verification_cache_hits.load(std::memory_order_relaxed);
+    result->tls_verification_cache_misses +=
+        data.tls_verification_cache_misses.load(std::memory_order_relaxed);
+    result->tsi_handshake_steps_offloaded +=
+        data.tsi_handshake_steps_offloaded.load(std::memory_order_relaxed);
+    result->tsi_handshakes_rejected +=
+        data.tsi_handshakes_rejected.load(std::memory_order_relaxed);
+    result->call_arena_pool_hits +=
+        data.call_arena_pool_hits.load(std::memory_order_relaxed);
+    result->call_arena_pool_misses +=
+        data.call_arena_pool_misses.load(std::memory_order_relaxed);
     data.call_initial_size.Collect(&result->call_initial_size);
     data.tcp_write_size.Collect(&result->tcp_write_size);
     data.tcp_write_iov_size.Collect(&result->tcp_write_iov_size);
@@ -298,6 +354,7 @@ std::unique_ptr<GlobalStats> GlobalStatsCollector::Collect() const {
     data.tcp_read_offer.Collect(&result->tcp_read_offer);
     data.tcp_read_offer_iov_size.Collect(&result->tcp_read_offer_iov_size);
     data.http2_send_message_size.Collect(&result->http2_send_message_size);
+    data.tsi_handshake_queue_depth.Collect(&result->tsi_handshake_queue_depth);
   }
   return result;
 }
@@ -327,6 +384,24 @@ std::unique_ptr<GlobalStats> GlobalStats::Diff(const GlobalStats& other) const {
   result->cq_pluck_creates = cq_pluck_creates - other.cq_pluck_creates;
   result->cq_next_creates = cq_next_creates - other.cq_next_creates;
   result->cq_callback_creates = cq_callback_creates - other.cq_callback_creates;
+  result->ssl_session_cache_hits =
+      ssl_session_cache_hits - other.ssl_session_cache_hits;
+  result->ssl_session_cache_misses =
+      ssl_session_cache_misses - other.ssl_session_cache_misses;
+  result->ssl_sessions_resumed =
+      ssl_sessions_resumed - other.ssl_sessions_resumed;
+  result->tls_verification_cache_hits =
+      tls_verification_cache_hits - other.tls_verification_cache_hits;
+  result->tls_verification_cache_misses =
+      tls_verification_cache_misses - other.tls_verification_cache_misses;
+  result->tsi_handshake_steps_offloaded =
+      tsi_handshake_steps_offloaded - other.tsi_handshake_steps_offloaded;
+  result->tsi_handshakes_rejected =
+      tsi_handshakes_rejected - other.tsi_handshakes_rejected;
+  result->call_arena_pool_hits =
+      call_arena_pool_hits - other.call_arena_pool_hits;
+  result->call_arena_pool_misses =
+      call_arena_pool_misses - other.call_arena_pool_misses;
   result->call_initial_size = call_initial_size - other.call_initial_size;
   result->tcp_write_size = tcp_write_size - other.tcp_write_size;
   result->tcp_write_iov_size = tcp_write_iov_size - other.tcp_write_iov_size;
@@ -336,6 +411,8 @@ std::unique_ptr<GlobalStats> GlobalStats::Diff(const GlobalStats& other) const {
       tcp_read_offer_iov_size - other.tcp_read_offer_iov_size;
   result->http2_send_message_size =
       http2_send_message_size - other.http2_send_message_size;
+  result->tsi_handshake_queue_depth =
+      tsi_handshake_queue_depth - other.tsi_handshake_queue_depth;
   return result;
 }
 }  // namespace grpc_core
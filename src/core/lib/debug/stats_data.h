@@ -122,6 +122,15 @@ struct GlobalStats {
     kCqPluckCreates,
     kCqNextCreates,
     kCqCallbackCreates,
+    kSslSessionCacheHits,
+    kSslSessionCacheMisses,
+    kSslSessionsResumed,
+    kTlsVerificationCacheHits,
+    kTlsVerificationCacheMisses,
+    kTsiHandshakeStepsOffloaded,
+    kTsiHandshakesRejected,
+    kCallArenaPoolHits,
+    kCallArenaPoolMisses,
     COUNT
   };
   enum class Histogram {
@@ -132,6 +141,7 @@ struct GlobalStats {
     kTcpReadOffer,
     kTcpReadOfferIovSize,
     kHttp2SendMessageSize,
+    kTsiHandshakeQueueDepth,
     COUNT
   };
   GlobalStats();
@@ -160,6 +170,15 @@ struct GlobalStats {
       uint64_t cq_pluck_creates;
       uint64_t cq_next_creates;
       uint64_t cq_callback_creates;
+      uint64_t ssl_session_cache_hits;
+      uint64_t ssl_session_cache_misses;
+      uint64_t ssl_sessions_resumed;
+      uint64_t tls_verification_cache_hits;
+      uint64_t tls_verification_cache_misses;
+      uint64_t tsi_handshake_steps_offloaded;
+      uint64_t tsi_handshakes_rejected;
+      uint64_t call_arena_pool_hits;
+      uint64_t call_arena_pool_misses;
     };
     uint64_t counters[static_cast<int>(Counter::COUNT)];
   };
@@ -170,6 +189,7 @@ struct GlobalStats {
   Histogram_16777216_20 tcp_read_offer;
   Histogram_80_10 tcp_read_offer_iov_size;
   Histogram_16777216_20 http2_send_message_size;
+  Histogram_32768_24 tsi_handshake_queue_depth;
   HistogramView histogram(Histogram which) const;
   std::unique_ptr<GlobalStats> Diff(const GlobalStats& other) const;
 };
@@ -236,6 +256,42 @@ class GlobalStatsCollector {
     data_.this_cpu().cq_callback_creates.fetch_add(1,
                                                    std::memory_order_relaxed);
   }
+  void IncrementSslSessionCacheHits() {
+    data_.this_cpu().ssl_session_cache_hits.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  void IncrementSslSessionCacheMisses() {
+    data_.this_cpu().ssl_session_cache_misses.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  void IncrementSslSessionsResumed() {
+    data_.this_cpu().ssl_sessions_resumed.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  void IncrementTlsVerificationCacheHits() {
+    data_.this_cpu().tls_verification_cache_hits.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  void IncrementTlsVerificationCacheMisses() {
+    data_.this_cpu().tls_verification_cache_misses.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  void IncrementTsiHandshakeStepsOffloaded() {
+    data_.this_cpu().tsi_handshake_steps_offloaded.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  void IncrementTsiHandshakesRejected() {
+    data_.this_cpu().tsi_handshakes_rejected.fetch_add(
+        1, std::memory_order_relaxed);
+  }
+  void IncrementCallArenaPoolHits() {
+    data_.this_cpu().call_arena_pool_hits.fetch_add(1,
+                                                    std::memory_order_relaxed);
+  }
+  void IncrementCallArenaPoolMisses() {
+    data_.this_cpu().call_arena_pool_misses.fetch_add(
+        1, std::memory_order_relaxed);
+  }
   void IncrementCallInitialSize(int value) {
     data_.this_cpu().call_initial_size.Increment(value);
   }
@@ -257,6 +313,9 @@ class GlobalStatsCollector {
   void IncrementHttp2SendMessageSize(int value) {
     data_.this_cpu().http2_send_message_size.Increment(value);
   }
+  void IncrementTsiHandshakeQueueDepth(int value) {
+    data_.this_cpu().tsi_handshake_queue_depth.Increment(value);
+  }
 
  private:
   struct Data {
@@ -277,6 +336,15 @@ class GlobalStatsCollector {
     std::atomic<uint64_t> cq_pluck_creates{0};
     std::atomic<uint64_t> cq_next_creates{0};
     std::atomic<uint64_t> cq_callback_creates{0};
+    std::atomic<uint64_t> ssl_session_cache_hits{0};
+    std::atomic<uint64_t> ssl_session_cache_misses{0};
+    std::atomic<uint64_t> ssl_sessions_resumed{0};
+    std::atomic<uint64_t> tls_verification_cache_hits{0};
+    std::atomic<uint64_t> tls_verification_cache_misses{0};
+    std::atomic<uint64_t> tsi_handshake_steps_offloaded{0};
+    std::atomic<uint64_t> tsi_handshakes_rejected{0};
+    std::atomic<uint64_t> call_arena_pool_hits{0};
+    std::atomic<uint64_t> call_arena_pool_misses{0};
     HistogramCollector_32768_24 call_initial_size;
     HistogramCollector_16777216_20 tcp_write_size;
     HistogramCollector_80_10 tcp_write_iov_size;
@@ -284,6 +352,7 @@ class GlobalStatsCollector {
     HistogramCollector_16777216_20 tcp_read_offer;
     HistogramCollector_80_10 tcp_read_offer_iov_size;
     HistogramCollector_16777216_20 http2_send_message_size;
+    HistogramCollector_32768_24 tsi_handshake_queue_depth;
   };
   PerCpu<Data> data_;
 };
@@ -53,6 +53,9 @@ const char* const description_posix_event_engine_enable_polling =
     "If set, enables polling on the default posix event engine.";
 const char* const description_free_large_allocator =
     "If set, return all free bytes from a \042big\042 allocator";
+const char* const description_ssl_zero_copy_frame_protector =
+    "If set, SSL connections use a zero-copy frame protector, which seals and "
+    "opens records directly between the endpoint's slice buffers.";
 }  // namespace
 
 namespace grpc_core {
@@ -74,6 +77,8 @@ const ExperimentMetadata g_experiment_metadata[] = {
     {"posix_event_engine_enable_polling",
      description_posix_event_engine_enable_polling, true},
     {"free_large_allocator", description_free_large_allocator, false},
+    {"ssl_zero_copy_frame_protector",
+     description_ssl_zero_copy_frame_protector, false},
 };
 
 }  // namespace grpc_core
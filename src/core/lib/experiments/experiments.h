@@ -46,6 +46,9 @@ inline bool IsPosixEventEngineEnablePollingEnabled() {
   return IsExperimentEnabled(11);
 }
 inline bool IsFreeLargeAllocatorEnabled() { return IsExperimentEnabled(12); }
+inline bool IsSslZeroCopyFrameProtectorEnabled() {
+  return IsExperimentEnabled(13);
+}
 
 struct ExperimentMetadata {
   const char* name;
@@ -53,7 +56,7 @@ struct ExperimentMetadata {
   bool default_value;
 };
 
-constexpr const size_t kNumExperiments = 13;
+constexpr const size_t kNumExperiments = 14;
 extern const ExperimentMetadata g_experiment_metadata[kNumExperiments];
 
 }  // namespace grpc_core
@@ -177,6 +177,16 @@ inline uint32_t RoundUpToPowerOf2(uint32_t v) {
   return v;
 }
 
+// Returns true if n is prime.  Uses trial division, so only meant for
+// validating configuration values such as Maglev table sizes.
+inline bool IsPrime(uint64_t n) {
+  if (n < 2) return false;
+  for (uint64_t i = 2; i * i <= n; ++i) {
+    if (n % i == 0) return false;
+  }
+  return true;
+}
+
 }  // namespace grpc_core
 
 #define GPR_ARRAY_SIZE(array) (sizeof(array) / sizeof(*(array)))
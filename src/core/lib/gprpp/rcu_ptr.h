@@ -0,0 +1,98 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_GPRPP_RCU_PTR_H
+#define GRPC_CORE_LIB_GPRPP_RCU_PTR_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+
+namespace grpc_core {
+
+// Holds a RefCountedPtr<T> that is read far more often than it is written.
+//
+// Get() takes a ref to the current value without locking.  Exchange()
+// publishes a new value and then waits for readers that may have seen the
+// old value to finish taking their refs before handing the old value back, so
+// it is never destroyed out from under a reader.  Readers only ever wait for
+// each other if Exchange() runs concurrently with them, and then only for an
+// atomic increment.
+//
+// Readers register in one of two counters selected by the low bit of epoch_;
+// Exchange() flips the epoch and drains the counter of the previous epoch, so
+// a steady stream of new readers cannot starve it.
+//
+// Calls to Exchange() must be serialized by the caller.
+template <typename T>
+class RcuPtr {
+ public:
+  RcuPtr() = default;
+  explicit RcuPtr(RefCountedPtr<T> value) : value_(value.release()) {}
+  ~RcuPtr() {
+    T* value = value_.load(std::memory_order_relaxed);
+    if (value != nullptr) value->Unref();
+  }
+
+  RcuPtr(const RcuPtr&) = delete;
+  RcuPtr& operator=(const RcuPtr&) = delete;
+
+  // Returns a ref to the current value.  Thread-safe.
+  RefCountedPtr<T> Get() const {
+    size_t epoch;
+    while (true) {
+      epoch = epoch_.load(std::memory_order_seq_cst);
+      readers_[epoch & 1].fetch_add(1, std::memory_order_seq_cst);
+      // If Exchange() flipped the epoch before we registered, it may not
+      // wait for us: register again under the new epoch.
+      if (epoch_.load(std::memory_order_seq_cst) == epoch) break;
+      readers_[epoch & 1].fetch_sub(1, std::memory_order_release);
+    }
+    T* value = value_.load(std::memory_order_seq_cst);
+    RefCountedPtr<T> result = value == nullptr ? nullptr : value->Ref();
+    readers_[epoch & 1].fetch_sub(1, std::memory_order_release);
+    return result;
+  }
+
+  // Returns the current value without taking a ref.  Only meaningful for
+  // comparisons, or while the caller excludes concurrent calls to Exchange().
+  T* get_unsafe() const { return value_.load(std::memory_order_acquire); }
+
+  // Publishes value and returns the previous value.  Once this returns,
+  // no reader can still be taking a ref to the previous value.  Calls must
+  // not overlap.
+  RefCountedPtr<T> Exchange(RefCountedPtr<T> value) {
+    T* old_value = value_.exchange(value.release(), std::memory_order_seq_cst);
+    const size_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+    while (readers_[epoch & 1].load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+    return RefCountedPtr<T>(old_value);
+  }
+
+ private:
+  std::atomic<T*> value_{nullptr};
+  std::atomic<size_t> epoch_{0};
+  mutable std::atomic<size_t> readers_[2] = {{0}, {0}};
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_GPRPP_RCU_PTR_H
@@ -0,0 +1,212 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/matchers/string_matcher_set.h"
+
+#include <inttypes.h>
+
+#include "absl/strings/ascii.h"
+
+#include <grpc/support/log.h>
+
+namespace grpc_core {
+
+//
+// StringMatcherSet::Trie
+//
+
+void StringMatcherSet::Trie::Insert(absl::string_view key, size_t id) {
+  size_t node = 0;
+  for (char c : key) {
+    auto it = nodes_[node].children.find(c);
+    if (it != nodes_[node].children.end()) {
+      node = it->second;
+      continue;
+    }
+    size_t child = nodes_.size();
+    nodes_[node].children.emplace(c, child);
+    nodes_.emplace_back();
+    node = child;
+  }
+  nodes_[node].ids.push_back(id);
+}
+
+template <typename Iterator>
+void StringMatcherSet::Trie::Match(Iterator begin, Iterator end,
+                                   IdList* ids) const {
+  size_t node = 0;
+  while (true) {
+    ids->insert(ids->end(), nodes_[node].ids.begin(), nodes_[node].ids.end());
+    if (begin == end) return;
+    auto it = nodes_[node].children.find(*begin);
+    if (it == nodes_[node].children.end()) return;
+    node = it->second;
+    ++begin;
+  }
+}
+
+//
+// StringMatcherSet
+//
+
+StringMatcherSet::StringMatcherSet(
+    const std::vector<const StringMatcher*>& matchers)
+    : size_(matchers.size()) {
+  for (size_t id = 0; id < matchers.size(); ++id) {
+    const StringMatcher& matcher = *matchers[id];
+    if (matcher.type() == StringMatcher::Type::kSafeRegex) {
+      if (regex_set_ == nullptr) {
+        regex_set_ =
+            std::make_unique<RE2::Set>(RE2::DefaultOptions, RE2::ANCHOR_BOTH);
+      }
+      std::string error;
+      if (regex_set_->Add(matcher.regex_matcher()->pattern(), &error) !=
+          static_cast<int>(regex_matchers_.size())) {
+        // Should not happen, since the pattern already compiled once.
+        gpr_log(GPR_ERROR, "Failed to add regex %s to RE2::Set: %s",
+                matcher.regex_matcher()->pattern().c_str(), error.c_str());
+        other_matchers_.emplace_back(id, matcher);
+        continue;
+      }
+      regex_matchers_.emplace_back(id, matcher);
+      continue;
+    }
+    if (matcher.type() == StringMatcher::Type::kContains) {
+      other_matchers_.emplace_back(id, matcher);
+      continue;
+    }
+    Index& index = matcher.case_sensitive() ? case_sensitive_index_
+                                            : case_insensitive_index_;
+    std::string key = matcher.case_sensitive()
+                          ? matcher.string_matcher()
+                          : absl::AsciiStrToLower(matcher.string_matcher());
+    index.empty = false;
+    switch (matcher.type()) {
+      case StringMatcher::Type::kExact:
+        index.exact[std::move(key)].push_back(id);
+        break;
+      case StringMatcher::Type::kPrefix:
+        index.prefixes.Insert(key, id);
+        break;
+      case StringMatcher::Type::kSuffix:
+        index.suffixes.Insert(std::string(key.rbegin(), key.rend()), id);
+        break;
+      default:
+        GPR_UNREACHABLE_CODE(break);
+    }
+  }
+  if (regex_set_ != nullptr && !regex_set_->Compile()) {
+    gpr_log(GPR_ERROR, "Failed to compile RE2::Set, matching %" PRIuPTR
+            " regexes one by one", regex_matchers_.size());
+    regex_set_.reset();
+  }
+}
+
+void StringMatcherSet::MatchIndex(const Index& index, absl::string_view value,
+                                  IdList* ids) const {
+  auto it = index.exact.find(value);
+  if (it != index.exact.end()) {
+    ids->insert(ids->end(), it->second.begin(), it->second.end());
+  }
+  index.prefixes.Match(value.begin(), value.end(), ids);
+  index.suffixes.Match(value.rbegin(), value.rend(), ids);
+}
+
+void StringMatcherSet::Match(absl::string_view value, IdList* ids) const {
+  if (!case_sensitive_index_.empty) {
+    MatchIndex(case_sensitive_index_, value, ids);
+  }
+  if (!case_insensitive_index_.empty) {
+    MatchIndex(case_insensitive_index_, absl::AsciiStrToLower(value), ids);
+  }
+  if (!regex_matchers_.empty()) {
+    std::vector<int> regex_ids;
+    RE2::Set::ErrorInfo error_info;
+    if (regex_set_ != nullptr &&
+        (regex_set_->Match(re2::StringPiece(value.data(), value.size()),
+                           &regex_ids, &error_info) ||
+         error_info.kind == RE2::Set::kNoError)) {
+      for (int regex_id : regex_ids) {
+        ids->push_back(regex_matchers_[regex_id].first);
+      }
+    } else {
+      for (const auto& p : regex_matchers_) {
+        if (p.second.Match(value)) ids->push_back(p.first);
+      }
+    }
+  }
+  for (const auto& p : other_matchers_) {
+    if (p.second.Match(value)) ids->push_back(p.first);
+  }
+}
+
+//
+// HeaderMatcherSet
+//
+
+HeaderMatcherSet::HeaderMatcherSet(
+    const std::vector<const HeaderMatcher*>& matchers) {
+  absl::flat_hash_map<absl::string_view, size_t> header_by_name;
+  std::vector<std::vector<const StringMatcher*>> string_matchers;
+  for (size_t id = 0; id < matchers.size(); ++id) {
+    const HeaderMatcher& matcher = *matchers[id];
+    auto it = header_by_name.find(matcher.name());
+    if (it == header_by_name.end()) {
+      it = header_by_name.emplace(matcher.name(), headers_.size()).first;
+      headers_.emplace_back();
+      headers_.back().name = matcher.name();
+      string_matchers.emplace_back();
+    }
+    size_t header = it->second;
+    header_of_matcher_.push_back(header);
+    if (matcher.type() == HeaderMatcher::Type::kRange ||
+        matcher.type() == HeaderMatcher::Type::kPresent) {
+      headers_[header].other_matchers.emplace_back(id, matcher);
+    } else {
+      headers_[header].string_matcher_ids.push_back(
+          StringMatcherId{id, matcher.invert_match()});
+      string_matchers[header].push_back(&matcher.matcher());
+    }
+  }
+  for (size_t header = 0; header < headers_.size(); ++header) {
+    headers_[header].string_matchers =
+        StringMatcherSet(string_matchers[header]);
+  }
+}
+
+void HeaderMatcherSet::Match(size_t header,
+                             const absl::optional<absl::string_view>& value,
+                             absl::Span<bool> results) const {
+  const Header& h = headers_[header];
+  // Mirrors HeaderMatcher::Match(): string matchers never match an absent
+  // header, even if inverted.
+  for (const StringMatcherId& matcher_id : h.string_matcher_ids) {
+    results[matcher_id.id] = value.has_value() && matcher_id.invert_match;
+  }
+  if (value.has_value() && !h.string_matcher_ids.empty()) {
+    StringMatcherSet::IdList ids;
+    h.string_matchers.Match(*value, &ids);
+    for (size_t id : ids) {
+      const StringMatcherId& matcher_id = h.string_matcher_ids[id];
+      results[matcher_id.id] = !matcher_id.invert_match;
+    }
+  }
+  for (const auto& p : h.other_matchers) {
+    results[p.first] = p.second.Match(value);
+  }
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,163 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_MATCHERS_STRING_MATCHER_SET_H
+#define GRPC_CORE_LIB_MATCHERS_STRING_MATCHER_SET_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "re2/set.h"
+
+#include "src/core/lib/matchers/matchers.h"
+
+namespace grpc_core {
+
+// Matches a value against many StringMatchers at once.
+//
+// Exact matchers are looked up in a hash map, prefix and suffix matchers in
+// tries, and all regex matchers are run in a single pass of one RE2::Set, so
+// the cost of a lookup depends on the length of the value and the number of
+// matches rather than on the number of matchers. Only contains matchers are
+// evaluated one by one.
+class StringMatcherSet {
+ public:
+  // Ids of matching matchers. Lookups usually match a handful of matchers, so
+  // they are kept inline rather than allocated for every lookup.
+  using IdList = absl::InlinedVector<size_t, 8>;
+
+  // Creates an empty set, which matches nothing.
+  StringMatcherSet() = default;
+  // Creates a set of \a matchers. The id of a matcher is its index in
+  // \a matchers.
+  explicit StringMatcherSet(const std::vector<const StringMatcher*>& matchers);
+
+  StringMatcherSet(StringMatcherSet&& other) noexcept = default;
+  StringMatcherSet& operator=(StringMatcherSet&& other) noexcept = default;
+
+  // Appends the ids of all matchers that match \a value to \a ids, in no
+  // particular order.
+  void Match(absl::string_view value, IdList* ids) const;
+
+  size_t size() const { return size_; }
+
+ private:
+  class Trie {
+   public:
+    void Insert(absl::string_view key, size_t id);
+    // Appends the ids of all keys that are a prefix of the string formed by
+    // [begin, end).
+    template <typename Iterator>
+    void Match(Iterator begin, Iterator end, IdList* ids) const;
+
+   private:
+    struct Node {
+      absl::flat_hash_map<char, size_t> children;
+      std::vector<size_t> ids;
+    };
+    std::vector<Node> nodes_{1};
+  };
+
+  // Index of the exact, prefix and suffix matchers. Case-insensitive matchers
+  // are indexed by their lower-case value.
+  struct Index {
+    bool empty = true;
+    absl::flat_hash_map<std::string, std::vector<size_t>> exact;
+    Trie prefixes;
+    // Indexed by the reversed suffix.
+    Trie suffixes;
+  };
+
+  void MatchIndex(const Index& index, absl::string_view value,
+                  IdList* ids) const;
+
+  size_t size_ = 0;
+  Index case_sensitive_index_;
+  Index case_insensitive_index_;
+  std::unique_ptr<RE2::Set> regex_set_;
+  // Maps the regexes in regex_set_ to matcher ids. The matchers are also kept
+  // to evaluate them one by one if the RE2::Set runs out of memory.
+  std::vector<std::pair<size_t, StringMatcher>> regex_matchers_;
+  // Matchers that are evaluated one by one.
+  std::vector<std::pair<size_t, StringMatcher>> other_matchers_;
+};
+
+// Matches the headers of a request against many HeaderMatchers at once.
+//
+// The matchers are grouped by header name, and the string matchers of each
+// header are combined into one StringMatcherSet, so evaluating all of the
+// matchers of a header only takes one pass over its value.
+class HeaderMatcherSet {
+ public:
+  // Creates an empty set.
+  HeaderMatcherSet() = default;
+  // Creates a set of \a matchers. The id of a matcher is its index in
+  // \a matchers.
+  explicit HeaderMatcherSet(const std::vector<const HeaderMatcher*>& matchers);
+
+  HeaderMatcherSet(HeaderMatcherSet&& other) noexcept = default;
+  HeaderMatcherSet& operator=(HeaderMatcherSet&& other) noexcept = default;
+
+  size_t size() const { return header_of_matcher_.size(); }
+
+  // Number of distinct header names. Headers are identified by an index in
+  // [0, num_headers()).
+  size_t num_headers() const { return headers_.size(); }
+
+  const std::string& header_name(size_t header) const {
+    return headers_[header].name;
+  }
+
+  // Returns the header matched by the matcher with id \a id.
+  size_t header_of(size_t id) const { return header_of_matcher_[id]; }
+
+  // Evaluates all matchers of \a header against \a value, which is nullopt if
+  // the header is absent, and stores the result of each in the element of
+  // \a results at its id. \a results must have size() elements.
+  void Match(size_t header, const absl::optional<absl::string_view>& value,
+             absl::Span<bool> results) const;
+
+ private:
+  struct StringMatcherId {
+    size_t id;
+    bool invert_match;
+  };
+
+  struct Header {
+    std::string name;
+    StringMatcherSet string_matchers;
+    // Maps the ids in string_matchers to ids in the HeaderMatcherSet.
+    std::vector<StringMatcherId> string_matcher_ids;
+    // Range and present matchers, which are evaluated one by one.
+    std::vector<std::pair<size_t, HeaderMatcher>> other_matchers;
+  };
+
+  std::vector<Header> headers_;
+  std::vector<size_t> header_of_matcher_;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_MATCHERS_STRING_MATCHER_SET_H
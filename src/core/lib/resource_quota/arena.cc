@@ -22,18 +22,24 @@
 
 #include <atomic>
 #include <new>
+#include <utility>
 
 #include <grpc/support/alloc.h>
 
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
 #include "src/core/lib/gpr/alloc.h"
 
 namespace {
 
-void* ArenaStorage(size_t initial_size) {
+size_t ArenaStorageSize(size_t initial_size) {
   static constexpr size_t base_size =
       GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(grpc_core::Arena));
-  initial_size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
-  size_t alloc_size = base_size + initial_size;
+  return base_size + GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
+}
+
+void* ArenaStorage(size_t initial_size) {
+  size_t alloc_size = ArenaStorageSize(initial_size);
   static constexpr size_t alignment =
       (GPR_CACHELINE_SIZE > GPR_MAX_ALIGNMENT &&
        GPR_CACHELINE_SIZE % GPR_MAX_ALIGNMENT == 0)
@@ -71,6 +77,23 @@ std::pair<Arena*, void*> Arena::CreateWithAlloc(
   return std::make_pair(new_arena, first_alloc);
 }
 
+std::pair<Arena*, void*> Arena::CreateWithAlloc(
+    size_t initial_size, size_t alloc_size, MemoryAllocator* memory_allocator,
+    ArenaStoragePool* storage_pool) {
+  if (storage_pool == nullptr) {
+    return CreateWithAlloc(initial_size, alloc_size, memory_allocator);
+  }
+  static constexpr size_t base_size =
+      GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena));
+  initial_size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
+  void* storage = storage_pool->Get(&initial_size);
+  if (storage == nullptr) storage = ArenaStorage(initial_size);
+  auto* new_arena = new (storage)
+      Arena(initial_size, alloc_size, memory_allocator, storage_pool);
+  void* first_alloc = reinterpret_cast<char*>(new_arena) + base_size;
+  return std::make_pair(new_arena, first_alloc);
+}
+
 size_t Arena::Destroy() {
   ManagedNewObject* p;
   // Outer loop: clear the managed new object list.
@@ -84,8 +107,14 @@ size_t Arena::Destroy() {
   }
   size_t size = total_used_.load(std::memory_order_relaxed);
   memory_allocator_->Release(total_allocated_.load(std::memory_order_relaxed));
+  ArenaStoragePool* storage_pool = storage_pool_;
+  const size_t initial_zone_size = initial_zone_size_;
   this->~Arena();
-  gpr_free_aligned(this);
+  if (storage_pool != nullptr) {
+    storage_pool->Put(this, initial_zone_size);
+  } else {
+    gpr_free_aligned(this);
+  }
   return size;
 }
 
@@ -135,4 +164,61 @@ void Arena::FreePooled(void* p, std::atomic<FreePoolNode*>* head) {
   }
 }
 
+ArenaStoragePool::ArenaStoragePool(size_t max_cached_blocks,
+                                   MemoryQuotaRefPtr memory_quota)
+    : max_cached_blocks_(max_cached_blocks),
+      memory_quota_(std::move(memory_quota)),
+      memory_allocator_(
+          memory_quota_->CreateMemoryAllocator("arena_storage_pool")) {}
+
+ArenaStoragePool::~ArenaStoragePool() {
+  MutexLock lock(&mu_);
+  while (cached_ != nullptr) {
+    Block* block = std::exchange(cached_, cached_->next);
+    memory_allocator_.Release(ArenaStorageSize(block->initial_zone_size));
+    gpr_free_aligned(block);
+  }
+}
+
+void* ArenaStoragePool::Get(size_t* initial_zone_size) {
+  Block* block;
+  {
+    MutexLock lock(&mu_);
+    block = cached_;
+    if (block != nullptr) {
+      cached_ = block->next;
+      --num_cached_;
+    }
+  }
+  if (block == nullptr) {
+    global_stats().IncrementCallArenaPoolMisses();
+    return nullptr;
+  }
+  // The block is the arena's again, and so is the arena's to account for.
+  memory_allocator_.Release(ArenaStorageSize(block->initial_zone_size));
+  // Blocks track the channel's call size estimate, so a block that is too
+  // small means the estimate has grown: drop it in favor of a bigger one.
+  if (block->initial_zone_size < *initial_zone_size) {
+    gpr_free_aligned(block);
+    global_stats().IncrementCallArenaPoolMisses();
+    return nullptr;
+  }
+  *initial_zone_size = block->initial_zone_size;
+  global_stats().IncrementCallArenaPoolHits();
+  return block;
+}
+
+void ArenaStoragePool::Put(void* storage, size_t initial_zone_size) {
+  if (!memory_quota_->IsMemoryPressureHigh()) {
+    MutexLock lock(&mu_);
+    if (num_cached_ < max_cached_blocks_) {
+      memory_allocator_.Reserve(ArenaStorageSize(initial_zone_size));
+      cached_ = new (storage) Block{cached_, initial_zone_size};
+      ++num_cached_;
+      return;
+    }
+  }
+  gpr_free_aligned(storage);
+}
+
 }  // namespace grpc_core
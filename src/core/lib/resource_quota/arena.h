@@ -34,6 +34,7 @@
 #include <new>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/meta/type_traits.h"
 #include "absl/utility/utility.h"
 
@@ -41,6 +42,7 @@
 
 #include "src/core/lib/gpr/alloc.h"
 #include "src/core/lib/gprpp/construct_destruct.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/promise/context.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
 
@@ -83,6 +85,52 @@ constexpr size_t AllocationSizeFromObjectSize(
 
 }  // namespace arena_detail
 
+// Caches the storage of destroyed arenas so that a steady stream of similarly
+// sized arenas (the calls on one channel, say) reuses it instead of going back
+// to the allocator each time. Only the initial zone is recycled: arenas that
+// outgrow it still allocate (and free) their extra zones.
+// Cached blocks are charged to memory_quota, since nothing else accounts for
+// them between calls, and are freed instead of cached while its memory
+// pressure is high.
+// Must outlive every arena created against it.
+class ArenaStoragePool {
+ public:
+  ArenaStoragePool(size_t max_cached_blocks, MemoryQuotaRefPtr memory_quota);
+  ~ArenaStoragePool();
+
+  ArenaStoragePool(const ArenaStoragePool&) = delete;
+  ArenaStoragePool& operator=(const ArenaStoragePool&) = delete;
+
+  // Number of blocks currently waiting to be reused.
+  size_t cached_blocks() {
+    MutexLock lock(&mu_);
+    return num_cached_;
+  }
+
+ private:
+  friend class Arena;
+
+  struct Block {
+    Block* next;
+    size_t initial_zone_size;
+  };
+
+  // Return a cached block with an initial zone of at least initial_zone_size
+  // bytes, setting *initial_zone_size to its actual size, or nullptr if there
+  // is none.
+  void* Get(size_t* initial_zone_size);
+  // Take back the storage of a destroyed arena, freeing it if the cache is
+  // full.
+  void Put(void* storage, size_t initial_zone_size);
+
+  const size_t max_cached_blocks_;
+  const MemoryQuotaRefPtr memory_quota_;
+  MemoryAllocator memory_allocator_;
+  Mutex mu_;
+  Block* cached_ ABSL_GUARDED_BY(mu_) = nullptr;
+  size_t num_cached_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
 class Arena {
   using PoolSizes = absl::integer_sequence<size_t, 256, 512, 768>;
 
@@ -97,8 +145,17 @@ class Arena {
       size_t initial_size, size_t alloc_size,
       MemoryAllocator* memory_allocator);
 
+  // As above, but take the arena's storage from storage_pool if it has a
+  // suitable block, and hand it back there on Destroy().
+  static std::pair<Arena*, void*> CreateWithAlloc(
+      size_t initial_size, size_t alloc_size, MemoryAllocator* memory_allocator,
+      ArenaStoragePool* storage_pool);
+
   // Destroy an arena, returning the total number of bytes allocated.
   size_t Destroy();
+  // Return the allocator the arena charges its memory to.  Callers may
+  // charge other memory owned by the arena's user (e.g., a call) to it.
+  MemoryAllocator* memory_allocator() const { return memory_allocator_; }
   // Allocate \a size bytes from the arena.
   void* Alloc(size_t size) {
     static constexpr size_t base_size =
@@ -192,11 +249,16 @@ class Arena {
   //   quick optimization (avoiding an atomic fetch-add) for the common case
   //   where we wish to create an arena and then perform an immediate
   //   allocation.
+  //
+  //   storage_pool: Optionally, the pool that the arena's storage came from and
+  //   should be returned to on destruction.
   explicit Arena(size_t initial_size, size_t initial_alloc,
-                 MemoryAllocator* memory_allocator)
+                 MemoryAllocator* memory_allocator,
+                 ArenaStoragePool* storage_pool = nullptr)
       : total_used_(GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_alloc)),
         initial_zone_size_(initial_size),
-        memory_allocator_(memory_allocator) {}
+        memory_allocator_(memory_allocator),
+        storage_pool_(storage_pool) {}
 
   ~Arena();
 
@@ -231,6 +293,7 @@ class Arena {
   std::atomic<FreePoolNode*> pools_[PoolSizes::size()]{};
   // The backing memory quota
   MemoryAllocator* const memory_allocator_;
+  ArenaStoragePool* const storage_pool_;
 };
 
 // Smart pointer for arenas when the final size is not required.
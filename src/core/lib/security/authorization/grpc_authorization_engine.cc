@@ -20,10 +20,148 @@
 #include <map>
 #include <utility>
 
+#include <grpc/grpc_security_constants.h>
+
 namespace grpc_core {
 
+namespace {
+
+const StringMatcher* GetStringMatcher(const Rbac::Permission& permission) {
+  return &permission.string_matcher;
+}
+
+const StringMatcher* GetStringMatcher(const Rbac::Principal& principal) {
+  return principal.string_matcher.has_value() ? &*principal.string_matcher
+                                              : nullptr;
+}
+
+const std::vector<std::unique_ptr<Rbac::Permission>>& GetChildren(
+    const Rbac::Permission& permission) {
+  return permission.permissions;
+}
+
+const std::vector<std::unique_ptr<Rbac::Principal>>& GetChildren(
+    const Rbac::Principal& principal) {
+  return principal.principals;
+}
+
+// Appends to \a matchers the string matchers of rules of \a type in \a rule,
+// such that \a rule only matches if one of them matches. Returns false, and
+// appends nothing, if \a rule may match regardless of rules of \a type.
+template <typename Rule>
+bool CollectRequiredMatchers(const Rule& rule, typename Rule::RuleType type,
+                             std::vector<const StringMatcher*>* matchers) {
+  if (rule.type == type) {
+    const StringMatcher* matcher = GetStringMatcher(rule);
+    if (matcher == nullptr) return false;
+    matchers->push_back(matcher);
+    return true;
+  }
+  switch (rule.type) {
+    case Rule::RuleType::kAnd:
+      for (const auto& child : GetChildren(rule)) {
+        if (CollectRequiredMatchers(*child, type, matchers)) return true;
+      }
+      return false;
+    case Rule::RuleType::kOr: {
+      size_t size = matchers->size();
+      for (const auto& child : GetChildren(rule)) {
+        if (!CollectRequiredMatchers(*child, type, matchers)) {
+          matchers->resize(size);
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// Accumulates the matchers of one PolicyIndex while the policies are compiled.
+struct PolicyIndexMatchers {
+  // Adds the policy with index \a policy, constrained by \a policy_matchers
+  // if \a is_constrained is true.
+  void AddPolicy(size_t policy, bool is_constrained,
+                 const std::vector<const StringMatcher*>& policy_matchers) {
+    constrained.push_back(is_constrained);
+    if (!is_constrained) return;
+    matchers.insert(matchers.end(), policy_matchers.begin(),
+                    policy_matchers.end());
+    matcher_policies.insert(matcher_policies.end(), policy_matchers.size(),
+                            policy);
+  }
+
+  std::vector<const StringMatcher*> matchers;
+  std::vector<size_t> matcher_policies;
+  std::vector<bool> constrained;
+};
+
+}  // namespace
+
+//
+// GrpcAuthorizationEngine::PolicyIndex
+//
+
+GrpcAuthorizationEngine::PolicyIndex::PolicyIndex(
+    const std::vector<const StringMatcher*>& string_matchers,
+    std::vector<size_t> policy_of_matcher, std::vector<bool> is_constrained)
+    : matchers(string_matchers),
+      matcher_policies(std::move(policy_of_matcher)),
+      constrained(std::move(is_constrained)) {
+  for (size_t i = 0; i < constrained.size(); ++i) {
+    if (!constrained[i]) unconstrained_policies.push_back(i);
+  }
+}
+
+std::vector<size_t> GrpcAuthorizationEngine::PolicyIndex::Match(
+    const std::vector<absl::string_view>& values) const {
+  StringMatcherSet::IdList ids;
+  for (absl::string_view value : values) {
+    matchers.Match(value, &ids);
+  }
+  std::vector<size_t> policies;
+  policies.reserve(ids.size());
+  for (size_t id : ids) {
+    policies.push_back(matcher_policies[id]);
+  }
+  std::sort(policies.begin(), policies.end());
+  policies.erase(std::unique(policies.begin(), policies.end()),
+                 policies.end());
+  return policies;
+}
+
+//
+// GrpcAuthorizationEngine
+//
+
 GrpcAuthorizationEngine::GrpcAuthorizationEngine(Rbac policy)
     : action_(policy.action) {
+  PolicyIndexMatchers path_matchers;
+  PolicyIndexMatchers principal_matchers;
+  size_t index = 0;
+  for (const auto& sub_policy : policy.policies) {
+    std::vector<const StringMatcher*> matchers;
+    bool constrained =
+        CollectRequiredMatchers(sub_policy.second.permissions,
+                                Rbac::Permission::RuleType::kPath,
+                                &matchers) ||
+        CollectRequiredMatchers(sub_policy.second.principals,
+                                Rbac::Principal::RuleType::kPath, &matchers);
+    path_matchers.AddPolicy(index, constrained, matchers);
+    matchers.clear();
+    constrained = CollectRequiredMatchers(
+        sub_policy.second.principals, Rbac::Principal::RuleType::kPrincipalName,
+        &matchers);
+    principal_matchers.AddPolicy(index, constrained, matchers);
+    ++index;
+  }
+  path_index_ = PolicyIndex(path_matchers.matchers,
+                            std::move(path_matchers.matcher_policies),
+                            std::move(path_matchers.constrained));
+  principal_index_ = PolicyIndex(principal_matchers.matchers,
+                                 std::move(principal_matchers.matcher_policies),
+                                 std::move(principal_matchers.constrained));
   for (auto& sub_policy : policy.policies) {
     Policy policy;
     policy.name = sub_policy.first;
@@ -35,12 +173,17 @@ GrpcAuthorizationEngine::GrpcAuthorizationEngine(Rbac policy)
 
 GrpcAuthorizationEngine::GrpcAuthorizationEngine(
     GrpcAuthorizationEngine&& other) noexcept
-    : action_(other.action_), policies_(std::move(other.policies_)) {}
+    : action_(other.action_),
+      policies_(std::move(other.policies_)),
+      path_index_(std::move(other.path_index_)),
+      principal_index_(std::move(other.principal_index_)) {}
 
 GrpcAuthorizationEngine& GrpcAuthorizationEngine::operator=(
     GrpcAuthorizationEngine&& other) noexcept {
   action_ = other.action_;
   policies_ = std::move(other.policies_);
+  path_index_ = std::move(other.path_index_);
+  principal_index_ = std::move(other.principal_index_);
   return *this;
 }
 
@@ -48,7 +191,57 @@ AuthorizationEngine::Decision GrpcAuthorizationEngine::Evaluate(
     const EvaluateArgs& args) const {
   Decision decision;
   bool matches = false;
-  for (const auto& policy : policies_) {
+  // Policies constrained by the path and principal indices that may match the
+  // request. Mirrors PathAuthorizationMatcher and
+  // AuthenticatedAuthorizationMatcher.
+  std::vector<size_t> path_policies;
+  if (path_index_.unconstrained_policies.size() < policies_.size()) {
+    absl::string_view path = args.GetPath();
+    if (!path.empty()) path_policies = path_index_.Match({path});
+  }
+  std::vector<size_t> principal_policies;
+  if (principal_index_.unconstrained_policies.size() < policies_.size()) {
+    absl::string_view security_type = args.GetTransportSecurityType();
+    if (security_type == GRPC_SSL_TRANSPORT_SECURITY_TYPE ||
+        security_type == GRPC_TLS_TRANSPORT_SECURITY_TYPE) {
+      std::vector<absl::string_view> principal_names = args.GetUriSans();
+      std::vector<absl::string_view> dns_sans = args.GetDnsSans();
+      principal_names.insert(principal_names.end(), dns_sans.begin(),
+                             dns_sans.end());
+      principal_names.push_back(args.GetSubject());
+      principal_policies = principal_index_.Match(principal_names);
+    }
+  }
+  // Walks the candidates of the smaller index in order, skipping those ruled
+  // out by the other index, so that the first matching policy is the same as
+  // if all policies were walked.
+  const PolicyIndex* index = &path_index_;
+  const std::vector<size_t>* matched = &path_policies;
+  const PolicyIndex* other_index = &principal_index_;
+  const std::vector<size_t>* other_matched = &principal_policies;
+  if (principal_policies.size() +
+          principal_index_.unconstrained_policies.size() <
+      path_policies.size() + path_index_.unconstrained_policies.size()) {
+    std::swap(index, other_index);
+    std::swap(matched, other_matched);
+  }
+  auto matched_it = matched->begin();
+  auto unconstrained_it = index->unconstrained_policies.begin();
+  while (matched_it != matched->end() ||
+         unconstrained_it != index->unconstrained_policies.end()) {
+    size_t candidate;
+    if (unconstrained_it == index->unconstrained_policies.end() ||
+        (matched_it != matched->end() && *matched_it < *unconstrained_it)) {
+      candidate = *matched_it++;
+    } else {
+      candidate = *unconstrained_it++;
+    }
+    if (other_index->constrained[candidate] &&
+        !std::binary_search(other_matched->begin(), other_matched->end(),
+                            candidate)) {
+      continue;
+    }
+    const Policy& policy = policies_[candidate];
     if (policy.matcher->Matches(args)) {
       matches = true;
       decision.matching_policy_name = policy.name;
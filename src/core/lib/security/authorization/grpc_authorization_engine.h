@@ -23,6 +23,10 @@
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
+
+#include "src/core/lib/matchers/matchers.h"
+#include "src/core/lib/matchers/string_matcher_set.h"
 #include "src/core/lib/security/authorization/authorization_engine.h"
 #include "src/core/lib/security/authorization/evaluate_args.h"
 #include "src/core/lib/security/authorization/matchers.h"
@@ -36,6 +40,10 @@ namespace grpc_core {
 // engine type. This engine ignores condition field in RBAC config. It is the
 // caller's responsibility to provide RBAC policies that are compatible with
 // this engine.
+//
+// To avoid walking the matcher trees of every policy on each request, the
+// policies are indexed by the paths and principal names they require, and
+// only the trees of the policies that may match are walked.
 class GrpcAuthorizationEngine : public AuthorizationEngine {
  public:
   // Builds GrpcAuthorizationEngine without any policies.
@@ -60,8 +68,33 @@ class GrpcAuthorizationEngine : public AuthorizationEngine {
     std::string name;
     std::unique_ptr<AuthorizationMatcher> matcher;
   };
+
+  // Index of the policies by one attribute of the request. A policy that is
+  // constrained by the index only matches requests for which the attribute
+  // matches at least one of the matchers added for the policy.
+  struct PolicyIndex {
+    PolicyIndex() = default;
+    PolicyIndex(const std::vector<const StringMatcher*>& string_matchers,
+                std::vector<size_t> policy_of_matcher,
+                std::vector<bool> is_constrained);
+
+    // Returns the sorted constrained policies that may match \a values.
+    std::vector<size_t> Match(
+        const std::vector<absl::string_view>& values) const;
+
+    StringMatcherSet matchers;
+    // Policy of each matcher in matchers.
+    std::vector<size_t> matcher_policies;
+    // Whether each policy is constrained.
+    std::vector<bool> constrained;
+    // Sorted policies that are not constrained.
+    std::vector<size_t> unconstrained_policies;
+  };
+
   Rbac::Action action_;
   std::vector<Policy> policies_;
+  PolicyIndex path_index_;
+  PolicyIndex principal_index_;
 };
 
 }  // namespace grpc_core
@@ -42,11 +42,11 @@ grpc_google_iam_credentials::GetRequestMetadata(
     grpc_core::ClientMetadataHandle initial_metadata,
     const grpc_call_credentials::GetRequestMetadataArgs*) {
   if (token_.has_value()) {
-    initial_metadata->Append(
+    initial_metadata->AppendStaticKey(
         GRPC_IAM_AUTHORIZATION_TOKEN_METADATA_KEY, token_->Ref(),
         [](absl::string_view, const grpc_core::Slice&) { abort(); });
   }
-  initial_metadata->Append(
+  initial_metadata->AppendStaticKey(
       GRPC_IAM_AUTHORITY_SELECTOR_METADATA_KEY, authority_selector_.Ref(),
       [](absl::string_view, const grpc_core::Slice&) { abort(); });
   return grpc_core::Immediate(std::move(initial_metadata));
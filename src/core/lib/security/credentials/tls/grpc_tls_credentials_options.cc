@@ -96,6 +96,12 @@ void grpc_tls_credentials_options_set_crl_directory(
   options->set_crl_directory(crl_directory);
 }
 
+void grpc_tls_credentials_options_set_verification_result_cache_size(
+    grpc_tls_credentials_options* options, size_t cache_size) {
+  GPR_ASSERT(options != nullptr);
+  options->set_verification_result_cache_size(cache_size);
+}
+
 void grpc_tls_credentials_options_set_check_call_host(
     grpc_tls_credentials_options* options, int check_call_host) {
   GPR_ASSERT(options != nullptr);
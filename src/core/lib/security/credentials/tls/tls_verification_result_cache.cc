@@ -0,0 +1,111 @@
+//
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/security/credentials/tls/tls_verification_result_cache.h"
+
+#include <openssl/sha.h>
+
+#include <utility>
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
+
+namespace grpc_core {
+
+TlsVerificationResultCache::TlsVerificationResultCache(size_t max_entries)
+    : max_entries_(max_entries) {
+  GPR_ASSERT(max_entries_ > 0);
+}
+
+std::string TlsVerificationResultCache::ChainHash(
+    absl::string_view cert_chain) {
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const unsigned char*>(cert_chain.data()),
+         cert_chain.size(), digest);
+  return std::string(reinterpret_cast<const char*>(digest), sizeof(digest));
+}
+
+bool TlsVerificationResultCache::IsCacheable(const absl::Status& status) {
+  switch (status.code()) {
+    case absl::StatusCode::kOk:
+    case absl::StatusCode::kUnauthenticated:
+    case absl::StatusCode::kPermissionDenied:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool TlsVerificationResultCache::UpdateVersionLocked(
+    uint64_t trust_bundle_version) {
+  if (trust_bundle_version < trust_bundle_version_) return false;
+  if (trust_bundle_version > trust_bundle_version_) {
+    map_.clear();
+    lru_list_.clear();
+    trust_bundle_version_ = trust_bundle_version;
+  }
+  return true;
+}
+
+absl::optional<absl::Status> TlsVerificationResultCache::Get(
+    absl::string_view cert_chain, uint64_t trust_bundle_version) {
+  std::string key = ChainHash(cert_chain);
+  MutexLock lock(&mu_);
+  if (UpdateVersionLocked(trust_bundle_version)) {
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+      lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+      global_stats().IncrementTlsVerificationCacheHits();
+      return it->second->status;
+    }
+  }
+  global_stats().IncrementTlsVerificationCacheMisses();
+  return absl::nullopt;
+}
+
+void TlsVerificationResultCache::Put(absl::string_view cert_chain,
+                                     uint64_t trust_bundle_version,
+                                     absl::Status status) {
+  if (!IsCacheable(status)) return;
+  std::string key = ChainHash(cert_chain);
+  MutexLock lock(&mu_);
+  if (!UpdateVersionLocked(trust_bundle_version)) return;
+  auto it = map_.find(key);
+  if (it != map_.end()) {
+    it->second->status = std::move(status);
+    lru_list_.splice(lru_list_.begin(), lru_list_, it->second);
+    return;
+  }
+  if (lru_list_.size() == max_entries_) {
+    map_.erase(lru_list_.back().key);
+    lru_list_.pop_back();
+  }
+  lru_list_.push_front(Entry{std::move(key), std::move(status)});
+  map_.emplace(lru_list_.front().key, lru_list_.begin());
+}
+
+size_t TlsVerificationResultCache::size() const {
+  MutexLock lock(&mu_);
+  return lru_list_.size();
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,100 @@
+//
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+
+#ifndef GRPC_CORE_LIB_SECURITY_CREDENTIALS_TLS_TLS_VERIFICATION_RESULT_CACHE_H
+#define GRPC_CORE_LIB_SECURITY_CREDENTIALS_TLS_TLS_VERIFICATION_RESULT_CACHE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+#include "src/core/lib/gprpp/sync.h"
+
+namespace grpc_core {
+
+// A bounded LRU cache of the results of grpc_tls_certificate_verifier, keyed
+// by the SHA-256 hash of the peer's certificate chain.
+//
+// Every entry belongs to a version of the trust bundle, which the caller
+// bumps whenever the root certificates change. Looking up or inserting with a
+// newer version drops all entries of older versions, and results computed
+// under an older version are never inserted.
+//
+// The cache only replaces the custom verifier. The TLS stack still verifies
+// the chain against the trust bundle on every handshake, so certificates that
+// have expired or been revoked since they were cached are still rejected.
+class TlsVerificationResultCache {
+ public:
+  explicit TlsVerificationResultCache(size_t max_entries);
+
+  TlsVerificationResultCache(const TlsVerificationResultCache&) = delete;
+  TlsVerificationResultCache& operator=(const TlsVerificationResultCache&) =
+      delete;
+
+  // Returns the cached result for \a cert_chain, or nullopt if there is none
+  // for \a trust_bundle_version.
+  absl::optional<absl::Status> Get(absl::string_view cert_chain,
+                                   uint64_t trust_bundle_version);
+
+  // Caches \a status as the result for \a cert_chain, evicting the least
+  // recently used entry if the cache is full. Only successes and definitive
+  // rejections (UNAUTHENTICATED, PERMISSION_DENIED) are cached: any other
+  // error, such as a cancelled request or a verifier backend that is
+  // unavailable, may not recur, so it is dropped and the chain is verified
+  // again next time.
+  void Put(absl::string_view cert_chain, uint64_t trust_bundle_version,
+           absl::Status status);
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    absl::Status status;
+  };
+
+  static std::string ChainHash(absl::string_view cert_chain);
+  static bool IsCacheable(const absl::Status& status);
+
+  // Drops all entries if \a trust_bundle_version is newer than the version of
+  // the cached entries. Returns false if it is older.
+  bool UpdateVersionLocked(uint64_t trust_bundle_version)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const size_t max_entries_;
+  mutable Mutex mu_;
+  uint64_t trust_bundle_version_ ABSL_GUARDED_BY(mu_) = 0;
+  // Most recently used entries at the front.
+  std::list<Entry> lru_list_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> map_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_SECURITY_CREDENTIALS_TLS_TLS_VERIFICATION_RESULT_CACHE_H
@@ -586,6 +586,11 @@ TlsServerSecurityConnector::TlsServerSecurityConnector(
     tls_session_key_logger_ =
         tsi::TlsSessionKeyLoggerCache::Get(tls_session_key_log_file_path);
   }
+  if (options_->certificate_verifier() != nullptr &&
+      options_->verification_result_cache_size() > 0) {
+    verification_result_cache_ = std::make_unique<TlsVerificationResultCache>(
+        options_->verification_result_cache_size());
+  }
   // Create a watcher.
   auto watcher_ptr = std::make_unique<TlsServerCertificateWatcher>(this);
   certificate_watcher_ = watcher_ptr.get();
@@ -648,8 +653,13 @@ void TlsServerSecurityConnector::check_peer(
   *auth_context =
       grpc_ssl_peer_to_auth_context(&peer, GRPC_TLS_TRANSPORT_SECURITY_TYPE);
   if (options_->certificate_verifier() != nullptr) {
-    auto* pending_request =
-        new ServerPendingVerifierRequest(Ref(), on_peer_checked, peer);
+    uint64_t trust_bundle_version;
+    {
+      MutexLock lock(&mu_);
+      trust_bundle_version = trust_bundle_version_;
+    }
+    auto* pending_request = new ServerPendingVerifierRequest(
+        Ref(), on_peer_checked, peer, trust_bundle_version);
     {
       MutexLock lock(&verifier_request_map_mu_);
       pending_verifier_requests_.emplace(on_peer_checked, pending_request);
@@ -704,6 +714,11 @@ void TlsServerSecurityConnector::TlsServerCertificateWatcher::
   GPR_ASSERT(security_connector_ != nullptr);
   MutexLock lock(&security_connector_->mu_);
   if (root_certs.has_value()) {
+    // The distributor also reports unchanged root certs along with identity
+    // updates, which should not drop the cached verification results.
+    if (security_connector_->pem_root_certs_ != root_certs) {
+      ++security_connector_->trust_bundle_version_;
+    }
     security_connector_->pem_root_certs_ = root_certs;
   }
   if (key_cert_pairs.has_value()) {
@@ -745,9 +760,11 @@ void TlsServerSecurityConnector::TlsServerCertificateWatcher::OnError(
 TlsServerSecurityConnector::ServerPendingVerifierRequest::
     ServerPendingVerifierRequest(
         RefCountedPtr<TlsServerSecurityConnector> security_connector,
-        grpc_closure* on_peer_checked, tsi_peer peer)
+        grpc_closure* on_peer_checked, tsi_peer peer,
+        uint64_t trust_bundle_version)
     : security_connector_(std::move(security_connector)),
-      on_peer_checked_(on_peer_checked) {
+      on_peer_checked_(on_peer_checked),
+      trust_bundle_version_(trust_bundle_version) {
   PendingVerifierRequestInit(nullptr, peer, &request_);
   tsi_peer_destruct(&peer);
 }
@@ -758,6 +775,20 @@ TlsServerSecurityConnector::ServerPendingVerifierRequest::
 }
 
 void TlsServerSecurityConnector::ServerPendingVerifierRequest::Start() {
+  // Peers without a certificate are never cached, since they would all share
+  // the same key.
+  TlsVerificationResultCache* cache =
+      security_connector_->verification_result_cache_.get();
+  const char* cert_chain = request_.peer_info.peer_cert_full_chain;
+  if (cache != nullptr && cert_chain != nullptr) {
+    absl::optional<absl::Status> cached_status =
+        cache->Get(cert_chain, trust_bundle_version_);
+    if (cached_status.has_value()) {
+      OnVerifyDone(false, std::move(*cached_status));
+      return;
+    }
+    cache_result_ = true;
+  }
   absl::Status sync_status;
   grpc_tls_certificate_verifier* verifier =
       security_connector_->options_->certificate_verifier();
@@ -776,6 +807,13 @@ void TlsServerSecurityConnector::ServerPendingVerifierRequest::OnVerifyDone(
     MutexLock lock(&security_connector_->verifier_request_map_mu_);
     security_connector_->pending_verifier_requests_.erase(on_peer_checked_);
   }
+  // The cache keeps only successes and definitive rejections, so that a
+  // cancelled request or a transient verifier failure is retried.
+  if (cache_result_) {
+    security_connector_->verification_result_cache_->Put(
+        request_.peer_info.peer_cert_full_chain, trust_bundle_version_,
+        status);
+  }
   grpc_error_handle error;
   if (!status.ok()) {
     error = GRPC_ERROR_CREATE(
@@ -21,7 +21,10 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <stdint.h>
+
 #include <map>
+#include <memory>
 #include <string>
 
 #include "absl/base/thread_annotations.h"
@@ -41,6 +44,7 @@
 #include "src/core/lib/iomgr/iomgr_fwd.h"
 #include "src/core/lib/promise/arena_promise.h"
 #include "src/core/lib/security/credentials/tls/grpc_tls_certificate_distributor.h"
+#include "src/core/lib/security/credentials/tls/tls_verification_result_cache.h"
 #include "src/core/lib/security/security_connector/security_connector.h"
 #include "src/core/lib/security/security_connector/ssl_utils.h"
 #include "src/core/lib/transport/handshaker.h"
@@ -215,6 +219,10 @@ class TlsServerSecurityConnector final : public grpc_server_security_connector {
     return pem_key_cert_pair_list_;
   }
 
+  TlsVerificationResultCache* VerificationResultCacheForTesting() {
+    return verification_result_cache_.get();
+  }
+
  private:
   // A watcher that watches certificate updates from
   // grpc_tls_certificate_distributor. It will never outlive
@@ -242,7 +250,8 @@ class TlsServerSecurityConnector final : public grpc_server_security_connector {
    public:
     ServerPendingVerifierRequest(
         RefCountedPtr<TlsServerSecurityConnector> security_connector,
-        grpc_closure* on_peer_checked, tsi_peer peer);
+        grpc_closure* on_peer_checked, tsi_peer peer,
+        uint64_t trust_bundle_version);
 
     ~ServerPendingVerifierRequest();
 
@@ -257,6 +266,11 @@ class TlsServerSecurityConnector final : public grpc_server_security_connector {
     RefCountedPtr<TlsServerSecurityConnector> security_connector_;
     grpc_tls_custom_verification_check_request request_;
     grpc_closure* on_peer_checked_;
+    // The version of the root certificates when the peer was checked.
+    uint64_t trust_bundle_version_;
+    // Whether the result of the verifier should be added to
+    // |verification_result_cache_|.
+    bool cache_result_ = false;
   };
 
   // Updates |server_handshaker_factory_| when the certificates that
@@ -276,9 +290,14 @@ class TlsServerSecurityConnector final : public grpc_server_security_connector {
   absl::optional<absl::string_view> pem_root_certs_ ABSL_GUARDED_BY(mu_);
   absl::optional<PemKeyCertPairList> pem_key_cert_pair_list_
       ABSL_GUARDED_BY(mu_);
+  // Incremented whenever |pem_root_certs_| is updated, so that results cached
+  // under the old root certificates are dropped.
+  uint64_t trust_bundle_version_ ABSL_GUARDED_BY(mu_) = 0;
   RefCountedPtr<TlsSessionKeyLogger> tls_session_key_logger_;
   std::map<grpc_closure* /*on_peer_checked*/, ServerPendingVerifierRequest*>
       pending_verifier_requests_ ABSL_GUARDED_BY(verifier_request_map_mu_);
+  // Null unless a cache size is set in |options_|.
+  std::unique_ptr<TlsVerificationResultCache> verification_result_cache_;
 };
 
 }  // namespace grpc_core
@@ -27,6 +27,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/base/attributes.h"
 #include "absl/status/status.h"
@@ -35,6 +36,8 @@
 #include "absl/types/optional.h"
 
 #include <grpc/grpc_security.h>
+#include <grpc/event_engine/memory_allocator.h>
+#include <grpc/event_engine/memory_request.h>
 #include <grpc/grpc_security_constants.h>
 #include <grpc/slice.h>
 #include <grpc/slice_buffer.h>
@@ -44,6 +47,8 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/channelz.h"
 #include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
 #include "src/core/lib/gprpp/debug_location.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/gprpp/status_helper.h"
@@ -55,9 +60,12 @@
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/iomgr_fwd.h"
 #include "src/core/lib/iomgr/tcp_server.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
 #include "src/core/lib/security/context/security_context.h"
 #include "src/core/lib/security/transport/secure_endpoint.h"
 #include "src/core/lib/security/transport/tsi_error.h"
+#include "src/core/lib/security/transport/tsi_handshake_executor.h"
 #include "src/core/lib/slice/slice.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/transport/handshaker.h"
@@ -67,6 +75,10 @@
 
 #define GRPC_INITIAL_HANDSHAKE_BUFFER_SIZE 256
 
+// Memory charged to the resource quota for each handshake step waiting on
+// the handshake executor, roughly what a TLS handshaker holds mid-handshake.
+#define GRPC_QUEUED_HANDSHAKE_STEP_MEMORY (16 * 1024)
+
 namespace grpc_core {
 
 namespace {
@@ -86,6 +98,10 @@ class SecurityHandshaker : public Handshaker {
  private:
   grpc_error_handle DoHandshakerNextLocked(const unsigned char* bytes_received,
                                            size_t bytes_received_size);
+  grpc_error_handle RunHandshakerNextLocked(
+      const unsigned char* bytes_received, size_t bytes_received_size);
+  grpc_error_handle OffloadHandshakerNextLocked(
+      const unsigned char* bytes_received, size_t bytes_received_size);
 
   grpc_error_handle OnHandshakeNextDoneLocked(
       tsi_result result, const unsigned char* bytes_to_send,
@@ -105,6 +121,8 @@ class SecurityHandshaker : public Handshaker {
       size_t bytes_to_send_size, tsi_handshaker_result* handshaker_result);
   static void OnPeerCheckedFn(void* arg, grpc_error_handle error);
   void OnPeerCheckedInner(grpc_error_handle error);
+  bool MaybeEnableKernelTxOffloadLocked(
+      tsi_zero_copy_grpc_protector* protector);
   size_t MoveReadBufferIntoHandshakeBuffer();
   grpc_error_handle CheckPeerLocked();
 
@@ -132,7 +150,15 @@ class SecurityHandshaker : public Handshaker {
   RefCountedPtr<grpc_auth_context> auth_context_;
   tsi_handshaker_result* handshaker_result_ = nullptr;
   size_t max_frame_size_ = 0;
+  bool enable_kernel_tx_offload_;
   std::string tsi_handshake_error_;
+  // Set if GRPC_ARG_EXPERIMENTAL_OFFLOAD_TSI_HANDSHAKES is enabled, in which
+  // case the steps of the TSI handshaker run there.
+  TsiHandshakeExecutor* handshake_executor_ = nullptr;
+  // Charged for the steps queued on handshake_executor_.  Null if there is
+  // no executor or no resource quota in the channel args.
+  MemoryQuotaRefPtr memory_quota_;
+  MemoryAllocator memory_allocator_;
 };
 
 SecurityHandshaker::SecurityHandshaker(tsi_handshaker* handshaker,
@@ -144,10 +170,22 @@ SecurityHandshaker::SecurityHandshaker(tsi_handshaker* handshaker,
       handshake_buffer_(
           static_cast<uint8_t*>(gpr_malloc(handshake_buffer_size_))),
       max_frame_size_(
-          std::max(0, args.GetInt(GRPC_ARG_TSI_MAX_FRAME_SIZE).value_or(0))) {
+          std::max(0, args.GetInt(GRPC_ARG_TSI_MAX_FRAME_SIZE).value_or(0))),
+      enable_kernel_tx_offload_(
+          args.GetBool(GRPC_ARG_EXPERIMENTAL_ENABLE_KTLS).value_or(false)) {
   grpc_slice_buffer_init(&outgoing_);
   GRPC_CLOSURE_INIT(&on_peer_checked_, &SecurityHandshaker::OnPeerCheckedFn,
                     this, grpc_schedule_on_exec_ctx);
+  if (args.GetBool(GRPC_ARG_EXPERIMENTAL_OFFLOAD_TSI_HANDSHAKES)
+          .value_or(false)) {
+    handshake_executor_ = TsiHandshakeExecutor::Get();
+    auto* resource_quota = args.GetObject<ResourceQuota>();
+    if (resource_quota != nullptr) {
+      memory_quota_ = resource_quota->memory_quota();
+      memory_allocator_ =
+          memory_quota_->CreateMemoryAllocator("security_handshaker");
+    }
+  }
 }
 
 SecurityHandshaker::~SecurityHandshaker() {
@@ -247,6 +285,29 @@ MakeChannelzSecurityFromAuthContext(grpc_auth_context* auth_context) {
 
 }  // namespace
 
+// Lets the kernel encrypt outgoing records if it can. Otherwise the
+// protector keeps doing it in user space. Returns false, having destroyed
+// the protector and failed the handshake, if the attempt left the connection
+// unusable.
+bool SecurityHandshaker::MaybeEnableKernelTxOffloadLocked(
+    tsi_zero_copy_grpc_protector* protector) {
+  int fd = grpc_endpoint_get_fd(args_->endpoint);
+  tsi_result result =
+      fd < 0 ? TSI_UNIMPLEMENTED
+             : tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(protector,
+                                                                     fd);
+  if (result == TSI_OK) return true;
+  if (result == TSI_UNIMPLEMENTED || result == TSI_FAILED_PRECONDITION) {
+    gpr_log(GPR_DEBUG, "Security handshaker %p: kTLS not enabled on fd %d: %s",
+            this, fd, tsi_result_to_string(result));
+    return true;
+  }
+  tsi_zero_copy_grpc_protector_destroy(protector);
+  HandshakeFailedLocked(grpc_set_tsi_error_result(
+      GRPC_ERROR_CREATE("Enabling kTLS transmission failed"), result));
+  return false;
+}
+
 void SecurityHandshaker::OnPeerCheckedInner(grpc_error_handle error) {
   MutexLock lock(&mu_);
   if (!error.ok() || is_shutdown_) {
@@ -292,8 +353,30 @@ void SecurityHandshaker::OnPeerCheckedInner(grpc_error_handle error) {
             result));
         return;
       }
+      if (enable_kernel_tx_offload_ &&
+          !MaybeEnableKernelTxOffloadLocked(zero_copy_protector)) {
+        return;
+      }
       break;
     case TSI_FRAME_PROTECTOR_NORMAL:
+      // kTLS needs a zero-copy protector, which the result may provide even
+      // though it prefers the normal one.
+      if (enable_kernel_tx_offload_) {
+        result = tsi_handshaker_result_create_zero_copy_grpc_protector(
+            handshaker_result_,
+            max_frame_size_ == 0 ? nullptr : &max_frame_size_,
+            &zero_copy_protector);
+        if (result == TSI_OK) {
+          if (!MaybeEnableKernelTxOffloadLocked(zero_copy_protector)) return;
+          break;
+        }
+        if (result != TSI_UNIMPLEMENTED) {
+          HandshakeFailedLocked(grpc_set_tsi_error_result(
+              GRPC_ERROR_CREATE("Zero-copy frame protector creation failed"),
+              result));
+          return;
+        }
+      }
       // Create normal frame protector.
       result = tsi_handshaker_result_create_frame_protector(
           handshaker_result_, max_frame_size_ == 0 ? nullptr : &max_frame_size_,
@@ -446,6 +529,14 @@ void SecurityHandshaker::OnHandshakeNextDoneGrpcWrapper(
 
 grpc_error_handle SecurityHandshaker::DoHandshakerNextLocked(
     const unsigned char* bytes_received, size_t bytes_received_size) {
+  if (handshake_executor_ != nullptr) {
+    return OffloadHandshakerNextLocked(bytes_received, bytes_received_size);
+  }
+  return RunHandshakerNextLocked(bytes_received, bytes_received_size);
+}
+
+grpc_error_handle SecurityHandshaker::RunHandshakerNextLocked(
+    const unsigned char* bytes_received, size_t bytes_received_size) {
   // Invoke TSI handshaker.
   const unsigned char* bytes_to_send = nullptr;
   size_t bytes_to_send_size = 0;
@@ -465,6 +556,49 @@ grpc_error_handle SecurityHandshaker::DoHandshakerNextLocked(
                                    hs_result);
 }
 
+grpc_error_handle SecurityHandshaker::OffloadHandshakerNextLocked(
+    const unsigned char* bytes_received, size_t bytes_received_size) {
+  // Admission control: new work is refused rather than queued when the
+  // process is short of memory, the same way the TCP server stops accepting
+  // connections.
+  if (memory_quota_ != nullptr && memory_quota_->IsMemoryPressureHigh()) {
+    global_stats().IncrementTsiHandshakesRejected();
+    return GRPC_ERROR_CREATE(
+        "Security handshake rejected: memory pressure is high");
+  }
+  MemoryAllocator::Reservation reservation;
+  if (memory_quota_ != nullptr) {
+    reservation = memory_allocator_.MakeReservation(
+        GRPC_QUEUED_HANDSHAKE_STEP_MEMORY);
+  }
+  // The caller's ref is handed to the step, as it would be to the callback
+  // of an asynchronous TSI handshaker.  bytes_received points into
+  // handshake_buffer_, which is not touched again until the step is done.
+  // The reservation is released when the step is destroyed.
+  bool queued = handshake_executor_->Run(
+      [this, bytes_received, bytes_received_size,
+       reservation = std::move(reservation)]() {
+        ExecCtx exec_ctx;
+        RefCountedPtr<SecurityHandshaker> h(this);
+        MutexLock lock(&mu_);
+        grpc_error_handle error =
+            is_shutdown_
+                ? GRPC_ERROR_CREATE("Handshaker shutdown")
+                : RunHandshakerNextLocked(bytes_received, bytes_received_size);
+        if (!error.ok()) {
+          HandshakeFailedLocked(error);
+        } else {
+          h.release();  // Avoid unref
+        }
+      });
+  if (!queued) {
+    global_stats().IncrementTsiHandshakesRejected();
+    return GRPC_ERROR_CREATE(
+        "Security handshake rejected: handshake executor queue is full");
+  }
+  return absl::OkStatus();
+}
+
 // This callback might be run inline while we are still holding on to the mutex,
 // so schedule OnHandshakeDataReceivedFromPeerFn on ExecCtx to avoid a deadlock.
 void SecurityHandshaker::OnHandshakeDataReceivedFromPeerFnScheduler(
@@ -0,0 +1,108 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/security/transport/tsi_handshake_executor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Bounds the queue of the process-wide executor.  A handshake has at most
+// one step queued, so this is also the number of handshakes that may wait.
+constexpr size_t kMaxQueuedStepsPerThread = 256;
+
+}  // namespace
+
+TsiHandshakeExecutor* TsiHandshakeExecutor::Get() {
+  static TsiHandshakeExecutor* executor = []() {
+    const size_t num_threads = std::max<size_t>(1, gpr_cpu_num_cores() / 2);
+    return new TsiHandshakeExecutor(num_threads,
+                                    num_threads * kMaxQueuedStepsPerThread);
+  }();
+  return executor;
+}
+
+TsiHandshakeExecutor::TsiHandshakeExecutor(size_t num_threads,
+                                           size_t max_queued_steps)
+    : max_queued_steps_(max_queued_steps) {
+  GPR_ASSERT(num_threads > 0);
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back("tsi_handshake_executor", &ThreadMain, this);
+    threads_.back().Start();
+  }
+}
+
+TsiHandshakeExecutor::~TsiHandshakeExecutor() {
+  {
+    MutexLock lock(&mu_);
+    shutdown_ = true;
+  }
+  cv_.SignalAll();
+  for (Thread& thread : threads_) {
+    thread.Join();
+  }
+}
+
+bool TsiHandshakeExecutor::Run(absl::AnyInvocable<void()> step) {
+  size_t queue_depth;
+  {
+    MutexLock lock(&mu_);
+    if (shutdown_ || queue_.size() >= max_queued_steps_) return false;
+    queue_depth = queue_.size();
+    queue_.push_back(std::move(step));
+  }
+  cv_.Signal();
+  global_stats().IncrementTsiHandshakeStepsOffloaded();
+  global_stats().IncrementTsiHandshakeQueueDepth(queue_depth);
+  return true;
+}
+
+size_t TsiHandshakeExecutor::queue_depth() {
+  MutexLock lock(&mu_);
+  return queue_.size();
+}
+
+void TsiHandshakeExecutor::ThreadMain(void* arg) {
+  TsiHandshakeExecutor* executor = static_cast<TsiHandshakeExecutor*>(arg);
+  while (true) {
+    absl::AnyInvocable<void()> step;
+    {
+      MutexLock lock(&executor->mu_);
+      while (executor->queue_.empty() && !executor->shutdown_) {
+        executor->cv_.Wait(&executor->mu_);
+      }
+      // Drain the queue before exiting, since each step owns a handshake.
+      if (executor->queue_.empty()) return;
+      step = std::move(executor->queue_.front());
+      executor->queue_.pop_front();
+    }
+    step();
+  }
+}
+
+}  // namespace grpc_core
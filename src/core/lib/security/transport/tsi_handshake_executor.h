@@ -0,0 +1,75 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_LIB_SECURITY_TRANSPORT_TSI_HANDSHAKE_EXECUTOR_H
+#define GRPC_CORE_LIB_SECURITY_TRANSPORT_TSI_HANDSHAKE_EXECUTOR_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#include <deque>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+
+namespace grpc_core {
+
+// Runs TSI handshake steps on a fixed number of dedicated threads, so that
+// the asymmetric crypto of many concurrent handshakes does not hold up the
+// pollers that also serve established connections.  The number of steps
+// waiting for a thread is bounded.
+class TsiHandshakeExecutor {
+ public:
+  // Returns the process-wide executor, which is created on first use with
+  // half as many threads as there are cores.  It is never destroyed.
+  static TsiHandshakeExecutor* Get();
+
+  TsiHandshakeExecutor(size_t num_threads, size_t max_queued_steps);
+  // Waits for the queued steps to run.
+  ~TsiHandshakeExecutor();
+
+  TsiHandshakeExecutor(const TsiHandshakeExecutor&) = delete;
+  TsiHandshakeExecutor& operator=(const TsiHandshakeExecutor&) = delete;
+
+  // Queues \a step to run on one of the executor's threads.  Returns false
+  // without queueing it if max_queued_steps steps are already waiting.
+  // Must be called with an ExecCtx, for the stats.
+  bool Run(absl::AnyInvocable<void()> step);
+
+  // Number of steps waiting for a thread.
+  size_t queue_depth();
+
+  size_t num_threads() const { return threads_.size(); }
+
+ private:
+  static void ThreadMain(void* arg);
+
+  const size_t max_queued_steps_;
+  Mutex mu_;
+  CondVar cv_;
+  std::deque<absl::AnyInvocable<void()>> queue_ ABSL_GUARDED_BY(mu_);
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  std::vector<Thread> threads_;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_SECURITY_TRANSPORT_TSI_HANDSHAKE_EXECUTOR_H
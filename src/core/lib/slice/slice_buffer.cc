@@ -403,6 +403,19 @@ void grpc_slice_buffer_copy_first_into_buffer(grpc_slice_buffer* src, size_t n,
   }
 }
 
+void grpc_slice_buffer_discard_first(grpc_slice_buffer* sb, size_t n) {
+  GPR_ASSERT(sb->length >= n);
+  while (n > 0) {
+    const size_t slice_len = GRPC_SLICE_LENGTH(sb->slices[0]);
+    if (slice_len > n) {
+      grpc_slice_buffer_sub_first(sb, n, slice_len);
+      return;
+    }
+    grpc_slice_buffer_remove_first(sb);
+    n -= slice_len;
+  }
+}
+
 void grpc_slice_buffer_trim_end(grpc_slice_buffer* sb, size_t n,
                                 grpc_slice_buffer* garbage) {
   GPR_ASSERT(n <= sb->length);
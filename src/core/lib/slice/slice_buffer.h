@@ -159,4 +159,7 @@ class SliceBuffer {
 void grpc_slice_buffer_copy_first_into_buffer(grpc_slice_buffer* src, size_t n,
                                               void* dst);
 
+// Remove the first n bytes of sb, unreffing slices that are removed entirely.
+void grpc_slice_buffer_discard_first(grpc_slice_buffer* sb, size_t n);
+
 #endif  // GRPC_CORE_LIB_SLICE_SLICE_BUFFER_H
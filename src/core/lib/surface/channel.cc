@@ -50,6 +50,7 @@
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/iomgr/error.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/resource_quota/arena.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
 #include "src/core/lib/resource_quota/resource_quota.h"
 #include "src/core/lib/surface/api_trace.h"
@@ -63,6 +64,18 @@
 
 namespace grpc_core {
 
+namespace {
+
+std::unique_ptr<ArenaStoragePool> MakeCallArenaPool(const ChannelArgs& args) {
+  const int pool_size =
+      args.GetInt(GRPC_ARG_EXPERIMENTAL_CALL_ARENA_POOL_SIZE).value_or(0);
+  if (pool_size <= 0) return nullptr;
+  return std::make_unique<ArenaStoragePool>(
+      pool_size, args.GetObject<ResourceQuota>()->memory_quota());
+}
+
+}  // namespace
+
 Channel::Channel(bool is_client, bool is_promising, std::string target,
                  const ChannelArgs& channel_args,
                  grpc_compression_options compression_options,
@@ -76,6 +89,7 @@ Channel::Channel(bool is_client, bool is_promising, std::string target,
       allocator_(channel_args.GetObject<ResourceQuota>()
                      ->memory_quota()
                      ->CreateMemoryOwner(target)),
+      call_arena_pool_(MakeCallArenaPool(channel_args)),
       target_(std::move(target)),
       channel_stack_(std::move(channel_stack)) {
   // We need to make sure that grpc_shutdown() does not shut things down
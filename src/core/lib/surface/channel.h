@@ -26,6 +26,7 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -52,6 +53,7 @@
 #include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/gprpp/time.h"
 #include "src/core/lib/iomgr/iomgr_fwd.h"
+#include "src/core/lib/resource_quota/arena.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
 #include "src/core/lib/slice/slice.h"
 #include "src/core/lib/surface/channel_stack_type.h"
@@ -141,6 +143,9 @@ class Channel : public RefCounted<Channel>,
   void UpdateCallSizeEstimate(size_t size);
   absl::string_view target() const { return target_; }
   MemoryAllocator* allocator() { return &allocator_; }
+  // Storage to recycle between calls, or nullptr if the channel doesn't pool
+  // call arenas (see GRPC_ARG_EXPERIMENTAL_CALL_ARENA_POOL_SIZE).
+  ArenaStoragePool* call_arena_pool() { return call_arena_pool_.get(); }
   bool is_client() const { return is_client_; }
   bool is_promising() const { return is_promising_; }
   RegisteredCall* RegisterCall(const char* method, const char* host);
@@ -172,6 +177,7 @@ class Channel : public RefCounted<Channel>,
   CallRegistrationTable registration_table_;
   RefCountedPtr<channelz::ChannelNode> channelz_node_;
   MemoryAllocator allocator_;
+  const std::unique_ptr<ArenaStoragePool> call_arena_pool_;
   std::string target_;
   const RefCountedPtr<grpc_channel_stack> channel_stack_;
 };
@@ -26,7 +26,7 @@
 #include <atomic>
 #include <list>
 #include <new>
-#include <queue>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -192,8 +192,17 @@ class Server::RequestMatcherInterface {
 // The RealRequestMatcher is an implementation of RequestMatcherInterface that
 // actually uses all the features of RequestMatcherInterface: expecting the
 // application to explicitly request RPCs and then matching those to incoming
-// RPCs, along with a slow path by which incoming RPCs are put on a locked
-// pending list if they aren't able to be matched to an application request.
+// RPCs, along with a slow path by which incoming RPCs are queued as pending if
+// they aren't able to be matched to an application request.
+//
+// Matching takes no server-wide lock. balance_ counts requested calls minus
+// pending calls: an arriving request or call first updates it, and if that
+// shows a counterpart has been (or is about to be) queued, the arrival claims
+// and pops that counterpart; otherwise it queues itself. Requests are queued
+// per CQ and an incoming call steals from whichever CQ has one, starting at its
+// channel's CQ. Pops only contend with other pops of the same queue. A claimed
+// counterpart may still be mid-push; the pop spins for it briefly and then
+// waits on a mutex, which pushes only take when such a waiter exists.
 class Server::RealRequestMatcher : public RequestMatcherInterface {
  public:
   explicit RealRequestMatcher(Server* server)
@@ -206,21 +215,18 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
   }
 
   void ZombifyPending() override {
-    while (!pending_.empty()) {
-      CallData* calld = pending_.front();
+    while (TryClaimPending()) {
+      CallData* calld = PopPending();
       calld->SetState(CallData::CallState::ZOMBIED);
       calld->KillZombie();
-      pending_.pop();
     }
   }
 
   void KillRequests(grpc_error_handle error) override {
-    for (size_t i = 0; i < requests_per_cq_.size(); i++) {
-      RequestedCall* rc;
-      while ((rc = reinterpret_cast<RequestedCall*>(
-                  requests_per_cq_[i].Pop())) != nullptr) {
-        server_->FailCall(i, rc, error);
-      }
+    while (TryClaimRequest()) {
+      size_t cq_idx;
+      RequestedCall* rc = PopRequest(0, &cq_idx);
+      server_->FailCall(cq_idx, rc, error);
     }
   }
 
@@ -230,77 +236,35 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
 
   void RequestCallWithPossiblePublish(size_t request_queue_index,
                                       RequestedCall* call) override {
-    if (requests_per_cq_[request_queue_index].Push(&call->mpscq_node)) {
-      // this was the first queued request: we need to lock and start
-      // matching calls
-      struct PendingCall {
-        RequestedCall* rc = nullptr;
-        CallData* calld;
-      };
-      auto pop_next_pending = [this, request_queue_index] {
-        PendingCall pending_call;
-        {
-          MutexLock lock(&server_->mu_call_);
-          if (!pending_.empty()) {
-            pending_call.rc = reinterpret_cast<RequestedCall*>(
-                requests_per_cq_[request_queue_index].Pop());
-            if (pending_call.rc != nullptr) {
-              pending_call.calld = pending_.front();
-              pending_.pop();
-            }
-          }
-        }
-        return pending_call;
-      };
-      while (true) {
-        PendingCall next_pending = pop_next_pending();
-        if (next_pending.rc == nullptr) break;
-        if (!next_pending.calld->MaybeActivate()) {
-          // Zombied Call
-          next_pending.calld->KillZombie();
-        } else {
-          next_pending.calld->Publish(request_queue_index, next_pending.rc);
-        }
+    while (true) {
+      if (balance_.fetch_add(1, std::memory_order_acq_rel) >= 0) {
+        // No call is waiting: leave the request for the next one.
+        requests_per_cq_[request_queue_index].Push(&call->mpscq_node);
+        WakeWaiters();
+        return;
+      }
+      CallData* calld = PopPending();
+      if (calld->MaybeActivate()) {
+        calld->Publish(request_queue_index, call);
+        return;
       }
+      // Zombied call: the request is still unmatched, so go around again.
+      calld->KillZombie();
     }
   }
 
   void MatchOrQueue(size_t start_request_queue_index,
                     CallData* calld) override {
-    for (size_t i = 0; i < requests_per_cq_.size(); i++) {
-      size_t cq_idx = (start_request_queue_index + i) % requests_per_cq_.size();
-      RequestedCall* rc =
-          reinterpret_cast<RequestedCall*>(requests_per_cq_[cq_idx].TryPop());
-      if (rc != nullptr) {
-        calld->SetState(CallData::CallState::ACTIVATED);
-        calld->Publish(cq_idx, rc);
-        return;
-      }
-    }
-    // No cq to take the request found; queue it on the slow list.
-    // We need to ensure that all the queues are empty.  We do this under
-    // the server mu_call_ lock to ensure that if something is added to
-    // an empty request queue, it will block until the call is actually
-    // added to the pending list.
-    RequestedCall* rc = nullptr;
-    size_t cq_idx = 0;
-    size_t loop_count;
-    {
-      MutexLock lock(&server_->mu_call_);
-      for (loop_count = 0; loop_count < requests_per_cq_.size(); loop_count++) {
-        cq_idx =
-            (start_request_queue_index + loop_count) % requests_per_cq_.size();
-        rc = reinterpret_cast<RequestedCall*>(requests_per_cq_[cq_idx].Pop());
-        if (rc != nullptr) {
-          break;
-        }
-      }
-      if (rc == nullptr) {
-        calld->SetState(CallData::CallState::PENDING);
-        pending_.push(calld);
-        return;
-      }
+    if (balance_.fetch_sub(1, std::memory_order_acq_rel) <= 0) {
+      // No request is available; queue the call on the slow list. The state
+      // must be set before the push makes the call visible to requests.
+      calld->SetState(CallData::CallState::PENDING);
+      pending_.Push(calld->pending_node());
+      WakeWaiters();
+      return;
     }
+    size_t cq_idx;
+    RequestedCall* rc = PopRequest(start_request_queue_index, &cq_idx);
     calld->SetState(CallData::CallState::ACTIVATED);
     calld->Publish(cq_idx, rc);
   }
@@ -308,9 +272,106 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
   Server* server() const override { return server_; }
 
  private:
+  // Claim a queued request (or pending call) without queueing anything if
+  // there is none. Used when draining at shutdown.
+  bool TryClaimRequest() {
+    intptr_t balance = balance_.load(std::memory_order_relaxed);
+    while (balance > 0) {
+      if (balance_.compare_exchange_weak(balance, balance - 1,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  bool TryClaimPending() {
+    intptr_t balance = balance_.load(std::memory_order_relaxed);
+    while (balance < 0) {
+      if (balance_.compare_exchange_weak(balance, balance + 1,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Pop a request that has already been claimed via balance_, searching the
+  // CQs cyclically from start_request_queue_index. The first pass only tries
+  // each CQ's lock, later passes wait for it.
+  RequestedCall* PopRequest(size_t start_request_queue_index, size_t* cq_idx) {
+    const size_t num_queues = requests_per_cq_.size();
+    bool try_only = true;
+    return PopClaimed([&]() -> RequestedCall* {
+      for (size_t i = 0; i < num_queues; i++) {
+        *cq_idx = (start_request_queue_index + i) % num_queues;
+        LockedMultiProducerSingleConsumerQueue& queue =
+            requests_per_cq_[*cq_idx];
+        RequestedCall* rc = reinterpret_cast<RequestedCall*>(
+            try_only ? queue.TryPop() : queue.Pop());
+        if (rc != nullptr) return rc;
+      }
+      try_only = false;
+      return nullptr;
+    });
+  }
+
+  // Pop a pending call that has already been claimed via balance_.
+  CallData* PopPending() {
+    return PopClaimed([this]() -> CallData* {
+      auto* node = static_cast<CallData::PendingNode*>(pending_.Pop());
+      return node == nullptr ? nullptr : node->calld;
+    });
+  }
+
+  // Return the result of try_pop() once it finds the item claimed by the
+  // caller. That item may still be mid-push, normally with its pusher a few
+  // instructions from done, so spin briefly, then yield, and if the pusher
+  // still hasn't finished (e.g. it was descheduled) block on waiters_mu_
+  // until a push completes.
+  template <typename F>
+  auto PopClaimed(F try_pop) -> decltype(try_pop()) {
+    for (int i = 0; i < kMaxSpins; i++) {
+      auto item = try_pop();
+      if (item != nullptr) return item;
+      if (i >= kSpinsBeforeYield) std::this_thread::yield();
+    }
+    MutexLock lock(&waiters_mu_);
+    waiters_.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in WakeWaiters(): either the pusher sees this
+    // waiter, or this waiter sees the completed push.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto item = try_pop();
+    while (item == nullptr) {
+      waiters_cv_.Wait(&waiters_mu_);
+      item = try_pop();
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return item;
+  }
+
+  // Called after each push to wake any PopClaimed() that stopped spinning.
+  void WakeWaiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) return;
+    MutexLock lock(&waiters_mu_);
+    waiters_cv_.SignalAll();
+  }
+
+  static constexpr int kSpinsBeforeYield = 16;
+  static constexpr int kMaxSpins = 64;
+
   Server* const server_;
-  std::queue<CallData*> pending_;
+  // Number of queued requests minus number of pending calls. Includes pushes
+  // that have been claimed but not yet completed.
+  std::atomic<intptr_t> balance_{0};
+  LockedMultiProducerSingleConsumerQueue pending_;
   std::vector<LockedMultiProducerSingleConsumerQueue> requests_per_cq_;
+  // Pops that gave up spinning in PopClaimed() and wait for a push.
+  std::atomic<size_t> waiters_{0};
+  Mutex waiters_mu_;
+  CondVar waiters_cv_;
 };
 
 // AllocatingRequestMatchers don't allow the application to request an RPC in
@@ -594,9 +655,14 @@ grpc_error_handle Server::SetupTransport(
     grpc_transport* transport, grpc_pollset* accepting_pollset,
     const ChannelArgs& args,
     const RefCountedPtr<channelz::SocketNode>& socket_node) {
-  // Create channel.
+  // Create channel.  Filters that report to channelz find the server's node
+  // in the channel args.
+  ChannelArgs channel_args = args;
+  if (channelz_node_ != nullptr) {
+    channel_args = channel_args.SetObject(channelz_node_);
+  }
   absl::StatusOr<RefCountedPtr<Channel>> channel =
-      Channel::Create(nullptr, args, GRPC_SERVER_CHANNEL, transport);
+      Channel::Create(nullptr, channel_args, GRPC_SERVER_CHANNEL, transport);
   if (!channel.ok()) {
     return absl_status_to_grpc_error(channel.status());
   }
@@ -1164,6 +1230,7 @@ Server::CallData::CallData(grpc_call_element* elem,
     : server_(std::move(server)),
       call_(grpc_call_from_top_element(elem)),
       call_combiner_(args.call_combiner) {
+  pending_node_.calld = this;
   GRPC_CLOSURE_INIT(&recv_initial_metadata_ready_, RecvInitialMetadataReady,
                     elem, grpc_schedule_on_exec_ctx);
   GRPC_CLOSURE_INIT(&recv_trailing_metadata_ready_, RecvTrailingMetadataReady,
@@ -46,6 +46,7 @@
 #include "src/core/lib/debug/trace.h"
 #include "src/core/lib/gprpp/cpp_impl_of.h"
 #include "src/core/lib/gprpp/dual_ref_counted.h"
+#include "src/core/lib/gprpp/mpscq.h"
 #include "src/core/lib/gprpp/notification.h"
 #include "src/core/lib/gprpp/orphanable.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
@@ -294,6 +295,12 @@ class Server : public InternallyRefCounted<Server>,
 
     void FailCallCreation();
 
+    // Links the call into a request matcher's queue of pending calls.
+    struct PendingNode : public MultiProducerSingleConsumerQueue::Node {
+      CallData* calld;
+    };
+    PendingNode* pending_node() { return &pending_node_; }
+
     // Filter vtable functions.
     static grpc_error_handle InitCallElement(
         grpc_call_element* elem, const grpc_call_element_args* args);
@@ -321,6 +328,7 @@ class Server : public InternallyRefCounted<Server>,
     grpc_call* call_;
 
     std::atomic<CallState> state_{CallState::NOT_STARTED};
+    PendingNode pending_node_;
 
     absl::optional<Slice> path_;
     absl::optional<Slice> host_;
@@ -16,6 +16,7 @@
 
 #include "src/core/lib/transport/metadata_batch.h"
 
+#include <stdint.h>
 #include <string.h>
 
 #include <algorithm>
@@ -24,6 +25,8 @@
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 
+#include <grpc/slice.h>
+
 #include "src/core/lib/transport/timeout_encoding.h"
 
 namespace grpc_core {
@@ -34,29 +37,150 @@ void DebugStringBuilder::Add(absl::string_view key, absl::string_view value) {
   absl::StrAppend(&out_, absl::CEscape(key), ": ", absl::CEscape(value));
 }
 
+namespace {
+// Values that fit in a grpc_slice's inline storage are copied there, so that
+// subsequent copies of the map don't touch a shared refcount.
+bool ShouldInline(const Slice& value) {
+  return value.size() <= GRPC_SLICE_INLINED_SIZE &&
+         reinterpret_cast<uintptr_t>(value.c_slice().refcount) > 1;
+}
+
+Slice InlineCopy(const Slice& value) {
+  grpc_slice inlined;
+  inlined.refcount = nullptr;
+  inlined.data.inlined.length = static_cast<uint8_t>(value.size());
+  memcpy(inlined.data.inlined.bytes, value.data(), value.size());
+  return Slice(inlined);
+}
+}  // namespace
+
 void UnknownMap::Append(absl::string_view key, Slice value) {
-  unknown_.EmplaceBack(Slice::FromCopiedString(key), value.Ref());
+  Append(MetadataKey(key), std::move(value));
+}
+
+void UnknownMap::Append(MetadataKey key, Slice value) {
+  new (AppendSlot())
+      Element(std::move(key),
+              ShouldInline(value) ? InlineCopy(value) : std::move(value));
+  ++size_;
+}
+
+void UnknownMap::AppendCopy(MetadataKey key, const Slice& value) {
+  new (AppendSlot()) Element(
+      std::move(key), ShouldInline(value) ? InlineCopy(value) : value.Ref());
+  ++size_;
+}
+
+void UnknownMap::AppendFrom(const UnknownMap& other) {
+  if (other.empty()) return;
+  if (empty() && arena_ == other.arena_) {
+    // Blocks live in the arena, so only share within one.
+    if (block_ != nullptr) Unref(block_);
+    other.block_->refs.fetch_add(1, std::memory_order_relaxed);
+    block_ = other.block_;
+    size_ = other.size_;
+    return;
+  }
+  other.ForEach([this](const MetadataKey& key, const Slice& value) {
+    new (AppendSlot()) Element(key, value.Ref());
+    ++size_;
+  });
+}
+
+constexpr size_t UnknownMap::kInitialCapacity;
+
+UnknownMap::Element* UnknownMap::AppendSlot() {
+  if (block_ != nullptr && size_ < block_->capacity) {
+    // Elements past size_ may have been appended by a map sharing the block,
+    // in which case the slot is taken.
+    size_t expected = size_;
+    if (block_->used.compare_exchange_strong(expected, size_ + 1,
+                                             std::memory_order_acq_rel)) {
+      return &block_->elements()[size_];
+    }
+  }
+  MoveToNewBlock(std::max<size_t>(2 * size_, kInitialCapacity));
+  block_->used.store(size_ + 1, std::memory_order_relaxed);
+  return &block_->elements()[size_];
+}
+
+void UnknownMap::MoveToNewBlock(size_t capacity) {
+  GPR_DEBUG_ASSERT(capacity >= size_);
+  Block* block = new (arena_->Alloc(sizeof(Block) + capacity * sizeof(Element)))
+      Block(capacity);
+  Element* elements = block->elements();
+  if (block_ != nullptr) {
+    Element* old = block_->elements();
+    if (block_->refs.load(std::memory_order_acquire) == 1) {
+      for (size_t i = 0; i < size_; i++) {
+        new (&elements[i]) Element(std::move(old[i]));
+      }
+    } else {
+      for (size_t i = 0; i < size_; i++) {
+        new (&elements[i]) Element(old[i].first, old[i].second.Ref());
+      }
+    }
+    Unref(block_);
+  }
+  block->used.store(size_, std::memory_order_relaxed);
+  block_ = block;
+}
+
+void UnknownMap::Unref(Block* block) {
+  if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  // The memory belongs to the arena; just destroy the elements.
+  Element* elements = block->elements();
+  const size_t used = block->used.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < used; i++) elements[i].~Element();
+  block->~Block();
+}
+
+void UnknownMap::Clear() {
+  if (block_ == nullptr) return;
+  if (block_->refs.load(std::memory_order_acquire) == 1) {
+    Element* elements = block_->elements();
+    const size_t used = block_->used.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < used; i++) elements[i].~Element();
+    block_->used.store(0, std::memory_order_relaxed);
+  } else {
+    Unref(block_);
+    block_ = nullptr;
+  }
+  size_ = 0;
 }
 
 void UnknownMap::Remove(absl::string_view key) {
-  unknown_.SetEnd(std::remove_if(unknown_.begin(), unknown_.end(),
-                                 [key](const std::pair<Slice, Slice>& p) {
-                                   return p.first.as_string_view() == key;
-                                 }));
+  auto matches = [key](const Element& p) {
+    return p.first.as_string_view() == key;
+  };
+  if (block_ == nullptr) return;
+  if (std::none_of(block_->elements(), block_->elements() + size_, matches)) {
+    return;
+  }
+  if (block_->refs.load(std::memory_order_acquire) != 1) {
+    MoveToNewBlock(block_->capacity);
+  }
+  // The block is ours alone now: compact it in place, also dropping any
+  // elements past size_ left behind by maps that used to share it.
+  Element* elements = block_->elements();
+  Element* end = std::remove_if(elements, elements + size_, matches);
+  const size_t used = block_->used.load(std::memory_order_relaxed);
+  for (Element* p = end; p != elements + used; ++p) p->~Element();
+  size_ = end - elements;
+  block_->used.store(size_, std::memory_order_relaxed);
 }
 
 absl::optional<absl::string_view> UnknownMap::GetStringValue(
     absl::string_view key, std::string* backing) const {
   absl::optional<absl::string_view> out;
-  for (const auto& p : unknown_) {
-    if (p.first.as_string_view() == key) {
-      if (!out.has_value()) {
-        out = p.second.as_string_view();
-      } else {
-        out = *backing = absl::StrCat(*out, ",", p.second.as_string_view());
-      }
+  ForEach([key, backing, &out](const MetadataKey& k, const Slice& value) {
+    if (k.as_string_view() != key) return;
+    if (!out.has_value()) {
+      out = value.as_string_view();
+    } else {
+      out = *backing = absl::StrCat(*out, ",", value.as_string_view());
     }
-  }
+  });
   return out;
 }
 
@@ -23,6 +23,7 @@
 
 #include <stdlib.h>
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <type_traits>
@@ -40,11 +41,11 @@
 #include <grpc/support/log.h>
 
 #include "src/core/lib/compression/compression_internal.h"
-#include "src/core/lib/gprpp/chunked_vector.h"
 #include "src/core/lib/gprpp/packed_table.h"
 #include "src/core/lib/gprpp/time.h"
 #include "src/core/lib/resource_quota/arena.h"
 #include "src/core/lib/slice/slice.h"
+#include "src/core/lib/transport/metadata_key_table.h"
 #include "src/core/lib/transport/parsed_metadata.h"
 
 namespace grpc_core {
@@ -521,7 +522,7 @@ class ParseHelper {
 
   GPR_ATTRIBUTE_NOINLINE ParsedMetadata<Container> NotFound(
       absl::string_view key) {
-    return ParsedMetadata<Container>(Slice::FromCopiedString(key),
+    return ParsedMetadata<Container>(MetadataKey::Copy(key),
                                      std::move(value_));
   }
 
@@ -542,8 +543,12 @@ class ParseHelper {
 template <typename Container>
 class AppendHelper {
  public:
-  AppendHelper(Container* container, Slice value, MetadataParseErrorFn on_error)
-      : container_(container), value_(std::move(value)), on_error_(on_error) {}
+  AppendHelper(Container* container, Slice value, MetadataParseErrorFn on_error,
+               bool intern_key)
+      : container_(container),
+        value_(std::move(value)),
+        on_error_(on_error),
+        intern_key_(intern_key) {}
 
   template <typename Trait>
   GPR_ATTRIBUTE_NOINLINE void Found(Trait trait) {
@@ -555,13 +560,16 @@ class AppendHelper {
   }
 
   GPR_ATTRIBUTE_NOINLINE void NotFound(absl::string_view key) {
-    container_->unknown_.Append(key, std::move(value_));
+    container_->unknown_.Append(
+        intern_key_ ? MetadataKey::Intern(key) : MetadataKey(key),
+        std::move(value_));
   }
 
  private:
   Container* const container_;
   Slice value_;
   MetadataParseErrorFn on_error_;
+  const bool intern_key_;
 };
 
 // This is an "Op" type for NameLookup.
@@ -840,10 +848,6 @@ class CopySink {
     dst_->Set(trait, std::move(value.AsOwned()));
   }
 
-  void Encode(const Slice& key, const Slice& value) {
-    dst_->unknown_.Append(key.as_string_view(), value.Ref());
-  }
-
  private:
   Output* dst_;
 };
@@ -909,28 +913,102 @@ class TransportSizeEncoder {
 };
 
 // Handle unknown (non-trait-based) fields in the metadata map.
+// Keys are interned in MetadataKeyTable where allowed and small values are
+// stored inline, so that copying the map (e.g. when a proxy forwards headers)
+// needs neither allocations nor refcount updates for the common case.
+//
+// Elements live in an arena-allocated, refcounted block. Copying a map within
+// an arena just takes a ref on the block, without touching the source map, so
+// that it is O(1) no matter how many elements there are and is safe alongside
+// concurrent readers of the source. Each map remembers how many elements of
+// the block are its own: elements below that are never modified while the
+// block is shared, and appending claims the next slot only if no other map
+// got there first (otherwise the map moves to a new block). Removing an
+// element from a shared block first gives the map a private copy
+// (copy-on-write).
 class UnknownMap {
  public:
-  explicit UnknownMap(Arena* arena) : unknown_(arena) {}
+  explicit UnknownMap(Arena* arena) : arena_(arena) {}
+  ~UnknownMap() {
+    if (block_ != nullptr) Unref(block_);
+  }
+
+  UnknownMap(const UnknownMap&) = delete;
+  UnknownMap& operator=(const UnknownMap&) = delete;
+  UnknownMap(UnknownMap&& other) noexcept
+      : arena_(other.arena_),
+        block_(std::exchange(other.block_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  UnknownMap& operator=(UnknownMap&& other) noexcept {
+    if (block_ != nullptr) Unref(block_);
+    arena_ = other.arena_;
+    block_ = std::exchange(other.block_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
 
-  using BackingType = ChunkedVector<std::pair<Slice, Slice>, 10>;
+  using Element = std::pair<MetadataKey, Slice>;
 
   void Append(absl::string_view key, Slice value);
+  void Append(MetadataKey key, Slice value);
+  // As Append(), but without taking ownership of value: a small value is
+  // copied without taking a ref on it.
+  void AppendCopy(MetadataKey key, const Slice& value);
+  // Append all elements of other to this map. If this map is empty and both
+  // use the same arena, this map and other share their elements from now on.
+  // Never modifies other.
+  void AppendFrom(const UnknownMap& other);
   void Remove(absl::string_view key);
   absl::optional<absl::string_view> GetStringValue(absl::string_view key,
                                                    std::string* backing) const;
 
-  BackingType::ConstForwardIterator begin() const { return unknown_.cbegin(); }
-  BackingType::ConstForwardIterator end() const { return unknown_.cend(); }
+  // Call f(const MetadataKey&, const Slice&) for each element, in order.
+  template <typename F>
+  void ForEach(F f) const {
+    if (block_ == nullptr) return;
+    const Element* elements = block_->elements();
+    for (size_t i = 0; i < size_; i++) {
+      f(elements[i].first, elements[i].second);
+    }
+  }
 
-  bool empty() const { return unknown_.empty(); }
-  size_t size() const { return unknown_.size(); }
-  void Clear() { unknown_.Clear(); }
-  Arena* arena() const { return unknown_.arena(); }
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  // Keeps the block if no other map shares it, so that a map cleared and
+  // filled again, as the transports do, does not allocate again.
+  void Clear();
+  Arena* arena() const { return arena_; }
 
  private:
-  // Backing store for added metadata.
-  ChunkedVector<std::pair<Slice, Slice>, 10> unknown_;
+  // Header of an arena-allocated array of up to capacity elements.
+  struct Block {
+    explicit Block(size_t capacity) : capacity(capacity) {}
+    Element* elements() { return reinterpret_cast<Element*>(this + 1); }
+    const Element* elements() const {
+      return reinterpret_cast<const Element*>(this + 1);
+    }
+    // Number of maps referencing this block.
+    std::atomic<size_t> refs{1};
+    // Number of constructed elements: the longest of the maps sharing it.
+    std::atomic<size_t> used{0};
+    const size_t capacity;
+  };
+  static_assert(sizeof(Block) % alignof(Element) == 0,
+                "elements must be aligned after the block header");
+
+  static constexpr size_t kInitialCapacity = 10;
+
+  // Return the slot for element number size_, moving to a new block if this
+  // map cannot extend the current one.
+  Element* AppendSlot();
+  // Move this map's elements to a new, unshared block of the given capacity.
+  void MoveToNewBlock(size_t capacity);
+  static void Unref(Block* block);
+
+  Arena* arena_;
+  Block* block_ = nullptr;
+  // Number of elements of block_ that belong to this map.
+  size_t size_ = 0;
 };
 
 }  // namespace metadata_detail
@@ -1073,27 +1151,27 @@ class MetadataMap {
     table_.template ForEachIn<metadata_detail::EncodeWrapper<Encoder>,
                               Value<Traits>...>(
         metadata_detail::EncodeWrapper<Encoder>{encoder});
-    for (const auto& unk : unknown_) {
-      encoder->Encode(unk.first, unk.second);
-    }
+    unknown_.ForEach([encoder](const MetadataKey& key, const Slice& value) {
+      encoder->Encode(key.slice(), value);
+    });
   }
 
   // Like Encode, but also visit the non-encodable fields.
   template <typename Encoder>
   void ForEach(Encoder* encoder) const {
     table_.ForEach(metadata_detail::ForEachWrapper<Encoder>{encoder});
-    for (const auto& unk : unknown_) {
-      encoder->Encode(unk.first, unk.second);
-    }
+    unknown_.ForEach([encoder](const MetadataKey& key, const Slice& value) {
+      encoder->Encode(key.slice(), value);
+    });
   }
 
   // Similar to Encode, but targeted at logging: for each metadatum,
   // call f(key, value) as absl::string_views.
   void Log(metadata_detail::LogFn log_fn) const {
     table_.ForEach(metadata_detail::LogWrapper{log_fn});
-    for (const auto& unk : unknown_) {
-      log_fn(unk.first.as_string_view(), unk.second.as_string_view());
-    }
+    unknown_.ForEach([log_fn](const MetadataKey& key, const Slice& value) {
+      log_fn(key.as_string_view(), value.as_string_view());
+    });
   }
 
   std::string DebugString() const {
@@ -1224,11 +1302,22 @@ class MetadataMap {
     m.SetOnContainer(static_cast<Derived*>(this));
   }
 
-  // Append a key/value pair - takes ownership of value
+  // Append a key/value pair - takes ownership of value.
+  // Unknown keys are looked up in MetadataKeyTable but never added to it: the
+  // name may have come from a peer, e.g. through a proxy forwarding headers.
   void Append(absl::string_view key, Slice value,
               MetadataParseErrorFn on_error) {
-    metadata_detail::AppendHelper<Derived> helper(static_cast<Derived*>(this),
-                                                  value.TakeOwned(), on_error);
+    metadata_detail::AppendHelper<Derived> helper(
+        static_cast<Derived*>(this), value.TakeOwned(), on_error, false);
+    metadata_detail::NameLookup<void, Traits...>::Lookup(key, &helper);
+  }
+  // As Append(), but an unknown key is interned in MetadataKeyTable, so that
+  // copies of the element share it. Only for key names fixed in the source,
+  // such as string literals, which bounds how many there can be.
+  void AppendStaticKey(absl::string_view key, Slice value,
+                       MetadataParseErrorFn on_error) {
+    metadata_detail::AppendHelper<Derived> helper(
+        static_cast<Derived*>(this), value.TakeOwned(), on_error, true);
     metadata_detail::NameLookup<void, Traits...>::Lookup(key, &helper);
   }
 
@@ -1299,7 +1388,9 @@ template <typename Derived, typename... Traits>
 Derived MetadataMap<Derived, Traits...>::Copy() const {
   Derived out(unknown_.arena());
   metadata_detail::CopySink<Derived> sink(&out);
-  ForEach(&sink);
+  table_.ForEach(metadata_detail::ForEachWrapper<
+                 metadata_detail::CopySink<Derived>>{&sink});
+  out.unknown_.AppendFrom(unknown_);
   return out;
 }
 
@@ -0,0 +1,142 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/transport/metadata_key_table.h"
+
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+#include "absl/hash/hash.h"
+
+#include <grpc/slice.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gprpp/no_destruct.h"
+#include "src/core/lib/gprpp/sync.h"
+
+namespace grpc_core {
+
+constexpr MetadataKeyTable::Id MetadataKeyTable::kNotInterned;
+constexpr size_t MetadataKeyTable::kMaxKeys;
+constexpr size_t MetadataKeyTable::kMaxKeyLength;
+
+namespace {
+
+// Open-addressed hash table from key to id. Slots are only ever filled, never
+// cleared, and hold at most half as many keys as there are slots, so a probe
+// always ends at an empty slot. Readers don't lock: a slot is published with a
+// release store after the key it refers to has been written.
+class KeyTable {
+ public:
+  MetadataKeyTable::Id Intern(absl::string_view key) {
+    if (key.size() > MetadataKeyTable::kMaxKeyLength) {
+      return MetadataKeyTable::kNotInterned;
+    }
+    const size_t hash = absl::HashOf(key);
+    MetadataKeyTable::Id id = Lookup(key, hash);
+    if (id != MetadataKeyTable::kNotInterned) return id;
+    MutexLock lock(&mu_);
+    // Another thread may have added the key since the lookup above.
+    size_t slot = hash & kSlotMask;
+    for (;; slot = (slot + 1) & kSlotMask) {
+      uint32_t entry = slots_[slot].load(std::memory_order_relaxed);
+      if (entry == 0) break;
+      if (keys_[entry - 1].as_string_view() == key) return entry - 1;
+    }
+    id = size_.load(std::memory_order_relaxed);
+    if (id >= MetadataKeyTable::kMaxKeys) return MetadataKeyTable::kNotInterned;
+    // Key bytes are never freed: ids (and the slices they name) are valid for
+    // the life of the process.
+    char* storage = static_cast<char*>(gpr_malloc(key.size() + 1));
+    memcpy(storage, key.data(), key.size());
+    storage[key.size()] = '\0';
+    keys_[id] = Slice(grpc_slice_from_static_buffer(storage, key.size()));
+    slots_[slot].store(id + 1, std::memory_order_release);
+    size_.store(id + 1, std::memory_order_relaxed);
+    return id;
+  }
+
+  MetadataKeyTable::Id Find(absl::string_view key) const {
+    if (key.size() > MetadataKeyTable::kMaxKeyLength) {
+      return MetadataKeyTable::kNotInterned;
+    }
+    return Lookup(key, absl::HashOf(key));
+  }
+
+  const Slice& Key(MetadataKeyTable::Id id) const {
+    GPR_DEBUG_ASSERT(id < MetadataKeyTable::kMaxKeys);
+    return keys_[id];
+  }
+
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr size_t kNumSlots = 2 * MetadataKeyTable::kMaxKeys;
+  static constexpr size_t kSlotMask = kNumSlots - 1;
+  static_assert((kNumSlots & kSlotMask) == 0, "kNumSlots must be 2^n");
+
+  MetadataKeyTable::Id Lookup(absl::string_view key, size_t hash) const {
+    for (size_t slot = hash & kSlotMask;; slot = (slot + 1) & kSlotMask) {
+      uint32_t entry = slots_[slot].load(std::memory_order_acquire);
+      if (entry == 0) return MetadataKeyTable::kNotInterned;
+      if (keys_[entry - 1].as_string_view() == key) return entry - 1;
+    }
+  }
+
+  // Serializes adding keys.
+  Mutex mu_;
+  // 0 for an empty slot, otherwise 1 + the id of the key.
+  std::atomic<uint32_t> slots_[kNumSlots] = {};
+  std::atomic<MetadataKeyTable::Id> size_{0};
+  // Written once per id, before the slot naming it is published.
+  Slice keys_[MetadataKeyTable::kMaxKeys];
+};
+
+KeyTable* GetKeyTable() {
+  static NoDestruct<KeyTable> table;
+  return table.get();
+}
+
+}  // namespace
+
+MetadataKeyTable::Id MetadataKeyTable::Intern(absl::string_view key) {
+  return GetKeyTable()->Intern(key);
+}
+
+MetadataKeyTable::Id MetadataKeyTable::Find(absl::string_view key) {
+  return GetKeyTable()->Find(key);
+}
+
+const Slice& MetadataKeyTable::Key(Id id) { return GetKeyTable()->Key(id); }
+
+size_t MetadataKeyTable::Size() { return GetKeyTable()->Size(); }
+
+MetadataKey::Owned* MetadataKey::Owned::Create(absl::string_view key) {
+  Owned* owned = new (gpr_malloc(sizeof(Owned) + key.size())) Owned(key.size());
+  memcpy(owned->bytes(), key.data(), key.size());
+  return owned;
+}
+
+void MetadataKey::Owned::Destroy(grpc_slice_refcount* refcount) {
+  Owned* owned = static_cast<Owned*>(refcount);
+  owned->~Owned();
+  gpr_free(owned);
+}
+
+}  // namespace grpc_core
@@ -0,0 +1,169 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_TRANSPORT_METADATA_KEY_TABLE_H
+#define GRPC_CORE_LIB_TRANSPORT_METADATA_KEY_TABLE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <limits>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+
+#include <grpc/slice.h>
+
+#include "src/core/lib/slice/slice.h"
+#include "src/core/lib/slice/slice_refcount.h"
+
+namespace grpc_core {
+
+// Process-wide table of interned metadata keys.
+//
+// Headers that have no trait in MetadataMap (custom application headers) can
+// be mapped to a small integer id. The key bytes live for the life of the
+// process, so the slice returned by Key() is static: copying it costs neither
+// an allocation nor refcount traffic.
+//
+// Only key names fixed in the source (see MetadataMap::AppendStaticKey()) are
+// added to the table. Anything else may have come from a peer, if only through
+// a proxy forwarding its headers, so is at most looked up. That keeps a peer
+// from filling the table with random header names and taking the fast path
+// away from everyone else. The table is also bounded: once kMaxKeys keys have
+// been interned (or for keys longer than kMaxKeyLength) Intern() returns
+// kNotInterned, and callers fall back to owning a copy of the key.
+//
+// Lookups don't take a lock; only adding a key does.
+class MetadataKeyTable {
+ public:
+  using Id = uint32_t;
+  static constexpr Id kNotInterned = std::numeric_limits<Id>::max();
+  static constexpr size_t kMaxKeys = 1024;
+  static constexpr size_t kMaxKeyLength = 64;
+
+  // Returns the id for key, adding it to the table if it's not yet present.
+  // Must only be called for key names fixed in the source. Thread-safe.
+  static Id Intern(absl::string_view key);
+  // Returns the id for key if it has already been interned, without adding it.
+  // Thread-safe and lock-free.
+  static Id Find(absl::string_view key);
+  // Returns the key for an id previously returned by Intern().
+  static const Slice& Key(Id id);
+  // Number of keys interned so far.
+  static size_t Size();
+};
+
+// Key of a metadata element without a trait.
+// Pointer-sized: either the id of a key in MetadataKeyTable, or a reference to
+// a refcounted copy of a key that is not in the table. A moved-from key is
+// empty.
+class MetadataKey {
+ public:
+  // Uses the interned key if key is in MetadataKeyTable, without adding it.
+  explicit MetadataKey(absl::string_view key)
+      : MetadataKey(key, MetadataKeyTable::Find(key)) {}
+  // Interns key first. Only for key names fixed in the source.
+  static MetadataKey Intern(absl::string_view key) {
+    return MetadataKey(key, MetadataKeyTable::Intern(key));
+  }
+  // Copies key without looking it up, for key names received from a peer:
+  // they are rarely interned, and a miss would cost a hash on top of the copy.
+  static MetadataKey Copy(absl::string_view key) {
+    return MetadataKey(key, MetadataKeyTable::kNotInterned);
+  }
+
+  MetadataKey(const MetadataKey& other) : rep_(other.rep_) {
+    if (rep_ != kEmpty && !interned()) owned()->Ref();
+  }
+  MetadataKey& operator=(const MetadataKey& other) {
+    MetadataKey copy(other);
+    std::swap(rep_, copy.rep_);
+    return *this;
+  }
+  MetadataKey(MetadataKey&& other) noexcept : rep_(other.rep_) {
+    other.rep_ = kEmpty;
+  }
+  MetadataKey& operator=(MetadataKey&& other) noexcept {
+    std::swap(rep_, other.rep_);
+    return *this;
+  }
+  ~MetadataKey() {
+    if (rep_ != kEmpty && !interned()) owned()->Unref();
+  }
+
+  bool interned() const { return (rep_ & 1) != 0; }
+  MetadataKeyTable::Id id() const {
+    return interned() ? static_cast<MetadataKeyTable::Id>(rep_ >> 1)
+                      : MetadataKeyTable::kNotInterned;
+  }
+
+  // Returns the key as a slice. Short keys are copied inline, as
+  // Slice::FromCopiedString() would, so that an encoder can coalesce them into
+  // its output. Otherwise static for interned keys, or a ref on the copy.
+  Slice slice() const {
+    if (size() <= GRPC_SLICE_INLINED_SIZE) {
+      return Slice::FromCopiedString(as_string_view());
+    }
+    if (interned()) return MetadataKeyTable::Key(id()).Ref();
+    owned()->Ref();
+    return Slice(grpc_slice{owned(), {{owned()->length, owned()->bytes()}}});
+  }
+  absl::string_view as_string_view() const {
+    if (interned()) return MetadataKeyTable::Key(id()).as_string_view();
+    if (rep_ == kEmpty) return absl::string_view();
+    return absl::string_view(reinterpret_cast<const char*>(owned()->bytes()),
+                             owned()->length);
+  }
+  size_t size() const { return as_string_view().size(); }
+
+  bool operator==(const MetadataKey& other) const {
+    if (rep_ == other.rep_) return true;
+    if (interned() && other.interned()) return false;
+    return as_string_view() == other.as_string_view();
+  }
+
+ private:
+  // A copy of a key, allocated together with its refcount, in the same way as
+  // a slice from Slice::FromCopiedString().
+  struct Owned : public grpc_slice_refcount {
+    explicit Owned(size_t length)
+        : grpc_slice_refcount(Destroy), length(length) {}
+    static Owned* Create(absl::string_view key);
+    static void Destroy(grpc_slice_refcount* refcount);
+    uint8_t* bytes() { return reinterpret_cast<uint8_t*>(this + 1); }
+    const size_t length;
+  };
+
+  // Representation of a moved-from key: not interned, and with no copy of a
+  // key to unref.
+  static constexpr uintptr_t kEmpty = 0;
+
+  MetadataKey(absl::string_view key, MetadataKeyTable::Id id)
+      : rep_(id == MetadataKeyTable::kNotInterned
+                 ? reinterpret_cast<uintptr_t>(Owned::Create(key))
+                 : (static_cast<uintptr_t>(id) << 1) | 1) {}
+
+  Owned* owned() const { return reinterpret_cast<Owned*>(rep_); }
+
+  // (id << 1) | 1 for an interned key, kEmpty for a moved-from key, otherwise
+  // an Owned* holding a ref.
+  uintptr_t rep_;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_TRANSPORT_METADATA_KEY_TABLE_H
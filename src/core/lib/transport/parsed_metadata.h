@@ -34,6 +34,7 @@
 
 #include "src/core/lib/gprpp/time.h"
 #include "src/core/lib/slice/slice.h"
+#include "src/core/lib/transport/metadata_key_table.h"
 
 namespace grpc_core {
 
@@ -152,10 +153,12 @@ class ParsedMetadata {
   }
   // Construct metadata from a string key, slice value pair.
   ParsedMetadata(Slice key, Slice value)
+      : ParsedMetadata(MetadataKey(key.as_string_view()), std::move(value)) {}
+  ParsedMetadata(MetadataKey key, Slice value)
       : vtable_(ParsedMetadata::KeyValueVTable(key.as_string_view())),
         transport_size_(static_cast<uint32_t>(key.size() + value.size() + 32)) {
     value_.pointer =
-        new std::pair<Slice, Slice>(std::move(key), std::move(value));
+        new std::pair<MetadataKey, Slice>(std::move(key), std::move(value));
   }
   ParsedMetadata() : vtable_(EmptyVTable()), transport_size_(0) {}
   ~ParsedMetadata() { vtable_->destroy(value_); }
@@ -374,18 +377,18 @@ ParsedMetadata<MetadataContainer>::SliceTraitVTable() {
 template <typename MetadataContainer>
 const typename ParsedMetadata<MetadataContainer>::VTable*
 ParsedMetadata<MetadataContainer>::KeyValueVTable(absl::string_view key) {
-  using KV = std::pair<Slice, Slice>;
+  using KV = std::pair<MetadataKey, Slice>;
   static const auto destroy = [](const Buffer& value) {
     delete static_cast<KV*>(value.pointer);
   };
   static const auto set = [](const Buffer& value, MetadataContainer* map) {
     auto* p = static_cast<KV*>(value.pointer);
-    map->unknown_.Append(p->first.as_string_view(), p->second.Ref());
+    map->unknown_.AppendCopy(p->first, p->second);
   };
   static const auto with_new_value = [](Slice* value, MetadataParseErrorFn,
                                         ParsedMetadata* result) {
     auto* p = new KV{
-        static_cast<KV*>(result->value_.pointer)->first.Ref(),
+        static_cast<KV*>(result->value_.pointer)->first,
         std::move(*value),
     };
     result->value_.pointer = p;
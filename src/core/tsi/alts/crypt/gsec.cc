@@ -113,6 +113,54 @@ grpc_status_code gsec_aead_crypter_decrypt_iovec(
   return GRPC_STATUS_INVALID_ARGUMENT;
 }
 
+grpc_status_code gsec_aead_crypter_encrypt_batch(gsec_aead_crypter* crypter,
+                                                 gsec_aead_batch_op* ops,
+                                                 size_t num_ops,
+                                                 char** error_details) {
+  if (crypter == nullptr || crypter->vtable == nullptr ||
+      crypter->vtable->encrypt_iovec == nullptr) {
+    maybe_copy_error_msg(vtable_error_msg, error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (num_ops > 0 && ops == nullptr) {
+    maybe_copy_error_msg("Non-zero num_ops but ops is nullptr.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  for (size_t i = 0; i < num_ops; ++i) {
+    gsec_aead_batch_op* op = &ops[i];
+    grpc_status_code status = crypter->vtable->encrypt_iovec(
+        crypter, op->nonce, op->nonce_length, op->aad_vec, op->aad_vec_length,
+        op->input_vec, op->input_vec_length, op->output, &op->bytes_written,
+        error_details);
+    if (status != GRPC_STATUS_OK) return status;
+  }
+  return GRPC_STATUS_OK;
+}
+
+grpc_status_code gsec_aead_crypter_decrypt_batch(gsec_aead_crypter* crypter,
+                                                 gsec_aead_batch_op* ops,
+                                                 size_t num_ops,
+                                                 char** error_details) {
+  if (crypter == nullptr || crypter->vtable == nullptr ||
+      crypter->vtable->decrypt_iovec == nullptr) {
+    maybe_copy_error_msg(vtable_error_msg, error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (num_ops > 0 && ops == nullptr) {
+    maybe_copy_error_msg("Non-zero num_ops but ops is nullptr.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  for (size_t i = 0; i < num_ops; ++i) {
+    gsec_aead_batch_op* op = &ops[i];
+    grpc_status_code status = crypter->vtable->decrypt_iovec(
+        crypter, op->nonce, op->nonce_length, op->aad_vec, op->aad_vec_length,
+        op->input_vec, op->input_vec_length, op->output, &op->bytes_written,
+        error_details);
+    if (status != GRPC_STATUS_OK) return status;
+  }
+  return GRPC_STATUS_OK;
+}
+
 grpc_status_code gsec_aead_crypter_max_ciphertext_and_tag_length(
     const gsec_aead_crypter* crypter, size_t plaintext_length,
     size_t* max_ciphertext_and_tag_length_to_return, char** error_details) {
@@ -320,6 +320,76 @@ grpc_status_code gsec_aead_crypter_decrypt_iovec(
     struct iovec plaintext_vec, size_t* plaintext_bytes_written,
     char** error_details);
 
+///
+/// One operation of a batched AEAD encrypt or decrypt.
+///
+///- nonce: buffer containing a nonce with its size equal to nonce_length.
+///- nonce_length: size of nonce buffer.
+///- aad_vec: an iovec array containing data that needs to be authenticated but
+///  not encrypted.
+///- aad_vec_length: the array length of aad_vec.
+///- input_vec: an iovec array containing the plaintext to encrypt, or the
+///  ciphertext+tag to decrypt.
+///- input_vec_length: the array length of input_vec.
+///- output: an iovec containing the buffer for the ciphertext+tag, or for the
+///  plaintext. The buffer should not overlap the input buffers.
+///- bytes_written: set to the actual number of bytes written to output.
+///
+typedef struct gsec_aead_batch_op {
+  const uint8_t* nonce;
+  size_t nonce_length;
+  const struct iovec* aad_vec;
+  size_t aad_vec_length;
+  const struct iovec* input_vec;
+  size_t input_vec_length;
+  struct iovec output;
+  size_t bytes_written;
+} gsec_aead_batch_op;
+
+///
+/// This method performs a batch of AEAD encrypt operations, e.g., to seal
+/// several frames of a record protocol at once. Each operation is performed as
+/// by gsec_aead_crypter_encrypt_iovec, in order.
+///
+///- crypter: AEAD crypter instance.
+///- ops: the operations to perform.
+///- num_ops: the array length of ops.
+///- error_details: a buffer containing an error message if the method does not
+///  function correctly. It is legal to pass nullptr into error_details, and
+///  otherwise, the parameter should be freed with gpr_free.
+///
+/// On the success of all encryptions, the method returns GRPC_STATUS_OK.
+/// Otherwise, it stops at the first failed operation and returns its error
+/// status code along with its details specified in error_details (if
+/// error_details is not nullptr).
+///
+grpc_status_code gsec_aead_crypter_encrypt_batch(gsec_aead_crypter* crypter,
+                                                 gsec_aead_batch_op* ops,
+                                                 size_t num_ops,
+                                                 char** error_details);
+
+///
+/// This method performs a batch of AEAD decrypt operations, e.g., to open
+/// several frames of a record protocol at once. Each operation is performed as
+/// by gsec_aead_crypter_decrypt_iovec, in order.
+///
+///- crypter: AEAD crypter instance.
+///- ops: the operations to perform.
+///- num_ops: the array length of ops.
+///- error_details: a buffer containing an error message if the method does not
+///  function correctly. It is legal to pass nullptr into error_details, and
+///  otherwise, the parameter should be freed with gpr_free.
+///
+/// On the success of all decryptions, the method returns GRPC_STATUS_OK.
+/// Otherwise, it stops at the first failed operation and returns its error
+/// status code along with its details specified in error_details (if
+/// error_details is not nullptr).
+///
+grpc_status_code gsec_aead_crypter_decrypt_batch(gsec_aead_crypter* crypter,
+                                                 gsec_aead_batch_op* ops,
+                                                 size_t num_ops,
+                                                 char** error_details);
+
 ///
 /// This method computes the size of ciphertext+tag buffer that must be passed
 /// to gsec_aead_crypter_encrypt function to ensure correct encryption of a
@@ -20,6 +20,10 @@
 
 #include "src/core/tsi/alts/zero_copy_frame_protector/alts_grpc_privacy_integrity_record_protocol.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
@@ -116,10 +120,150 @@ static tsi_result alts_grpc_privacy_integrity_unprotect(
   return TSI_OK;
 }
 
+// Appends iovecs pointing to the next length bytes of sb to rp->iovec_buf,
+// starting at slice *slice_index, offset *slice_offset, and advances those
+// past the bytes. If dst is not nullptr, the bytes are instead copied to dst.
+// Returns the number of iovecs appended.
+static size_t take_slice_buffer_bytes(alts_grpc_record_protocol* rp,
+                                      grpc_slice_buffer* sb,
+                                      size_t* slice_index,
+                                      size_t* slice_offset, size_t length,
+                                      size_t* iovec_count, unsigned char* dst) {
+  size_t num_iovecs = 0;
+  while (length > 0) {
+    GPR_ASSERT(*slice_index < sb->count);
+    grpc_slice& slice = sb->slices[*slice_index];
+    size_t n = std::min(length, GRPC_SLICE_LENGTH(slice) - *slice_offset);
+    unsigned char* bytes = GRPC_SLICE_START_PTR(slice) + *slice_offset;
+    if (dst != nullptr) {
+      memcpy(dst, bytes, n);
+      dst += n;
+    } else {
+      rp->iovec_buf[*iovec_count].iov_base = bytes;
+      rp->iovec_buf[*iovec_count].iov_len = n;
+      ++*iovec_count;
+      ++num_iovecs;
+    }
+    length -= n;
+    *slice_offset += n;
+    if (*slice_offset == GRPC_SLICE_LENGTH(slice)) {
+      ++*slice_index;
+      *slice_offset = 0;
+    }
+  }
+  return num_iovecs;
+}
+
+static tsi_result alts_grpc_privacy_integrity_protect_frames(
+    alts_grpc_record_protocol* rp, grpc_slice_buffer* unprotected_slices,
+    size_t max_frame_data_size, grpc_slice_buffer* protected_slices) {
+  size_t data_length = unprotected_slices->length;
+  if (data_length <= max_frame_data_size) {
+    return alts_grpc_privacy_integrity_protect(rp, unprotected_slices,
+                                               protected_slices);
+  }
+  // Splits the unprotected data into frames without copying them. Each frame
+  // boundary splits at most one slice.
+  size_t num_frames =
+      (data_length + max_frame_data_size - 1) / max_frame_data_size;
+  alts_grpc_record_protocol_reserve_iovec_buf(
+      rp, unprotected_slices->count + num_frames);
+  alts_grpc_record_protocol_reserve_frame_bufs(rp, num_frames);
+  size_t* frame_vec_lengths = rp->frame_vec_lengths;
+  size_t slice_index = 0;
+  size_t slice_offset = 0;
+  size_t iovec_count = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    frame_vec_lengths[i] = take_slice_buffer_bytes(
+        rp, unprotected_slices, &slice_index, &slice_offset,
+        std::min(max_frame_data_size, data_length - i * max_frame_data_size),
+        &iovec_count, /*dst=*/nullptr);
+  }
+  // Seals all of the frames into one newly allocated buffer.
+  grpc_slice protected_slice = GRPC_SLICE_MALLOC(
+      data_length + num_frames * (rp->header_length + rp->tag_length));
+  iovec_t protected_iovec = {GRPC_SLICE_START_PTR(protected_slice),
+                             GRPC_SLICE_LENGTH(protected_slice)};
+  char* error_details = nullptr;
+  grpc_status_code status =
+      alts_iovec_record_protocol_privacy_integrity_protect_batch(
+          rp->iovec_rp, rp->iovec_buf, frame_vec_lengths, num_frames,
+          protected_iovec, &error_details);
+  if (status != GRPC_STATUS_OK) {
+    gpr_log(GPR_ERROR, "Failed to protect, %s", error_details);
+    gpr_free(error_details);
+    grpc_core::CSliceUnref(protected_slice);
+    return TSI_INTERNAL_ERROR;
+  }
+  grpc_slice_buffer_add(protected_slices, protected_slice);
+  grpc_slice_buffer_reset_and_unref(unprotected_slices);
+  return TSI_OK;
+}
+
+static tsi_result alts_grpc_privacy_integrity_unprotect_frames(
+    alts_grpc_record_protocol* rp, grpc_slice_buffer* protected_slices,
+    const size_t* frame_sizes, size_t num_frames,
+    grpc_slice_buffer* unprotected_slices) {
+  if (num_frames == 1) {
+    return alts_grpc_privacy_integrity_unprotect(rp, protected_slices,
+                                                 unprotected_slices);
+  }
+  size_t frame_overhead = rp->header_length + rp->tag_length;
+  for (size_t i = 0; i < num_frames; ++i) {
+    if (frame_sizes[i] < frame_overhead) {
+      gpr_log(GPR_ERROR, "Protected slices do not have sufficient data.");
+      return TSI_INVALID_ARGUMENT;
+    }
+  }
+  // Splits the frames into headers, which are copied since they are small,
+  // and protected data, which are not.
+  alts_grpc_record_protocol_reserve_iovec_buf(
+      rp, protected_slices->count + 2 * num_frames);
+  alts_grpc_record_protocol_reserve_frame_bufs(rp, num_frames);
+  unsigned char* header_bytes = rp->frame_header_buf;
+  iovec_t* headers = rp->frame_headers;
+  size_t* frame_vec_lengths = rp->frame_vec_lengths;
+  size_t slice_index = 0;
+  size_t slice_offset = 0;
+  size_t iovec_count = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    headers[i].iov_base = header_bytes + i * rp->header_length;
+    headers[i].iov_len = rp->header_length;
+    take_slice_buffer_bytes(rp, protected_slices, &slice_index, &slice_offset,
+                            rp->header_length, &iovec_count,
+                            static_cast<unsigned char*>(headers[i].iov_base));
+    frame_vec_lengths[i] = take_slice_buffer_bytes(
+        rp, protected_slices, &slice_index, &slice_offset,
+        frame_sizes[i] - rp->header_length, &iovec_count, /*dst=*/nullptr);
+  }
+  // Opens all of the frames into one newly allocated buffer.
+  grpc_slice unprotected_slice =
+      GRPC_SLICE_MALLOC(protected_slices->length - num_frames * frame_overhead);
+  iovec_t unprotected_iovec = {GRPC_SLICE_START_PTR(unprotected_slice),
+                               GRPC_SLICE_LENGTH(unprotected_slice)};
+  char* error_details = nullptr;
+  grpc_status_code status =
+      alts_iovec_record_protocol_privacy_integrity_unprotect_batch(
+          rp->iovec_rp, headers, rp->iovec_buf, frame_vec_lengths, num_frames,
+          unprotected_iovec, &error_details);
+  if (status != GRPC_STATUS_OK) {
+    gpr_log(GPR_ERROR, "Failed to unprotect, %s", error_details);
+    gpr_free(error_details);
+    grpc_core::CSliceUnref(unprotected_slice);
+    return TSI_INTERNAL_ERROR;
+  }
+  grpc_slice_buffer_reset_and_unref(protected_slices);
+  grpc_slice_buffer_add(unprotected_slices, unprotected_slice);
+  return TSI_OK;
+}
+
 static const alts_grpc_record_protocol_vtable
     alts_grpc_privacy_integrity_record_protocol_vtable = {
         alts_grpc_privacy_integrity_protect,
-        alts_grpc_privacy_integrity_unprotect, nullptr};
+        alts_grpc_privacy_integrity_unprotect,
+        nullptr,
+        alts_grpc_privacy_integrity_protect_frames,
+        alts_grpc_privacy_integrity_unprotect_frames};
 
 tsi_result alts_grpc_privacy_integrity_record_protocol_create(
     gsec_aead_crypter* crypter, size_t overflow_size, bool is_client,
@@ -68,6 +68,50 @@ tsi_result alts_grpc_record_protocol_unprotect(
     alts_grpc_record_protocol* self, grpc_slice_buffer* protected_slices,
     grpc_slice_buffer* unprotected_slices);
 
+///
+/// This methods performs protect operation on unprotected data that may span
+/// several frames, and appends the protected frames to protected_slices. The
+/// data are split into frames of max_frame_data_size bytes, except for the
+/// last frame, which may be shorter. Implementations may seal all of the
+/// frames at once into a single slice. The input unprotected data slice buffer
+/// will be cleared, although the actual unprotected data bytes are not
+/// modified.
+///
+///- self: an alts_grpc_record_protocol instance.
+///- unprotected_slices: the unprotected data to be protected.
+///- max_frame_data_size: maximum unprotected data size of a frame.
+///- protected_slices: slice buffer where the protected frames are appended.
+///
+/// This method returns TSI_OK in case of success or a specific error code in
+/// case of failure.
+///
+tsi_result alts_grpc_record_protocol_protect_frames(
+    alts_grpc_record_protocol* self, grpc_slice_buffer* unprotected_slices,
+    size_t max_frame_data_size, grpc_slice_buffer* protected_slices);
+
+///
+/// This methods performs unprotect operation on several full frames of
+/// protected data and appends unprotected data to unprotected_slices.
+/// Implementations may open all of the frames at once into a single slice. The
+/// input protected frames slice buffer will be cleared, although the actual
+/// protected data bytes are not modified.
+///
+///- self: an alts_grpc_record_protocol instance.
+///- protected_slices: full frames of protected data in grpc slices, one frame
+///  after another.
+///- frame_sizes: the size of each frame in protected_slices, including its
+///  header.
+///- num_frames: the array length of frame_sizes.
+///- unprotected_slices: slice buffer where unprotected data is appended.
+///
+/// This method returns TSI_OK in case of success or a specific error code in
+/// case of failure.
+///
+tsi_result alts_grpc_record_protocol_unprotect_frames(
+    alts_grpc_record_protocol* self, grpc_slice_buffer* protected_slices,
+    const size_t* frame_sizes, size_t num_frames,
+    grpc_slice_buffer* unprotected_slices);
+
 ///
 /// This method returns maximum allowed unprotected data size, given maximum
 /// protected frame size.
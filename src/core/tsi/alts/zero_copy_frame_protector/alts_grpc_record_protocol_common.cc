@@ -31,26 +31,41 @@
 
 const size_t kInitialIovecBufferSize = 8;
 
-// Makes sure iovec_buf in alts_grpc_record_protocol is large enough.
-static void ensure_iovec_buf_size(alts_grpc_record_protocol* rp,
-                                  const grpc_slice_buffer* sb) {
-  GPR_ASSERT(rp != nullptr && sb != nullptr);
-  if (sb->count <= rp->iovec_buf_length) {
+// --- Implementation of methods defined in tsi_grpc_record_protocol_common.h.
+// ---
+
+void alts_grpc_record_protocol_reserve_iovec_buf(alts_grpc_record_protocol* rp,
+                                                 size_t length) {
+  GPR_ASSERT(rp != nullptr);
+  if (length <= rp->iovec_buf_length) {
     return;
   }
   // At least double the iovec buffer size.
-  rp->iovec_buf_length = std::max(sb->count, 2 * rp->iovec_buf_length);
+  rp->iovec_buf_length = std::max(length, 2 * rp->iovec_buf_length);
   rp->iovec_buf = static_cast<iovec_t*>(
       gpr_realloc(rp->iovec_buf, rp->iovec_buf_length * sizeof(iovec_t)));
 }
 
-// --- Implementation of methods defined in tsi_grpc_record_protocol_common.h.
-// ---
+void alts_grpc_record_protocol_reserve_frame_bufs(alts_grpc_record_protocol* rp,
+                                                  size_t num_frames) {
+  GPR_ASSERT(rp != nullptr);
+  if (num_frames <= rp->frame_buf_length) {
+    return;
+  }
+  // At least double the scratch space.
+  rp->frame_buf_length = std::max(num_frames, 2 * rp->frame_buf_length);
+  rp->frame_vec_lengths = static_cast<size_t*>(gpr_realloc(
+      rp->frame_vec_lengths, rp->frame_buf_length * sizeof(size_t)));
+  rp->frame_headers = static_cast<iovec_t*>(gpr_realloc(
+      rp->frame_headers, rp->frame_buf_length * sizeof(iovec_t)));
+  rp->frame_header_buf = static_cast<unsigned char*>(gpr_realloc(
+      rp->frame_header_buf, rp->frame_buf_length * rp->header_length));
+}
 
 void alts_grpc_record_protocol_convert_slice_buffer_to_iovec(
     alts_grpc_record_protocol* rp, const grpc_slice_buffer* sb) {
   GPR_ASSERT(rp != nullptr && sb != nullptr);
-  ensure_iovec_buf_size(rp, sb);
+  alts_grpc_record_protocol_reserve_iovec_buf(rp, sb->count);
   for (size_t i = 0; i < sb->count; i++) {
     rp->iovec_buf[i].iov_base = GRPC_SLICE_START_PTR(sb->slices[i]);
     rp->iovec_buf[i].iov_len = GRPC_SLICE_LENGTH(sb->slices[i]);
@@ -148,6 +163,77 @@ tsi_result alts_grpc_record_protocol_unprotect(
   return self->vtable->unprotect(self, protected_slices, unprotected_slices);
 }
 
+tsi_result alts_grpc_record_protocol_protect_frames(
+    alts_grpc_record_protocol* self, grpc_slice_buffer* unprotected_slices,
+    size_t max_frame_data_size, grpc_slice_buffer* protected_slices) {
+  if (grpc_core::ExecCtx::Get() == nullptr || self == nullptr ||
+      self->vtable == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr || max_frame_data_size == 0) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  if (self->vtable->protect_frames != nullptr) {
+    return self->vtable->protect_frames(self, unprotected_slices,
+                                        max_frame_data_size, protected_slices);
+  }
+  if (self->vtable->protect == nullptr) {
+    return TSI_UNIMPLEMENTED;
+  }
+  // Protects one frame at a time.
+  grpc_slice_buffer frame_sb;
+  grpc_slice_buffer_init(&frame_sb);
+  tsi_result result = TSI_OK;
+  while (result == TSI_OK && unprotected_slices->length > max_frame_data_size) {
+    grpc_slice_buffer_move_first(unprotected_slices, max_frame_data_size,
+                                 &frame_sb);
+    result = self->vtable->protect(self, &frame_sb, protected_slices);
+  }
+  if (result == TSI_OK) {
+    result = self->vtable->protect(self, unprotected_slices, protected_slices);
+  }
+  grpc_slice_buffer_destroy(&frame_sb);
+  return result;
+}
+
+tsi_result alts_grpc_record_protocol_unprotect_frames(
+    alts_grpc_record_protocol* self, grpc_slice_buffer* protected_slices,
+    const size_t* frame_sizes, size_t num_frames,
+    grpc_slice_buffer* unprotected_slices) {
+  if (grpc_core::ExecCtx::Get() == nullptr || self == nullptr ||
+      self->vtable == nullptr || protected_slices == nullptr ||
+      frame_sizes == nullptr || num_frames == 0 ||
+      unprotected_slices == nullptr) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  size_t total_frame_size = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    total_frame_size += frame_sizes[i];
+  }
+  if (total_frame_size != protected_slices->length) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  if (self->vtable->unprotect_frames != nullptr) {
+    return self->vtable->unprotect_frames(self, protected_slices, frame_sizes,
+                                          num_frames, unprotected_slices);
+  }
+  if (self->vtable->unprotect == nullptr) {
+    return TSI_UNIMPLEMENTED;
+  }
+  // Unprotects one frame at a time.
+  grpc_slice_buffer frame_sb;
+  grpc_slice_buffer_init(&frame_sb);
+  tsi_result result = TSI_OK;
+  for (size_t i = 0; result == TSI_OK && i + 1 < num_frames; ++i) {
+    grpc_slice_buffer_move_first(protected_slices, frame_sizes[i], &frame_sb);
+    result = self->vtable->unprotect(self, &frame_sb, unprotected_slices);
+  }
+  if (result == TSI_OK) {
+    result =
+        self->vtable->unprotect(self, protected_slices, unprotected_slices);
+  }
+  grpc_slice_buffer_destroy(&frame_sb);
+  return result;
+}
+
 void alts_grpc_record_protocol_destroy(alts_grpc_record_protocol* self) {
   if (self == nullptr) {
     return;
@@ -159,6 +245,9 @@ void alts_grpc_record_protocol_destroy(alts_grpc_record_protocol* self) {
   grpc_slice_buffer_destroy(&self->header_sb);
   gpr_free(self->header_buf);
   gpr_free(self->iovec_buf);
+  gpr_free(self->frame_vec_lengths);
+  gpr_free(self->frame_headers);
+  gpr_free(self->frame_header_buf);
   gpr_free(self);
 }
 
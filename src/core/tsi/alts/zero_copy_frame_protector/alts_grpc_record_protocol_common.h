@@ -39,6 +39,16 @@ struct alts_grpc_record_protocol_vtable {
                           grpc_slice_buffer* protected_slices,
                           grpc_slice_buffer* unprotected_slices);
   void (*destruct)(alts_grpc_record_protocol* self);
+  // Optional. If nullptr, the frames are protected or unprotected one at a
+  // time.
+  tsi_result (*protect_frames)(alts_grpc_record_protocol* self,
+                               grpc_slice_buffer* unprotected_slices,
+                               size_t max_frame_data_size,
+                               grpc_slice_buffer* protected_slices);
+  tsi_result (*unprotect_frames)(alts_grpc_record_protocol* self,
+                                 grpc_slice_buffer* protected_slices,
+                                 const size_t* frame_sizes, size_t num_frames,
+                                 grpc_slice_buffer* unprotected_slices);
 };
 // Main struct for alts_grpc_record_protocol implementation, shared by both
 // integrity-only record protocol and privacy-integrity record protocol.
@@ -53,6 +63,12 @@ struct alts_grpc_record_protocol {
   size_t tag_length;
   iovec_t* iovec_buf;
   size_t iovec_buf_length;
+  // Per-frame scratch space for protect_frames and unprotect_frames, grown as
+  // needed so that batches of up to frame_buf_length frames do not allocate.
+  size_t* frame_vec_lengths;
+  iovec_t* frame_headers;
+  unsigned char* frame_header_buf;
+  size_t frame_buf_length;
 };
 
 ///
@@ -63,6 +79,18 @@ struct alts_grpc_record_protocol {
 void alts_grpc_record_protocol_convert_slice_buffer_to_iovec(
     alts_grpc_record_protocol* rp, const grpc_slice_buffer* sb);
 
+///
+/// Makes sure rp->iovec_buf can hold at least length iovec_t's.
+///
+void alts_grpc_record_protocol_reserve_iovec_buf(alts_grpc_record_protocol* rp,
+                                                 size_t length);
+
+///
+/// Makes sure the per-frame scratch space of rp can hold num_frames frames.
+///
+void alts_grpc_record_protocol_reserve_frame_bufs(alts_grpc_record_protocol* rp,
+                                                  size_t num_frames);
+
 ///
 /// Copies bytes from slice buffer to destination buffer. Caller is responsible
 /// for allocating enough memory of destination buffer. This method is used for
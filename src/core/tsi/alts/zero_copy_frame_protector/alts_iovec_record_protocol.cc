@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
@@ -34,6 +36,11 @@ struct alts_iovec_record_protocol {
   size_t tag_length;
   bool is_integrity_only;
   bool is_protect;
+  // Scratch space for batch operations, grown as needed, so that batches of
+  // up to batch_capacity frames do not allocate.
+  gsec_aead_batch_op* batch_ops;
+  unsigned char* batch_nonces;
+  size_t batch_capacity;
 };
 
 // Copies error message to destination.
@@ -426,6 +433,223 @@ grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect(
   return increment_counter(rp->ctr, error_details);
 }
 
+// Checks that rp may perform privacy-integrity operations in the given
+// direction.
+static grpc_status_code ensure_privacy_integrity(
+    const alts_iovec_record_protocol* rp, bool is_protect,
+    char** error_details) {
+  if (rp == nullptr) {
+    maybe_copy_error_msg("Input iovec_record_protocol is nullptr.",
+                         error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (rp->is_integrity_only) {
+    maybe_copy_error_msg(
+        "Privacy-integrity operations are not allowed for this object.",
+        error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  if (rp->is_protect != is_protect) {
+    maybe_copy_error_msg(
+        is_protect ? "Protect operations are not allowed for this object."
+                   : "Unprotect operations are not allowed for this object.",
+        error_details);
+    return GRPC_STATUS_FAILED_PRECONDITION;
+  }
+  return GRPC_STATUS_OK;
+}
+
+// Copies the current counter into nonce and increments the counter, so that
+// the nonces of a batch of frames can be computed before any of them is
+// sealed or opened.
+static grpc_status_code take_nonce(alts_iovec_record_protocol* rp,
+                                   unsigned char* nonce,
+                                   char** error_details) {
+  memcpy(nonce, alts_counter_get_counter(rp->ctr),
+         alts_counter_get_size(rp->ctr));
+  return increment_counter(rp->ctr, error_details);
+}
+
+// Makes sure the batch scratch space of rp can hold num_frames frames.
+static void reserve_batch(alts_iovec_record_protocol* rp, size_t num_frames) {
+  if (num_frames <= rp->batch_capacity) {
+    return;
+  }
+  // At least double the scratch space.
+  rp->batch_capacity = std::max(num_frames, 2 * rp->batch_capacity);
+  rp->batch_ops = static_cast<gsec_aead_batch_op*>(gpr_realloc(
+      rp->batch_ops, rp->batch_capacity * sizeof(gsec_aead_batch_op)));
+  rp->batch_nonces = static_cast<unsigned char*>(gpr_realloc(
+      rp->batch_nonces, rp->batch_capacity * alts_counter_get_size(rp->ctr)));
+}
+
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect_batch(
+    alts_iovec_record_protocol* rp, const iovec_t* unprotected_vec,
+    const size_t* frame_vec_lengths, size_t num_frames,
+    iovec_t protected_frames, char** error_details) {
+  grpc_status_code status =
+      ensure_privacy_integrity(rp, /*is_protect=*/true, error_details);
+  if (status != GRPC_STATUS_OK) {
+    return status;
+  }
+  if (num_frames == 0 || frame_vec_lengths == nullptr) {
+    maybe_copy_error_msg("No frames to protect.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  if (protected_frames.iov_base == nullptr) {
+    maybe_copy_error_msg("Protected frames buffer is nullptr.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  // Ensures protected frames iovec has sufficient size.
+  const size_t header_length = alts_iovec_record_protocol_get_header_length();
+  size_t total_length = 0;
+  size_t vec_index = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    total_length +=
+        header_length +
+        get_total_length(unprotected_vec + vec_index, frame_vec_lengths[i]) +
+        rp->tag_length;
+    vec_index += frame_vec_lengths[i];
+  }
+  if (protected_frames.iov_len != total_length) {
+    maybe_copy_error_msg("Protected frames size is incorrect.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  // Writes the frame headers and takes a nonce for each frame, then seals all
+  // of the frames with one call.
+  const size_t nonce_length = alts_counter_get_size(rp->ctr);
+  reserve_batch(rp, num_frames);
+  gsec_aead_batch_op* ops = rp->batch_ops;
+  unsigned char* nonces = rp->batch_nonces;
+  unsigned char* frame = static_cast<unsigned char*>(protected_frames.iov_base);
+  vec_index = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    const iovec_t* frame_vec = unprotected_vec + vec_index;
+    size_t data_length = get_total_length(frame_vec, frame_vec_lengths[i]);
+    status = write_frame_header(data_length + rp->tag_length, frame,
+                                error_details);
+    if (status == GRPC_STATUS_OK) {
+      status = take_nonce(rp, nonces + i * nonce_length, error_details);
+    }
+    if (status != GRPC_STATUS_OK) {
+      return status;
+    }
+    ops[i].nonce = nonces + i * nonce_length;
+    ops[i].nonce_length = nonce_length;
+    ops[i].aad_vec = nullptr;
+    ops[i].aad_vec_length = 0;
+    ops[i].input_vec = frame_vec;
+    ops[i].input_vec_length = frame_vec_lengths[i];
+    ops[i].output.iov_base = frame + header_length;
+    ops[i].output.iov_len = data_length + rp->tag_length;
+    ops[i].bytes_written = 0;
+    frame += header_length + data_length + rp->tag_length;
+    vec_index += frame_vec_lengths[i];
+  }
+  status = gsec_aead_crypter_encrypt_batch(rp->crypter, ops, num_frames,
+                                           error_details);
+  for (size_t i = 0; status == GRPC_STATUS_OK && i < num_frames; ++i) {
+    if (ops[i].bytes_written != ops[i].output.iov_len) {
+      maybe_copy_error_msg(
+          "Bytes written expects to be data length plus tag length.",
+          error_details);
+      status = GRPC_STATUS_INTERNAL;
+    }
+  }
+  return status;
+}
+
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect_batch(
+    alts_iovec_record_protocol* rp, const iovec_t* headers,
+    const iovec_t* protected_vec, const size_t* frame_vec_lengths,
+    size_t num_frames, iovec_t unprotected_data, char** error_details) {
+  grpc_status_code status =
+      ensure_privacy_integrity(rp, /*is_protect=*/false, error_details);
+  if (status != GRPC_STATUS_OK) {
+    return status;
+  }
+  if (num_frames == 0 || headers == nullptr || frame_vec_lengths == nullptr) {
+    maybe_copy_error_msg("No frames to unprotect.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  // Verifies the frame headers and ensures unprotected data iovec has
+  // sufficient size.
+  size_t total_length = 0;
+  size_t vec_index = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    size_t protected_data_length =
+        get_total_length(protected_vec + vec_index, frame_vec_lengths[i]);
+    if (protected_data_length < rp->tag_length) {
+      maybe_copy_error_msg(
+          "Protected data length should be more than the tag length.",
+          error_details);
+      return GRPC_STATUS_INVALID_ARGUMENT;
+    }
+    if (headers[i].iov_base == nullptr ||
+        headers[i].iov_len != alts_iovec_record_protocol_get_header_length()) {
+      maybe_copy_error_msg("Header is nullptr or has incorrect length.",
+                           error_details);
+      return GRPC_STATUS_INVALID_ARGUMENT;
+    }
+    status = verify_frame_header(
+        protected_data_length,
+        static_cast<unsigned char*>(headers[i].iov_base), error_details);
+    if (status != GRPC_STATUS_OK) {
+      return status;
+    }
+    total_length += protected_data_length - rp->tag_length;
+    vec_index += frame_vec_lengths[i];
+  }
+  if (unprotected_data.iov_len != total_length ||
+      (total_length > 0 && unprotected_data.iov_base == nullptr)) {
+    maybe_copy_error_msg("Unprotected data size is incorrect.", error_details);
+    return GRPC_STATUS_INVALID_ARGUMENT;
+  }
+  // Takes a nonce for each frame, then opens all of the frames with one call.
+  const size_t nonce_length = alts_counter_get_size(rp->ctr);
+  reserve_batch(rp, num_frames);
+  gsec_aead_batch_op* ops = rp->batch_ops;
+  unsigned char* nonces = rp->batch_nonces;
+  unsigned char* data = static_cast<unsigned char*>(unprotected_data.iov_base);
+  vec_index = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    const iovec_t* frame_vec = protected_vec + vec_index;
+    size_t data_length = get_total_length(frame_vec, frame_vec_lengths[i]) -
+                         rp->tag_length;
+    status = take_nonce(rp, nonces + i * nonce_length, error_details);
+    if (status != GRPC_STATUS_OK) {
+      return status;
+    }
+    ops[i].nonce = nonces + i * nonce_length;
+    ops[i].nonce_length = nonce_length;
+    ops[i].aad_vec = nullptr;
+    ops[i].aad_vec_length = 0;
+    ops[i].input_vec = frame_vec;
+    ops[i].input_vec_length = frame_vec_lengths[i];
+    ops[i].output.iov_base = data;
+    ops[i].output.iov_len = data_length;
+    ops[i].bytes_written = 0;
+    data += data_length;
+    vec_index += frame_vec_lengths[i];
+  }
+  status = gsec_aead_crypter_decrypt_batch(rp->crypter, ops, num_frames,
+                                           error_details);
+  if (status != GRPC_STATUS_OK) {
+    maybe_append_error_msg(" Frame decryption failed.", error_details);
+    status = GRPC_STATUS_INTERNAL;
+  }
+  for (size_t i = 0; status == GRPC_STATUS_OK && i < num_frames; ++i) {
+    if (ops[i].bytes_written != ops[i].output.iov_len) {
+      maybe_copy_error_msg(
+          "Bytes written expects to be protected data length minus tag "
+          "length.",
+          error_details);
+      status = GRPC_STATUS_INTERNAL;
+    }
+  }
+  return status;
+}
+
 grpc_status_code alts_iovec_record_protocol_create(
     gsec_aead_crypter* crypter, size_t overflow_size, bool is_client,
     bool is_integrity_only, bool is_protect, alts_iovec_record_protocol** rp,
@@ -473,6 +697,8 @@ void alts_iovec_record_protocol_destroy(alts_iovec_record_protocol* rp) {
   if (rp != nullptr) {
     alts_counter_destroy(rp->ctr);
     gsec_aead_crypter_destroy(rp->crypter);
+    gpr_free(rp->batch_ops);
+    gpr_free(rp->batch_nonces);
     gpr_free(rp);
   }
 }
@@ -159,6 +159,59 @@ grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect(
     const iovec_t* protected_vec, size_t protected_vec_length,
     iovec_t unprotected_data, char** error_details);
 
+///
+/// This method performs privacy-integrity protect operation on a batch of
+/// frames, i.e., computes num_frames consecutive protected frames with a single
+/// batched AEAD call. The caller needs to allocate the memory for the protected
+/// frames prior to calling this method.
+///
+///- rp: an alts_iovec_record_protocol instance.
+///- unprotected_vec: an iovec array containing the unprotected data of all the
+///  frames, one frame after another.
+///- frame_vec_lengths: an array containing, for each frame, the number of
+///  iovecs of unprotected_vec that hold its unprotected data.
+///- num_frames: the array length of frame_vec_lengths.
+///- protected_frames: an iovec containing the output protected frames, one
+///  frame after another. Its length must be the total length of the frames.
+///- error_details: a buffer containing an error message if the method does not
+///  function correctly. It is OK to pass nullptr into error_details.
+///
+/// On success, the method returns GRPC_STATUS_OK. Otherwise, it returns an
+/// error status code along with its details specified in error_details (if
+/// error_details is not nullptr).
+///
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_protect_batch(
+    alts_iovec_record_protocol* rp, const iovec_t* unprotected_vec,
+    const size_t* frame_vec_lengths, size_t num_frames,
+    iovec_t protected_frames, char** error_details);
+
+///
+/// This method performs privacy-integrity unprotect operation on a batch of
+/// full protected frames, i.e., computes the unprotected data of num_frames
+/// consecutive frames with a single batched AEAD call. The caller needs to
+/// allocate the memory for the unprotected data prior to calling this method.
+///
+///- rp: an alts_iovec_record_protocol instance.
+///- headers: an iovec array containing the header of each frame.
+///- protected_vec: an iovec array containing the protected data, including
+///  the tag, of all the frames, one frame after another.
+///- frame_vec_lengths: an array containing, for each frame, the number of
+///  iovecs of protected_vec that hold its protected data.
+///- num_frames: the array length of headers and frame_vec_lengths.
+///- unprotected_data: an iovec containing the output unprotected data of all
+///  the frames, one frame after another.
+///- error_details: a buffer containing an error message if the method does not
+///  function correctly. It is OK to pass nullptr into error_details.
+///
+/// On success, the method returns GRPC_STATUS_OK. Otherwise, it returns an
+/// error status code along with its details specified in error_details (if
+/// error_details is not nullptr).
+///
+grpc_status_code alts_iovec_record_protocol_privacy_integrity_unprotect_batch(
+    alts_iovec_record_protocol* rp, const iovec_t* headers,
+    const iovec_t* protected_vec, const size_t* frame_vec_lengths,
+    size_t num_frames, iovec_t unprotected_data, char** error_details);
+
 ///
 /// This method creates an alts_iovec_record_protocol instance, given a
 /// gsec_aead_crypter instance, a flag indicating if the created instance will
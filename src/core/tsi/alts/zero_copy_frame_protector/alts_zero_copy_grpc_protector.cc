@@ -22,6 +22,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
@@ -38,6 +40,13 @@
 constexpr size_t kMinFrameLength = 1024;
 constexpr size_t kDefaultFrameLength = 16 * 1024;
 constexpr size_t kMaxFrameLength = 16 * 1024 * 1024;
+// Maximum number of frames, and of bytes of protected frames, sealed or opened
+// by one call to the record protocol. Batching amortizes the per-frame
+// allocation and setup. The byte limit keeps each batch's output slice below
+// malloc's mmap threshold: larger slices are mapped and faulted in afresh on
+// every batch, which costs more than batching saves.
+constexpr size_t kMaxFramesPerBatch = 16;
+constexpr size_t kMaxBatchSize = 64 * 1024;
 
 ///
 /// Main struct for alts_zero_copy_grpc_protector.
@@ -156,20 +165,26 @@ static tsi_result alts_zero_copy_grpc_protector_protect(
   }
   alts_zero_copy_grpc_protector* protector =
       reinterpret_cast<alts_zero_copy_grpc_protector*>(self);
-  // Calls alts_grpc_record_protocol protect repeatly.
-  while (unprotected_slices->length > protector->max_unprotected_data_size) {
-    grpc_slice_buffer_move_first(unprotected_slices,
-                                 protector->max_unprotected_data_size,
+  // Calls alts_grpc_record_protocol protect_frames repeatedly, with up to
+  // kMaxFramesPerBatch frames and kMaxBatchSize bytes of frames each time.
+  const size_t frames_per_batch = std::max<size_t>(
+      1, std::min(kMaxFramesPerBatch,
+                  kMaxBatchSize / protector->max_protected_frame_size));
+  const size_t max_batch_size =
+      frames_per_batch * protector->max_unprotected_data_size;
+  while (unprotected_slices->length > max_batch_size) {
+    grpc_slice_buffer_move_first(unprotected_slices, max_batch_size,
                                  &protector->unprotected_staging_sb);
-    tsi_result status = alts_grpc_record_protocol_protect(
+    tsi_result status = alts_grpc_record_protocol_protect_frames(
         protector->record_protocol, &protector->unprotected_staging_sb,
-        protected_slices);
+        protector->max_unprotected_data_size, protected_slices);
     if (status != TSI_OK) {
       return status;
     }
   }
-  return alts_grpc_record_protocol_protect(
-      protector->record_protocol, unprotected_slices, protected_slices);
+  return alts_grpc_record_protocol_protect_frames(
+      protector->record_protocol, unprotected_slices,
+      protector->max_unprotected_data_size, protected_slices);
 }
 
 static tsi_result alts_zero_copy_grpc_protector_unprotect(
@@ -184,36 +199,49 @@ static tsi_result alts_zero_copy_grpc_protector_unprotect(
   alts_zero_copy_grpc_protector* protector =
       reinterpret_cast<alts_zero_copy_grpc_protector*>(self);
   grpc_slice_buffer_move_into(protected_slices, &protector->protected_sb);
-  // Keep unprotecting each frame if possible.
-  while (protector->protected_sb.length >= kZeroCopyFrameLengthFieldSize) {
-    if (protector->parsed_frame_size == 0) {
-      // We have not parsed frame size yet. Parses frame size.
-      if (!read_frame_size(&protector->protected_sb,
-                           &protector->parsed_frame_size)) {
-        grpc_slice_buffer_reset_and_unref(&protector->protected_sb);
-        return TSI_DATA_CORRUPTED;
+  // Keep unprotecting full frames if possible, up to kMaxFramesPerBatch
+  // frames and kMaxBatchSize bytes at a time.
+  size_t frame_sizes[kMaxFramesPerBatch];
+  size_t num_frames = 0;
+  size_t batch_size = 0;
+  while (true) {
+    bool has_full_frame = false;
+    if (protector->protected_sb.length >= kZeroCopyFrameLengthFieldSize) {
+      if (protector->parsed_frame_size == 0) {
+        // We have not parsed frame size yet. Parses frame size.
+        if (!read_frame_size(&protector->protected_sb,
+                             &protector->parsed_frame_size)) {
+          grpc_slice_buffer_reset_and_unref(&protector->protected_sb);
+          grpc_slice_buffer_reset_and_unref(&protector->protected_staging_sb);
+          return TSI_DATA_CORRUPTED;
+        }
       }
+      has_full_frame =
+          protector->protected_sb.length >= protector->parsed_frame_size;
     }
-    if (protector->protected_sb.length < protector->parsed_frame_size) break;
-    // At this point, protected_sb contains at least one frame of data.
-    tsi_result status;
-    if (protector->protected_sb.length == protector->parsed_frame_size) {
-      status = alts_grpc_record_protocol_unprotect(protector->unrecord_protocol,
-                                                   &protector->protected_sb,
-                                                   unprotected_slices);
-    } else {
-      grpc_slice_buffer_move_first(&protector->protected_sb,
-                                   protector->parsed_frame_size,
-                                   &protector->protected_staging_sb);
-      status = alts_grpc_record_protocol_unprotect(
+    // Opens the batch once it is full or no further frame is available.
+    if (num_frames > 0 &&
+        (!has_full_frame || num_frames == kMaxFramesPerBatch ||
+         batch_size + protector->parsed_frame_size > kMaxBatchSize)) {
+      tsi_result status = alts_grpc_record_protocol_unprotect_frames(
           protector->unrecord_protocol, &protector->protected_staging_sb,
-          unprotected_slices);
+          frame_sizes, num_frames, unprotected_slices);
+      num_frames = 0;
+      batch_size = 0;
+      if (status != TSI_OK) {
+        grpc_slice_buffer_reset_and_unref(&protector->protected_sb);
+        grpc_slice_buffer_reset_and_unref(&protector->protected_staging_sb);
+        return status;
+      }
     }
+    if (!has_full_frame) break;
+    // Moves the frame to the batch in protected_staging_sb.
+    grpc_slice_buffer_move_first(&protector->protected_sb,
+                                 protector->parsed_frame_size,
+                                 &protector->protected_staging_sb);
+    frame_sizes[num_frames++] = protector->parsed_frame_size;
+    batch_size += protector->parsed_frame_size;
     protector->parsed_frame_size = 0;
-    if (status != TSI_OK) {
-      grpc_slice_buffer_reset_and_unref(&protector->protected_sb);
-      return status;
-    }
   }
   if (min_progress_size != nullptr) {
     if (protector->parsed_frame_size > kZeroCopyFrameLengthFieldSize) {
@@ -255,7 +283,9 @@ static const tsi_zero_copy_grpc_protector_vtable
         alts_zero_copy_grpc_protector_protect,
         alts_zero_copy_grpc_protector_unprotect,
         alts_zero_copy_grpc_protector_destroy,
-        alts_zero_copy_grpc_protector_max_frame_size};
+        alts_zero_copy_grpc_protector_max_frame_size,
+        nullptr,  // enable_kernel_tx_offload
+};
 
 tsi_result alts_zero_copy_grpc_protector_create(
     const uint8_t* key, size_t key_size, bool is_rekey, bool is_client,
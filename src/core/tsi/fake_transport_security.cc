@@ -518,6 +518,7 @@ static const tsi_zero_copy_grpc_protector_vtable
         fake_zero_copy_grpc_protector_unprotect,
         fake_zero_copy_grpc_protector_destroy,
         fake_zero_copy_grpc_protector_max_frame_size,
+        nullptr,  // enable_kernel_tx_offload
 };
 
 // --- tsi_handshaker_result methods implementation. ---
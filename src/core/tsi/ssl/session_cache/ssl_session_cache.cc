@@ -20,20 +20,46 @@
 
 #include "src/core/tsi/ssl/session_cache/ssl_session_cache.h"
 
+#include <deque>
+#include <functional>
+#include <map>
+#include <utility>
+
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/tsi/ssl/session_cache/ssl_session.h"
 
 namespace tsi {
 
-/// Node for single cached session.
+namespace {
+
+// Caches are only split into shards once each shard would still hold this
+// many keys, so that small caches keep an exact LRU order.
+constexpr size_t kMinShardCapacity = 64;
+constexpr size_t kMaxShards = 16;
+
+constexpr size_t kSharedCacheCapacity = 4096;
+
+bool IsSingleUseSession(const SSL_SESSION* session) {
+#ifdef TLS1_3_VERSION
+  return SSL_SESSION_get_protocol_version(session) == TLS1_3_VERSION;
+#else
+  (void)session;
+  return false;
+#endif
+}
+
+}  // namespace
+
+/// Node for the sessions cached under a single key.
 class SslSessionLRUCache::Node {
  public:
   Node(const std::string& key, SslSessionPtr session) : key_(key) {
-    SetSession(std::move(session));
+    AddSession(std::move(session));
   }
 
   // Not copyable nor movable.
@@ -42,29 +68,72 @@ class SslSessionLRUCache::Node {
 
   const std::string& key() const { return key_; }
 
-  /// Returns a copy of the node's cache session.
-  SslSessionPtr CopySession() const { return session_->CopySession(); }
+  bool empty() const { return sessions_.empty(); }
+
+  /// Returns a copy of the newest session. A single-use session is removed,
+  /// since offering it again would likely fail resumption.
+  SslSessionPtr TakeSession() {
+    SslSessionPtr session = sessions_.back()->CopySession();
+    if (single_use_) sessions_.pop_back();
+    return session;
+  }
 
-  /// Set the \a session (which is moved) for the node.
-  void SetSession(SslSessionPtr session) {
-    session_ = SslCachedSession::Create(std::move(session));
+  /// Add the \a session (which is moved) to the node. Single-use sessions are
+  /// kept alongside each other, up to kMaxTicketsPerKey of them; any other
+  /// session replaces those that the node holds.
+  void AddSession(SslSessionPtr session) {
+    const bool single_use = IsSingleUseSession(session.get());
+    if (!single_use || !single_use_) sessions_.clear();
+    single_use_ = single_use;
+    sessions_.push_back(SslCachedSession::Create(std::move(session)));
+    if (sessions_.size() > kMaxTicketsPerKey) sessions_.pop_front();
   }
 
  private:
-  friend class SslSessionLRUCache;
+  friend class SslSessionLRUCache::Shard;
 
   std::string key_;
-  std::unique_ptr<SslCachedSession> session_;
+  // Oldest first.
+  std::deque<std::unique_ptr<SslCachedSession>> sessions_;
+  bool single_use_ = false;
 
   Node* next_ = nullptr;
   Node* prev_ = nullptr;
 };
 
-SslSessionLRUCache::SslSessionLRUCache(size_t capacity) : capacity_(capacity) {
-  GPR_ASSERT(capacity > 0);
-}
+/// LRU list of the nodes for a subset of the keys.
+class SslSessionLRUCache::Shard {
+ public:
+  Shard() = default;
+  ~Shard();
 
-SslSessionLRUCache::~SslSessionLRUCache() {
+  // Not copyable nor movable.
+  Shard(const Shard&) = delete;
+  Shard& operator=(const Shard&) = delete;
+
+  void set_capacity(size_t capacity) { capacity_ = capacity; }
+
+  size_t Size();
+  void Put(const std::string& key, SslSessionPtr session);
+  SslSessionPtr Get(const std::string& key);
+
+ private:
+  Node* FindLocked(const std::string& key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void Remove(Node* node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void PushFront(Node* node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void AssertInvariants() ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  grpc_core::Mutex lock_;
+  size_t capacity_ = 0;
+
+  Node* use_order_list_head_ ABSL_GUARDED_BY(lock_) = nullptr;
+  Node* use_order_list_tail_ ABSL_GUARDED_BY(lock_) = nullptr;
+  size_t use_order_list_size_ ABSL_GUARDED_BY(lock_) = 0;
+  std::map<std::string, Node*> entry_by_key_ ABSL_GUARDED_BY(lock_);
+};
+
+SslSessionLRUCache::Shard::~Shard() {
   Node* node = use_order_list_head_;
   while (node) {
     Node* next = node->next_;
@@ -73,12 +142,12 @@ SslSessionLRUCache::~SslSessionLRUCache() {
   }
 }
 
-size_t SslSessionLRUCache::Size() {
+size_t SslSessionLRUCache::Shard::Size() {
   grpc_core::MutexLock lock(&lock_);
   return use_order_list_size_;
 }
 
-SslSessionLRUCache::Node* SslSessionLRUCache::FindLocked(
+SslSessionLRUCache::Node* SslSessionLRUCache::Shard::FindLocked(
     const std::string& key) {
   auto it = entry_by_key_.find(key);
   if (it == entry_by_key_.end()) {
@@ -92,11 +161,12 @@ SslSessionLRUCache::Node* SslSessionLRUCache::FindLocked(
   return node;
 }
 
-void SslSessionLRUCache::Put(const char* key, SslSessionPtr session) {
+void SslSessionLRUCache::Shard::Put(const std::string& key,
+                                    SslSessionPtr session) {
   grpc_core::MutexLock lock(&lock_);
   Node* node = FindLocked(key);
   if (node != nullptr) {
-    node->SetSession(std::move(session));
+    node->AddSession(std::move(session));
     return;
   }
   node = new Node(key, std::move(session));
@@ -114,17 +184,23 @@ void SslSessionLRUCache::Put(const char* key, SslSessionPtr session) {
   }
 }
 
-SslSessionPtr SslSessionLRUCache::Get(const char* key) {
+SslSessionPtr SslSessionLRUCache::Shard::Get(const std::string& key) {
   grpc_core::MutexLock lock(&lock_);
-  // Key is only used for lookups.
   Node* node = FindLocked(key);
   if (node == nullptr) {
     return nullptr;
   }
-  return node->CopySession();
+  SslSessionPtr session = node->TakeSession();
+  if (node->empty()) {
+    Remove(node);
+    entry_by_key_.erase(node->key());
+    delete node;
+    AssertInvariants();
+  }
+  return session;
 }
 
-void SslSessionLRUCache::Remove(SslSessionLRUCache::Node* node) {
+void SslSessionLRUCache::Shard::Remove(SslSessionLRUCache::Node* node) {
   if (node->prev_ == nullptr) {
     use_order_list_head_ = node->next_;
   } else {
@@ -139,7 +215,7 @@ void SslSessionLRUCache::Remove(SslSessionLRUCache::Node* node) {
   use_order_list_size_--;
 }
 
-void SslSessionLRUCache::PushFront(SslSessionLRUCache::Node* node) {
+void SslSessionLRUCache::Shard::PushFront(SslSessionLRUCache::Node* node) {
   if (use_order_list_head_ == nullptr) {
     use_order_list_head_ = node;
     use_order_list_tail_ = node;
@@ -155,13 +231,14 @@ void SslSessionLRUCache::PushFront(SslSessionLRUCache::Node* node) {
 }
 
 #ifndef NDEBUG
-void SslSessionLRUCache::AssertInvariants() {
+void SslSessionLRUCache::Shard::AssertInvariants() {
   size_t size = 0;
   Node* prev = nullptr;
   Node* current = use_order_list_head_;
   while (current != nullptr) {
     size++;
     GPR_ASSERT(current->prev_ == prev);
+    GPR_ASSERT(!current->empty());
     auto it = entry_by_key_.find(current->key());
     GPR_ASSERT(it != entry_by_key_.end());
     GPR_ASSERT(it->second == current);
@@ -173,7 +250,53 @@ void SslSessionLRUCache::AssertInvariants() {
   GPR_ASSERT(entry_by_key_.size() == use_order_list_size_);
 }
 #else
-void SslSessionLRUCache::AssertInvariants() {}
+void SslSessionLRUCache::Shard::AssertInvariants() {}
 #endif
 
+//
+// SslSessionLRUCache
+//
+
+constexpr size_t SslSessionLRUCache::kMaxTicketsPerKey;
+
+SslSessionLRUCache* SslSessionLRUCache::Shared() {
+  static SslSessionLRUCache* cache = Create(kSharedCacheCapacity).release();
+  return cache;
+}
+
+SslSessionLRUCache::SslSessionLRUCache(size_t capacity)
+    : num_shards_(grpc_core::Clamp<size_t>(capacity / kMinShardCapacity, 1,
+                                           kMaxShards)) {
+  GPR_ASSERT(capacity > 0);
+  shards_ = std::make_unique<Shard[]>(num_shards_);
+  for (size_t i = 0; i < num_shards_; ++i) {
+    shards_[i].set_capacity((capacity + num_shards_ - 1) / num_shards_);
+  }
+}
+
+SslSessionLRUCache::~SslSessionLRUCache() = default;
+
+SslSessionLRUCache::Shard* SslSessionLRUCache::ShardFor(
+    const std::string& key) {
+  return &shards_[std::hash<std::string>()(key) % num_shards_];
+}
+
+size_t SslSessionLRUCache::Size() {
+  size_t size = 0;
+  for (size_t i = 0; i < num_shards_; ++i) {
+    size += shards_[i].Size();
+  }
+  return size;
+}
+
+void SslSessionLRUCache::Put(const char* key, SslSessionPtr session) {
+  std::string key_str(key);
+  ShardFor(key_str)->Put(key_str, std::move(session));
+}
+
+SslSessionPtr SslSessionLRUCache::Get(const char* key) {
+  std::string key_str(key);
+  return ShardFor(key_str)->Get(key_str);
+}
+
 }  // namespace tsi
@@ -21,7 +21,10 @@
 
 #include <grpc/support/port_platform.h>
 
-#include <map>
+#include <stddef.h>
+
+#include <memory>
+#include <string>
 
 #include <openssl/ssl.h>
 
@@ -42,6 +45,14 @@
 /// name. Note that servers are required to share session ticket encryption keys
 /// in order for cache to be effective.
 ///
+/// Large caches are split into shards by key, each with its own lock and LRU
+/// list, so that concurrent handshakes to different servers do not contend.
+///
+/// TLS 1.3 tickets are meant to be used only once (RFC 8446, Appendix C.4),
+/// and servers usually issue several per connection, so up to
+/// kMaxTicketsPerKey of them are kept for each key and each one is handed out
+/// by a single Get(). Sessions of earlier versions are reused until replaced.
+///
 /// This class is thread safe.
 
 namespace tsi {
@@ -56,6 +67,11 @@ class SslSessionLRUCache
     return grpc_core::MakeRefCounted<SslSessionLRUCache>(capacity);
   }
 
+  /// Returns the process-wide cache, which is used by channels that set
+  /// GRPC_ARG_EXPERIMENTAL_SHARED_SSL_SESSION_CACHE instead of providing
+  /// their own cache. It is never destroyed.
+  static SslSessionLRUCache* Shared();
+
   // Use Create function instead of using this directly.
   explicit SslSessionLRUCache(size_t capacity);
   ~SslSessionLRUCache() override;
@@ -68,30 +84,26 @@ class SslSessionLRUCache
     return GRPC_SSL_SESSION_CACHE_ARG;
   }
 
-  /// Returns current number of sessions in the cache.
+  /// Returns current number of keys in the cache.
   size_t Size();
   /// Add \a session in the cache using \a key. This operation may discard older
   /// sessions.
   void Put(const char* key, SslSessionPtr session);
   /// Returns the session from the cache associated with \a key or null if not
-  /// found.
+  /// found. A TLS 1.3 session is removed from the cache.
   SslSessionPtr Get(const char* key);
 
+  /// Number of TLS 1.3 tickets kept per key.
+  static constexpr size_t kMaxTicketsPerKey = 4;
+
  private:
   class Node;
+  class Shard;
 
-  Node* FindLocked(const std::string& key);
-  void Remove(Node* node);
-  void PushFront(Node* node);
-  void AssertInvariants();
-
-  grpc_core::Mutex lock_;
-  size_t capacity_;
+  Shard* ShardFor(const std::string& key);
 
-  Node* use_order_list_head_ = nullptr;
-  Node* use_order_list_tail_ = nullptr;
-  size_t use_order_list_size_ = 0;
-  std::map<std::string, Node*> entry_by_key_;
+  std::unique_ptr<Shard[]> shards_;
+  size_t num_shards_;
 };
 
 }  // namespace tsi
@@ -33,34 +33,46 @@
 #include <sys/socket.h>
 #endif
 
+#include <algorithm>
 #include <string>
 
 #include <openssl/bio.h>
 #include <openssl/crypto.h>  // For OPENSSL_free
 #include <openssl/engine.h>
 #include <openssl/err.h>
+#include <openssl/sha.h>
 #include <openssl/ssl.h>
 #include <openssl/tls1.h>
 #include <openssl/x509.h>
 #include <openssl/x509v3.h>
 
+#include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 
 #include <grpc/grpc_security.h>
+#include <grpc/slice.h>
+#include <grpc/slice_buffer.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/thd_id.h>
 
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
+#include "src/core/lib/experiments/experiments.h"
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/slice/slice.h"
+#include "src/core/lib/slice/slice_internal.h"
 #include "src/core/tsi/ssl/key_logging/ssl_key_logging.h"
 #include "src/core/tsi/ssl/session_cache/ssl_session_cache.h"
 #include "src/core/tsi/ssl_transport_security_utils.h"
 #include "src/core/tsi/ssl_types.h"
 #include "src/core/tsi/transport_security.h"
+#include "src/core/tsi/transport_security_grpc.h"
 
 // --- Constants. ---
 
@@ -79,6 +91,19 @@
 // SSL structure. This is what we would ultimately want though...
 #define TSI_SSL_MAX_PROTECTION_OVERHEAD 100
 
+// Slices at least this large are sealed in place by the zero-copy protector.
+// Smaller ones are coalesced first, since each TLS record carries a header and
+// a tag.
+#define TSI_SSL_ZERO_COPY_DIRECT_WRITE_THRESHOLD 4096
+
+// The zero-copy protector decrypts into slices of this size, which holds the
+// plaintext of a full TLS record.
+#define TSI_SSL_ZERO_COPY_READ_SLICE_SIZE 16384
+
+// Records with less plaintext than this are copied out of the read slice, so
+// that a small record does not pin a whole read slice.
+#define TSI_SSL_ZERO_COPY_SMALL_READ_SIZE 256
+
 using TlsSessionKeyLogger = tsi::TlsSessionKeyLoggerCache::TlsSessionKeyLogger;
 
 // --- Structure definitions. ---
@@ -98,6 +123,10 @@ struct tsi_ssl_client_handshaker_factory {
   unsigned char* alpn_protocol_list;
   size_t alpn_protocol_list_length;
   grpc_core::RefCountedPtr<tsi::SslSessionLRUCache> session_cache;
+  // Prepended to the server name to form the session cache keys. It is a
+  // digest of the options that decide whether a server accepts this factory's
+  // sessions, so that a shared cache only hands them to equivalent factories.
+  char session_cache_key_prefix[2 * SHA256_DIGEST_LENGTH + 1];
   grpc_core::RefCountedPtr<TlsSessionKeyLogger> key_logger;
 };
 
@@ -138,6 +167,26 @@ struct tsi_ssl_frame_protector {
   size_t buffer_size;
   size_t buffer_offset;
 };
+// Used instead of tsi_ssl_frame_protector when the
+// ssl_zero_copy_frame_protector experiment is enabled. Plaintext moves between
+// the caller's slices and SSL without staging, but the ciphertext still
+// crosses the BIO pair, which costs one copy in each direction.
+struct tsi_ssl_zero_copy_grpc_protector {
+  tsi_zero_copy_grpc_protector base;
+  SSL* ssl;
+  BIO* network_io;
+  size_t max_frame_size;
+  // Largest plaintext that is sealed into one record.
+  size_t max_plaintext_size;
+  // Coalesces small unprotected slices into one record.
+  unsigned char* staging_buffer;
+  // The slice SSL_read decrypts into. It is kept across calls when a read
+  // produces nothing or is copied out.
+  grpc_slice read_slice;
+  // Set once the kernel encrypts outgoing records; protect then passes data
+  // through, and unprotect fails if SSL produces a record of its own.
+  bool kernel_tx_offload;
+};
 // --- Library Initialization. ---
 
 static gpr_once g_init_openssl_once = GPR_ONCE_INIT;
@@ -1014,6 +1063,257 @@ static const tsi_frame_protector_vtable frame_protector_vtable = {
     ssl_protector_destroy,
 };
 
+// --- tsi_zero_copy_grpc_protector methods implementation. ---
+
+// Moves the records pending in the network BIO to protected_slices. Returns
+// the number of bytes moved through drained_size.
+static tsi_result ssl_zero_copy_grpc_protector_drain(
+    tsi_ssl_zero_copy_grpc_protector* impl, grpc_slice_buffer* protected_slices,
+    size_t* drained_size) {
+  *drained_size = 0;
+  size_t pending = BIO_pending(impl->network_io);
+  while (pending > 0) {
+    GPR_ASSERT(pending <= INT_MAX);
+    grpc_slice slice = GRPC_SLICE_MALLOC(pending);
+    int read_from_bio = BIO_read(impl->network_io, GRPC_SLICE_START_PTR(slice),
+                                 static_cast<int>(pending));
+    if (read_from_bio <= 0) {
+      gpr_log(GPR_ERROR,
+              "Could not read from BIO even though some data is pending");
+      grpc_core::CSliceUnref(slice);
+      return TSI_INTERNAL_ERROR;
+    }
+    GRPC_SLICE_SET_LENGTH(slice, static_cast<size_t>(read_from_bio));
+    grpc_slice_buffer_add(protected_slices, slice);
+    *drained_size += static_cast<size_t>(read_from_bio);
+    pending = BIO_pending(impl->network_io);
+  }
+  return TSI_OK;
+}
+
+// Seals bytes into records of at most max_plaintext_size and appends them to
+// protected_slices.
+static tsi_result ssl_zero_copy_grpc_protector_seal(
+    tsi_ssl_zero_copy_grpc_protector* impl, const unsigned char* bytes,
+    size_t bytes_size, grpc_slice_buffer* protected_slices) {
+  while (bytes_size > 0) {
+    size_t record_size = std::min(bytes_size, impl->max_plaintext_size);
+    ERR_clear_error();
+    int ssl_write_result =
+        SSL_write(impl->ssl, bytes, static_cast<int>(record_size));
+    size_t drained_size;
+    if (ssl_write_result <= 0) {
+      int ssl_error = SSL_get_error(impl->ssl, ssl_write_result);
+      if (ssl_error == SSL_ERROR_WANT_READ) {
+        gpr_log(
+            GPR_ERROR,
+            "Peer tried to renegotiate SSL connection. This is unsupported.");
+        return TSI_UNIMPLEMENTED;
+      }
+      if (ssl_error != SSL_ERROR_WANT_WRITE) {
+        gpr_log(GPR_ERROR, "SSL_write failed with error %s.",
+                grpc_core::SslErrorString(ssl_error));
+        return TSI_INTERNAL_ERROR;
+      }
+      // The BIO pair is full. Drain it and retry the same write.
+      tsi_result result = ssl_zero_copy_grpc_protector_drain(
+          impl, protected_slices, &drained_size);
+      if (result != TSI_OK) return result;
+      if (drained_size == 0) {
+        gpr_log(GPR_ERROR, "SSL_write made no progress.");
+        return TSI_INTERNAL_ERROR;
+      }
+      continue;
+    }
+    tsi_result result = ssl_zero_copy_grpc_protector_drain(
+        impl, protected_slices, &drained_size);
+    if (result != TSI_OK) return result;
+    bytes += ssl_write_result;
+    bytes_size -= static_cast<size_t>(ssl_write_result);
+  }
+  return TSI_OK;
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_protect(
+    tsi_zero_copy_grpc_protector* self, grpc_slice_buffer* unprotected_slices,
+    grpc_slice_buffer* protected_slices) {
+  if (self == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr) {
+    gpr_log(GPR_ERROR, "Invalid nullptr arguments to zero-copy grpc protect.");
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  if (impl->kernel_tx_offload) {
+    grpc_slice_buffer_move_into(unprotected_slices, protected_slices);
+    return TSI_OK;
+  }
+  tsi_result result = TSI_OK;
+  size_t staging_offset = 0;
+  for (size_t i = 0; i < unprotected_slices->count && result == TSI_OK; i++) {
+    const grpc_slice& slice = unprotected_slices->slices[i];
+    const unsigned char* bytes = GRPC_SLICE_START_PTR(slice);
+    size_t bytes_size = GRPC_SLICE_LENGTH(slice);
+    if (bytes_size >= TSI_SSL_ZERO_COPY_DIRECT_WRITE_THRESHOLD) {
+      // Keep the byte order: whatever is staged goes out first.
+      if (staging_offset > 0) {
+        result = ssl_zero_copy_grpc_protector_seal(
+            impl, impl->staging_buffer, staging_offset, protected_slices);
+        staging_offset = 0;
+        if (result != TSI_OK) break;
+      }
+      result = ssl_zero_copy_grpc_protector_seal(impl, bytes, bytes_size,
+                                                 protected_slices);
+      continue;
+    }
+    while (bytes_size > 0) {
+      size_t to_copy =
+          std::min(bytes_size, impl->max_plaintext_size - staging_offset);
+      memcpy(impl->staging_buffer + staging_offset, bytes, to_copy);
+      staging_offset += to_copy;
+      bytes += to_copy;
+      bytes_size -= to_copy;
+      if (staging_offset == impl->max_plaintext_size) {
+        result = ssl_zero_copy_grpc_protector_seal(
+            impl, impl->staging_buffer, staging_offset, protected_slices);
+        staging_offset = 0;
+        if (result != TSI_OK) break;
+      }
+    }
+  }
+  if (result == TSI_OK && staging_offset > 0) {
+    result = ssl_zero_copy_grpc_protector_seal(
+        impl, impl->staging_buffer, staging_offset, protected_slices);
+  }
+  grpc_slice_buffer_reset_and_unref(unprotected_slices);
+  return result;
+}
+
+// Decrypts every complete record that SSL has received into
+// unprotected_slices.
+static tsi_result ssl_zero_copy_grpc_protector_open(
+    tsi_ssl_zero_copy_grpc_protector* impl,
+    grpc_slice_buffer* unprotected_slices) {
+  while (true) {
+    if (GRPC_SLICE_IS_EMPTY(impl->read_slice)) {
+      impl->read_slice = GRPC_SLICE_MALLOC(TSI_SSL_ZERO_COPY_READ_SLICE_SIZE);
+    }
+    size_t read_size = TSI_SSL_ZERO_COPY_READ_SLICE_SIZE;
+    tsi_result result = grpc_core::DoSslRead(
+        impl->ssl, GRPC_SLICE_START_PTR(impl->read_slice), &read_size);
+    if (result != TSI_OK || read_size == 0) return result;
+    if (read_size < TSI_SSL_ZERO_COPY_SMALL_READ_SIZE) {
+      grpc_slice_buffer_add(
+          unprotected_slices,
+          grpc_slice_from_copied_buffer(
+              reinterpret_cast<const char*>(
+                  GRPC_SLICE_START_PTR(impl->read_slice)),
+              read_size));
+    } else {
+      GRPC_SLICE_SET_LENGTH(impl->read_slice, read_size);
+      grpc_slice_buffer_add(unprotected_slices, impl->read_slice);
+      impl->read_slice = grpc_empty_slice();
+    }
+  }
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_unprotect(
+    tsi_zero_copy_grpc_protector* self, grpc_slice_buffer* protected_slices,
+    grpc_slice_buffer* unprotected_slices, int* min_progress_size) {
+  if (self == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr) {
+    gpr_log(GPR_ERROR,
+            "Invalid nullptr arguments to zero-copy grpc unprotect.");
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  tsi_result result = TSI_OK;
+  for (size_t i = 0; i < protected_slices->count && result == TSI_OK; i++) {
+    const grpc_slice& slice = protected_slices->slices[i];
+    const unsigned char* bytes = GRPC_SLICE_START_PTR(slice);
+    size_t bytes_size = GRPC_SLICE_LENGTH(slice);
+    while (bytes_size > 0) {
+      // The BIO pair may hold less than the slice, so feed it in pieces and
+      // let SSL consume each piece before writing more.
+      int written_into_bio = BIO_write(
+          impl->network_io, bytes,
+          static_cast<int>(std::min<size_t>(bytes_size, INT_MAX)));
+      if (written_into_bio <= 0) {
+        gpr_log(GPR_ERROR, "Sending protected frame to ssl failed with %d",
+                written_into_bio);
+        result = TSI_INTERNAL_ERROR;
+        break;
+      }
+      bytes += written_into_bio;
+      bytes_size -= static_cast<size_t>(written_into_bio);
+      result = ssl_zero_copy_grpc_protector_open(impl, unprotected_slices);
+      if (result != TSI_OK) break;
+    }
+  }
+  grpc_slice_buffer_reset_and_unref(protected_slices);
+  if (impl->kernel_tx_offload && BIO_pending(impl->network_io) > 0) {
+    // SSL wrote a record of its own, a fatal alert or a reply to a TLS 1.3
+    // KeyUpdate request, with keys the kernel now owns. It cannot be sent, so
+    // the connection must not go on without it.
+    gpr_log(GPR_ERROR,
+            "SSL produced a record that cannot be sent with kTLS enabled.");
+    if (result == TSI_OK) result = TSI_PROTOCOL_FAILURE;
+  }
+  if (min_progress_size != nullptr) {
+    // When SSL is waiting for the rest of a record, this is how much of it
+    // is still missing. It is bounded by the size of the BIO pair.
+    size_t read_request = BIO_ctrl_get_read_request(impl->network_io);
+    *min_progress_size =
+        read_request > 0 ? static_cast<int>(read_request) : 1;
+  }
+  return result;
+}
+
+static void ssl_zero_copy_grpc_protector_destroy(
+    tsi_zero_copy_grpc_protector* self) {
+  if (self == nullptr) return;
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  grpc_core::CSliceUnref(impl->read_slice);
+  if (impl->staging_buffer != nullptr) gpr_free(impl->staging_buffer);
+  if (impl->ssl != nullptr) SSL_free(impl->ssl);
+  if (impl->network_io != nullptr) BIO_free(impl->network_io);
+  gpr_free(self);
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_max_frame_size(
+    tsi_zero_copy_grpc_protector* self, size_t* max_frame_size) {
+  if (self == nullptr || max_frame_size == nullptr) return TSI_INVALID_ARGUMENT;
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  *max_frame_size = impl->max_frame_size;
+  return TSI_OK;
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_enable_kernel_tx_offload(
+    tsi_zero_copy_grpc_protector* self, int fd) {
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  if (impl->kernel_tx_offload) return TSI_OK;
+  // Records already sealed here but not yet sent would have to go out before
+  // the ones the kernel seals.
+  if (BIO_pending(impl->network_io) > 0) return TSI_FAILED_PRECONDITION;
+  tsi_result result =
+      grpc_core::SslEnableKernelTxOffload(impl->ssl, impl->network_io, fd);
+  if (result == TSI_OK) impl->kernel_tx_offload = true;
+  return result;
+}
+
+static const tsi_zero_copy_grpc_protector_vtable
+    zero_copy_grpc_protector_vtable = {
+        ssl_zero_copy_grpc_protector_protect,
+        ssl_zero_copy_grpc_protector_unprotect,
+        ssl_zero_copy_grpc_protector_destroy,
+        ssl_zero_copy_grpc_protector_max_frame_size,
+        ssl_zero_copy_grpc_protector_enable_kernel_tx_offload,
+};
+
 // --- tsi_server_handshaker_factory methods implementation. ---
 
 static void tsi_ssl_handshaker_factory_destroy(
@@ -1151,7 +1451,43 @@ static tsi_result ssl_handshaker_result_extract_peer(
 static tsi_result ssl_handshaker_result_get_frame_protector_type(
     const tsi_handshaker_result* /*self*/,
     tsi_frame_protector_type* frame_protector_type) {
-  *frame_protector_type = TSI_FRAME_PROTECTOR_NORMAL;
+  *frame_protector_type = grpc_core::IsSslZeroCopyFrameProtectorEnabled()
+                              ? TSI_FRAME_PROTECTOR_NORMAL_OR_ZERO_COPY
+                              : TSI_FRAME_PROTECTOR_NORMAL;
+  return TSI_OK;
+}
+
+static tsi_result ssl_handshaker_result_create_zero_copy_grpc_protector(
+    const tsi_handshaker_result* self, size_t* max_output_protected_frame_size,
+    tsi_zero_copy_grpc_protector** protector) {
+  size_t actual_max_output_protected_frame_size =
+      TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND;
+  tsi_ssl_handshaker_result* impl =
+      reinterpret_cast<tsi_ssl_handshaker_result*>(
+          const_cast<tsi_handshaker_result*>(self));
+  if (max_output_protected_frame_size != nullptr) {
+    *max_output_protected_frame_size =
+        grpc_core::Clamp<size_t>(*max_output_protected_frame_size,
+                                 TSI_SSL_MAX_PROTECTED_FRAME_SIZE_LOWER_BOUND,
+                                 TSI_SSL_MAX_PROTECTED_FRAME_SIZE_UPPER_BOUND);
+    actual_max_output_protected_frame_size = *max_output_protected_frame_size;
+  }
+  tsi_ssl_zero_copy_grpc_protector* protector_impl =
+      static_cast<tsi_ssl_zero_copy_grpc_protector*>(
+          gpr_zalloc(sizeof(*protector_impl)));
+  protector_impl->max_frame_size = actual_max_output_protected_frame_size;
+  protector_impl->max_plaintext_size =
+      actual_max_output_protected_frame_size - TSI_SSL_MAX_PROTECTION_OVERHEAD;
+  protector_impl->staging_buffer = static_cast<unsigned char*>(
+      gpr_malloc(protector_impl->max_plaintext_size));
+  protector_impl->read_slice = grpc_empty_slice();
+  // Transfer ownership of ssl and network_io to the frame protector.
+  protector_impl->ssl = impl->ssl;
+  impl->ssl = nullptr;
+  protector_impl->network_io = impl->network_io;
+  impl->network_io = nullptr;
+  protector_impl->base.vtable = &zero_copy_grpc_protector_vtable;
+  *protector = &protector_impl->base;
   return TSI_OK;
 }
 
@@ -1222,7 +1558,7 @@ static void ssl_handshaker_result_destroy(tsi_handshaker_result* self) {
 static const tsi_handshaker_result_vtable handshaker_result_vtable = {
     ssl_handshaker_result_extract_peer,
     ssl_handshaker_result_get_frame_protector_type,
-    nullptr,  // create_zero_copy_grpc_protector
+    ssl_handshaker_result_create_zero_copy_grpc_protector,
     ssl_handshaker_result_create_frame_protector,
     ssl_handshaker_result_get_unused_bytes,
     ssl_handshaker_result_destroy,
@@ -1254,6 +1590,19 @@ static tsi_result ssl_handshaker_result_create(
 
 // --- tsi_handshaker methods implementation. ---
 
+// The stats need an ExecCtx to pick a per-CPU shard. The security handshaker
+// drives handshakes under one; other TSI callers may not, and only they pay
+// for a temporary one.
+static void tsi_ssl_record_session_stat(
+    void (grpc_core::GlobalStatsCollector::*increment)()) {
+  if (grpc_core::ExecCtx::Get() != nullptr) {
+    (grpc_core::global_stats().*increment)();
+    return;
+  }
+  grpc_core::ExecCtx exec_ctx;
+  (grpc_core::global_stats().*increment)();
+}
+
 static tsi_result ssl_handshaker_get_bytes_to_send_to_peer(
     tsi_ssl_handshaker* impl, unsigned char* bytes, size_t* bytes_size,
     std::string* error) {
@@ -1469,12 +1818,18 @@ static tsi_result ssl_handshaker_next(tsi_handshaker* self,
       if (error != nullptr) *error = "More unused bytes than received bytes.";
       return TSI_INTERNAL_ERROR;
     }
+    const bool resumed_client_session =
+        !SSL_is_server(impl->ssl) && SSL_session_reused(impl->ssl);
     status = ssl_handshaker_result_create(impl, unused_bytes, unused_bytes_size,
                                           handshaker_result, error);
     if (status == TSI_OK) {
       // Indicates that the handshake has completed and that a handshaker_result
       // has been created.
       self->handshaker_result_created = true;
+      if (resumed_client_session) {
+        tsi_ssl_record_session_stat(
+            &grpc_core::GlobalStatsCollector::IncrementSslSessionsResumed);
+      }
     }
   }
   return status;
@@ -1493,16 +1848,27 @@ static const tsi_handshaker_vtable handshaker_vtable = {
 
 // --- tsi_ssl_handshaker_factory common methods. ---
 
+static std::string tsi_ssl_session_cache_key(
+    const tsi_ssl_client_handshaker_factory* factory, const char* server_name) {
+  return absl::StrCat(factory->session_cache_key_prefix, server_name);
+}
+
 static void tsi_ssl_handshaker_resume_session(
-    SSL* ssl, tsi::SslSessionLRUCache* session_cache) {
+    SSL* ssl, tsi_ssl_client_handshaker_factory* factory) {
   const char* server_name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
   if (server_name == nullptr) {
     return;
   }
-  tsi::SslSessionPtr session = session_cache->Get(server_name);
+  tsi::SslSessionPtr session = factory->session_cache->Get(
+      tsi_ssl_session_cache_key(factory, server_name).c_str());
   if (session != nullptr) {
+    tsi_ssl_record_session_stat(
+        &grpc_core::GlobalStatsCollector::IncrementSslSessionCacheHits);
     // SSL_set_session internally increments reference counter.
     SSL_set_session(ssl, session.get());
+  } else {
+    tsi_ssl_record_session_stat(
+        &grpc_core::GlobalStatsCollector::IncrementSslSessionCacheMisses);
   }
 }
 
@@ -1548,8 +1914,7 @@ static tsi_result create_tsi_ssl_handshaker(SSL_CTX* ctx, int is_client,
     tsi_ssl_client_handshaker_factory* client_factory =
         reinterpret_cast<tsi_ssl_client_handshaker_factory*>(factory);
     if (client_factory->session_cache != nullptr) {
-      tsi_ssl_handshaker_resume_session(ssl,
-                                        client_factory->session_cache.get());
+      tsi_ssl_handshaker_resume_session(ssl, client_factory);
     }
     ERR_clear_error();
     ssl_result = SSL_do_handshake(ssl);
@@ -1791,7 +2156,9 @@ static int server_handshaker_factory_new_session_callback(
   if (server_name == nullptr) {
     return 0;
   }
-  factory->session_cache->Put(server_name, tsi::SslSessionPtr(session));
+  factory->session_cache->Put(
+      tsi_ssl_session_cache_key(factory, server_name).c_str(),
+      tsi::SslSessionPtr(session));
   // Return 1 to indicate transferred ownership over the given session.
   return 1;
 }
@@ -1823,6 +2190,44 @@ static int verify_cb(int ok, X509_STORE_CTX* ctx) {
   return ok;
 }
 
+// Writes a hex encoded digest of the client options that decide whether a
+// server would accept a session to \a prefix. Factories created from different
+// credentials get different prefixes, and thus never offer each other's
+// sessions from a shared cache.
+static void tsi_ssl_client_session_cache_key_prefix(
+    const tsi_ssl_client_handshaker_options* options, char* prefix) {
+  std::string material;
+  auto add = [&material](absl::string_view value) {
+    material.append(value.data(), value.size());
+    material.push_back('\0');
+  };
+  add(options->pem_root_certs == nullptr ? "" : options->pem_root_certs);
+  add(absl::StrCat(reinterpret_cast<uintptr_t>(options->root_store)));
+  if (options->pem_key_cert_pair != nullptr) {
+    add(options->pem_key_cert_pair->cert_chain == nullptr
+            ? ""
+            : options->pem_key_cert_pair->cert_chain);
+    add(options->pem_key_cert_pair->private_key == nullptr
+            ? ""
+            : options->pem_key_cert_pair->private_key);
+  }
+  add(options->cipher_suites == nullptr ? "" : options->cipher_suites);
+  for (size_t i = 0; i < options->num_alpn_protocols; ++i) {
+    add(options->alpn_protocols[i]);
+  }
+  add(absl::StrCat(
+      static_cast<int>(options->skip_server_certificate_verification), ":",
+      static_cast<int>(options->min_tls_version), ":",
+      static_cast<int>(options->max_tls_version)));
+  add(options->crl_directory == nullptr ? "" : options->crl_directory);
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const unsigned char*>(material.data()),
+         material.size(), digest);
+  std::string hex = absl::BytesToHexString(
+      absl::string_view(reinterpret_cast<const char*>(digest), sizeof(digest)));
+  memcpy(prefix, hex.c_str(), hex.size() + 1);
+}
+
 // --- tsi_ssl_handshaker_factory constructors. ---
 
 static tsi_ssl_handshaker_factory_vtable client_handshaker_factory_vtable = {
@@ -1883,6 +2288,8 @@ tsi_result tsi_create_ssl_client_handshaker_factory_with_options(
     impl->session_cache =
         reinterpret_cast<tsi::SslSessionLRUCache*>(options->session_cache)
             ->Ref();
+    tsi_ssl_client_session_cache_key_prefix(options,
+                                            impl->session_cache_key_prefix);
     SSL_CTX_sess_set_new_cb(ssl_context,
                             server_handshaker_factory_new_session_callback);
     SSL_CTX_set_session_cache_mode(ssl_context, SSL_SESS_CACHE_CLIENT);
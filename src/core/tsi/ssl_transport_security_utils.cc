@@ -24,8 +24,41 @@
 #include <openssl/err.h>
 #include <openssl/ssl.h>
 
+#include <grpc/support/log.h>
+
 #include "src/core/tsi/transport_security_interface.h"
 
+// Kernel TLS needs the write keys and sequence number of the connection, which
+// only BoringSSL exposes while the records go through a BIO pair.
+#if defined(GPR_LINUX) && defined(OPENSSL_IS_BORINGSSL)
+#define GRPC_TSI_SSL_HAVE_KTLS 1
+#endif
+
+#ifdef GRPC_TSI_SSL_HAVE_KTLS
+#include <errno.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include <openssl/hkdf.h>
+#include <openssl/nid.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif  // GRPC_TSI_SSL_HAVE_KTLS
+
 namespace grpc_core {
 
 const char* SslErrorString(int error) {
@@ -247,4 +280,218 @@ tsi_result SslProtectorUnprotect(const unsigned char* protected_frames_bytes,
   return result;
 }
 
+#ifdef GRPC_TSI_SSL_HAVE_KTLS
+
+namespace {
+
+// Both AES-GCM suites use a 4-byte implicit salt and an 8-byte nonce.
+constexpr size_t kKtlsSaltSize = 4;
+constexpr size_t kKtlsIvSize = 8;
+constexpr size_t kKtlsMaxKeySize = 32;
+
+// Keys for one direction of a connection, in the form the kernel takes them.
+struct KtlsKeys {
+  uint16_t version;
+  size_t key_size;
+  uint8_t key[kKtlsMaxKeySize];
+  uint8_t salt[kKtlsSaltSize];
+  uint8_t iv[kKtlsIvSize];
+  uint8_t rec_seq[8];
+};
+
+// HKDF-Expand-Label from RFC 8446, section 7.1, with an empty context.
+bool Tls13ExpandLabel(const EVP_MD* digest, const uint8_t* secret,
+                      size_t secret_size, absl::string_view label,
+                      uint8_t* out, size_t out_size) {
+  std::string full_label = absl::StrCat("tls13 ", label);
+  std::vector<uint8_t> info;
+  info.push_back(static_cast<uint8_t>(out_size >> 8));
+  info.push_back(static_cast<uint8_t>(out_size));
+  info.push_back(static_cast<uint8_t>(full_label.size()));
+  info.insert(info.end(), full_label.begin(), full_label.end());
+  info.push_back(0);
+  return HKDF_expand(out, out_size, digest, secret, secret_size, info.data(),
+                     info.size()) == 1;
+}
+
+tsi_result GetKtlsWriteKeys(SSL* ssl, KtlsKeys* keys) {
+  keys->version = static_cast<uint16_t>(SSL_version(ssl));
+  if (keys->version != TLS1_2_VERSION && keys->version != TLS1_3_VERSION) {
+    return TSI_UNIMPLEMENTED;
+  }
+#ifndef TLS_1_3_VERSION
+  if (keys->version == TLS1_3_VERSION) return TSI_UNIMPLEMENTED;
+#endif
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) return TSI_FAILED_PRECONDITION;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+    case NID_aes_128_gcm:
+      keys->key_size = 16;
+      break;
+    case NID_aes_256_gcm:
+      keys->key_size = 32;
+      break;
+    default:
+      return TSI_UNIMPLEMENTED;
+  }
+  uint64_t sequence = SSL_get_write_sequence(ssl);
+  for (int i = 7; i >= 0; --i) {
+    keys->rec_seq[i] = static_cast<uint8_t>(sequence);
+    sequence >>= 8;
+  }
+  if (keys->version == TLS1_3_VERSION) {
+    bssl::Span<const uint8_t> read_secret;
+    bssl::Span<const uint8_t> write_secret;
+    if (!bssl::SSL_get_traffic_secrets(ssl, &read_secret, &write_secret)) {
+      return TSI_INTERNAL_ERROR;
+    }
+    const EVP_MD* digest = SSL_CIPHER_get_handshake_digest(cipher);
+    uint8_t nonce[kKtlsSaltSize + kKtlsIvSize];
+    if (!Tls13ExpandLabel(digest, write_secret.data(), write_secret.size(),
+                          "key", keys->key, keys->key_size) ||
+        !Tls13ExpandLabel(digest, write_secret.data(), write_secret.size(),
+                          "iv", nonce, sizeof(nonce))) {
+      OPENSSL_cleanse(nonce, sizeof(nonce));
+      return TSI_INTERNAL_ERROR;
+    }
+    // The kernel XORs the sequence number into the last 8 bytes itself.
+    memcpy(keys->salt, nonce, kKtlsSaltSize);
+    memcpy(keys->iv, nonce + kKtlsSaltSize, kKtlsIvSize);
+    OPENSSL_cleanse(nonce, sizeof(nonce));
+    return TSI_OK;
+  }
+  // The key block of an AEAD suite holds no MAC keys: the client and server
+  // write keys, then the client and server implicit nonces.
+  const size_t key_block_size = SSL_get_key_block_len(ssl);
+  if (key_block_size != 2 * (keys->key_size + kKtlsSaltSize)) {
+    return TSI_UNIMPLEMENTED;
+  }
+  std::vector<uint8_t> key_block(key_block_size);
+  if (!SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return TSI_INTERNAL_ERROR;
+  }
+  const bool is_server = SSL_is_server(ssl);
+  memcpy(keys->key, key_block.data() + (is_server ? keys->key_size : 0),
+         keys->key_size);
+  memcpy(keys->salt,
+         key_block.data() + 2 * keys->key_size + (is_server ? kKtlsSaltSize : 0),
+         kKtlsSaltSize);
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  // BoringSSL uses the sequence number as the explicit nonce; the kernel
+  // continues from here.
+  memcpy(keys->iv, keys->rec_seq, kKtlsIvSize);
+  return TSI_OK;
+}
+
+template <typename CryptoInfo>
+int SetKtlsCryptoInfo(int fd, uint16_t cipher_type, const KtlsKeys& keys) {
+  CryptoInfo crypto_info;
+  memset(&crypto_info, 0, sizeof(crypto_info));
+  static_assert(sizeof(crypto_info.salt) == kKtlsSaltSize, "");
+  static_assert(sizeof(crypto_info.iv) == kKtlsIvSize, "");
+  static_assert(sizeof(crypto_info.rec_seq) == sizeof(keys.rec_seq), "");
+  GPR_ASSERT(sizeof(crypto_info.key) == keys.key_size);
+#ifdef TLS_1_3_VERSION
+  crypto_info.info.version =
+      keys.version == TLS1_3_VERSION ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+#else
+  crypto_info.info.version = TLS_1_2_VERSION;
+#endif
+  crypto_info.info.cipher_type = cipher_type;
+  memcpy(crypto_info.key, keys.key, keys.key_size);
+  memcpy(crypto_info.salt, keys.salt, kKtlsSaltSize);
+  memcpy(crypto_info.iv, keys.iv, kKtlsIvSize);
+  memcpy(crypto_info.rec_seq, keys.rec_seq, sizeof(keys.rec_seq));
+  int result = setsockopt(fd, SOL_TLS, TLS_TX, &crypto_info,
+                          sizeof(crypto_info));
+  OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+  return result;
+}
+
+// A TLS 1.3 server does not send its session tickets until it first writes.
+// Flushes them and sends them on fd, so that they go out before the records
+// that the kernel seals and SSL's write sequence number accounts for them.
+tsi_result SendDeferredRecords(SSL* ssl, BIO* network_io, int fd) {
+  static const uint8_t kNothing[1] = {0};
+  if (SSL_write(ssl, kNothing, 0) < 0) return TSI_INTERNAL_ERROR;
+  size_t pending = BIO_pending(network_io);
+  if (pending == 0) return TSI_OK;
+  std::vector<uint8_t> records(pending);
+  if (BIO_read(network_io, records.data(), static_cast<int>(pending)) !=
+      static_cast<int>(pending)) {
+    return TSI_INTERNAL_ERROR;
+  }
+  // The handshake has just completed, so the socket has room for these few
+  // hundred bytes. If it does not take them all, they are lost and the
+  // connection cannot be used.
+  size_t sent = 0;
+  while (sent < records.size()) {
+    ssize_t n = send(fd, records.data() + sent, records.size() - sent,
+                     MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      gpr_log(GPR_ERROR, "Could not send TLS records on fd %d: %s", fd,
+              n < 0 ? strerror(errno) : "no progress");
+      return TSI_INTERNAL_ERROR;
+    }
+    sent += static_cast<size_t>(n);
+  }
+  return TSI_OK;
+}
+
+}  // namespace
+
+tsi_result SslEnableKernelTxOffload(SSL* ssl, BIO* network_io, int fd) {
+  if (SSL_version(ssl) == TLS1_3_VERSION) {
+    tsi_result result = SendDeferredRecords(ssl, network_io, fd);
+    if (result != TSI_OK) return result;
+  }
+  KtlsKeys keys;
+  tsi_result result = GetKtlsWriteKeys(ssl, &keys);
+  if (result != TSI_OK) {
+    OPENSSL_cleanse(&keys, sizeof(keys));
+    return result;
+  }
+  // Attaching the TLS upper layer protocol fails with ENOENT when the tls
+  // module is not loaded. Until TLS_TX is set, the socket behaves as before.
+  if (setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+    gpr_log(GPR_DEBUG, "Could not attach kTLS to fd %d: %s", fd,
+            strerror(errno));
+    OPENSSL_cleanse(&keys, sizeof(keys));
+    return TSI_UNIMPLEMENTED;
+  }
+  int set_result;
+  if (keys.key_size == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+    set_result = SetKtlsCryptoInfo<tls12_crypto_info_aes_gcm_128>(
+        fd, TLS_CIPHER_AES_GCM_128, keys);
+  } else {
+#ifdef TLS_CIPHER_AES_GCM_256
+    set_result = SetKtlsCryptoInfo<tls12_crypto_info_aes_gcm_256>(
+        fd, TLS_CIPHER_AES_GCM_256, keys);
+#else
+    set_result = -1;
+    errno = ENOTSUP;
+#endif
+  }
+  OPENSSL_cleanse(&keys, sizeof(keys));
+  if (set_result != 0) {
+    gpr_log(GPR_DEBUG, "Could not configure kTLS transmission on fd %d: %s",
+            fd, strerror(errno));
+    return TSI_UNIMPLEMENTED;
+  }
+  // SSL must not write a close_notify into the BIO pair, where nothing would
+  // send it.
+  SSL_set_quiet_shutdown(ssl, 1);
+  return TSI_OK;
+}
+
+#else  // GRPC_TSI_SSL_HAVE_KTLS
+
+tsi_result SslEnableKernelTxOffload(SSL* /*ssl*/, BIO* /*network_io*/,
+                                    int /*fd*/) {
+  return TSI_UNIMPLEMENTED;
+}
+
+#endif  // GRPC_TSI_SSL_HAVE_KTLS
+
 }  // namespace grpc_core
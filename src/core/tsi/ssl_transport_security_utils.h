@@ -142,6 +142,30 @@ tsi_result SslProtectorUnprotect(const unsigned char* protected_frames_bytes,
                                  unsigned char* unprotected_bytes,
                                  size_t* unprotected_bytes_size);
 
+// Configures kernel TLS (kTLS) transmission on |fd| with the write keys and
+// record sequence number of |ssl|, so that plaintext written to |fd| goes out
+// as TLS records that continue the connection. TLS 1.2 and TLS 1.3 are
+// supported.
+//
+// Records that |ssl| would still produce on its own cannot be sent once the
+// kernel owns the keys. A TLS 1.3 server's session tickets, which SSL holds
+// back until the first write, are flushed and sent on |fd| here. |ssl| is set
+// not to send a close_notify. What remains are fatal alerts and, in TLS 1.3,
+// replies to KeyUpdate requests: a caller that finds records in |network_io|
+// after this call must fail the connection.
+//
+// ssl: the |SSL| object of a completed handshake. It must not be used to
+//      write after this call succeeds.
+// network_io: the network end of the BIO pair of |ssl|. It must be empty.
+// fd: the TCP socket carrying the connection of |ssl|. Nothing may be
+//     pending on it.
+//
+// return: TSI_OK on success. TSI_UNIMPLEMENTED if the platform, the TLS
+//         library, the protocol version or the cipher is not supported, or
+//         if the kernel has no TLS support; the connection can go on without
+//         offload. Other TSI errors if it cannot.
+tsi_result SslEnableKernelTxOffload(SSL* ssl, BIO* network_io, int fd);
+
 }  // namespace grpc_core
 
 #endif  // GRPC_CORE_TSI_SSL_TRANSPORT_SECURITY_UTILS_H
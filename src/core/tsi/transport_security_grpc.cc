@@ -72,3 +72,12 @@ tsi_result tsi_zero_copy_grpc_protector_max_frame_size(
   if (self->vtable->max_frame_size == nullptr) return TSI_UNIMPLEMENTED;
   return self->vtable->max_frame_size(self, max_frame_size);
 }
+
+tsi_result tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(
+    tsi_zero_copy_grpc_protector* self, int fd) {
+  if (self == nullptr || fd < 0) return TSI_INVALID_ARGUMENT;
+  if (self->vtable->enable_kernel_tx_offload == nullptr) {
+    return TSI_UNIMPLEMENTED;
+  }
+  return self->vtable->enable_kernel_tx_offload(self, fd);
+}
@@ -63,6 +63,21 @@ void tsi_zero_copy_grpc_protector_destroy(tsi_zero_copy_grpc_protector* self);
 tsi_result tsi_zero_copy_grpc_protector_max_frame_size(
     tsi_zero_copy_grpc_protector* self, size_t* max_frame_size);
 
+// Hands record encryption of outgoing data over to the kernel (Linux kTLS) on
+// the socket fd, which must carry the connection this protector was created
+// for.
+// - On success, protect passes unprotected_slices through unchanged, and the
+//   caller must write them to fd as they are. Unprotect still decrypts, but
+//   fails if the protector would have to send a record of its own, such as
+//   an alert.
+// - On TSI_UNIMPLEMENTED or TSI_FAILED_PRECONDITION, the protector keeps
+//   encrypting in user space. TSI_UNIMPLEMENTED means the protector, the
+//   negotiated protocol version or cipher, or the platform does not support
+//   offload.
+// - Any other failure leaves the connection unusable.
+tsi_result tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(
+    tsi_zero_copy_grpc_protector* self, int fd);
+
 // Base for tsi_zero_copy_grpc_protector implementations.
 struct tsi_zero_copy_grpc_protector_vtable {
   tsi_result (*protect)(tsi_zero_copy_grpc_protector* self,
@@ -75,6 +90,8 @@ struct tsi_zero_copy_grpc_protector_vtable {
   void (*destroy)(tsi_zero_copy_grpc_protector* self);
   tsi_result (*max_frame_size)(tsi_zero_copy_grpc_protector* self,
                                size_t* max_frame_size);
+  tsi_result (*enable_kernel_tx_offload)(tsi_zero_copy_grpc_protector* self,
+                                         int fd);
 };
 struct tsi_zero_copy_grpc_protector {
   const tsi_zero_copy_grpc_protector_vtable* vtable;
@@ -106,5 +106,13 @@ void TlsServerCredentialsOptions::set_cert_request_type(
                                                      cert_request_type);
 }
 
+void TlsServerCredentialsOptions::set_verification_result_cache_size(
+    size_t cache_size) {
+  grpc_tls_credentials_options* options = c_credentials_options();
+  GPR_ASSERT(options != nullptr);
+  grpc_tls_credentials_options_set_verification_result_cache_size(options,
+                                                                  cache_size);
+}
+
 }  // namespace experimental
 }  // namespace grpc
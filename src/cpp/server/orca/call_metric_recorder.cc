@@ -57,6 +57,12 @@ CallMetricRecorder& CallMetricRecorder::RecordMemoryUtilizationMetric(
   return *this;
 }
 
+CallMetricRecorder& CallMetricRecorder::RecordQpsMetric(double value) {
+  internal::MutexLock lock(&mu_);
+  backend_metric_data_->qps = value;
+  return *this;
+}
+
 CallMetricRecorder& CallMetricRecorder::RecordUtilizationMetric(
     grpc::string_ref name, double value) {
   internal::MutexLock lock(&mu_);
@@ -78,6 +84,7 @@ absl::optional<std::string> CallMetricRecorder::CreateSerializedReport() {
   internal::MutexLock lock(&mu_);
   bool has_data = backend_metric_data_->cpu_utilization != -1 ||
                   backend_metric_data_->mem_utilization != -1 ||
+                  backend_metric_data_->qps != -1 ||
                   !backend_metric_data_->utilization.empty() ||
                   !backend_metric_data_->request_cost.empty();
   if (!has_data) {
@@ -93,6 +100,12 @@ absl::optional<std::string> CallMetricRecorder::CreateSerializedReport() {
     xds_data_orca_v3_OrcaLoadReport_set_mem_utilization(
         response, backend_metric_data_->mem_utilization);
   }
+  if (backend_metric_data_->qps != -1) {
+    xds_data_orca_v3_OrcaLoadReport_set_rps(
+        response, static_cast<uint64_t>(backend_metric_data_->qps));
+    xds_data_orca_v3_OrcaLoadReport_set_rps_fractional(
+        response, backend_metric_data_->qps);
+  }
   for (const auto& p : backend_metric_data_->request_cost) {
     xds_data_orca_v3_OrcaLoadReport_request_cost_set(
         response,
@@ -15,6 +15,9 @@
 # AUTO-GENERATED FROM `$REPO_ROOT/templates/src/python/grpcio/grpc_core_dependencies.py.template`!!!
 
 CORE_SOURCE_FILES = [
+    'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.cc',
+    'src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_service_config_parser.cc',
+    'src/core/ext/filters/adaptive_concurrency/concurrency_limiter.cc',
     'src/core/ext/filters/census/grpc_context.cc',
     'src/core/ext/filters/channel_idle/channel_idle_filter.cc',
     'src/core/ext/filters/channel_idle/idle_filter_state.cc',
@@ -38,13 +41,19 @@ CORE_SOURCE_FILES = [
     'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_balancer_addresses.cc',
     'src/core/ext/filters/client_channel/lb_policy/grpclb/grpclb_client_stats.cc',
     'src/core/ext/filters/client_channel/lb_policy/grpclb/load_balancer_api.cc',
+    'src/core/ext/filters/client_channel/lb_policy/least_request/least_request.cc',
+    'src/core/ext/filters/client_channel/lb_policy/maglev/maglev.cc',
     'src/core/ext/filters/client_channel/lb_policy/oob_backend_metric.cc',
+    'src/core/ext/filters/client_channel/lb_policy/outlier_detection/latency_sketch.cc',
     'src/core/ext/filters/client_channel/lb_policy/outlier_detection/outlier_detection.cc',
     'src/core/ext/filters/client_channel/lb_policy/pick_first/pick_first.cc',
     'src/core/ext/filters/client_channel/lb_policy/priority/priority.cc',
+    'src/core/ext/filters/client_channel/lb_policy/ring_hash/consistent_hash.cc',
     'src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.cc',
     'src/core/ext/filters/client_channel/lb_policy/rls/rls.cc',
     'src/core/ext/filters/client_channel/lb_policy/round_robin/round_robin.cc',
+    'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/static_stride_scheduler.cc',
+    'src/core/ext/filters/client_channel/lb_policy/weighted_round_robin/weighted_round_robin.cc',
     'src/core/ext/filters/client_channel/lb_policy/weighted_target/weighted_target.cc',
     'src/core/ext/filters/client_channel/lb_policy/xds/cds.cc',
     'src/core/ext/filters/client_channel/lb_policy/xds/xds_attributes.cc',
@@ -621,6 +630,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/load_balancing/lb_policy.cc',
     'src/core/lib/load_balancing/lb_policy_registry.cc',
     'src/core/lib/matchers/matchers.cc',
+    'src/core/lib/matchers/string_matcher_set.cc',
     'src/core/lib/promise/activity.cc',
     'src/core/lib/promise/pipe.cc',
     'src/core/lib/promise/sleep.cc',
@@ -677,6 +687,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/security/credentials/tls/grpc_tls_credentials_options.cc',
     'src/core/lib/security/credentials/tls/tls_credentials.cc',
     'src/core/lib/security/credentials/tls/tls_utils.cc',
+    'src/core/lib/security/credentials/tls/tls_verification_result_cache.cc',
     'src/core/lib/security/credentials/xds/xds_credentials.cc',
     'src/core/lib/security/security_connector/alts/alts_security_connector.cc',
     'src/core/lib/security/security_connector/fake/fake_security_connector.cc',
@@ -694,6 +705,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/security/transport/security_handshaker.cc',
     'src/core/lib/security/transport/server_auth_filter.cc',
     'src/core/lib/security/transport/tsi_error.cc',
+    'src/core/lib/security/transport/tsi_handshake_executor.cc',
     'src/core/lib/security/util/json_util.cc',
     'src/core/lib/service_config/service_config_impl.cc',
     'src/core/lib/service_config/service_config_parser.cc',
@@ -731,6 +743,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/transport/handshaker_registry.cc',
     'src/core/lib/transport/http_connect_handshaker.cc',
     'src/core/lib/transport/metadata_batch.cc',
+    'src/core/lib/transport/metadata_key_table.cc',
     'src/core/lib/transport/parsed_metadata.cc',
     'src/core/lib/transport/pid_controller.cc',
     'src/core/lib/transport/status_conversion.cc',
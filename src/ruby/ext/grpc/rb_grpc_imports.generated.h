@@ -536,6 +536,9 @@ extern grpc_tls_credentials_options_set_cert_request_type_type grpc_tls_credenti
 typedef void(*grpc_tls_credentials_options_set_crl_directory_type)(grpc_tls_credentials_options* options, const char* crl_directory);
 extern grpc_tls_credentials_options_set_crl_directory_type grpc_tls_credentials_options_set_crl_directory_import;
 #define grpc_tls_credentials_options_set_crl_directory grpc_tls_credentials_options_set_crl_directory_import
+typedef void(*grpc_tls_credentials_options_set_verification_result_cache_size_type)(grpc_tls_credentials_options* options, size_t cache_size);
+extern grpc_tls_credentials_options_set_verification_result_cache_size_type grpc_tls_credentials_options_set_verification_result_cache_size_import;
+#define grpc_tls_credentials_options_set_verification_result_cache_size grpc_tls_credentials_options_set_verification_result_cache_size_import
 typedef void(*grpc_tls_credentials_options_set_verify_server_cert_type)(grpc_tls_credentials_options* options, int verify_server_cert);
 extern grpc_tls_credentials_options_set_verify_server_cert_type grpc_tls_credentials_options_set_verify_server_cert_import;
 #define grpc_tls_credentials_options_set_verify_server_cert grpc_tls_credentials_options_set_verify_server_cert_import
@@ -0,0 +1,114 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/filters/client_channel/lb_policy/outlier_detection/latency_sketch.h"
+
+#include <stdint.h>
+
+#include <thread>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace grpc_core {
+namespace {
+
+// Returns true if estimate is within the sketch's error bound of actual.
+bool IsCloseTo(absl::optional<int64_t> estimate, int64_t actual) {
+  return estimate.has_value() && *estimate >= actual * 0.875 &&
+         *estimate <= actual * 1.125;
+}
+
+TEST(LatencySketchTest, Empty) {
+  LatencySketch sketch;
+  EXPECT_EQ(sketch.Count(), 0);
+  EXPECT_EQ(sketch.Quantile(0.5), absl::nullopt);
+}
+
+TEST(LatencySketchTest, SmallLatenciesAreExact) {
+  LatencySketch sketch;
+  for (int64_t latency = 0; latency < 4; ++latency) {
+    sketch.Record(latency);
+  }
+  EXPECT_EQ(sketch.Count(), 4);
+  EXPECT_EQ(sketch.Quantile(0.25), 0);
+  EXPECT_EQ(sketch.Quantile(0.5), 1);
+  EXPECT_EQ(sketch.Quantile(1), 3);
+}
+
+TEST(LatencySketchTest, QuantilesAreWithinErrorBound) {
+  LatencySketch sketch;
+  // 1..10000 microseconds, once each.
+  for (int64_t latency = 1; latency <= 10000; ++latency) {
+    sketch.Record(latency);
+  }
+  EXPECT_EQ(sketch.Count(), 10000);
+  for (double q : {0.01, 0.1, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+    EXPECT_TRUE(IsCloseTo(sketch.Quantile(q), static_cast<int64_t>(q * 10000)))
+        << "quantile " << q << " estimate " << *sketch.Quantile(q);
+  }
+}
+
+TEST(LatencySketchTest, TailIsVisible) {
+  LatencySketch sketch;
+  // 98% of calls take 1ms, 2% take 100ms.
+  for (int i = 0; i < 980; ++i) sketch.Record(1000);
+  for (int i = 0; i < 20; ++i) sketch.Record(100000);
+  EXPECT_TRUE(IsCloseTo(sketch.Quantile(0.5), 1000));
+  EXPECT_TRUE(IsCloseTo(sketch.Quantile(0.98), 1000));
+  EXPECT_TRUE(IsCloseTo(sketch.Quantile(0.99), 100000));
+}
+
+TEST(LatencySketchTest, OutOfRangeLatenciesAreClamped) {
+  LatencySketch sketch;
+  sketch.Record(-5);
+  EXPECT_EQ(sketch.Quantile(1), 0);
+  sketch.Reset();
+  sketch.Record(int64_t{1} << 40);
+  EXPECT_TRUE(IsCloseTo(sketch.Quantile(1), LatencySketch::kMaxLatencyMicros));
+}
+
+TEST(LatencySketchTest, Reset) {
+  LatencySketch sketch;
+  sketch.Record(1000);
+  sketch.Reset();
+  EXPECT_EQ(sketch.Count(), 0);
+  EXPECT_EQ(sketch.Quantile(0.5), absl::nullopt);
+}
+
+TEST(LatencySketchTest, ConcurrentRecords) {
+  LatencySketch sketch;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&sketch]() {
+      for (int64_t latency = 1; latency <= 10000; ++latency) {
+        sketch.Record(latency);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(sketch.Count(), 40000);
+  EXPECT_TRUE(IsCloseTo(sketch.Quantile(0.5), 5000));
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -22,6 +22,7 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <chrono>
 #include <deque>
 #include <functional>
 #include <map>
@@ -50,6 +51,7 @@
 #include <grpc/support/log.h>
 
 #include "src/core/ext/filters/client_channel/lb_call_state_internal.h"
+#include "src/core/ext/filters/client_channel/lb_policy/backend_metric_data.h"
 #include "src/core/ext/filters/client_channel/subchannel_pool_interface.h"
 #include "src/core/lib/address_utils/parse_address.h"
 #include "src/core/lib/address_utils/sockaddr_utils.h"
@@ -72,6 +74,8 @@
 #include "src/core/lib/resolver/server_address.h"
 #include "src/core/lib/transport/connectivity_state.h"
 #include "src/core/lib/uri/uri_parser.h"
+#include "test/core/event_engine/fuzzing_event_engine/fuzzing_event_engine.h"
+#include "test/core/event_engine/fuzzing_event_engine/fuzzing_event_engine.pb.h"
 
 namespace grpc_core {
 namespace testing {
@@ -297,6 +301,20 @@ class LoadBalancingPolicyTest : public ::testing::Test {
       return std::move(result);
     }
 
+    // Removes all events from the queue and returns the last state update
+    // among them, if any.  For use with policies that may report new
+    // pickers asynchronously (e.g., from a timer).
+    absl::optional<StateUpdate> DrainQueue() {
+      MutexLock lock(&mu_);
+      absl::optional<StateUpdate> result;
+      for (Event& event : queue_) {
+        auto* update = absl::get_if<StateUpdate>(&event);
+        if (update != nullptr) result = std::move(*update);
+      }
+      queue_.clear();
+      return result;
+    }
+
     // Returns the next event in the queue if it is a re-resolution.
     // If the queue is empty or the next event is not a re-resolution,
     // fails the test and returns nullopt without removing anything
@@ -360,7 +378,7 @@ class LoadBalancingPolicyTest : public ::testing::Test {
     absl::string_view GetAuthority() override { return "server.example.com"; }
 
     grpc_event_engine::experimental::EventEngine* GetEventEngine() override {
-      return grpc_event_engine::experimental::GetDefaultEventEngine().get();
+      return test_->event_engine_.get();
     }
 
     void AddTraceEvent(TraceSeverity, absl::string_view) override {}
@@ -401,6 +419,23 @@ class LoadBalancingPolicyTest : public ::testing::Test {
     std::map<std::string, std::string> metadata_;
   };
 
+  // A fake BackendMetricAccessor implementation, for use in FinishArgs.
+  class FakeBackendMetricAccessor
+      : public LoadBalancingPolicy::BackendMetricAccessor {
+   public:
+    explicit FakeBackendMetricAccessor(
+        absl::optional<BackendMetricData> backend_metric_data)
+        : backend_metric_data_(std::move(backend_metric_data)) {}
+
+    const BackendMetricData* GetBackendMetricData() override {
+      if (!backend_metric_data_.has_value()) return nullptr;
+      return &*backend_metric_data_;
+    }
+
+   private:
+    absl::optional<BackendMetricData> backend_metric_data_;
+  };
+
   // A fake CallState implementation, for use in PickArgs.
   class FakeCallState : public LbCallStateInternal {
    public:
@@ -429,7 +464,9 @@ class LoadBalancingPolicyTest : public ::testing::Test {
   };
 
   LoadBalancingPolicyTest()
-      : work_serializer_(std::make_shared<WorkSerializer>()) {}
+      : work_serializer_(std::make_shared<WorkSerializer>()),
+        event_engine_(
+            grpc_event_engine::experimental::GetDefaultEventEngine()) {}
 
   void TearDown() override {
     // Note: Can't safely trigger this from inside the FakeHelper dtor,
@@ -823,10 +860,43 @@ class LoadBalancingPolicyTest : public ::testing::Test {
   }
 
   std::shared_ptr<WorkSerializer> work_serializer_;
+  // Held for the life of the test, so that timers started by the LB policy
+  // are not lost when the default engine would otherwise be destroyed.
+  std::shared_ptr<grpc_event_engine::experimental::EventEngine> event_engine_;
   FakeHelper* helper_ = nullptr;
   std::map<SubchannelKey, SubchannelState> subchannel_pool_;
 };
 
+// A subclass to be used for LB policies that start timers.  Injects a
+// FuzzingEventEngine that also drives the process clock, so that tests
+// advance time explicitly instead of sleeping.
+class TimeAwareLoadBalancingPolicyTest : public LoadBalancingPolicyTest {
+ protected:
+  TimeAwareLoadBalancingPolicyTest() {
+    grpc_event_engine::experimental::FuzzingEventEngine::Options options;
+    options.final_tick_length = std::chrono::milliseconds(1);
+    auto fuzzing_ee =
+        std::make_shared<grpc_event_engine::experimental::FuzzingEventEngine>(
+            options, fuzzing_event_engine::Actions());
+    fuzzing_ee_ = fuzzing_ee.get();
+    event_engine_ = std::move(fuzzing_ee);
+    grpc_event_engine::experimental::FuzzingEventEngine::
+        SetGlobalNowImplEngine(fuzzing_ee_);
+  }
+
+  ~TimeAwareLoadBalancingPolicyTest() override {
+    grpc_event_engine::experimental::FuzzingEventEngine::
+        UnsetGlobalNowImplEngine(fuzzing_ee_);
+  }
+
+  // Advances the clock by duration, running any timers that come due.
+  void IncrementTimeBy(Duration duration) {
+    fuzzing_ee_->TickForDuration(duration);
+  }
+
+  grpc_event_engine::experimental::FuzzingEventEngine* fuzzing_ee_;
+};
+
 }  // namespace testing
 }  // namespace grpc_core
 
@@ -0,0 +1,198 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <stddef.h>
+
+#include <array>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "gtest/gtest.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/load_balancing/lb_policy.h"
+#include "test/core/client_channel/lb_policy/lb_policy_test_lib.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+class LeastRequestTest : public LoadBalancingPolicyTest {
+ protected:
+  // A pick whose call has been started and not yet finished.
+  struct InFlightCall {
+    std::string address;
+    std::unique_ptr<LoadBalancingPolicy::SubchannelCallTrackerInterface>
+        tracker;
+  };
+
+  LeastRequestTest() : lb_policy_(MakeLbPolicy("least_request")) {}
+
+  static RefCountedPtr<LoadBalancingPolicy::Config> MakeLeastRequestConfig(
+      int choice_count) {
+    return MakeConfig(Json::Array{Json::Object{
+        {"least_request", Json::Object{{"choiceCount", choice_count}}}}});
+  }
+
+  // Connects every address and returns the resulting READY picker.
+  RefCountedPtr<LoadBalancingPolicy::SubchannelPicker> ExpectStartup(
+      absl::Span<const absl::string_view> addresses, int choice_count) {
+    EXPECT_EQ(ApplyUpdate(BuildUpdate(addresses,
+                                      MakeLeastRequestConfig(choice_count)),
+                          lb_policy_.get()),
+              absl::OkStatus());
+    ExpectConnectingUpdate();
+    for (size_t i = 0; i < addresses.size(); ++i) {
+      auto* subchannel = FindSubchannel(addresses[i]);
+      EXPECT_NE(subchannel, nullptr) << "Address: " << addresses[i];
+      if (subchannel == nullptr) return nullptr;
+      EXPECT_TRUE(subchannel->ConnectionRequested());
+      subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+      subchannel->SetConnectivityState(GRPC_CHANNEL_READY);
+    }
+    auto update = helper_->DrainQueue();
+    EXPECT_TRUE(update.has_value());
+    if (!update.has_value()) return nullptr;
+    EXPECT_EQ(update->state, GRPC_CHANNEL_READY);
+    return std::move(update->picker);
+  }
+
+  // Does a pick and starts a call on the result.
+  InFlightCall StartCall(LoadBalancingPolicy::SubchannelPicker* picker) {
+    auto pick_result = DoPick(picker);
+    auto* complete = absl::get_if<LoadBalancingPolicy::PickResult::Complete>(
+        &pick_result.result);
+    EXPECT_NE(complete, nullptr) << PickResultString(pick_result);
+    if (complete == nullptr) return {};
+    EXPECT_NE(complete->subchannel_call_tracker, nullptr);
+    if (complete->subchannel_call_tracker == nullptr) return {};
+    complete->subchannel_call_tracker->Start();
+    auto* subchannel = static_cast<SubchannelState::FakeSubchannel*>(
+        complete->subchannel.get());
+    return {subchannel->state()->address(),
+            std::move(complete->subchannel_call_tracker)};
+  }
+
+  static void FinishCall(InFlightCall* call) {
+    FakeMetadata metadata({});
+    FakeBackendMetricAccessor backend_metric_accessor(absl::nullopt);
+    call->tracker->Finish(
+        {absl::OkStatus(), &metadata, &backend_metric_accessor});
+    call->tracker.reset();
+  }
+
+  OrphanablePtr<LoadBalancingPolicy> lb_policy_;
+};
+
+TEST_F(LeastRequestTest, Basic) {
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  auto picker = ExpectStartup(kAddresses, 2);
+  ASSERT_NE(picker, nullptr);
+  // With no calls in flight, every address gets picks.
+  auto picks = GetCompletePicks(picker.get(), 100);
+  ASSERT_TRUE(picks.has_value());
+  std::set<std::string> picked(picks->begin(), picks->end());
+  EXPECT_EQ(picked.size(), kAddresses.size());
+}
+
+TEST_F(LeastRequestTest, PicksAddressWithFewestCallsInFlight) {
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  // With choiceCount covering every address, picks are exact.
+  auto picker = ExpectStartup(kAddresses, 3);
+  ASSERT_NE(picker, nullptr);
+  // Each call goes to an address with no calls in flight.
+  std::map<std::string, InFlightCall> calls;
+  for (size_t i = 0; i < kAddresses.size(); ++i) {
+    auto call = StartCall(picker.get());
+    ASSERT_NE(call.tracker, nullptr);
+    EXPECT_EQ(calls.count(call.address), 0) << call.address;
+    std::string address = call.address;
+    calls.emplace(std::move(address), std::move(call));
+  }
+  EXPECT_EQ(calls.size(), kAddresses.size());
+  // Once the call to one address finishes, that address is picked next.
+  FinishCall(&calls[std::string(kAddresses[1])]);
+  auto call = StartCall(picker.get());
+  EXPECT_EQ(call.address, kAddresses[1]);
+  // A call that is abandoned after starting stops counting as well.
+  calls[std::string(kAddresses[2])].tracker.reset();
+  auto call2 = StartCall(picker.get());
+  EXPECT_EQ(call2.address, kAddresses[2]);
+}
+
+TEST_F(LeastRequestTest, CallsInFlightSurviveAddressUpdate) {
+  const std::array<absl::string_view, 2> kAddresses = {"ipv4:127.0.0.1:441",
+                                                       "ipv4:127.0.0.1:442"};
+  auto picker = ExpectStartup(kAddresses, 2);
+  ASSERT_NE(picker, nullptr);
+  // Keep one call in flight to each address.
+  auto call1 = StartCall(picker.get());
+  auto call2 = StartCall(picker.get());
+  // The first pick was made with nothing in flight, so the second must have
+  // gone to the other address.
+  ASSERT_NE(call1.address, call2.address);
+  // Add a third address.
+  const std::array<absl::string_view, 3> kNewAddresses = {
+      kAddresses[0], kAddresses[1], "ipv4:127.0.0.1:443"};
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(kNewAddresses, MakeLeastRequestConfig(3)),
+                        lb_policy_.get()),
+            absl::OkStatus());
+  auto* subchannel = FindSubchannel(kNewAddresses[2]);
+  ASSERT_NE(subchannel, nullptr);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_READY);
+  auto update = helper_->DrainQueue();
+  ASSERT_TRUE(update.has_value());
+  ASSERT_EQ(update->state, GRPC_CHANNEL_READY);
+  // The calls started through the old picker still count, so the new
+  // address is picked.
+  auto call3 = StartCall(update->picker.get());
+  EXPECT_EQ(call3.address, kNewAddresses[2]);
+}
+
+TEST_F(LeastRequestTest, InvalidConfig) {
+  auto config = CoreConfiguration::Get()
+                    .lb_policy_registry()
+                    .ParseLoadBalancingConfig(Json::Array{Json::Object{
+                        {"least_request", Json::Object{{"choiceCount", 1}}}}});
+  EXPECT_FALSE(config.ok());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -0,0 +1,211 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "gtest/gtest.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/load_balancing/lb_policy.h"
+#include "test/core/client_channel/lb_policy/lb_policy_test_lib.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+// A small table keeps the tests that look at every entry fast.
+constexpr uint64_t kTableSize = 1021;
+
+class MaglevTest : public LoadBalancingPolicyTest {
+ protected:
+  MaglevTest() : lb_policy_(MakeLbPolicy("maglev_experimental")) {}
+
+  static RefCountedPtr<LoadBalancingPolicy::Config> MakeMaglevConfig() {
+    return MakeConfig(Json::Array{Json::Object{
+        {"maglev_experimental", Json::Object{{"tableSize", kTableSize}}}}});
+  }
+
+  // Sends an update with addresses to lb_policy, connects every address
+  // that is not yet connected, and returns the resulting READY picker.
+  RefCountedPtr<LoadBalancingPolicy::SubchannelPicker> ConnectAll(
+      absl::Span<const absl::string_view> addresses,
+      LoadBalancingPolicy* lb_policy) {
+    EXPECT_EQ(ApplyUpdate(BuildUpdate(addresses, MakeMaglevConfig()),
+                          lb_policy),
+              absl::OkStatus());
+    for (absl::string_view address : addresses) {
+      auto* subchannel = FindSubchannel(address);
+      EXPECT_NE(subchannel, nullptr) << "Address: " << address;
+      if (subchannel == nullptr) return nullptr;
+      if (!connected_.insert(std::string(address)).second) continue;
+      subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+      subchannel->SetConnectivityState(GRPC_CHANNEL_READY);
+    }
+    auto update = helper_->DrainQueue();
+    EXPECT_TRUE(update.has_value());
+    if (!update.has_value()) return nullptr;
+    EXPECT_EQ(update->state, GRPC_CHANNEL_READY);
+    return std::move(update->picker);
+  }
+
+  absl::optional<std::string> PickForHash(
+      LoadBalancingPolicy::SubchannelPicker* picker, uint64_t hash) {
+    return ExpectPickComplete(
+        picker, {{RequestHashAttributeName(), absl::StrCat(hash)}});
+  }
+
+  // Returns the address picked for each entry of the table.
+  std::vector<std::string> PickEveryEntry(
+      LoadBalancingPolicy::SubchannelPicker* picker) {
+    std::vector<std::string> addresses;
+    for (uint64_t hash = 0; hash < kTableSize; ++hash) {
+      auto address = PickForHash(picker, hash);
+      EXPECT_TRUE(address.has_value()) << "hash " << hash;
+      addresses.push_back(address.value_or(""));
+    }
+    return addresses;
+  }
+
+  OrphanablePtr<LoadBalancingPolicy> lb_policy_;
+  std::set<std::string> connected_;
+};
+
+TEST_F(MaglevTest, PicksAreConsistentAndBalanced) {
+  ExecCtx exec_ctx;
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  auto picker = ConnectAll(kAddresses, lb_policy_.get());
+  ASSERT_NE(picker, nullptr);
+  auto entries = PickEveryEntry(picker.get());
+  std::map<std::string, size_t> counts;
+  for (const std::string& address : entries) ++counts[address];
+  ASSERT_EQ(counts.size(), kAddresses.size());
+  // Addresses with the same weight own the same number of entries, give or
+  // take one.
+  for (const auto& p : counts) {
+    EXPECT_GE(p.second, kTableSize / kAddresses.size()) << p.first;
+    EXPECT_LE(p.second, kTableSize / kAddresses.size() + 1) << p.first;
+  }
+  // Hashes map to their entry modulo the table size.
+  for (uint64_t hash : {uint64_t{0}, uint64_t{17}, uint64_t{1000}}) {
+    EXPECT_EQ(PickForHash(picker.get(), hash + 5 * kTableSize),
+              entries[hash]);
+  }
+}
+
+TEST_F(MaglevTest, RemovingAnAddressMovesFewOtherEntries) {
+  ExecCtx exec_ctx;
+  const std::array<absl::string_view, 4> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443",
+      "ipv4:127.0.0.1:444"};
+  auto picker = ConnectAll(kAddresses, lb_policy_.get());
+  ASSERT_NE(picker, nullptr);
+  auto before = PickEveryEntry(picker.get());
+  // A second policy without the last address.
+  auto lb_policy2 = MakeLbPolicy("maglev_experimental");
+  auto picker2 = ConnectAll(absl::MakeConstSpan(kAddresses).first(3),
+                            lb_policy2.get());
+  ASSERT_NE(picker2, nullptr);
+  auto after = PickEveryEntry(picker2.get());
+  size_t moved = 0;
+  for (size_t i = 0; i < kTableSize; ++i) {
+    if (before[i] == kAddresses[3]) continue;
+    if (before[i] != after[i]) ++moved;
+  }
+  // Entries that belonged to the remaining addresses almost all stay put.
+  EXPECT_LT(moved, kTableSize / 20);
+}
+
+TEST_F(MaglevTest, PoliciesWithSameAddressesPickTheSame) {
+  ExecCtx exec_ctx;
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  auto picker = ConnectAll(kAddresses, lb_policy_.get());
+  ASSERT_NE(picker, nullptr);
+  auto lb_policy2 = MakeLbPolicy("maglev_experimental");
+  auto picker2 = ConnectAll(kAddresses, lb_policy2.get());
+  ASSERT_NE(picker2, nullptr);
+  EXPECT_EQ(PickEveryEntry(picker.get()), PickEveryEntry(picker2.get()));
+}
+
+TEST_F(MaglevTest, SkipsToNextReadySubchannel) {
+  ExecCtx exec_ctx;
+  const std::array<absl::string_view, 2> kAddresses = {"ipv4:127.0.0.1:441",
+                                                       "ipv4:127.0.0.1:442"};
+  auto picker = ConnectAll(kAddresses, lb_policy_.get());
+  ASSERT_NE(picker, nullptr);
+  // Find a hash that maps to the first address.
+  uint64_t hash = 0;
+  while (hash < kTableSize && PickForHash(picker.get(), hash) != kAddresses[0]) {
+    ++hash;
+  }
+  ASSERT_LT(hash, kTableSize);
+  // Once that address fails, picks for the hash go to the other address.
+  auto* subchannel = FindSubchannel(kAddresses[0]);
+  ASSERT_NE(subchannel, nullptr);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_IDLE);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_TRANSIENT_FAILURE,
+                                   absl::UnavailableError("connection failed"));
+  auto update = helper_->DrainQueue();
+  ASSERT_TRUE(update.has_value());
+  ASSERT_EQ(update->state, GRPC_CHANNEL_READY);
+  EXPECT_EQ(PickForHash(update->picker.get(), hash), kAddresses[1]);
+}
+
+TEST_F(MaglevTest, InvalidConfig) {
+  for (uint64_t table_size : {0, 65536, 5000012}) {
+    auto config = CoreConfiguration::Get()
+                      .lb_policy_registry()
+                      .ParseLoadBalancingConfig(Json::Array{Json::Object{
+                          {"maglev_experimental",
+                           Json::Object{{"tableSize", table_size}}}}});
+    EXPECT_FALSE(config.ok()) << table_size;
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
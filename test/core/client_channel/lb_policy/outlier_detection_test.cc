@@ -18,12 +18,17 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <array>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/variant.h"
 #include "gtest/gtest.h"
 
 #include <grpc/grpc.h>
@@ -40,7 +45,7 @@ namespace grpc_core {
 namespace testing {
 namespace {
 
-class OutlierDetectionTest : public LoadBalancingPolicyTest {
+class OutlierDetectionTest : public TimeAwareLoadBalancingPolicyTest {
  protected:
   class ConfigBuilder {
    public:
@@ -103,6 +108,27 @@ class OutlierDetectionTest : public LoadBalancingPolicyTest {
       return *this;
     }
 
+    ConfigBuilder& SetLatencyPercentile(uint32_t value) {
+      GetLatency()["percentile"] = value;
+      return *this;
+    }
+    ConfigBuilder& SetLatencyThresholdFactor(uint32_t value) {
+      GetLatency()["thresholdFactor"] = value;
+      return *this;
+    }
+    ConfigBuilder& SetLatencyEnforcementPercentage(uint32_t value) {
+      GetLatency()["enforcementPercentage"] = value;
+      return *this;
+    }
+    ConfigBuilder& SetLatencyMinimumHosts(uint32_t value) {
+      GetLatency()["minimumHosts"] = value;
+      return *this;
+    }
+    ConfigBuilder& SetLatencyRequestVolume(uint32_t value) {
+      GetLatency()["requestVolume"] = value;
+      return *this;
+    }
+
     RefCountedPtr<LoadBalancingPolicy::Config> Build() {
       Json config =
           Json::Array{Json::Object{{"outlier_detection_experimental", json_}}};
@@ -121,6 +147,11 @@ class OutlierDetectionTest : public LoadBalancingPolicyTest {
       return *it->second.mutable_object();
     }
 
+    Json::Object& GetLatency() {
+      auto it = json_.emplace("latencyEjection", Json::Object()).first;
+      return *it->second.mutable_object();
+    }
+
     Json::Object json_;
   };
 
@@ -158,6 +189,79 @@ TEST_F(OutlierDetectionTest, Basic) {
   }
 }
 
+TEST_F(OutlierDetectionTest, LatencyEjection) {
+  const std::array<absl::string_view, 4> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443",
+      "ipv4:127.0.0.1:444"};
+  absl::Status status = ApplyUpdate(
+      BuildUpdate(kAddresses, ConfigBuilder()
+                                  .SetInterval(Duration::Milliseconds(100))
+                                  .SetBaseEjectionTime(Duration::Seconds(30))
+                                  .SetLatencyThresholdFactor(3000)
+                                  .SetLatencyEnforcementPercentage(100)
+                                  .SetLatencyMinimumHosts(3)
+                                  .SetLatencyRequestVolume(5)
+                                  .Build()),
+      lb_policy_.get());
+  EXPECT_TRUE(status.ok()) << status;
+  for (absl::string_view address : kAddresses) {
+    auto* subchannel = FindSubchannel(address);
+    ASSERT_NE(subchannel, nullptr) << address;
+    subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+    subchannel->SetConnectivityState(GRPC_CHANNEL_READY);
+  }
+  auto update = helper_->DrainQueue();
+  ASSERT_TRUE(update.has_value());
+  ASSERT_EQ(update->state, GRPC_CHANNEL_READY);
+  // Start 10 calls to each address.  Calls to the first address take
+  // 100ms, and calls to the others 10ms.  All calls finish at the same
+  // time, so that they are counted in the same interval.
+  std::vector<std::unique_ptr<
+      LoadBalancingPolicy::SubchannelCallTrackerInterface>>
+      slow_calls, fast_calls;
+  for (size_t i = 0; i < 10 * kAddresses.size(); ++i) {
+    auto pick_result = DoPick(update->picker.get());
+    auto* complete = absl::get_if<LoadBalancingPolicy::PickResult::Complete>(
+        &pick_result.result);
+    ASSERT_NE(complete, nullptr) << PickResultString(pick_result);
+    ASSERT_NE(complete->subchannel_call_tracker, nullptr);
+    auto* subchannel = static_cast<SubchannelState::FakeSubchannel*>(
+        complete->subchannel.get());
+    if (subchannel->state()->address() == kAddresses[0]) {
+      slow_calls.push_back(std::move(complete->subchannel_call_tracker));
+    } else {
+      fast_calls.push_back(std::move(complete->subchannel_call_tracker));
+    }
+  }
+  ASSERT_EQ(slow_calls.size(), 10);
+  for (auto& call : slow_calls) call->Start();
+  IncrementTimeBy(Duration::Milliseconds(90));
+  for (auto& call : fast_calls) call->Start();
+  IncrementTimeBy(Duration::Milliseconds(10));
+  for (auto* calls : {&slow_calls, &fast_calls}) {
+    for (auto& call : *calls) {
+      FakeMetadata metadata({});
+      FakeBackendMetricAccessor backend_metric_accessor(absl::nullopt);
+      call->Finish({absl::OkStatus(), &metadata, &backend_metric_accessor});
+    }
+  }
+  // The calls may have finished just after a timer tick, so the slow
+  // address is ejected at the latest on the tick after next, and the child
+  // policy stops picking it.
+  bool ejected = false;
+  for (size_t i = 0; i < 2 && !ejected; ++i) {
+    IncrementTimeBy(Duration::Milliseconds(100));
+    auto new_update = helper_->DrainQueue();
+    if (!new_update.has_value()) continue;
+    ASSERT_EQ(new_update->state, GRPC_CHANNEL_READY);
+    auto picks = GetCompletePicks(new_update->picker.get(), 6);
+    ASSERT_TRUE(picks.has_value());
+    ejected = std::find(picks->begin(), picks->end(), kAddresses[0]) ==
+              picks->end();
+  }
+  EXPECT_TRUE(ejected);
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace grpc_core
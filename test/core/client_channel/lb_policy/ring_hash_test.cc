@@ -0,0 +1,172 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/filters/client_channel/lb_policy/ring_hash/ring_hash.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "gtest/gtest.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/load_balancing/lb_policy.h"
+#include "test/core/client_channel/lb_policy/lb_policy_test_lib.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+class RingHashTest : public LoadBalancingPolicyTest {
+ protected:
+  RingHashTest() : lb_policy_(MakeLbPolicy("ring_hash_experimental")) {}
+
+  static RefCountedPtr<LoadBalancingPolicy::Config> MakeRingHashConfig() {
+    return MakeConfig(Json::Array{Json::Object{
+        {"ring_hash_experimental",
+         Json::Object{{"minRingSize", 1024}, {"maxRingSize", 4096}}}}});
+  }
+
+  // Sends an update with addresses to lb_policy, connects every address,
+  // and returns the resulting READY picker.
+  RefCountedPtr<LoadBalancingPolicy::SubchannelPicker> ConnectAll(
+      absl::Span<const absl::string_view> addresses,
+      LoadBalancingPolicy* lb_policy) {
+    EXPECT_EQ(
+        ApplyUpdate(BuildUpdate(addresses, MakeRingHashConfig()), lb_policy),
+        absl::OkStatus());
+    for (absl::string_view address : addresses) {
+      auto* subchannel = FindSubchannel(address);
+      EXPECT_NE(subchannel, nullptr) << "Address: " << address;
+      if (subchannel == nullptr) return nullptr;
+      subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+      subchannel->SetConnectivityState(GRPC_CHANNEL_READY);
+    }
+    auto update = helper_->DrainQueue();
+    EXPECT_TRUE(update.has_value());
+    if (!update.has_value()) return nullptr;
+    EXPECT_EQ(update->state, GRPC_CHANNEL_READY);
+    return std::move(update->picker);
+  }
+
+  absl::optional<std::string> PickForHash(
+      LoadBalancingPolicy::SubchannelPicker* picker, uint64_t hash) {
+    return ExpectPickComplete(
+        picker, {{RequestHashAttributeName(), absl::StrCat(hash)}});
+  }
+
+  OrphanablePtr<LoadBalancingPolicy> lb_policy_;
+};
+
+TEST_F(RingHashTest, PicksAreConsistentAndSpread) {
+  // Ring hash pickers hop into the ExecCtx when destroyed.
+  ExecCtx exec_ctx;
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  auto picker = ConnectAll(kAddresses, lb_policy_.get());
+  ASSERT_NE(picker, nullptr);
+  std::set<std::string> picked;
+  for (uint64_t i = 0; i < 100; ++i) {
+    const uint64_t hash = i * 0x9e3779b97f4a7c15;
+    auto address = PickForHash(picker.get(), hash);
+    ASSERT_TRUE(address.has_value());
+    // The same hash always maps to the same address.
+    EXPECT_EQ(PickForHash(picker.get(), hash), address);
+    picked.insert(*address);
+  }
+  EXPECT_EQ(picked.size(), kAddresses.size());
+  // The ends of the hash space wrap around to the same entry.
+  EXPECT_EQ(PickForHash(picker.get(), 0),
+            PickForHash(picker.get(), ~uint64_t{0}));
+}
+
+TEST_F(RingHashTest, PoliciesWithSameAddressesPickTheSame) {
+  ExecCtx exec_ctx;
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  auto picker = ConnectAll(kAddresses, lb_policy_.get());
+  ASSERT_NE(picker, nullptr);
+  // A second policy for the same addresses shares the subchannels, which
+  // are already connected.
+  auto lb_policy2 = MakeLbPolicy("ring_hash_experimental");
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(kAddresses, MakeRingHashConfig()),
+                        lb_policy2.get()),
+            absl::OkStatus());
+  auto update = helper_->DrainQueue();
+  ASSERT_TRUE(update.has_value());
+  ASSERT_EQ(update->state, GRPC_CHANNEL_READY);
+  auto picker2 = std::move(update->picker);
+  for (uint64_t i = 0; i < 100; ++i) {
+    const uint64_t hash = i * 0x9e3779b97f4a7c15;
+    EXPECT_EQ(PickForHash(picker.get(), hash), PickForHash(picker2.get(), hash))
+        << "hash " << hash;
+  }
+}
+
+TEST_F(RingHashTest, SkipsToNextReadySubchannel) {
+  ExecCtx exec_ctx;
+  const std::array<absl::string_view, 2> kAddresses = {"ipv4:127.0.0.1:441",
+                                                       "ipv4:127.0.0.1:442"};
+  auto picker = ConnectAll(kAddresses, lb_policy_.get());
+  ASSERT_NE(picker, nullptr);
+  // Find a hash that maps to the first address.
+  uint64_t hash = 0;
+  for (uint64_t i = 0; i < 100; ++i) {
+    hash = i * 0x9e3779b97f4a7c15;
+    if (PickForHash(picker.get(), hash) == kAddresses[0]) break;
+  }
+  ASSERT_EQ(PickForHash(picker.get(), hash), kAddresses[0]);
+  // Once that address fails, picks for the hash go to the other address.
+  auto* subchannel = FindSubchannel(kAddresses[0]);
+  ASSERT_NE(subchannel, nullptr);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_IDLE);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+  subchannel->SetConnectivityState(GRPC_CHANNEL_TRANSIENT_FAILURE,
+                                   absl::UnavailableError("connection failed"));
+  auto update = helper_->DrainQueue();
+  ASSERT_TRUE(update.has_value());
+  ASSERT_EQ(update->state, GRPC_CHANNEL_READY);
+  EXPECT_EQ(PickForHash(update->picker.get(), hash), kAddresses[1]);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
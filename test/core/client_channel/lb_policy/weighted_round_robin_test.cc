@@ -0,0 +1,241 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <stddef.h>
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "gtest/gtest.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/backend_metric_data.h"
+#include "src/core/lib/gprpp/orphanable.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/time.h"
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/load_balancing/lb_policy.h"
+#include "test/core/client_channel/lb_policy/lb_policy_test_lib.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+class WeightedRoundRobinTest : public TimeAwareLoadBalancingPolicyTest {
+ protected:
+  WeightedRoundRobinTest()
+      : lb_policy_(MakeLbPolicy("weighted_round_robin")) {}
+
+  // Returns a config for the policy.  A long weight update period keeps
+  // the timer from reporting new pickers while the test is waiting for
+  // specific connectivity state updates.
+  static RefCountedPtr<LoadBalancingPolicy::Config> MakeWrrConfig(
+      absl::string_view blackout_period = "10s",
+      absl::string_view weight_update_period = "1000s") {
+    return MakeConfig(Json::Array{Json::Object{
+        {"weighted_round_robin",
+         Json::Object{
+             {"blackoutPeriod", std::string(blackout_period)},
+             {"weightUpdatePeriod", std::string(weight_update_period)},
+         }}}});
+  }
+
+  void ExpectStartup(absl::Span<const absl::string_view> addresses) {
+    EXPECT_EQ(ApplyUpdate(BuildUpdate(addresses, MakeWrrConfig()),
+                          lb_policy_.get()),
+              absl::OkStatus());
+    // Expect the initial CONNECTNG update with a picker that queues.
+    ExpectConnectingUpdate();
+    // WRR should have created a subchannel for each address.
+    for (size_t i = 0; i < addresses.size(); ++i) {
+      auto* subchannel = FindSubchannel(addresses[i]);
+      ASSERT_NE(subchannel, nullptr) << "Address: " << addresses[i];
+      // WRR should ask each subchannel to connect.
+      EXPECT_TRUE(subchannel->ConnectionRequested());
+      // The subchannel will connect successfully.
+      subchannel->SetConnectivityState(GRPC_CHANNEL_CONNECTING);
+      subchannel->SetConnectivityState(GRPC_CHANNEL_READY);
+      // Without any backend metrics, WRR should behave like RR.
+      if (i == 0) {
+        auto picker = WaitForConnected();
+        ExpectRoundRobinPicks(picker.get(), {addresses[0]});
+      } else {
+        WaitForRoundRobinListChange(
+            absl::MakeSpan(addresses).subspan(0, i),
+            absl::MakeSpan(addresses).subspan(0, i + 1));
+      }
+    }
+  }
+
+  // Does picks until every address in backend_metrics has been picked at
+  // least once, completing each call with the backend metrics for its
+  // address.
+  void ReportBackendMetrics(
+      LoadBalancingPolicy::SubchannelPicker* picker,
+      const std::map<std::string, BackendMetricData>& backend_metrics) {
+    std::set<std::string> reported;
+    for (size_t i = 0; i < 100 && reported.size() < backend_metrics.size();
+         ++i) {
+      auto pick_result = DoPick(picker);
+      auto* complete = absl::get_if<LoadBalancingPolicy::PickResult::Complete>(
+          &pick_result.result);
+      ASSERT_NE(complete, nullptr) << PickResultString(pick_result);
+      ASSERT_NE(complete->subchannel_call_tracker, nullptr);
+      auto* subchannel = static_cast<SubchannelState::FakeSubchannel*>(
+          complete->subchannel.get());
+      const std::string& address = subchannel->state()->address();
+      auto it = backend_metrics.find(address);
+      ASSERT_NE(it, backend_metrics.end()) << address;
+      complete->subchannel_call_tracker->Start();
+      FakeMetadata metadata({});
+      FakeBackendMetricAccessor backend_metric_accessor(it->second);
+      complete->subchannel_call_tracker->Finish(
+          {absl::OkStatus(), &metadata, &backend_metric_accessor});
+      reported.insert(address);
+    }
+    EXPECT_EQ(reported.size(), backend_metrics.size());
+  }
+
+  // Returns the number of picks for each address out of num_picks.
+  std::map<std::string, size_t> GetPickCounts(
+      LoadBalancingPolicy::SubchannelPicker* picker, size_t num_picks) {
+    std::map<std::string, size_t> counts;
+    auto picks = GetCompletePicks(picker, num_picks);
+    if (!picks.has_value()) return counts;
+    for (const auto& address : *picks) ++counts[address];
+    return counts;
+  }
+
+  OrphanablePtr<LoadBalancingPolicy> lb_policy_;
+};
+
+TEST_F(WeightedRoundRobinTest, Basic) {
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  ExpectStartup(kAddresses);
+}
+
+TEST_F(WeightedRoundRobinTest, AddressUpdates) {
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  ExpectStartup(kAddresses);
+  // Send update to remove address 2.
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(absl::MakeSpan(kAddresses).first(2),
+                                    MakeWrrConfig()),
+                        lb_policy_.get()),
+            absl::OkStatus());
+  WaitForRoundRobinListChange(kAddresses, absl::MakeSpan(kAddresses).first(2));
+}
+
+TEST_F(WeightedRoundRobinTest, InvalidConfig) {
+  auto config = CoreConfiguration::Get()
+                    .lb_policy_registry()
+                    .ParseLoadBalancingConfig(Json::Array{Json::Object{
+                        {"weighted_round_robin",
+                         Json::Object{{"blackoutPeriod", "foo"}}}}});
+  EXPECT_FALSE(config.ok());
+}
+
+TEST_F(WeightedRoundRobinTest, PicksFollowBackendMetrics) {
+  const std::array<absl::string_view, 3> kAddresses = {
+      "ipv4:127.0.0.1:441", "ipv4:127.0.0.1:442", "ipv4:127.0.0.1:443"};
+  ExpectStartup(kAddresses);
+  // Switch to a config that applies reports immediately and rebuilds the
+  // picker frequently.
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(kAddresses, MakeWrrConfig("0s", "0.1s")),
+                        lb_policy_.get()),
+            absl::OkStatus());
+  auto update = helper_->DrainQueue();
+  ASSERT_TRUE(update.has_value());
+  ASSERT_EQ(update->state, GRPC_CHANNEL_READY);
+  // Report weights of 4:2:1 through per-call metrics.
+  std::map<std::string, BackendMetricData> backend_metrics;
+  for (size_t i = 0; i < kAddresses.size(); ++i) {
+    BackendMetricData data;
+    data.qps = 100;
+    data.cpu_utilization = 0.1 * (1 << i);
+    backend_metrics.emplace(std::string(kAddresses[i]), data);
+  }
+  ReportBackendMetrics(update->picker.get(), backend_metrics);
+  // When the timer fires, it publishes a picker that uses the new weights.
+  IncrementTimeBy(Duration::Milliseconds(100));
+  auto new_update = helper_->DrainQueue();
+  ASSERT_TRUE(new_update.has_value());
+  ASSERT_EQ(new_update->state, GRPC_CHANNEL_READY);
+  auto counts = GetPickCounts(new_update->picker.get(), 700);
+  EXPECT_NEAR(counts[std::string(kAddresses[0])], 400, 10);
+  EXPECT_NEAR(counts[std::string(kAddresses[1])], 200, 10);
+  EXPECT_NEAR(counts[std::string(kAddresses[2])], 100, 10);
+  // Go back to a long weight update period.
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(kAddresses, MakeWrrConfig()),
+                        lb_policy_.get()),
+            absl::OkStatus());
+  update = helper_->DrainQueue();
+  ASSERT_TRUE(update.has_value());
+  EXPECT_EQ(update->state, GRPC_CHANNEL_READY);
+}
+
+TEST_F(WeightedRoundRobinTest, WeightUpdatePeriodChange) {
+  const std::array<absl::string_view, 2> kAddresses = {"ipv4:127.0.0.1:441",
+                                                       "ipv4:127.0.0.1:442"};
+  ExpectStartup(kAddresses);
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(kAddresses, MakeWrrConfig("0s", "0.1s")),
+                        lb_policy_.get()),
+            absl::OkStatus());
+  ASSERT_TRUE(helper_->DrainQueue().has_value());
+  // The timer publishes a new picker every period.
+  for (int i = 0; i < 3; ++i) {
+    IncrementTimeBy(Duration::Milliseconds(100));
+    auto update = helper_->DrainQueue();
+    ASSERT_TRUE(update.has_value()) << "period " << i;
+    EXPECT_EQ(update->state, GRPC_CHANNEL_READY);
+  }
+  // Changing the period restarts the timer with the new period.
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(kAddresses, MakeWrrConfig("0s", "0.5s")),
+                        lb_policy_.get()),
+            absl::OkStatus());
+  ASSERT_TRUE(helper_->DrainQueue().has_value());
+  IncrementTimeBy(Duration::Milliseconds(400));
+  EXPECT_FALSE(helper_->DrainQueue().has_value());
+  IncrementTimeBy(Duration::Milliseconds(100));
+  EXPECT_TRUE(helper_->DrainQueue().has_value());
+  // Go back to a long weight update period.
+  EXPECT_EQ(ApplyUpdate(BuildUpdate(kAddresses, MakeWrrConfig()),
+                        lb_policy_.get()),
+            absl::OkStatus());
+  ASSERT_TRUE(helper_->DrainQueue().has_value());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc::testing::TestEnvironment env(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
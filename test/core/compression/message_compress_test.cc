@@ -160,6 +160,27 @@ TEST(MessageCompressTest, TinyDataCompress) {
   grpc_slice_buffer_destroy(&output);
 }
 
+TEST(MessageCompressTest, TinyDataTryCompressLeavesOutputUnchanged) {
+  grpc_slice_buffer input;
+  grpc_slice_buffer output;
+
+  grpc_slice_buffer_init(&input);
+  grpc_slice_buffer_init(&output);
+  grpc_slice_buffer_add(&input, create_test_value(ONE_A));
+
+  for (int i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    grpc_core::ExecCtx exec_ctx;
+    ASSERT_EQ(0, grpc_msg_try_compress(
+                     static_cast<grpc_compression_algorithm>(i), &input,
+                     &output));
+    ASSERT_EQ(0, output.count);
+    ASSERT_EQ(0, output.length);
+  }
+
+  grpc_slice_buffer_destroy(&input);
+  grpc_slice_buffer_destroy(&output);
+}
+
 TEST(MessageCompressTest, BadDecompressionDataCrc) {
   grpc_slice_buffer input;
   grpc_slice_buffer corrupted;
@@ -85,6 +85,14 @@ extern void graceful_server_shutdown(grpc_end2end_test_config config);
 extern void graceful_server_shutdown_pre_init(void);
 extern void grpc_authz(grpc_end2end_test_config config);
 extern void grpc_authz_pre_init(void);
+extern void hedging(grpc_end2end_test_config config);
+extern void hedging_pre_init(void);
+extern void hedging_server_pushback(grpc_end2end_test_config config);
+extern void hedging_server_pushback_pre_init(void);
+extern void hedging_streaming(grpc_end2end_test_config config);
+extern void hedging_streaming_pre_init(void);
+extern void hedging_throttled(grpc_end2end_test_config config);
+extern void hedging_throttled_pre_init(void);
 extern void high_initial_seqno(grpc_end2end_test_config config);
 extern void high_initial_seqno_pre_init(void);
 extern void hpack_size(grpc_end2end_test_config config);
@@ -147,6 +155,8 @@ extern void retry_lb_drop(grpc_end2end_test_config config);
 extern void retry_lb_drop_pre_init(void);
 extern void retry_lb_fail(grpc_end2end_test_config config);
 extern void retry_lb_fail_pre_init(void);
+extern void retry_memory_pressure(grpc_end2end_test_config config);
+extern void retry_memory_pressure_pre_init(void);
 extern void retry_non_retriable_status(grpc_end2end_test_config config);
 extern void retry_non_retriable_status_pre_init(void);
 extern void retry_non_retriable_status_before_recv_trailing_metadata_started(grpc_end2end_test_config config);
@@ -247,6 +257,10 @@ void grpc_end2end_tests_pre_init(void) {
   filtered_metadata_pre_init();
   graceful_server_shutdown_pre_init();
   grpc_authz_pre_init();
+  hedging_pre_init();
+  hedging_server_pushback_pre_init();
+  hedging_streaming_pre_init();
+  hedging_throttled_pre_init();
   high_initial_seqno_pre_init();
   hpack_size_pre_init();
   invoke_large_request_pre_init();
@@ -278,6 +292,7 @@ void grpc_end2end_tests_pre_init(void) {
   retry_exceeds_buffer_size_in_subsequent_batch_pre_init();
   retry_lb_drop_pre_init();
   retry_lb_fail_pre_init();
+  retry_memory_pressure_pre_init();
   retry_non_retriable_status_pre_init();
   retry_non_retriable_status_before_recv_trailing_metadata_started_pre_init();
   retry_per_attempt_recv_timeout_pre_init();
@@ -350,6 +365,10 @@ void grpc_end2end_tests(int argc, char **argv,
     filtered_metadata(config);
     graceful_server_shutdown(config);
     grpc_authz(config);
+    hedging(config);
+    hedging_server_pushback(config);
+    hedging_streaming(config);
+    hedging_throttled(config);
     high_initial_seqno(config);
     hpack_size(config);
     invoke_large_request(config);
@@ -381,6 +400,7 @@ void grpc_end2end_tests(int argc, char **argv,
     retry_exceeds_buffer_size_in_subsequent_batch(config);
     retry_lb_drop(config);
     retry_lb_fail(config);
+    retry_memory_pressure(config);
     retry_non_retriable_status(config);
     retry_non_retriable_status_before_recv_trailing_metadata_started(config);
     retry_per_attempt_recv_timeout(config);
@@ -531,6 +551,22 @@ void grpc_end2end_tests(int argc, char **argv,
       grpc_authz(config);
       continue;
     }
+    if (0 == strcmp("hedging", argv[i])) {
+      hedging(config);
+      continue;
+    }
+    if (0 == strcmp("hedging_server_pushback", argv[i])) {
+      hedging_server_pushback(config);
+      continue;
+    }
+    if (0 == strcmp("hedging_streaming", argv[i])) {
+      hedging_streaming(config);
+      continue;
+    }
+    if (0 == strcmp("hedging_throttled", argv[i])) {
+      hedging_throttled(config);
+      continue;
+    }
     if (0 == strcmp("high_initial_seqno", argv[i])) {
       high_initial_seqno(config);
       continue;
@@ -655,6 +691,10 @@ void grpc_end2end_tests(int argc, char **argv,
       retry_lb_fail(config);
       continue;
     }
+    if (0 == strcmp("retry_memory_pressure", argv[i])) {
+      retry_memory_pressure(config);
+      continue;
+    }
     if (0 == strcmp("retry_non_retriable_status", argv[i])) {
       retry_non_retriable_status(config);
       continue;
@@ -247,6 +247,10 @@ END2END_TESTS = {
     "filtered_metadata": _test_options(),
     "graceful_server_shutdown": _test_options(exclude_inproc = True),
     "grpc_authz": _test_options(secure = True),
+    "hedging": _test_options(needs_client_channel = True, needs_retry = True),
+    "hedging_server_pushback": _test_options(needs_client_channel = True, needs_retry = True),
+    "hedging_streaming": _test_options(needs_client_channel = True, needs_retry = True),
+    "hedging_throttled": _test_options(needs_client_channel = True, needs_retry = True),
     "hpack_size": _test_options(
         proxyable = False,
         traceable = False,
@@ -313,6 +317,7 @@ END2END_TESTS = {
     ),
     "retry_lb_drop": _test_options(needs_client_channel = True, needs_retry = True),
     "retry_lb_fail": _test_options(needs_client_channel = True, needs_retry = True),
+    "retry_memory_pressure": _test_options(needs_client_channel = True, needs_retry = True),
     "retry_non_retriable_status": _test_options(needs_client_channel = True, needs_retry = True),
     "retry_non_retriable_status_before_recv_trailing_metadata_started": _test_options(
         needs_client_channel = True,
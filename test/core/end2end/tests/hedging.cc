@@ -0,0 +1,287 @@
+//
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+
+#include <stdint.h>
+#include <string.h>
+
+#include <grpc/byte_buffer.h>
+#include <grpc/grpc.h>
+#include <grpc/impl/propagation_bits.h>
+#include <grpc/slice.h>
+#include <grpc/status.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gpr/useful.h"
+#include "test/core/end2end/cq_verifier.h"
+#include "test/core/end2end/end2end_tests.h"
+#include "test/core/util/test_config.h"
+
+static void* tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+static grpc_end2end_test_fixture begin_test(grpc_end2end_test_config config,
+                                            const char* test_name,
+                                            grpc_channel_args* client_args,
+                                            grpc_channel_args* server_args) {
+  grpc_end2end_test_fixture f;
+  gpr_log(GPR_INFO, "Running test: %s/%s", test_name, config.name);
+  f = config.create_fixture(client_args, server_args);
+  config.init_server(&f, server_args);
+  config.init_client(&f, client_args);
+  return f;
+}
+
+static gpr_timespec n_seconds_from_now(int n) {
+  return grpc_timeout_seconds_to_deadline(n);
+}
+
+static gpr_timespec five_seconds_from_now(void) {
+  return n_seconds_from_now(5);
+}
+
+static void drain_cq(grpc_completion_queue* cq) {
+  grpc_event ev;
+  do {
+    ev = grpc_completion_queue_next(cq, five_seconds_from_now(), nullptr);
+  } while (ev.type != GRPC_QUEUE_SHUTDOWN);
+}
+
+static void shutdown_server(grpc_end2end_test_fixture* f) {
+  if (!f->server) return;
+  grpc_server_shutdown_and_notify(f->server, f->cq, tag(1000));
+  grpc_event ev;
+  do {
+    ev = grpc_completion_queue_next(f->cq, grpc_timeout_seconds_to_deadline(5),
+                                    nullptr);
+  } while (ev.type != GRPC_OP_COMPLETE || ev.tag != tag(1000));
+  grpc_server_destroy(f->server);
+  f->server = nullptr;
+}
+
+static void shutdown_client(grpc_end2end_test_fixture* f) {
+  if (!f->client) return;
+  grpc_channel_destroy(f->client);
+  f->client = nullptr;
+}
+
+static void end_test(grpc_end2end_test_fixture* f) {
+  shutdown_server(f);
+  shutdown_client(f);
+
+  grpc_completion_queue_shutdown(f->cq);
+  drain_cq(f->cq);
+  grpc_completion_queue_destroy(f->cq);
+}
+
+// Starts a batch on the server call s that waits for the call to be
+// closed, recording whether it was cancelled in *was_cancelled.
+static void start_recv_close_on_server(grpc_call* s, int* was_cancelled,
+                                       intptr_t t) {
+  grpc_op op;
+  memset(&op, 0, sizeof(op));
+  op.op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  op.data.recv_close_on_server.cancelled = was_cancelled;
+  grpc_call_error error = grpc_call_start_batch(s, &op, 1, tag(t), nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+}
+
+// Tests hedging.
+// - 3 attempts allowed, 1 second apart
+// - each attempt starts hedgingDelay after the previous one, and no
+//   attempt is started after the third
+// - the second attempt responds, so the call is committed to it and the
+//   other two are cancelled
+static void test_hedging(grpc_end2end_test_config config) {
+  grpc_call* c;
+  grpc_call* s[3];
+  grpc_op ops[6];
+  grpc_op* op;
+  grpc_metadata_array initial_metadata_recv;
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_metadata_array request_metadata_recv[3];
+  grpc_call_details call_details[3];
+  grpc_slice request_payload_slice = grpc_slice_from_static_string("foo");
+  grpc_slice response_payload_slice = grpc_slice_from_static_string("bar");
+  grpc_byte_buffer* request_payload =
+      grpc_raw_byte_buffer_create(&request_payload_slice, 1);
+  grpc_byte_buffer* response_payload =
+      grpc_raw_byte_buffer_create(&response_payload_slice, 1);
+  grpc_byte_buffer* response_payload_recv = nullptr;
+  grpc_status_code status;
+  grpc_call_error error;
+  grpc_slice details;
+  int was_cancelled[3] = {2, 2, 2};
+
+  grpc_arg args[] = {
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING), 1),
+      grpc_channel_arg_string_create(
+          const_cast<char*>(GRPC_ARG_SERVICE_CONFIG),
+          const_cast<char*>(
+              "{\n"
+              "  \"methodConfig\": [ {\n"
+              "    \"name\": [\n"
+              "      { \"service\": \"service\", \"method\": \"method\" }\n"
+              "    ],\n"
+              "    \"hedgingPolicy\": {\n"
+              "      \"maxAttempts\": 3,\n"
+              "      \"hedgingDelay\": \"1s\",\n"
+              "      \"nonFatalStatusCodes\": [ \"ABORTED\" ]\n"
+              "    }\n"
+              "  } ]\n"
+              "}")),
+  };
+  grpc_channel_args client_args = {GPR_ARRAY_SIZE(args), args};
+  grpc_end2end_test_fixture f =
+      begin_test(config, "hedging", &client_args, nullptr);
+
+  grpc_core::CqVerifier cqv(f.cq);
+
+  gpr_timespec deadline = n_seconds_from_now(30);
+  c = grpc_channel_create_call(f.client, nullptr, GRPC_PROPAGATE_DEFAULTS, f.cq,
+                               grpc_slice_from_static_string("/service/method"),
+                               nullptr, deadline, nullptr);
+  GPR_ASSERT(c);
+
+  grpc_metadata_array_init(&initial_metadata_recv);
+  grpc_metadata_array_init(&trailing_metadata_recv);
+  for (int i = 0; i < 3; ++i) {
+    grpc_metadata_array_init(&request_metadata_recv[i]);
+    grpc_call_details_init(&call_details[i]);
+  }
+  grpc_slice status_details = grpc_slice_from_static_string("xyz");
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_SEND_MESSAGE;
+  op->data.send_message.send_message = request_payload;
+  op++;
+  op->op = GRPC_OP_RECV_MESSAGE;
+  op->data.recv_message.recv_message = &response_payload_recv;
+  op++;
+  op->op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  op++;
+  op->op = GRPC_OP_RECV_INITIAL_METADATA;
+  op->data.recv_initial_metadata.recv_initial_metadata = &initial_metadata_recv;
+  op++;
+  op->op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  op->data.recv_status_on_client.trailing_metadata = &trailing_metadata_recv;
+  op->data.recv_status_on_client.status = &status;
+  op->data.recv_status_on_client.status_details = &details;
+  op++;
+  gpr_timespec start_time = gpr_now(GPR_CLOCK_MONOTONIC);
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(1),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  // Attempt i (counting from 0) starts i hedgingDelays after the call.
+  // To avoid flakiness, we allow some fudge factor here.
+  for (int i = 0; i < 3; ++i) {
+    error = grpc_server_request_call(f.server, &s[i], &call_details[i],
+                                     &request_metadata_recv[i], f.cq, f.cq,
+                                     tag(100 * (i + 1) + 1));
+    GPR_ASSERT(GRPC_CALL_OK == error);
+    cqv.Expect(tag(100 * (i + 1) + 1), true);
+    cqv.Verify();
+    int32_t elapsed_ms = gpr_time_to_millis(
+        gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start_time));
+    gpr_log(GPR_INFO, "attempt %d started after %d ms", i + 1, elapsed_ms);
+    GPR_ASSERT(elapsed_ms >= i * 1000 - 200);
+    GPR_ASSERT(
+        0 == grpc_slice_str_cmp(call_details[i].method, "/service/method"));
+    start_recv_close_on_server(s[i], &was_cancelled[i], 100 * (i + 1) + 2);
+  }
+
+  // No fourth attempt is started, since maxAttempts is 3.
+  grpc_call* s4 = nullptr;
+  grpc_metadata_array request_metadata_recv4;
+  grpc_call_details call_details4;
+  grpc_metadata_array_init(&request_metadata_recv4);
+  grpc_call_details_init(&call_details4);
+  error =
+      grpc_server_request_call(f.server, &s4, &call_details4,
+                               &request_metadata_recv4, f.cq, f.cq, tag(401));
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  cqv.VerifyEmpty(grpc_core::Duration::Seconds(2));
+
+  // The second attempt responds.
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_SEND_MESSAGE;
+  op->data.send_message.send_message = response_payload;
+  op++;
+  op->op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  op->data.send_status_from_server.trailing_metadata_count = 0;
+  op->data.send_status_from_server.status = GRPC_STATUS_OK;
+  op->data.send_status_from_server.status_details = &status_details;
+  op++;
+  error = grpc_call_start_batch(s[1], ops, static_cast<size_t>(op - ops),
+                                tag(203), nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  // The other attempts are cancelled when the call commits.
+  cqv.Expect(tag(102), true);
+  cqv.Expect(tag(202), true);
+  cqv.Expect(tag(203), true);
+  cqv.Expect(tag(302), true);
+  cqv.Expect(tag(1), true);
+  cqv.Verify();
+
+  GPR_ASSERT(status == GRPC_STATUS_OK);
+  GPR_ASSERT(0 == grpc_slice_str_cmp(details, "xyz"));
+  GPR_ASSERT(
+      byte_buffer_eq_slice(response_payload_recv, response_payload_slice));
+  GPR_ASSERT(was_cancelled[0] == 1);
+  GPR_ASSERT(was_cancelled[1] == 0);
+  GPR_ASSERT(was_cancelled[2] == 1);
+
+  grpc_slice_unref(details);
+  grpc_metadata_array_destroy(&initial_metadata_recv);
+  grpc_metadata_array_destroy(&trailing_metadata_recv);
+  for (int i = 0; i < 3; ++i) {
+    grpc_metadata_array_destroy(&request_metadata_recv[i]);
+    grpc_call_details_destroy(&call_details[i]);
+    grpc_call_unref(s[i]);
+  }
+  grpc_byte_buffer_destroy(request_payload);
+  grpc_byte_buffer_destroy(response_payload);
+  grpc_byte_buffer_destroy(response_payload_recv);
+
+  grpc_call_unref(c);
+
+  end_test(&f);
+  GPR_ASSERT(s4 == nullptr);
+  grpc_metadata_array_destroy(&request_metadata_recv4);
+  grpc_call_details_destroy(&call_details4);
+  config.tear_down_data(&f);
+}
+
+void hedging(grpc_end2end_test_config config) {
+  GPR_ASSERT(config.feature_mask & FEATURE_MASK_SUPPORTS_CLIENT_CHANNEL);
+  test_hedging(config);
+}
+
+void hedging_pre_init(void) {}
@@ -0,0 +1,315 @@
+//
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+
+#include <stdint.h>
+#include <string.h>
+
+#include <grpc/byte_buffer.h>
+#include <grpc/grpc.h>
+#include <grpc/impl/propagation_bits.h>
+#include <grpc/slice.h>
+#include <grpc/status.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/gpr/useful.h"
+#include "test/core/end2end/cq_verifier.h"
+#include "test/core/end2end/end2end_tests.h"
+#include "test/core/util/test_config.h"
+
+static void* tag(intptr_t t) { return reinterpret_cast<void*>(t); }
+
+static grpc_end2end_test_fixture begin_test(grpc_end2end_test_config config,
+                                            const char* test_name,
+                                            grpc_channel_args* client_args,
+                                            grpc_channel_args* server_args) {
+  grpc_end2end_test_fixture f;
+  gpr_log(GPR_INFO, "Running test: %s/%s", test_name, config.name);
+  f = config.create_fixture(client_args, server_args);
+  config.init_server(&f, server_args);
+  config.init_client(&f, client_args);
+  return f;
+}
+
+static gpr_timespec n_seconds_from_now(int n) {
+  return grpc_timeout_seconds_to_deadline(n);
+}
+
+static gpr_timespec five_seconds_from_now(void) {
+  return n_seconds_from_now(5);
+}
+
+static void drain_cq(grpc_completion_queue* cq) {
+  grpc_event ev;
+  do {
+    ev = grpc_completion_queue_next(cq, five_seconds_from_now(), nullptr);
+  } while (ev.type != GRPC_QUEUE_SHUTDOWN);
+}
+
+static void shutdown_server(grpc_end2end_test_fixture* f) {
+  if (!f->server) return;
+  grpc_server_shutdown_and_notify(f->server, f->cq, tag(1000));
+  grpc_event ev;
+  do {
+    ev = grpc_completion_queue_next(f->cq, grpc_timeout_seconds_to_deadline(5),
+                                    nullptr);
+  } while (ev.type != GRPC_OP_COMPLETE || ev.tag != tag(1000));
+  grpc_server_destroy(f->server);
+  f->server = nullptr;
+}
+
+static void shutdown_client(grpc_end2end_test_fixture* f) {
+  if (!f->client) return;
+  grpc_channel_destroy(f->client);
+  f->client = nullptr;
+}
+
+static void end_test(grpc_end2end_test_fixture* f) {
+  shutdown_server(f);
+  shutdown_client(f);
+
+  grpc_completion_queue_shutdown(f->cq);
+  drain_cq(f->cq);
+  grpc_completion_queue_destroy(f->cq);
+}
+
+// Starts a batch on call with the single op op.
+static void start_op(grpc_call* call, grpc_op* op, intptr_t t) {
+  grpc_call_error error = grpc_call_start_batch(call, op, 1, tag(t), nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+}
+
+// Receives a message on the server call s and checks that it is expected.
+static void recv_message_on_server(grpc_core::CqVerifier* cqv, grpc_call* s,
+                                   intptr_t t, const char* expected) {
+  grpc_byte_buffer* payload_recv = nullptr;
+  grpc_op op;
+  memset(&op, 0, sizeof(op));
+  op.op = GRPC_OP_RECV_MESSAGE;
+  op.data.recv_message.recv_message = &payload_recv;
+  start_op(s, &op, t);
+  cqv->Expect(tag(t), true);
+  cqv->Verify();
+  GPR_ASSERT(byte_buffer_eq_string(payload_recv, expected));
+  grpc_byte_buffer_destroy(payload_recv);
+}
+
+// Tests that hedged attempts replay cached send ops, and that the cache
+// outlives the commit.
+// - 2 attempts allowed, 1 second apart
+// - client sends 2 messages in separate batches before the second
+//   attempt starts, which replays them from the cache
+// - the second attempt responds, so the call is committed to it and the
+//   first one is cancelled
+// - client sends a third message after the commit, which goes to the
+//   second attempt only
+static void test_hedging_streaming(grpc_end2end_test_config config) {
+  grpc_call* c;
+  grpc_call* s[2];
+  grpc_op ops[2];
+  grpc_op* op;
+  grpc_metadata_array initial_metadata_recv;
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_metadata_array request_metadata_recv[2];
+  grpc_call_details call_details[2];
+  grpc_slice request_payload_slice = grpc_slice_from_static_string("foo");
+  grpc_slice request2_payload_slice = grpc_slice_from_static_string("bar");
+  grpc_slice request3_payload_slice = grpc_slice_from_static_string("baz");
+  grpc_byte_buffer* request_payload =
+      grpc_raw_byte_buffer_create(&request_payload_slice, 1);
+  grpc_byte_buffer* request2_payload =
+      grpc_raw_byte_buffer_create(&request2_payload_slice, 1);
+  grpc_byte_buffer* request3_payload =
+      grpc_raw_byte_buffer_create(&request3_payload_slice, 1);
+  grpc_status_code status;
+  grpc_call_error error;
+  grpc_slice details;
+  int was_cancelled[2] = {2, 2};
+
+  grpc_arg args[] = {
+      grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING), 1),
+      grpc_channel_arg_string_create(
+          const_cast<char*>(GRPC_ARG_SERVICE_CONFIG),
+          const_cast<char*>(
+              "{\n"
+              "  \"methodConfig\": [ {\n"
+              "    \"name\": [\n"
+              "      { \"service\": \"service\", \"method\": \"method\" }\n"
+              "    ],\n"
+              "    \"hedgingPolicy\": {\n"
+              "      \"maxAttempts\": 2,\n"
+              "      \"hedgingDelay\": \"1s\",\n"
+              "      \"nonFatalStatusCodes\": [ \"ABORTED\" ]\n"
+              "    }\n"
+              "  } ]\n"
+              "}")),
+  };
+  grpc_channel_args client_args = {GPR_ARRAY_SIZE(args), args};
+  grpc_end2end_test_fixture f =
+      begin_test(config, "hedging_streaming", &client_args, nullptr);
+
+  grpc_core::CqVerifier cqv(f.cq);
+
+  gpr_timespec deadline = n_seconds_from_now(30);
+  c = grpc_channel_create_call(f.client, nullptr, GRPC_PROPAGATE_DEFAULTS, f.cq,
+                               grpc_slice_from_static_string("/service/method"),
+                               nullptr, deadline, nullptr);
+  GPR_ASSERT(c);
+
+  grpc_metadata_array_init(&initial_metadata_recv);
+  grpc_metadata_array_init(&trailing_metadata_recv);
+  for (int i = 0; i < 2; ++i) {
+    grpc_metadata_array_init(&request_metadata_recv[i]);
+    grpc_call_details_init(&call_details[i]);
+  }
+  grpc_slice status_details = grpc_slice_from_static_string("xyz");
+
+  // Client starts a batch with send_initial_metadata and send_message.
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_SEND_MESSAGE;
+  op->data.send_message.send_message = request_payload;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(1),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  // Client starts receiving initial metadata and status.
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_RECV_INITIAL_METADATA;
+  ops[0].data.recv_initial_metadata.recv_initial_metadata =
+      &initial_metadata_recv;
+  start_op(c, &ops[0], 2);
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  ops[0].data.recv_status_on_client.trailing_metadata = &trailing_metadata_recv;
+  ops[0].data.recv_status_on_client.status = &status;
+  ops[0].data.recv_status_on_client.status_details = &details;
+  start_op(c, &ops[0], 3);
+
+  // Server gets the first attempt and its first message.
+  error = grpc_server_request_call(f.server, &s[0], &call_details[0],
+                                   &request_metadata_recv[0], f.cq, f.cq,
+                                   tag(101));
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  cqv.Expect(tag(101), true);
+  cqv.Expect(tag(1), true);
+  cqv.Verify();
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  ops[0].data.recv_close_on_server.cancelled = &was_cancelled[0];
+  start_op(s[0], &ops[0], 102);
+  recv_message_on_server(&cqv, s[0], 103, "foo");
+
+  // Client sends a second message in its own batch.
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_MESSAGE;
+  ops[0].data.send_message.send_message = request2_payload;
+  start_op(c, &ops[0], 4);
+  cqv.Expect(tag(4), true);
+  cqv.Verify();
+  recv_message_on_server(&cqv, s[0], 104, "bar");
+
+  // Server gets the second attempt, which replays both messages.
+  error = grpc_server_request_call(f.server, &s[1], &call_details[1],
+                                   &request_metadata_recv[1], f.cq, f.cq,
+                                   tag(201));
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  cqv.Expect(tag(201), true);
+  cqv.Verify();
+  GPR_ASSERT(
+      0 == grpc_slice_str_cmp(call_details[1].method, "/service/method"));
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  ops[0].data.recv_close_on_server.cancelled = &was_cancelled[1];
+  start_op(s[1], &ops[0], 202);
+  recv_message_on_server(&cqv, s[1], 203, "foo");
+  recv_message_on_server(&cqv, s[1], 204, "bar");
+
+  // Server sends initial metadata on the second attempt, which commits
+  // the call to it and cancels the first attempt.
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+  ops[0].data.send_initial_metadata.count = 0;
+  start_op(s[1], &ops[0], 205);
+  cqv.Expect(tag(205), true);
+  cqv.Expect(tag(2), true);
+  cqv.Expect(tag(102), true);
+  cqv.Verify();
+  GPR_ASSERT(was_cancelled[0] == 1);
+
+  // Client sends a third message and half-closes after the commit.
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_MESSAGE;
+  op->data.send_message.send_message = request3_payload;
+  op++;
+  op->op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(5),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  cqv.Expect(tag(5), true);
+  cqv.Verify();
+  recv_message_on_server(&cqv, s[1], 206, "baz");
+
+  // Server sends status.
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  ops[0].data.send_status_from_server.trailing_metadata_count = 0;
+  ops[0].data.send_status_from_server.status = GRPC_STATUS_OK;
+  ops[0].data.send_status_from_server.status_details = &status_details;
+  start_op(s[1], &ops[0], 207);
+  cqv.Expect(tag(207), true);
+  cqv.Expect(tag(202), true);
+  cqv.Expect(tag(3), true);
+  cqv.Verify();
+
+  GPR_ASSERT(status == GRPC_STATUS_OK);
+  GPR_ASSERT(0 == grpc_slice_str_cmp(details, "xyz"));
+  GPR_ASSERT(was_cancelled[1] == 0);
+
+  grpc_slice_unref(details);
+  grpc_metadata_array_destroy(&initial_metadata_recv);
+  grpc_metadata_array_destroy(&trailing_metadata_recv);
+  for (int i = 0; i < 2; ++i) {
+    grpc_metadata_array_destroy(&request_metadata_recv[i]);
+    grpc_call_details_destroy(&call_details[i]);
+    grpc_call_unref(s[i]);
+  }
+  grpc_byte_buffer_destroy(request_payload);
+  grpc_byte_buffer_destroy(request2_payload);
+  grpc_byte_buffer_destroy(request3_payload);
+
+  grpc_call_unref(c);
+
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+void hedging_streaming(grpc_end2end_test_config config) {
+  GPR_ASSERT(config.feature_mask & FEATURE_MASK_SUPPORTS_CLIENT_CHANNEL);
+  test_hedging_streaming(config);
+}
+
+void hedging_streaming_pre_init(void) {}
@@ -124,6 +124,11 @@ void FuzzingEventEngine::Tick() {
   }
 }
 
+void FuzzingEventEngine::TickForDuration(Duration d) {
+  const Time end = Now() + d;
+  while (Now() < end) Tick();
+}
+
 FuzzingEventEngine::Time FuzzingEventEngine::Now() {
   grpc_core::MutexLock lock(&mu_);
   return now_;
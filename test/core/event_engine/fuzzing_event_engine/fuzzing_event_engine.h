@@ -52,6 +52,10 @@ class FuzzingEventEngine : public EventEngine {
 
   void FuzzingDone();
   void Tick();
+  // Tick until Now() has advanced by at least d. Time moves in steps of
+  // final_tick_length once the scheduled tick lengths are used up, so tests
+  // driving the clock directly should pick a small final_tick_length.
+  void TickForDuration(Duration d) ABSL_LOCKS_EXCLUDED(mu_);
 
   absl::StatusOr<std::unique_ptr<Listener>> CreateListener(
       Listener::AcceptCallback on_accept,
@@ -0,0 +1,224 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/filters/adaptive_concurrency/adaptive_concurrency_filter.h"
+
+#include <memory>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/variant.h"
+#include "gtest/gtest.h"
+
+#include <grpc/event_engine/memory_allocator.h>
+#include <grpc/grpc.h>
+#include <grpc/impl/grpc_types.h>
+
+#include "src/core/ext/filters/adaptive_concurrency/concurrency_limiter.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/channel/channel_args_preconditioning.h"
+#include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/promise/latch.h"
+#include "src/core/lib/promise/poll.h"
+#include "src/core/lib/resource_quota/arena.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "src/core/lib/transport/metadata_batch.h"
+#include "test/core/promise/test_context.h"
+
+namespace grpc_core {
+namespace {
+
+// A limit of one call that fails calls above it immediately.
+constexpr absl::string_view kConfig =
+    "{\"minLimit\":1,\"maxLimit\":1,\"initialLimit\":1}";
+
+ChannelArgs ServerChannelArgs(absl::string_view config) {
+  auto args = ChannelArgs()
+                  .Set(GRPC_ARG_EXPERIMENTAL_ADAPTIVE_CONCURRENCY_CONFIG,
+                       config)
+                  .ToC();
+  return CoreConfiguration::Get()
+      .channel_args_preconditioning()
+      .PreconditionChannelArgs(args.get());
+}
+
+// One call through the filter.  The rest of the stack sends server initial
+// metadata as soon as the call starts, unless send_initial_metadata is
+// false, and completes the call once Finish() is called.
+class TestCall {
+ public:
+  TestCall(AdaptiveConcurrencyFilter* filter, bool send_initial_metadata)
+      : arena_(MakeScopedArena(1024, &memory_allocator_)),
+        initial_metadata_(arena_.get()),
+        trailing_metadata_(arena_.get()),
+        context_(arena_.get()) {
+    promise_ = filter->MakeCallPromise(
+        CallArgs{ClientMetadataHandle(), &server_initial_metadata_, nullptr,
+                 nullptr},
+        [this, send_initial_metadata](CallArgs call_args) {
+          if (send_initial_metadata) {
+            call_args.server_initial_metadata->Set(&initial_metadata_);
+          }
+          return ArenaPromise<ServerMetadataHandle>(
+              [this]() -> Poll<ServerMetadataHandle> {
+                if (!finished_) return Pending();
+                return ServerMetadataHandle(&trailing_metadata_,
+                                            Arena::PooledDeleter(nullptr));
+              });
+        });
+  }
+
+  // Polls the call.  Returns the call's status once it completes.
+  absl::optional<absl::Status> Step() {
+    auto r = promise_();
+    auto* md = absl::get_if<ServerMetadataHandle>(&r);
+    if (md == nullptr) return absl::nullopt;
+    return absl::Status(
+        static_cast<absl::StatusCode>(
+            (*md)->get(GrpcStatusMetadata()).value_or(GRPC_STATUS_UNKNOWN)),
+        "");
+  }
+
+  void Finish() {
+    trailing_metadata_.Set(GrpcStatusMetadata(), GRPC_STATUS_OK);
+    finished_ = true;
+  }
+
+  // The server initial metadata that reached the transport, if any.
+  absl::optional<ServerMetadata*> received_initial_metadata() {
+    auto r = server_initial_metadata_.Wait()();
+    auto* md = absl::get_if<ServerMetadata**>(&r);
+    if (md == nullptr) return absl::nullopt;
+    return **md;
+  }
+  ServerMetadata* sent_initial_metadata() { return &initial_metadata_; }
+
+ private:
+  MemoryAllocator memory_allocator_ = MemoryAllocator(
+      ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator("test"));
+  ScopedArenaPtr arena_;
+  grpc_metadata_batch initial_metadata_;
+  grpc_metadata_batch trailing_metadata_;
+  Latch<ServerMetadata*> server_initial_metadata_;
+  TestContext<Arena> context_;
+  ArenaPromise<ServerMetadataHandle> promise_;
+  bool finished_ = false;
+};
+
+TEST(ServerAdaptiveConcurrencyFilterTest, CreateFailsWithoutConfig) {
+  EXPECT_FALSE(ServerAdaptiveConcurrencyFilter::Create(ChannelArgs(),
+                                                       ChannelFilter::Args())
+                   .ok());
+}
+
+TEST(ServerAdaptiveConcurrencyFilterTest, CreateFailsWithInvalidConfig) {
+  ChannelArgs args = ServerChannelArgs("{\"minLimit\":0}");
+  EXPECT_EQ(args.GetObject<ConcurrencyLimiter>(), nullptr);
+  auto filter =
+      ServerAdaptiveConcurrencyFilter::Create(args, ChannelFilter::Args());
+  EXPECT_EQ(filter.status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+TEST(ServerAdaptiveConcurrencyFilterTest, EachServerGetsItsOwnLimiter) {
+  ChannelArgs server1_args = ServerChannelArgs(kConfig);
+  ChannelArgs server2_args = ServerChannelArgs(kConfig);
+  auto* limiter = server1_args.GetObject<ConcurrencyLimiter>();
+  ASSERT_NE(limiter, nullptr);
+  EXPECT_NE(server2_args.GetObject<ConcurrencyLimiter>(), nullptr);
+  EXPECT_NE(server2_args.GetObject<ConcurrencyLimiter>(), limiter);
+  // Preconditioning the args again keeps the limiter they already have.
+  EXPECT_EQ(CoreConfiguration::Get()
+                .channel_args_preconditioning()
+                .PreconditionChannelArgs(server1_args.ToC().get())
+                .GetObject<ConcurrencyLimiter>(),
+            limiter);
+}
+
+TEST(ServerAdaptiveConcurrencyFilterTest, ConnectionsShareTheServerLimit) {
+  ChannelArgs server_args = ServerChannelArgs(kConfig);
+  auto filter1 = *ServerAdaptiveConcurrencyFilter::Create(
+      server_args, ChannelFilter::Args());
+  auto filter2 = *ServerAdaptiveConcurrencyFilter::Create(
+      server_args, ChannelFilter::Args());
+  auto* limiter = server_args.GetObject<ConcurrencyLimiter>();
+  TestCall call1(&filter1, true);
+  EXPECT_EQ(call1.Step(), absl::nullopt);
+  EXPECT_EQ(limiter->in_flight(), 1u);
+  // The only slot is taken, so a call on another connection fails.
+  TestCall call2(&filter2, true);
+  EXPECT_EQ(call2.Step(), absl::UnavailableError(""));
+  // Once the first call completes, its slot is free again.
+  call1.Finish();
+  EXPECT_EQ(call1.Step(), absl::OkStatus());
+  EXPECT_EQ(limiter->in_flight(), 0u);
+  TestCall call3(&filter2, true);
+  EXPECT_EQ(call3.Step(), absl::nullopt);
+  EXPECT_EQ(limiter->in_flight(), 1u);
+  call3.Finish();
+  EXPECT_EQ(call3.Step(), absl::OkStatus());
+  EXPECT_EQ(limiter->in_flight(), 0u);
+}
+
+TEST(ServerAdaptiveConcurrencyFilterTest, ServersDoNotShareALimit) {
+  auto filter1 = *ServerAdaptiveConcurrencyFilter::Create(
+      ServerChannelArgs(kConfig), ChannelFilter::Args());
+  auto filter2 = *ServerAdaptiveConcurrencyFilter::Create(
+      ServerChannelArgs(kConfig), ChannelFilter::Args());
+  TestCall call1(&filter1, true);
+  EXPECT_EQ(call1.Step(), absl::nullopt);
+  TestCall call2(&filter2, true);
+  EXPECT_EQ(call2.Step(), absl::nullopt);
+  call1.Finish();
+  call2.Finish();
+  EXPECT_EQ(call1.Step(), absl::OkStatus());
+  EXPECT_EQ(call2.Step(), absl::OkStatus());
+}
+
+TEST(ServerAdaptiveConcurrencyFilterTest, PassesInitialMetadataThrough) {
+  auto filter = *ServerAdaptiveConcurrencyFilter::Create(
+      ServerChannelArgs(kConfig), ChannelFilter::Args());
+  TestCall call(&filter, true);
+  EXPECT_EQ(call.Step(), absl::nullopt);
+  EXPECT_EQ(call.received_initial_metadata(), call.sent_initial_metadata());
+  call.Finish();
+  EXPECT_EQ(call.Step(), absl::OkStatus());
+}
+
+TEST(ServerAdaptiveConcurrencyFilterTest,
+     CallCompletesWithoutInitialMetadata) {
+  ChannelArgs server_args = ServerChannelArgs(kConfig);
+  auto filter = *ServerAdaptiveConcurrencyFilter::Create(
+      server_args, ChannelFilter::Args());
+  TestCall call(&filter, false);
+  EXPECT_EQ(call.Step(), absl::nullopt);
+  call.Finish();
+  EXPECT_EQ(call.Step(), absl::OkStatus());
+  EXPECT_EQ(call.received_initial_metadata(), absl::nullopt);
+  EXPECT_EQ(server_args.GetObject<ConcurrencyLimiter>()->in_flight(), 0u);
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int r = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return r;
+}
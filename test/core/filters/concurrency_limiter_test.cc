@@ -0,0 +1,228 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/filters/adaptive_concurrency/concurrency_limiter.h"
+
+#include <stdint.h>
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+#include "src/core/lib/json/json.h"
+#include "src/core/lib/json/json_object_loader.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+ConcurrencyLimiter::Config MakeConfig(uint32_t min_limit, uint32_t max_limit,
+                                      uint32_t initial_limit) {
+  ConcurrencyLimiter::Config config;
+  config.min_limit = min_limit;
+  config.max_limit = max_limit;
+  config.initial_limit = initial_limit;
+  return config;
+}
+
+// Fills the limiter, then completes every call with the given RTT.
+void RunRound(ConcurrencyLimiter* limiter, int64_t rtt_micros) {
+  uint32_t admitted = 0;
+  while (limiter->TryAcquire()) ++admitted;
+  for (uint32_t i = 0; i < admitted; ++i) limiter->Release(rtt_micros);
+}
+
+class CountingWakeable final : public Wakeable {
+ public:
+  explicit CountingWakeable(int* wakeups) : wakeups_(wakeups) {}
+  void Wakeup() override {
+    ++*wakeups_;
+    delete this;
+  }
+  void Drop() override { delete this; }
+  std::string ActivityDebugTag() const override { return "CountingWakeable"; }
+
+ private:
+  int* const wakeups_;
+};
+
+TEST(ConcurrencyLimiterTest, AdmitsUpToLimit) {
+  auto limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 100, 3), nullptr);
+  EXPECT_TRUE(limiter->TryAcquire());
+  EXPECT_TRUE(limiter->TryAcquire());
+  EXPECT_TRUE(limiter->TryAcquire());
+  EXPECT_FALSE(limiter->TryAcquire());
+  EXPECT_EQ(limiter->in_flight(), 3);
+  // An abandoned call frees its slot without changing the limit.
+  limiter->Release(absl::nullopt);
+  EXPECT_EQ(limiter->limit(), 3);
+  EXPECT_TRUE(limiter->TryAcquire());
+}
+
+TEST(ConcurrencyLimiterTest, LimitGrowsWhileLatencyIsFlat) {
+  auto limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 100, 10), nullptr);
+  for (int i = 0; i < 50; ++i) RunRound(limiter.get(), 1000);
+  EXPECT_GT(limiter->limit(), 10);
+  EXPECT_EQ(limiter->in_flight(), 0);
+}
+
+TEST(ConcurrencyLimiterTest, LimitIsCappedAtMaxLimit) {
+  auto limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 30, 10), nullptr);
+  for (int i = 0; i < 200; ++i) RunRound(limiter.get(), 1000);
+  EXPECT_EQ(limiter->limit(), 30);
+}
+
+TEST(ConcurrencyLimiterTest, LimitShrinksWhenLatencyRises) {
+  auto limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(5, 100, 50), nullptr);
+  // Establish a baseline RTT of 1ms.
+  for (int i = 0; i < 5; ++i) RunRound(limiter.get(), 1000);
+  const uint32_t baseline_limit = limiter->limit();
+  // Latency rises tenfold, well beyond the default tolerance of 1.5.
+  for (int i = 0; i < 20; ++i) RunRound(limiter.get(), 10000);
+  EXPECT_LT(limiter->limit(), baseline_limit);
+  // It does not go below min_limit.
+  for (int i = 0; i < 200; ++i) RunRound(limiter.get(), 100000);
+  EXPECT_GE(limiter->limit(), 5);
+}
+
+TEST(ConcurrencyLimiterTest, LimitDoesNotGrowWhenUnderused) {
+  auto limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 100, 20), nullptr);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(limiter->TryAcquire());
+    limiter->Release(1000);
+  }
+  EXPECT_EQ(limiter->limit(), 20);
+}
+
+TEST(ConcurrencyLimiterTest, ReportsSignificantChanges) {
+  auto limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 1000, 10), nullptr);
+  uint32_t last_reported = 10;
+  int reports = 0;
+  for (int i = 0; i < 50; ++i) {
+    uint32_t admitted = 0;
+    while (limiter->TryAcquire()) ++admitted;
+    for (uint32_t j = 0; j < admitted; ++j) {
+      absl::optional<uint32_t> new_limit = limiter->Release(1000);
+      if (new_limit.has_value()) {
+        EXPECT_GE(*new_limit * 10, last_reported * 11);
+        last_reported = *new_limit;
+        ++reports;
+      }
+    }
+  }
+  EXPECT_GT(reports, 0);
+  EXPECT_LT(reports, 50);
+}
+
+TEST(ConcurrencyLimiterTest, ReleaseWakesWaiters) {
+  auto limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 100, 1), nullptr);
+  int wakeups = 0;
+  EXPECT_TRUE(limiter->TryAcquireOrWait(Waker(new CountingWakeable(&wakeups))));
+  EXPECT_FALSE(
+      limiter->TryAcquireOrWait(Waker(new CountingWakeable(&wakeups))));
+  EXPECT_EQ(wakeups, 0);
+  limiter->Release(absl::nullopt);
+  EXPECT_EQ(wakeups, 1);
+  EXPECT_TRUE(limiter->TryAcquire());
+}
+
+TEST(ConcurrencyLimiterTest, NewLimiterKeepsOldLimit) {
+  auto old_limiter =
+      MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 100, 10), nullptr);
+  for (int i = 0; i < 50; ++i) RunRound(old_limiter.get(), 1000);
+  const uint32_t learned_limit = old_limiter->limit();
+  ASSERT_GT(learned_limit, 10);
+  auto limiter = MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 100, 10),
+                                                    old_limiter.get());
+  EXPECT_EQ(limiter->limit(), learned_limit);
+  // The old limit is clamped to the new bounds.
+  limiter = MakeRefCounted<ConcurrencyLimiter>(MakeConfig(1, 10, 10),
+                                               old_limiter.get());
+  EXPECT_EQ(limiter->limit(), 10);
+}
+
+TEST(ConcurrencyLimiterMapTest, SharesLimiterUntilConfigChanges) {
+  auto config = MakeConfig(1, 100, 10);
+  auto limiter1 = ConcurrencyLimiterMap::Get()->GetLimiter("test", config);
+  auto limiter2 = ConcurrencyLimiterMap::Get()->GetLimiter("test", config);
+  EXPECT_EQ(limiter1, limiter2);
+  EXPECT_NE(limiter1, ConcurrencyLimiterMap::Get()->GetLimiter("other", config));
+  config.max_queue_time = Duration::Seconds(1);
+  auto limiter3 = ConcurrencyLimiterMap::Get()->GetLimiter("test", config);
+  EXPECT_NE(limiter1, limiter3);
+  EXPECT_EQ(limiter3, ConcurrencyLimiterMap::Get()->GetLimiter("test", config));
+}
+
+TEST(ConcurrencyLimiterConfigTest, Defaults) {
+  auto json = Json::Parse("{}");
+  ASSERT_TRUE(json.ok()) << json.status();
+  auto config = LoadFromJson<ConcurrencyLimiter::Config>(*json);
+  ASSERT_TRUE(config.ok()) << config.status();
+  EXPECT_EQ(*config, ConcurrencyLimiter::Config());
+}
+
+TEST(ConcurrencyLimiterConfigTest, AllFields) {
+  auto json = Json::Parse(
+      "{\"minLimit\": 5, \"maxLimit\": 500, \"initialLimit\": 50, "
+      "\"smoothing\": 0.5, \"rttTolerance\": 2, \"longWindow\": 100, "
+      "\"maxQueueTime\": \"0.5s\"}");
+  ASSERT_TRUE(json.ok()) << json.status();
+  auto config = LoadFromJson<ConcurrencyLimiter::Config>(*json);
+  ASSERT_TRUE(config.ok()) << config.status();
+  EXPECT_EQ(config->min_limit, 5);
+  EXPECT_EQ(config->max_limit, 500);
+  EXPECT_EQ(config->initial_limit, 50);
+  EXPECT_EQ(config->smoothing, 0.5);
+  EXPECT_EQ(config->rtt_tolerance, 2);
+  EXPECT_EQ(config->long_window, 100);
+  EXPECT_EQ(config->max_queue_time, Duration::Milliseconds(500));
+}
+
+TEST(ConcurrencyLimiterConfigTest, InvalidValues) {
+  auto json = Json::Parse(
+      "{\"minLimit\": 10, \"maxLimit\": 5, \"initialLimit\": 20, "
+      "\"smoothing\": 0, \"rttTolerance\": 0.5, \"longWindow\": 0}");
+  ASSERT_TRUE(json.ok()) << json.status();
+  auto config = LoadFromJson<ConcurrencyLimiter::Config>(*json);
+  EXPECT_EQ(config.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(config.status().message(),
+            "errors validating JSON: ["
+            "field:initialLimit error:must be between minLimit and maxLimit; "
+            "field:longWindow error:must be greater than 0; "
+            "field:maxLimit error:must be greater than or equal to minLimit; "
+            "field:rttTolerance error:must be greater than or equal to 1; "
+            "field:smoothing error:must be in the range (0, 1]]")
+      << config.status();
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
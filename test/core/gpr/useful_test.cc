@@ -92,6 +92,18 @@ TEST(UsefulTest, RoundUpToPowerOf2) {
   EXPECT_EQ(RoundUpToPowerOf2(8), 8);
 }
 
+TEST(UsefulTest, IsPrime) {
+  EXPECT_FALSE(IsPrime(0));
+  EXPECT_FALSE(IsPrime(1));
+  EXPECT_TRUE(IsPrime(2));
+  EXPECT_TRUE(IsPrime(3));
+  EXPECT_FALSE(IsPrime(4));
+  EXPECT_FALSE(IsPrime(65536));
+  EXPECT_TRUE(IsPrime(65537));
+  EXPECT_TRUE(IsPrime(5000011));
+  EXPECT_FALSE(IsPrime(5000011ull * 5000011ull));
+}
+
 }  // namespace grpc_core
 
 int main(int argc, char** argv) {
@@ -0,0 +1,103 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/core/lib/gprpp/rcu_ptr.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/core/lib/gprpp/ref_counted.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+class Value : public RefCounted<Value> {
+ public:
+  Value(int value, std::atomic<int>* live) : value_(value), live_(live) {
+    live_->fetch_add(1);
+  }
+  ~Value() override {
+    value_ = -1;
+    live_->fetch_sub(1);
+  }
+
+  int value() const { return value_; }
+
+ private:
+  int value_;
+  std::atomic<int>* live_;
+};
+
+TEST(RcuPtrTest, Empty) {
+  RcuPtr<Value> p;
+  EXPECT_EQ(p.Get(), nullptr);
+  EXPECT_EQ(p.get_unsafe(), nullptr);
+}
+
+TEST(RcuPtrTest, ExchangeReturnsPreviousValue) {
+  std::atomic<int> live{0};
+  {
+    RcuPtr<Value> p(MakeRefCounted<Value>(1, &live));
+    EXPECT_EQ(p.Get()->value(), 1);
+    auto old = p.Exchange(MakeRefCounted<Value>(2, &live));
+    ASSERT_NE(old, nullptr);
+    EXPECT_EQ(old->value(), 1);
+    EXPECT_EQ(p.Get()->value(), 2);
+    EXPECT_EQ(p.get_unsafe()->value(), 2);
+    old.reset();
+    EXPECT_EQ(live.load(), 1);
+  }
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(RcuPtrTest, ReadersNeverSeeDestroyedValue) {
+  std::atomic<int> live{0};
+  {
+    RcuPtr<Value> p(MakeRefCounted<Value>(0, &live));
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+      readers.emplace_back([&]() {
+        int last = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+          auto value = p.Get();
+          ASSERT_NE(value, nullptr);
+          // Values only move forward, and are never destroyed while held.
+          EXPECT_GE(value->value(), last);
+          last = value->value();
+        }
+      });
+    }
+    for (int i = 1; i <= 10000; ++i) {
+      p.Exchange(MakeRefCounted<Value>(i, &live));
+    }
+    done.store(true);
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(p.Get()->value(), 10000);
+  }
+  EXPECT_EQ(live.load(), 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
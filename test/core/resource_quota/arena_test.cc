@@ -32,6 +32,8 @@
 #include <grpc/support/sync.h>
 #include <grpc/support/time.h>
 
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/gprpp/thd.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
@@ -187,6 +189,77 @@ TEST_F(ArenaTest, PooledObjectsArePooled) {
   EXPECT_EQ(p, obj.get());
 }
 
+TEST_F(ArenaTest, StoragePoolRecyclesArenas) {
+  ExecCtx exec_ctx;
+  ArenaStoragePool pool(2, ResourceQuota::Default()->memory_quota());
+  auto stats_before = global_stats().Collect();
+  auto a = Arena::CreateWithAlloc(1024, 64, &memory_allocator_, &pool);
+  void* storage = a.first;
+  a.first->Destroy();
+  EXPECT_EQ(pool.cached_blocks(), 1);
+  // A same-sized (or smaller) arena reuses the block.
+  auto b = Arena::CreateWithAlloc(512, 64, &memory_allocator_, &pool);
+  EXPECT_EQ(b.first, storage);
+  EXPECT_EQ(pool.cached_blocks(), 0);
+  // The reused arena still has its full initial zone to allocate from.
+  for (int i = 0; i < 10; i++) {
+    memset(b.first->Alloc(64), 0, 64);
+  }
+  b.first->Destroy();
+  EXPECT_EQ(pool.cached_blocks(), 1);
+  // A larger arena can't use it.
+  auto c = Arena::CreateWithAlloc(4096, 64, &memory_allocator_, &pool);
+  EXPECT_EQ(pool.cached_blocks(), 0);
+  c.first->Destroy();
+  EXPECT_EQ(pool.cached_blocks(), 1);
+  auto stats = global_stats().Collect()->Diff(*stats_before);
+  EXPECT_EQ(stats->call_arena_pool_hits, 1);
+  EXPECT_EQ(stats->call_arena_pool_misses, 2);
+}
+
+TEST_F(ArenaTest, StoragePoolIsBounded) {
+  ExecCtx exec_ctx;
+  ArenaStoragePool pool(2, ResourceQuota::Default()->memory_quota());
+  std::vector<Arena*> arenas;
+  for (int i = 0; i < 5; i++) {
+    arenas.push_back(
+        Arena::CreateWithAlloc(1024, 64, &memory_allocator_, &pool).first);
+  }
+  for (Arena* arena : arenas) arena->Destroy();
+  EXPECT_EQ(pool.cached_blocks(), 2);
+}
+
+TEST_F(ArenaTest, StoragePoolChargesCachedBlocks) {
+  ExecCtx exec_ctx;
+  static constexpr size_t kQuotaSize = 1024 * 1024;
+  auto memory_quota = MakeMemoryQuota("test");
+  memory_quota->SetSize(kQuotaSize);
+  MemoryOwner probe = memory_quota->CreateMemoryOwner("probe");
+  {
+    ArenaStoragePool pool(1, memory_quota);
+    Arena::CreateWithAlloc(kQuotaSize / 2, 64, &memory_allocator_, &pool)
+        .first->Destroy();
+    EXPECT_EQ(pool.cached_blocks(), 1);
+    EXPECT_GE(probe.GetPressureInfo().instantaneous_pressure, 0.5);
+  }
+  // Freeing the cached block releases its charge.
+  EXPECT_LT(probe.GetPressureInfo().instantaneous_pressure, 0.5);
+}
+
+TEST_F(ArenaTest, StoragePoolDoesNotCacheUnderMemoryPressure) {
+  ExecCtx exec_ctx;
+  static constexpr size_t kQuotaSize = 1024 * 1024;
+  auto memory_quota = MakeMemoryQuota("test");
+  memory_quota->SetSize(kQuotaSize);
+  ArenaStoragePool pool(2, memory_quota);
+  MemoryOwner memory_owner = memory_quota->CreateMemoryOwner("pressure");
+  memory_owner.Reserve(kQuotaSize / 1000 * 995);
+  ASSERT_TRUE(memory_quota->IsMemoryPressureHigh());
+  Arena::CreateWithAlloc(1024, 64, &memory_allocator_, &pool).first->Destroy();
+  EXPECT_EQ(pool.cached_blocks(), 0);
+  memory_owner.Release(kQuotaSize / 1000 * 995);
+}
+
 TEST_F(ArenaTest, CreateManyObjects) {
   struct TestObj {
     char a[100];
@@ -0,0 +1,154 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares evaluating RBAC policies with GrpcAuthorizationEngine, which only
+// walks the matcher trees of the policies whose paths and principal names
+// match the request, against walking the matcher trees of all policies.
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+
+#include <grpc/grpc.h>
+#include <grpc/grpc_security_constants.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/matchers/matchers.h"
+#include "src/core/lib/security/authorization/grpc_authorization_engine.h"
+#include "src/core/lib/security/authorization/matchers.h"
+#include "src/core/lib/security/authorization/rbac_policy.h"
+#include "test/core/util/evaluate_args_test_util.h"
+
+namespace grpc_core {
+namespace {
+
+constexpr int kNumPoliciesLow = 8;
+constexpr int kNumPoliciesHigh = 1024;
+
+Rbac::Permission MakePathPermission(StringMatcher::Type type,
+                                    absl::string_view path) {
+  return Rbac::Permission::MakePathPermission(
+      std::move(*StringMatcher::Create(type, path)));
+}
+
+// Policies that each allow one client to call the methods of one service,
+// with the service matched by exact path, prefix or regex.
+std::map<std::string, Rbac::Policy> MakePolicies(int num_policies) {
+  std::map<std::string, Rbac::Policy> policies;
+  for (int i = 0; i < num_policies; ++i) {
+    Rbac::Permission permission;
+    switch (i % 3) {
+      case 0:
+        permission = MakePathPermission(
+            StringMatcher::Type::kExact,
+            absl::StrCat("/pkg.Service", i, "/Method"));
+        break;
+      case 1:
+        permission = MakePathPermission(StringMatcher::Type::kPrefix,
+                                        absl::StrCat("/pkg.Service", i, "/"));
+        break;
+      default:
+        permission = MakePathPermission(
+            StringMatcher::Type::kSafeRegex,
+            absl::StrCat("/pkg\\.Service", i, "/(Get|Method)"));
+    }
+    policies[absl::StrFormat("policy%05d", i)] = Rbac::Policy(
+        std::move(permission),
+        Rbac::Principal::MakeAuthenticatedPrincipal(
+            std::move(*StringMatcher::Create(
+                StringMatcher::Type::kExact,
+                absl::StrCat("spiffe://example.com/client", i)))));
+  }
+  return policies;
+}
+
+// A request that only matches the last policy, so that walking all policies
+// has to evaluate each of them.
+class Request {
+ public:
+  explicit Request(int num_policies)
+      : path_(absl::StrCat("/pkg.Service", num_policies - 1, "/Method")),
+        uri_san_(
+            absl::StrCat("spiffe://example.com/client", num_policies - 1)) {
+    util_.AddPairToMetadata(":path", path_.c_str());
+    util_.AddPropertyToAuthContext(GRPC_TRANSPORT_SECURITY_TYPE_PROPERTY_NAME,
+                                   GRPC_TLS_TRANSPORT_SECURITY_TYPE);
+    util_.AddPropertyToAuthContext(GRPC_PEER_URI_PROPERTY_NAME,
+                                   uri_san_.c_str());
+  }
+
+  EvaluateArgs MakeEvaluateArgs() { return util_.MakeEvaluateArgs(); }
+
+ private:
+  std::string path_;
+  std::string uri_san_;
+  EvaluateArgsTestUtil util_;
+};
+
+void BM_TreeWalk(benchmark::State& state) {
+  std::vector<std::unique_ptr<AuthorizationMatcher>> matchers;
+  for (auto& policy : MakePolicies(state.range(0))) {
+    matchers.push_back(std::make_unique<PolicyAuthorizationMatcher>(
+        std::move(policy.second)));
+  }
+  Request request(state.range(0));
+  EvaluateArgs args = request.MakeEvaluateArgs();
+  for (auto _ : state) {
+    bool matches = false;
+    for (const auto& matcher : matchers) {
+      if (matcher->Matches(args)) {
+        matches = true;
+        break;
+      }
+    }
+    GPR_ASSERT(matches);
+  }
+}
+BENCHMARK(BM_TreeWalk)->Range(kNumPoliciesLow, kNumPoliciesHigh);
+
+void BM_GrpcAuthorizationEngine(benchmark::State& state) {
+  GrpcAuthorizationEngine engine(
+      Rbac(Rbac::Action::kAllow, MakePolicies(state.range(0))));
+  Request request(state.range(0));
+  EvaluateArgs args = request.MakeEvaluateArgs();
+  for (auto _ : state) {
+    GPR_ASSERT(engine.Evaluate(args).type ==
+               AuthorizationEngine::Decision::Type::kAllow);
+  }
+}
+BENCHMARK(BM_GrpcAuthorizationEngine)->Range(kNumPoliciesLow, kNumPoliciesHigh);
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc_init();
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
@@ -19,8 +19,105 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <set>
+
+#include "absl/types/optional.h"
+
+#include <grpc/grpc_security_constants.h>
+
+#include "src/core/lib/matchers/matchers.h"
+#include "test/core/util/evaluate_args_test_util.h"
+
 namespace grpc_core {
 
+namespace {
+
+StringMatcher MakeStringMatcher(StringMatcher::Type type,
+                                absl::string_view matcher) {
+  return std::move(*StringMatcher::Create(type, matcher));
+}
+
+std::unique_ptr<Rbac::Permission> MakePathPermission(StringMatcher::Type type,
+                                                     absl::string_view path) {
+  return std::make_unique<Rbac::Permission>(
+      Rbac::Permission::MakePathPermission(MakeStringMatcher(type, path)));
+}
+
+std::unique_ptr<Rbac::Principal> MakePrincipalName(StringMatcher::Type type,
+                                                   absl::string_view name) {
+  return std::make_unique<Rbac::Principal>(
+      Rbac::Principal::MakeAuthenticatedPrincipal(
+          MakeStringMatcher(type, name)));
+}
+
+template <typename T>
+std::vector<std::unique_ptr<T>> MakeVector(std::unique_ptr<T> a,
+                                           std::unique_ptr<T> b) {
+  std::vector<std::unique_ptr<T>> v;
+  v.push_back(std::move(a));
+  v.push_back(std::move(b));
+  return v;
+}
+
+// Policies with path and principal name rules in various positions, some of
+// which can be indexed and some of which cannot.
+std::map<std::string, Rbac::Policy> MakeIndexedPolicies() {
+  std::map<std::string, Rbac::Policy> policies;
+  policies["a_regex_path"] = Rbac::Policy(
+      std::move(*MakePathPermission(StringMatcher::Type::kSafeRegex,
+                                    "/pkg\\.Admin/.*")),
+      Rbac::Principal::MakeAnyPrincipal());
+  policies["b_not_path"] = Rbac::Policy(
+      Rbac::Permission::MakeNotPermission(std::move(*MakePathPermission(
+          StringMatcher::Type::kExact, "/pkg.Service/Get"))),
+      std::move(*MakePrincipalName(StringMatcher::Type::kExact,
+                                   "spiffe://foo/admin")));
+  policies["c_and_path"] = Rbac::Policy(
+      Rbac::Permission::MakeAndPermission(MakeVector(
+          std::make_unique<Rbac::Permission>(
+              Rbac::Permission::MakeAnyPermission()),
+          MakePathPermission(StringMatcher::Type::kExact,
+                             "/pkg.Service/List"))),
+      Rbac::Principal::MakeOrPrincipal(MakeVector(
+          MakePrincipalName(StringMatcher::Type::kPrefix, "spiffe://foo/"),
+          MakePrincipalName(StringMatcher::Type::kExact,
+                            "client.example.com"))));
+  policies["d_prefix_or_suffix_path"] = Rbac::Policy(
+      Rbac::Permission::MakeOrPermission(MakeVector(
+          MakePathPermission(StringMatcher::Type::kPrefix, "/pkg.Service/"),
+          MakePathPermission(StringMatcher::Type::kSuffix, "/Health"))),
+      Rbac::Principal::MakeAnyPrincipal());
+  policies["e_principal_path"] = Rbac::Policy(
+      Rbac::Permission::MakeAnyPermission(),
+      Rbac::Principal::MakeAndPrincipal(MakeVector(
+          std::make_unique<Rbac::Principal>(Rbac::Principal::MakePathPrincipal(
+              MakeStringMatcher(StringMatcher::Type::kExact,
+                                "/pkg.Other/Get"))),
+          std::make_unique<Rbac::Principal>(
+              Rbac::Principal::MakeAuthenticatedPrincipal(absl::nullopt)))));
+  policies["f_any_authenticated"] = Rbac::Policy(
+      std::move(*MakePathPermission(StringMatcher::Type::kExact,
+                                    "/pkg.Other/List")),
+      Rbac::Principal::MakeAuthenticatedPrincipal(absl::nullopt));
+  policies["g_or_any"] = Rbac::Policy(
+      Rbac::Permission::MakeOrPermission(
+          MakeVector(MakePathPermission(StringMatcher::Type::kExact, "/x"),
+                     std::make_unique<Rbac::Permission>(
+                         Rbac::Permission::MakeAnyPermission()))),
+      std::move(*MakePrincipalName(StringMatcher::Type::kSafeRegex,
+                                   "spiffe://bar/.*")));
+  return policies;
+}
+
+struct Peer {
+  const char* security_type;
+  const char* uri_san;
+  const char* dns_san;
+  const char* subject;
+};
+
+}  // namespace
+
 TEST(GrpcAuthorizationEngineTest, AllowEngineWithMatchingPolicy) {
   Rbac::Policy policy1(
       Rbac::Permission::MakeNotPermission(
@@ -103,6 +200,93 @@ TEST(GrpcAuthorizationEngineTest, DenyEngineWithEmptyPolicies) {
   EXPECT_TRUE(decision.matching_policy_name.empty());
 }
 
+TEST(GrpcAuthorizationEngineTest, IndexedPoliciesMatchLikeTreeWalk) {
+  GrpcAuthorizationEngine engine(
+      Rbac(Rbac::Action::kAllow, MakeIndexedPolicies()));
+  ASSERT_EQ(engine.num_policies(), 7);
+  std::vector<std::pair<std::string, std::unique_ptr<AuthorizationMatcher>>>
+      matchers;
+  for (auto& policy : MakeIndexedPolicies()) {
+    matchers.emplace_back(policy.first,
+                          std::make_unique<PolicyAuthorizationMatcher>(
+                              std::move(policy.second)));
+  }
+  const char* paths[] = {"/pkg.Admin/Delete", "/pkg.Service/Get",
+                         "/pkg.Service/List", "/pkg.Other/Get",
+                         "/pkg.Other/List",   "/x/Health",
+                         "/x",                ""};
+  const Peer peers[] = {
+      {nullptr, nullptr, nullptr, nullptr},
+      {GRPC_SSL_TRANSPORT_SECURITY_TYPE, "spiffe://foo/admin", nullptr,
+       nullptr},
+      {GRPC_TLS_TRANSPORT_SECURITY_TYPE, "spiffe://foo/user",
+       "client.example.com", nullptr},
+      {GRPC_TLS_TRANSPORT_SECURITY_TYPE, nullptr, "client.example.com",
+       nullptr},
+      {GRPC_TLS_TRANSPORT_SECURITY_TYPE, "spiffe://bar/x", nullptr, nullptr},
+      {GRPC_TLS_TRANSPORT_SECURITY_TYPE, nullptr, nullptr, "CN=abc"},
+  };
+  std::set<std::string> matched_policies;
+  for (const char* path : paths) {
+    for (const Peer& peer : peers) {
+      EvaluateArgsTestUtil util;
+      if (path[0] != '\0') util.AddPairToMetadata(":path", path);
+      if (peer.security_type != nullptr) {
+        util.AddPropertyToAuthContext(
+            GRPC_TRANSPORT_SECURITY_TYPE_PROPERTY_NAME, peer.security_type);
+      }
+      if (peer.uri_san != nullptr) {
+        util.AddPropertyToAuthContext(GRPC_PEER_URI_PROPERTY_NAME,
+                                      peer.uri_san);
+      }
+      if (peer.dns_san != nullptr) {
+        util.AddPropertyToAuthContext(GRPC_PEER_DNS_PROPERTY_NAME,
+                                      peer.dns_san);
+      }
+      if (peer.subject != nullptr) {
+        util.AddPropertyToAuthContext(GRPC_X509_SUBJECT_PROPERTY_NAME,
+                                      peer.subject);
+      }
+      EvaluateArgs args = util.MakeEvaluateArgs();
+      std::string expected_policy;
+      for (const auto& p : matchers) {
+        if (p.second->Matches(args)) {
+          expected_policy = p.first;
+          break;
+        }
+      }
+      AuthorizationEngine::Decision decision = engine.Evaluate(args);
+      EXPECT_EQ(decision.matching_policy_name, expected_policy)
+          << "path=" << path << " uri_san="
+          << (peer.uri_san == nullptr ? "" : peer.uri_san)
+          << " dns_san=" << (peer.dns_san == nullptr ? "" : peer.dns_san);
+      EXPECT_EQ(decision.type,
+                expected_policy.empty()
+                    ? AuthorizationEngine::Decision::Type::kDeny
+                    : AuthorizationEngine::Decision::Type::kAllow);
+      matched_policies.insert(expected_policy);
+    }
+  }
+  // Every policy, and no policy, must have been the match for some request.
+  EXPECT_EQ(matched_policies.size(), 8);
+}
+
+TEST(GrpcAuthorizationEngineTest, IndexedPoliciesFirstMatchWins) {
+  GrpcAuthorizationEngine engine(
+      Rbac(Rbac::Action::kDeny, MakeIndexedPolicies()));
+  EvaluateArgsTestUtil util;
+  util.AddPairToMetadata(":path", "/pkg.Service/List");
+  util.AddPropertyToAuthContext(GRPC_TRANSPORT_SECURITY_TYPE_PROPERTY_NAME,
+                                GRPC_TLS_TRANSPORT_SECURITY_TYPE);
+  util.AddPropertyToAuthContext(GRPC_PEER_URI_PROPERTY_NAME,
+                                "spiffe://foo/admin");
+  // b_not_path, c_and_path and d_prefix_or_suffix_path all match.
+  AuthorizationEngine::Decision decision =
+      engine.Evaluate(util.MakeEvaluateArgs());
+  EXPECT_EQ(decision.type, AuthorizationEngine::Decision::Type::kDeny);
+  EXPECT_EQ(decision.matching_policy_name, "b_not_path");
+}
+
 }  // namespace grpc_core
 
 int main(int argc, char** argv) {
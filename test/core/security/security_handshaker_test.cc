@@ -0,0 +1,546 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/lib/security/transport/security_handshaker.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include <grpc/grpc.h>
+#include <grpc/impl/grpc_types.h>
+#include <grpc/slice_buffer.h>
+#include <grpc/support/alloc.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
+#include "src/core/lib/gprpp/notification.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/iomgr/endpoint.h"
+#include "src/core/lib/iomgr/endpoint_pair.h"
+#include "src/core/lib/iomgr/error.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "src/core/lib/security/credentials/insecure/insecure_credentials.h"
+#include "src/core/lib/security/security_connector/insecure/insecure_security_connector.h"
+#include "src/core/lib/security/transport/tsi_handshake_executor.h"
+#include "src/core/lib/transport/handshaker.h"
+#include "src/core/tsi/transport_security.h"
+#include "src/core/tsi/transport_security_grpc.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+// What the fake TSI handshaker's result offers, and what the security
+// handshaker did with it.
+struct FakeTsiState {
+  tsi_frame_protector_type frame_protector_type = TSI_FRAME_PROTECTOR_NORMAL;
+  bool supports_zero_copy_protector = true;
+  tsi_result kernel_tx_offload_result = TSI_OK;
+  std::atomic<int> frame_protectors_created{0};
+  std::atomic<int> zero_copy_protectors_created{0};
+  std::atomic<int> protectors_destroyed{0};
+  std::atomic<int> kernel_tx_offload_fd{-1};
+  // What the TSI handshaker's only step returns, and where it ran.
+  tsi_result next_result = TSI_OK;
+  std::atomic<int> next_calls{0};
+  std::thread::id next_thread;
+  Notification handshaker_destroyed;
+};
+
+//
+// Fake frame protectors.  The handshakes in these tests never carry any
+// application data, so the protectors only record their creation and
+// destruction.
+//
+
+struct FakeFrameProtector {
+  tsi_frame_protector base;
+  FakeTsiState* state;
+};
+
+tsi_result FakeFrameProtectorProtect(tsi_frame_protector* /*self*/,
+                                     const unsigned char* /*unprotected_bytes*/,
+                                     size_t* /*unprotected_bytes_size*/,
+                                     unsigned char* /*protected_output_frames*/,
+                                     size_t* /*protected_output_frames_size*/) {
+  return TSI_UNIMPLEMENTED;
+}
+
+tsi_result FakeFrameProtectorProtectFlush(
+    tsi_frame_protector* /*self*/, unsigned char* /*protected_output_frames*/,
+    size_t* /*protected_output_frames_size*/, size_t* /*still_pending_size*/) {
+  return TSI_UNIMPLEMENTED;
+}
+
+tsi_result FakeFrameProtectorUnprotect(
+    tsi_frame_protector* /*self*/,
+    const unsigned char* /*protected_frames_bytes*/,
+    size_t* /*protected_frames_bytes_size*/,
+    unsigned char* /*unprotected_bytes*/, size_t* /*unprotected_bytes_size*/) {
+  return TSI_UNIMPLEMENTED;
+}
+
+void FakeFrameProtectorDestroy(tsi_frame_protector* self) {
+  auto* protector = reinterpret_cast<FakeFrameProtector*>(self);
+  protector->state->protectors_destroyed.fetch_add(1);
+  delete protector;
+}
+
+const tsi_frame_protector_vtable kFakeFrameProtectorVtable = {
+    FakeFrameProtectorProtect, FakeFrameProtectorProtectFlush,
+    FakeFrameProtectorUnprotect, FakeFrameProtectorDestroy};
+
+struct FakeZeroCopyProtector {
+  tsi_zero_copy_grpc_protector base;
+  FakeTsiState* state;
+};
+
+tsi_result FakeZeroCopyProtectorProtect(tsi_zero_copy_grpc_protector* /*self*/,
+                                        grpc_slice_buffer* /*unprotected*/,
+                                        grpc_slice_buffer* /*protected*/) {
+  return TSI_UNIMPLEMENTED;
+}
+
+tsi_result FakeZeroCopyProtectorUnprotect(
+    tsi_zero_copy_grpc_protector* /*self*/, grpc_slice_buffer* /*protected*/,
+    grpc_slice_buffer* /*unprotected*/, int* /*min_progress_size*/) {
+  return TSI_UNIMPLEMENTED;
+}
+
+void FakeZeroCopyProtectorDestroy(tsi_zero_copy_grpc_protector* self) {
+  auto* protector = reinterpret_cast<FakeZeroCopyProtector*>(self);
+  protector->state->protectors_destroyed.fetch_add(1);
+  delete protector;
+}
+
+tsi_result FakeZeroCopyProtectorMaxFrameSize(
+    tsi_zero_copy_grpc_protector* /*self*/, size_t* max_frame_size) {
+  *max_frame_size = 16384;
+  return TSI_OK;
+}
+
+tsi_result FakeZeroCopyProtectorEnableKernelTxOffload(
+    tsi_zero_copy_grpc_protector* self, int fd) {
+  auto* protector = reinterpret_cast<FakeZeroCopyProtector*>(self);
+  protector->state->kernel_tx_offload_fd.store(fd);
+  return protector->state->kernel_tx_offload_result;
+}
+
+const tsi_zero_copy_grpc_protector_vtable kFakeZeroCopyProtectorVtable = {
+    FakeZeroCopyProtectorProtect, FakeZeroCopyProtectorUnprotect,
+    FakeZeroCopyProtectorDestroy, FakeZeroCopyProtectorMaxFrameSize,
+    FakeZeroCopyProtectorEnableKernelTxOffload};
+
+//
+// Fake handshaker result.
+//
+
+struct FakeHandshakerResult {
+  tsi_handshaker_result base;
+  FakeTsiState* state;
+};
+
+FakeTsiState* StateOf(const tsi_handshaker_result* self) {
+  return reinterpret_cast<const FakeHandshakerResult*>(self)->state;
+}
+
+tsi_result FakeHandshakerResultExtractPeer(
+    const tsi_handshaker_result* /*self*/, tsi_peer* peer) {
+  return tsi_construct_peer(0, peer);
+}
+
+tsi_result FakeHandshakerResultGetFrameProtectorType(
+    const tsi_handshaker_result* self,
+    tsi_frame_protector_type* frame_protector_type) {
+  *frame_protector_type = StateOf(self)->frame_protector_type;
+  return TSI_OK;
+}
+
+tsi_result FakeHandshakerResultCreateZeroCopyGrpcProtector(
+    const tsi_handshaker_result* self,
+    size_t* /*max_output_protected_frame_size*/,
+    tsi_zero_copy_grpc_protector** protector) {
+  FakeTsiState* state = StateOf(self);
+  if (!state->supports_zero_copy_protector) return TSI_UNIMPLEMENTED;
+  state->zero_copy_protectors_created.fetch_add(1);
+  *protector = &(new FakeZeroCopyProtector{{&kFakeZeroCopyProtectorVtable},
+                                           state})
+                    ->base;
+  return TSI_OK;
+}
+
+tsi_result FakeHandshakerResultCreateFrameProtector(
+    const tsi_handshaker_result* self,
+    size_t* /*max_output_protected_frame_size*/,
+    tsi_frame_protector** protector) {
+  FakeTsiState* state = StateOf(self);
+  state->frame_protectors_created.fetch_add(1);
+  *protector =
+      &(new FakeFrameProtector{{&kFakeFrameProtectorVtable}, state})->base;
+  return TSI_OK;
+}
+
+tsi_result FakeHandshakerResultGetUnusedBytes(
+    const tsi_handshaker_result* /*self*/, const unsigned char** bytes,
+    size_t* bytes_size) {
+  *bytes = nullptr;
+  *bytes_size = 0;
+  return TSI_OK;
+}
+
+void FakeHandshakerResultDestroy(tsi_handshaker_result* self) {
+  delete reinterpret_cast<FakeHandshakerResult*>(self);
+}
+
+const tsi_handshaker_result_vtable kFakeHandshakerResultVtable = {
+    FakeHandshakerResultExtractPeer,
+    FakeHandshakerResultGetFrameProtectorType,
+    FakeHandshakerResultCreateZeroCopyGrpcProtector,
+    FakeHandshakerResultCreateFrameProtector,
+    FakeHandshakerResultGetUnusedBytes,
+    FakeHandshakerResultDestroy};
+
+//
+// Fake TSI handshaker, which completes in its first step without exchanging
+// any bytes with the peer.
+//
+
+struct FakeHandshaker {
+  tsi_handshaker base;
+  FakeTsiState* state;
+};
+
+tsi_result FakeHandshakerNext(tsi_handshaker* self,
+                              const unsigned char* /*received_bytes*/,
+                              size_t /*received_bytes_size*/,
+                              const unsigned char** bytes_to_send,
+                              size_t* bytes_to_send_size,
+                              tsi_handshaker_result** handshaker_result,
+                              tsi_handshaker_on_next_done_cb /*cb*/,
+                              void* /*user_data*/, std::string* /*error*/) {
+  auto* handshaker = reinterpret_cast<FakeHandshaker*>(self);
+  handshaker->state->next_calls.fetch_add(1);
+  handshaker->state->next_thread = std::this_thread::get_id();
+  if (handshaker->state->next_result != TSI_OK) {
+    return handshaker->state->next_result;
+  }
+  *bytes_to_send = nullptr;
+  *bytes_to_send_size = 0;
+  *handshaker_result =
+      &(new FakeHandshakerResult{{&kFakeHandshakerResultVtable},
+                                 handshaker->state})
+           ->base;
+  return TSI_OK;
+}
+
+void FakeHandshakerDestroy(tsi_handshaker* self) {
+  auto* handshaker = reinterpret_cast<FakeHandshaker*>(self);
+  handshaker->state->handshaker_destroyed.Notify();
+  delete handshaker;
+}
+
+const tsi_handshaker_vtable kFakeHandshakerVtable = {
+    nullptr, nullptr, nullptr, nullptr, nullptr, FakeHandshakerDestroy,
+    FakeHandshakerNext, nullptr};
+
+tsi_handshaker* CreateFakeHandshaker(FakeTsiState* state) {
+  auto* handshaker = new FakeHandshaker{};
+  handshaker->base.vtable = &kFakeHandshakerVtable;
+  handshaker->state = state;
+  return &handshaker->base;
+}
+
+class SecurityHandshakerTest : public ::testing::Test {
+ protected:
+  SecurityHandshakerTest()
+      : connector_(MakeRefCounted<InsecureChannelSecurityConnector>(
+            MakeRefCounted<InsecureCredentials>(), nullptr)) {}
+
+  // Starts a security handshake with the fake TSI handshaker over one end of
+  // an endpoint pair.  \a args must carry a resource quota, as the channel
+  // args of real handshakes do.
+  void StartHandshake(const ChannelArgs& args) {
+    ExecCtx exec_ctx;
+    endpoints_ =
+        grpc_iomgr_create_endpoint_pair("security_handshaker_test", nullptr);
+    endpoint_fd_ = grpc_endpoint_get_fd(endpoints_.client);
+    handshaker_ = SecurityHandshakerCreate(CreateFakeHandshaker(&state_),
+                                           connector_.get(), args);
+    handshaker_args_.endpoint = endpoints_.client;
+    handshaker_args_.args = args;
+    handshaker_args_.read_buffer =
+        static_cast<grpc_slice_buffer*>(gpr_malloc(sizeof(grpc_slice_buffer)));
+    grpc_slice_buffer_init(handshaker_args_.read_buffer);
+    handshaker_->DoHandshake(
+        nullptr,
+        GRPC_CLOSURE_INIT(&on_handshake_done_, OnHandshakeDone, this,
+                          grpc_schedule_on_exec_ctx),
+        &handshaker_args_);
+  }
+
+  // Waits for the handshake to finish, and returns its result once the
+  // handshaker has been destroyed.
+  absl::Status FinishHandshake() {
+    ExecCtx exec_ctx;
+    handshake_done_.WaitForNotification();
+    // On success the caller owns the endpoint and read buffer; on failure
+    // the handshaker destroys them.
+    if (handshaker_args_.endpoint != nullptr) {
+      grpc_endpoint_shutdown(handshaker_args_.endpoint,
+                             absl::CancelledError());
+      grpc_endpoint_destroy(handshaker_args_.endpoint);
+    }
+    if (handshaker_args_.read_buffer != nullptr) {
+      grpc_slice_buffer_destroy(handshaker_args_.read_buffer);
+      gpr_free(handshaker_args_.read_buffer);
+    }
+    grpc_endpoint_shutdown(endpoints_.server, absl::CancelledError());
+    grpc_endpoint_destroy(endpoints_.server);
+    handshaker_.reset();
+    ExecCtx::Get()->Flush();
+    state_.handshaker_destroyed.WaitForNotification();
+    return handshake_status_;
+  }
+
+  absl::Status DoHandshake(const ChannelArgs& args) {
+    StartHandshake(args);
+    return FinishHandshake();
+  }
+
+  static ChannelArgs DefaultArgs() {
+    return ChannelArgs().SetObject(ResourceQuota::Default());
+  }
+
+  FakeTsiState state_;
+  int endpoint_fd_ = -1;
+  RefCountedPtr<Handshaker> handshaker_;
+
+ private:
+  static void OnHandshakeDone(void* arg, grpc_error_handle error) {
+    auto* test = static_cast<SecurityHandshakerTest*>(arg);
+    test->handshake_status_ = error;
+    test->handshake_done_.Notify();
+  }
+
+  RefCountedPtr<grpc_channel_security_connector> connector_;
+  grpc_endpoint_pair endpoints_;
+  HandshakerArgs handshaker_args_;
+  grpc_closure on_handshake_done_;
+  absl::Status handshake_status_;
+  Notification handshake_done_;
+};
+
+TEST_F(SecurityHandshakerTest, UsesNormalProtectorWithoutKtls) {
+  EXPECT_EQ(DoHandshake(DefaultArgs()), absl::OkStatus());
+  EXPECT_EQ(state_.frame_protectors_created.load(), 1);
+  EXPECT_EQ(state_.zero_copy_protectors_created.load(), 0);
+  EXPECT_EQ(state_.kernel_tx_offload_fd.load(), -1);
+  EXPECT_EQ(state_.protectors_destroyed.load(), 1);
+}
+
+TEST_F(SecurityHandshakerTest, KtlsArgSelectsZeroCopyProtector) {
+  EXPECT_EQ(DoHandshake(DefaultArgs().Set(GRPC_ARG_EXPERIMENTAL_ENABLE_KTLS,
+                                          true)),
+            absl::OkStatus());
+  EXPECT_EQ(state_.frame_protectors_created.load(), 0);
+  EXPECT_EQ(state_.zero_copy_protectors_created.load(), 1);
+  EXPECT_EQ(state_.kernel_tx_offload_fd.load(), endpoint_fd_);
+  EXPECT_EQ(state_.protectors_destroyed.load(), 1);
+}
+
+TEST_F(SecurityHandshakerTest, KtlsArgEnablesOffloadOnZeroCopyProtector) {
+  state_.frame_protector_type = TSI_FRAME_PROTECTOR_ZERO_COPY;
+  EXPECT_EQ(DoHandshake(DefaultArgs().Set(GRPC_ARG_EXPERIMENTAL_ENABLE_KTLS,
+                                          true)),
+            absl::OkStatus());
+  EXPECT_EQ(state_.zero_copy_protectors_created.load(), 1);
+  EXPECT_EQ(state_.kernel_tx_offload_fd.load(), endpoint_fd_);
+  EXPECT_EQ(state_.protectors_destroyed.load(), 1);
+}
+
+TEST_F(SecurityHandshakerTest, KtlsArgFallsBackToNormalProtector) {
+  state_.supports_zero_copy_protector = false;
+  EXPECT_EQ(DoHandshake(DefaultArgs().Set(GRPC_ARG_EXPERIMENTAL_ENABLE_KTLS,
+                                          true)),
+            absl::OkStatus());
+  EXPECT_EQ(state_.frame_protectors_created.load(), 1);
+  EXPECT_EQ(state_.zero_copy_protectors_created.load(), 0);
+  EXPECT_EQ(state_.kernel_tx_offload_fd.load(), -1);
+  EXPECT_EQ(state_.protectors_destroyed.load(), 1);
+}
+
+TEST_F(SecurityHandshakerTest, UnsupportedKtlsKeepsUserSpaceEncryption) {
+  state_.kernel_tx_offload_result = TSI_UNIMPLEMENTED;
+  EXPECT_EQ(DoHandshake(DefaultArgs().Set(GRPC_ARG_EXPERIMENTAL_ENABLE_KTLS,
+                                          true)),
+            absl::OkStatus());
+  EXPECT_EQ(state_.zero_copy_protectors_created.load(), 1);
+  EXPECT_EQ(state_.kernel_tx_offload_fd.load(), endpoint_fd_);
+  EXPECT_EQ(state_.protectors_destroyed.load(), 1);
+}
+
+TEST_F(SecurityHandshakerTest, FailedKtlsFailsHandshake) {
+  state_.kernel_tx_offload_result = TSI_INTERNAL_ERROR;
+  EXPECT_FALSE(DoHandshake(DefaultArgs().Set(GRPC_ARG_EXPERIMENTAL_ENABLE_KTLS,
+                                             true))
+                   .ok());
+  EXPECT_EQ(state_.zero_copy_protectors_created.load(), 1);
+  EXPECT_EQ(state_.protectors_destroyed.load(), 1);
+}
+
+//
+// Handshakes whose TSI steps run on the TsiHandshakeExecutor.
+//
+
+// Keeps every thread of the process-wide TSI handshake executor busy until
+// destroyed, so that the steps queued meanwhile stay queued.
+class ExecutorBlocker {
+ public:
+  ExecutorBlocker() {
+    ExecCtx exec_ctx;
+    for (size_t i = 0; i < executor_->num_threads(); ++i) {
+      EXPECT_TRUE(executor_->Run([this]() {
+        started_.fetch_add(1);
+        unblock_.WaitForNotification();
+        finished_.fetch_add(1);
+      }));
+    }
+    while (started_.load() < executor_->num_threads()) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+  }
+
+  ~ExecutorBlocker() {
+    unblock_.Notify();
+    while (finished_.load() < executor_->num_threads()) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+  }
+
+  // Queues steps that do nothing until the executor refuses more.
+  void FillQueue() {
+    ExecCtx exec_ctx;
+    while (executor_->Run([]() {})) {
+    }
+  }
+
+ private:
+  TsiHandshakeExecutor* const executor_ = TsiHandshakeExecutor::Get();
+  std::atomic<size_t> started_{0};
+  std::atomic<size_t> finished_{0};
+  Notification unblock_;
+};
+
+ChannelArgs OffloadArgs(const ChannelArgs& args) {
+  return args.Set(GRPC_ARG_EXPERIMENTAL_OFFLOAD_TSI_HANDSHAKES, true);
+}
+
+uint64_t TsiHandshakesRejected() {
+  return global_stats().Collect()->tsi_handshakes_rejected;
+}
+
+TEST_F(SecurityHandshakerTest, OffloadedHandshakeSucceeds) {
+  EXPECT_EQ(DoHandshake(OffloadArgs(DefaultArgs())), absl::OkStatus());
+  EXPECT_EQ(state_.next_calls.load(), 1);
+  EXPECT_NE(state_.next_thread, std::this_thread::get_id());
+  EXPECT_EQ(state_.frame_protectors_created.load(), 1);
+  EXPECT_EQ(state_.protectors_destroyed.load(), 1);
+}
+
+TEST_F(SecurityHandshakerTest, OffloadedStepFailureFailsHandshake) {
+  state_.next_result = TSI_INTERNAL_ERROR;
+  EXPECT_FALSE(DoHandshake(OffloadArgs(DefaultArgs())).ok());
+  EXPECT_EQ(state_.next_calls.load(), 1);
+  EXPECT_NE(state_.next_thread, std::this_thread::get_id());
+  EXPECT_EQ(state_.frame_protectors_created.load(), 0);
+}
+
+TEST_F(SecurityHandshakerTest, ShutdownWhileQueuedFailsHandshake) {
+  {
+    ExecutorBlocker blocker;
+    StartHandshake(OffloadArgs(DefaultArgs()));
+    ExecCtx exec_ctx;
+    handshaker_->Shutdown(GRPC_ERROR_CREATE("test shutdown"));
+  }
+  absl::Status status = FinishHandshake();
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("Handshaker shutdown"));
+  // The queued step saw the shutdown and never ran the TSI handshaker.
+  EXPECT_EQ(state_.next_calls.load(), 0);
+}
+
+TEST_F(SecurityHandshakerTest, RejectsHandshakeWhenExecutorQueueIsFull) {
+  const uint64_t rejected_before = TsiHandshakesRejected();
+  absl::Status status;
+  {
+    ExecutorBlocker blocker;
+    blocker.FillQueue();
+    status = DoHandshake(OffloadArgs(DefaultArgs()));
+  }
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("queue is full"));
+  EXPECT_EQ(state_.next_calls.load(), 0);
+  EXPECT_EQ(TsiHandshakesRejected() - rejected_before, 1);
+}
+
+TEST_F(SecurityHandshakerTest, RejectsHandshakeWhenMemoryPressureIsHigh) {
+  ExecCtx exec_ctx;
+  // Reserve enough of the quota for its memory pressure to be high, leaving
+  // the rest free so that nothing needs to be reclaimed.
+  const size_t kQuotaSize = MemoryRequest::max_allowed_size();
+  const size_t kReservedBytes = kQuotaSize / 1000 * 993;
+  ResourceQuotaRefPtr resource_quota =
+      MakeResourceQuota("security_handshaker_test");
+  resource_quota->memory_quota()->SetSize(kQuotaSize);
+  MemoryOwner memory_owner =
+      resource_quota->memory_quota()->CreateMemoryOwner("memory_pressure");
+  memory_owner.Reserve(kReservedBytes);
+  ASSERT_TRUE(resource_quota->memory_quota()->IsMemoryPressureHigh());
+  const uint64_t rejected_before = TsiHandshakesRejected();
+  absl::Status status =
+      DoHandshake(OffloadArgs(ChannelArgs().SetObject(resource_quota)));
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(),
+              ::testing::HasSubstr("memory pressure is high"));
+  EXPECT_EQ(state_.next_calls.load(), 0);
+  EXPECT_EQ(TsiHandshakesRejected() - rejected_before, 1);
+  memory_owner.Release(kReservedBytes);
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -0,0 +1,237 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/core/lib/matchers/string_matcher_set.h"
+
+#include <algorithm>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+
+namespace grpc_core {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class StringMatcherSetTest : public ::testing::Test {
+ protected:
+  void Add(StringMatcher::Type type, absl::string_view matcher,
+           bool case_sensitive = true) {
+    auto string_matcher = StringMatcher::Create(type, matcher, case_sensitive);
+    ASSERT_TRUE(string_matcher.ok());
+    matchers_.push_back(std::move(*string_matcher));
+  }
+
+  void Build() {
+    std::vector<const StringMatcher*> matchers;
+    for (const auto& matcher : matchers_) matchers.push_back(&matcher);
+    set_ = StringMatcherSet(matchers);
+  }
+
+  std::vector<size_t> Match(absl::string_view value) {
+    StringMatcherSet::IdList matched;
+    set_.Match(value, &matched);
+    std::vector<size_t> ids(matched.begin(), matched.end());
+    std::sort(ids.begin(), ids.end());
+    // The ids must be the same as when evaluating the matchers one by one.
+    std::vector<size_t> expected_ids;
+    for (size_t i = 0; i < matchers_.size(); ++i) {
+      if (matchers_[i].Match(value)) expected_ids.push_back(i);
+    }
+    EXPECT_EQ(ids, expected_ids) << value;
+    return ids;
+  }
+
+  std::vector<StringMatcher> matchers_;
+  StringMatcherSet set_;
+};
+
+TEST_F(StringMatcherSetTest, Empty) {
+  Build();
+  EXPECT_EQ(set_.size(), 0);
+  EXPECT_THAT(Match("foo"), IsEmpty());
+}
+
+TEST_F(StringMatcherSetTest, Exact) {
+  Add(StringMatcher::Type::kExact, "/foo");
+  Add(StringMatcher::Type::kExact, "/bar");
+  Add(StringMatcher::Type::kExact, "/foo");
+  Add(StringMatcher::Type::kExact, "/Foo", /*case_sensitive=*/false);
+  Build();
+  EXPECT_EQ(set_.size(), 4);
+  EXPECT_THAT(Match("/foo"), ElementsAre(0, 2, 3));
+  EXPECT_THAT(Match("/FOO"), ElementsAre(3));
+  EXPECT_THAT(Match("/bar"), ElementsAre(1));
+  EXPECT_THAT(Match("/foo/"), IsEmpty());
+}
+
+TEST_F(StringMatcherSetTest, Prefix) {
+  Add(StringMatcher::Type::kPrefix, "");
+  Add(StringMatcher::Type::kPrefix, "/pkg.");
+  Add(StringMatcher::Type::kPrefix, "/pkg.Service/");
+  Add(StringMatcher::Type::kPrefix, "/PKG.service/", /*case_sensitive=*/false);
+  Add(StringMatcher::Type::kPrefix, "/other/");
+  Build();
+  EXPECT_THAT(Match("/pkg.Service/Method"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(Match("/pkg.service/Method"), ElementsAre(0, 1, 3));
+  EXPECT_THAT(Match("/pkg"), ElementsAre(0));
+  EXPECT_THAT(Match(""), ElementsAre(0));
+}
+
+TEST_F(StringMatcherSetTest, Suffix) {
+  Add(StringMatcher::Type::kSuffix, "/Method");
+  Add(StringMatcher::Type::kSuffix, "Method");
+  Add(StringMatcher::Type::kSuffix, "/method", /*case_sensitive=*/false);
+  Build();
+  EXPECT_THAT(Match("/pkg.Service/Method"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(Match("/pkg.Service/METHOD"), ElementsAre(2));
+  EXPECT_THAT(Match("OtherMethod"), ElementsAre(1));
+}
+
+TEST_F(StringMatcherSetTest, SafeRegex) {
+  Add(StringMatcher::Type::kSafeRegex, "/pkg\\.Service/.*");
+  Add(StringMatcher::Type::kSafeRegex, ".*Method");
+  Add(StringMatcher::Type::kSafeRegex, "Method");
+  Build();
+  EXPECT_THAT(Match("/pkg.Service/Method"), ElementsAre(0, 1));
+  EXPECT_THAT(Match("Method"), ElementsAre(1, 2));
+  // Regexes must match the whole value.
+  EXPECT_THAT(Match("/pkg.Service/Method/"), ElementsAre(0));
+  EXPECT_THAT(Match("/pkgxService/Other"), IsEmpty());
+}
+
+TEST_F(StringMatcherSetTest, Contains) {
+  Add(StringMatcher::Type::kContains, "Service");
+  Add(StringMatcher::Type::kContains, "service", /*case_sensitive=*/false);
+  Build();
+  EXPECT_THAT(Match("/pkg.Service/Method"), ElementsAre(0, 1));
+  EXPECT_THAT(Match("/pkg.SERVICE/Method"), ElementsAre(1));
+}
+
+TEST_F(StringMatcherSetTest, AllTypes) {
+  Add(StringMatcher::Type::kExact, "/pkg.Service/Method");
+  Add(StringMatcher::Type::kPrefix, "/pkg.Service/");
+  Add(StringMatcher::Type::kSuffix, "/Method");
+  Add(StringMatcher::Type::kSafeRegex, "/pkg\\.[A-Za-z]+/Method");
+  Add(StringMatcher::Type::kContains, ".Service/");
+  Add(StringMatcher::Type::kExact, "/pkg.Service/Other");
+  Build();
+  EXPECT_THAT(Match("/pkg.Service/Method"), ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_THAT(Match("/pkg.Service/Other"), ElementsAre(1, 4, 5));
+  EXPECT_THAT(Match("/pkg.Other/Method"), ElementsAre(2, 3));
+}
+
+TEST_F(StringMatcherSetTest, ManyMatchers) {
+  for (int i = 0; i < 200; ++i) {
+    Add(StringMatcher::Type::kExact, absl::StrCat("/pkg.Service", i, "/Get"));
+    Add(StringMatcher::Type::kPrefix, absl::StrCat("/pkg.Service", i, "/"));
+    Add(StringMatcher::Type::kSafeRegex,
+        absl::StrCat("/pkg\\.Service", i, "/(Get|List)"));
+  }
+  Build();
+  EXPECT_THAT(Match("/pkg.Service42/Get"), ElementsAre(126, 127, 128));
+  EXPECT_THAT(Match("/pkg.Service42/List"), ElementsAre(127, 128));
+  EXPECT_THAT(Match("/pkg.Service420/List"), IsEmpty());
+}
+
+class HeaderMatcherSetTest : public ::testing::Test {
+ protected:
+  void Add(absl::string_view name, HeaderMatcher::Type type,
+           absl::string_view matcher, int64_t range_start = 0,
+           int64_t range_end = 0, bool present_match = false,
+           bool invert_match = false) {
+    auto header_matcher = HeaderMatcher::Create(
+        name, type, matcher, range_start, range_end, present_match,
+        invert_match);
+    ASSERT_TRUE(header_matcher.ok());
+    matchers_.push_back(std::move(*header_matcher));
+  }
+
+  void Build() {
+    std::vector<const HeaderMatcher*> matchers;
+    for (const auto& matcher : matchers_) matchers.push_back(&matcher);
+    set_ = HeaderMatcherSet(matchers);
+  }
+
+  // Returns the ids of the matchers of \a name that match \a value.
+  std::vector<size_t> Match(absl::string_view name,
+                            const absl::optional<absl::string_view>& value) {
+    size_t header = 0;
+    while (header < set_.num_headers() && set_.header_name(header) != name) {
+      ++header;
+    }
+    EXPECT_LT(header, set_.num_headers());
+    absl::InlinedVector<bool, 16> results(set_.size(), false);
+    set_.Match(header, value, absl::MakeSpan(results));
+    // The results must be the same as when evaluating the matchers one by
+    // one.
+    std::vector<size_t> ids;
+    for (size_t i = 0; i < matchers_.size(); ++i) {
+      if (matchers_[i].name() != name) continue;
+      EXPECT_EQ(set_.header_of(i), header);
+      EXPECT_EQ(results[i], matchers_[i].Match(value))
+          << matchers_[i].ToString() << " "
+          << (value.has_value() ? *value : "<absent>");
+      if (results[i]) ids.push_back(i);
+    }
+    return ids;
+  }
+
+  std::vector<HeaderMatcher> matchers_;
+  HeaderMatcherSet set_;
+};
+
+TEST_F(HeaderMatcherSetTest, GroupsMatchersByHeader) {
+  Add("foo", HeaderMatcher::Type::kExact, "bar");
+  Add("baz", HeaderMatcher::Type::kPrefix, "qu");
+  Add("foo", HeaderMatcher::Type::kSafeRegex, "b.*");
+  Build();
+  EXPECT_EQ(set_.size(), 3);
+  EXPECT_EQ(set_.num_headers(), 2);
+  EXPECT_THAT(Match("foo", "bar"), ElementsAre(0, 2));
+  EXPECT_THAT(Match("foo", "baz"), ElementsAre(2));
+  EXPECT_THAT(Match("baz", "qux"), ElementsAre(1));
+  EXPECT_THAT(Match("baz", absl::nullopt), IsEmpty());
+}
+
+TEST_F(HeaderMatcherSetTest, InvertedAndAbsentHeaders) {
+  Add("foo", HeaderMatcher::Type::kExact, "bar", 0, 0, false,
+      /*invert_match=*/true);
+  Add("foo", HeaderMatcher::Type::kSuffix, "ar");
+  Add("foo", HeaderMatcher::Type::kContains, "x", 0, 0, false,
+      /*invert_match=*/true);
+  Add("foo", HeaderMatcher::Type::kPresent, "", 0, 0, /*present_match=*/true);
+  Add("foo", HeaderMatcher::Type::kPresent, "", 0, 0, /*present_match=*/false);
+  Add("foo", HeaderMatcher::Type::kRange, "", 10, 20);
+  Add("foo", HeaderMatcher::Type::kRange, "", 10, 20, false,
+      /*invert_match=*/true);
+  Build();
+  EXPECT_THAT(Match("foo", "bar"), ElementsAre(1, 2, 3, 6));
+  EXPECT_THAT(Match("foo", "xar"), ElementsAre(0, 1, 3, 6));
+  EXPECT_THAT(Match("foo", "15"), ElementsAre(0, 2, 3, 5));
+  EXPECT_THAT(Match("foo", absl::nullopt), ElementsAre(4));
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -115,6 +115,38 @@ class TlsSecurityConnectorTest : public ::testing::Test {
   HostNameCertificateVerifier hostname_certificate_verifier_;
 };
 
+// A synchronous verifier that counts the requests it sees.
+class CountingCertificateVerifier : public grpc_tls_certificate_verifier {
+ public:
+  explicit CountingCertificateVerifier(absl::Status status)
+      : status_(std::move(status)) {}
+
+  bool Verify(grpc_tls_custom_verification_check_request* /*request*/,
+              std::function<void(absl::Status)> /*callback*/,
+              absl::Status* sync_status) override {
+    ++num_verifications_;
+    *sync_status = status_;
+    return true;
+  }
+  void Cancel(grpc_tls_custom_verification_check_request*) override {}
+
+  UniqueTypeName type() const override {
+    static UniqueTypeName::Factory kFactory("counting");
+    return kFactory.Create();
+  }
+
+  int num_verifications() const { return num_verifications_; }
+
+ private:
+  int CompareImpl(const grpc_tls_certificate_verifier* other) const override {
+    return QsortCompare(static_cast<const grpc_tls_certificate_verifier*>(this),
+                        other);
+  }
+
+  absl::Status status_;
+  int num_verifications_ = 0;
+};
+
 class TlsTestCertificateProvider : public grpc_tls_certificate_provider {
  public:
   explicit TlsTestCertificateProvider(
@@ -1019,6 +1051,123 @@ TEST_F(TlsSecurityConnectorTest,
   connector->check_peer(peer, nullptr, args, &auth_context, on_peer_checked);
 }
 
+TEST_F(TlsSecurityConnectorTest,
+       ServerSecurityConnectorCachesVerificationResults) {
+  RefCountedPtr<grpc_tls_certificate_distributor> distributor =
+      MakeRefCounted<grpc_tls_certificate_distributor>();
+  distributor->SetKeyMaterials(kRootCertName, root_cert_0_, absl::nullopt);
+  distributor->SetKeyMaterials(kIdentityCertName, absl::nullopt,
+                               identity_pairs_0_);
+  RefCountedPtr<grpc_tls_certificate_provider> provider =
+      MakeRefCounted<TlsTestCertificateProvider>(distributor);
+  auto verifier = MakeRefCounted<CountingCertificateVerifier>(
+      absl::UnauthenticatedError("rejected"));
+  RefCountedPtr<grpc_tls_credentials_options> options =
+      MakeRefCounted<grpc_tls_credentials_options>();
+  options->set_cert_request_type(
+      GRPC_SSL_REQUEST_AND_REQUIRE_CLIENT_CERTIFICATE_AND_VERIFY);
+  options->set_certificate_verifier(verifier);
+  options->set_verification_result_cache_size(10);
+  options->set_certificate_provider(provider);
+  options->set_watch_root_cert(true);
+  options->set_watch_identity_pair(true);
+  options->set_root_cert_name(kRootCertName);
+  options->set_identity_cert_name(kIdentityCertName);
+  auto credentials = MakeRefCounted<TlsServerCredentials>(options);
+  auto connector = credentials->create_security_connector(ChannelArgs());
+  auto* tls_connector =
+      static_cast<TlsServerSecurityConnector*>(connector.get());
+  ASSERT_NE(tls_connector->VerificationResultCacheForTesting(), nullptr);
+  const char* expected_error_msg =
+      "Custom verification check failed with error: UNAUTHENTICATED: rejected";
+  auto check_peer = [&](const char* cert_chain) {
+    tsi_peer peer;
+    GPR_ASSERT(tsi_construct_peer(2, &peer) == TSI_OK);
+    GPR_ASSERT(tsi_construct_string_peer_property(
+                   TSI_SSL_ALPN_SELECTED_PROTOCOL, "grpc", strlen("grpc"),
+                   &peer.properties[0]) == TSI_OK);
+    GPR_ASSERT(tsi_construct_string_peer_property_from_cstring(
+                   TSI_X509_PEM_CERT_CHAIN_PROPERTY, cert_chain,
+                   &peer.properties[1]) == TSI_OK);
+    RefCountedPtr<grpc_auth_context> auth_context;
+    ExecCtx exec_ctx;
+    grpc_closure* on_peer_checked = GRPC_CLOSURE_CREATE(
+        VerifyExpectedErrorCallback, const_cast<char*>(expected_error_msg),
+        grpc_schedule_on_exec_ctx);
+    connector->check_peer(peer, nullptr, ChannelArgs(), &auth_context,
+                          on_peer_checked);
+  };
+  check_peer("chain_a");
+  EXPECT_EQ(verifier->num_verifications(), 1);
+  // The result for the same chain comes from the cache.
+  check_peer("chain_a");
+  EXPECT_EQ(verifier->num_verifications(), 1);
+  check_peer("chain_b");
+  EXPECT_EQ(verifier->num_verifications(), 2);
+  EXPECT_EQ(tls_connector->VerificationResultCacheForTesting()->size(), 2);
+  // Rotating the root certificates drops the cached results.
+  distributor->SetKeyMaterials(kRootCertName, root_cert_1_, absl::nullopt);
+  check_peer("chain_a");
+  EXPECT_EQ(verifier->num_verifications(), 3);
+  EXPECT_EQ(tls_connector->VerificationResultCacheForTesting()->size(), 1);
+  // A new identity certificate does not.
+  distributor->SetKeyMaterials(kIdentityCertName, absl::nullopt,
+                               identity_pairs_1_);
+  check_peer("chain_a");
+  EXPECT_EQ(verifier->num_verifications(), 3);
+}
+
+TEST_F(TlsSecurityConnectorTest,
+       ServerSecurityConnectorDoesNotCacheTransientVerificationErrors) {
+  RefCountedPtr<grpc_tls_certificate_distributor> distributor =
+      MakeRefCounted<grpc_tls_certificate_distributor>();
+  distributor->SetKeyMaterials(kRootCertName, root_cert_0_, absl::nullopt);
+  distributor->SetKeyMaterials(kIdentityCertName, absl::nullopt,
+                               identity_pairs_0_);
+  RefCountedPtr<grpc_tls_certificate_provider> provider =
+      MakeRefCounted<TlsTestCertificateProvider>(distributor);
+  auto verifier = MakeRefCounted<CountingCertificateVerifier>(
+      absl::UnavailableError("backend down"));
+  RefCountedPtr<grpc_tls_credentials_options> options =
+      MakeRefCounted<grpc_tls_credentials_options>();
+  options->set_cert_request_type(
+      GRPC_SSL_REQUEST_AND_REQUIRE_CLIENT_CERTIFICATE_AND_VERIFY);
+  options->set_certificate_verifier(verifier);
+  options->set_verification_result_cache_size(10);
+  options->set_certificate_provider(provider);
+  options->set_watch_root_cert(true);
+  options->set_watch_identity_pair(true);
+  options->set_root_cert_name(kRootCertName);
+  options->set_identity_cert_name(kIdentityCertName);
+  auto credentials = MakeRefCounted<TlsServerCredentials>(options);
+  auto connector = credentials->create_security_connector(ChannelArgs());
+  auto* tls_connector =
+      static_cast<TlsServerSecurityConnector*>(connector.get());
+  ASSERT_NE(tls_connector->VerificationResultCacheForTesting(), nullptr);
+  const char* expected_error_msg =
+      "Custom verification check failed with error: UNAVAILABLE: backend down";
+  for (int i = 1; i <= 2; ++i) {
+    tsi_peer peer;
+    GPR_ASSERT(tsi_construct_peer(2, &peer) == TSI_OK);
+    GPR_ASSERT(tsi_construct_string_peer_property(
+                   TSI_SSL_ALPN_SELECTED_PROTOCOL, "grpc", strlen("grpc"),
+                   &peer.properties[0]) == TSI_OK);
+    GPR_ASSERT(tsi_construct_string_peer_property_from_cstring(
+                   TSI_X509_PEM_CERT_CHAIN_PROPERTY, "chain_a",
+                   &peer.properties[1]) == TSI_OK);
+    RefCountedPtr<grpc_auth_context> auth_context;
+    ExecCtx exec_ctx;
+    grpc_closure* on_peer_checked = GRPC_CLOSURE_CREATE(
+        VerifyExpectedErrorCallback, const_cast<char*>(expected_error_msg),
+        grpc_schedule_on_exec_ctx);
+    connector->check_peer(peer, nullptr, ChannelArgs(), &auth_context,
+                          on_peer_checked);
+    // Each handshake asks the verifier again.
+    EXPECT_EQ(verifier->num_verifications(), i);
+  }
+  EXPECT_EQ(tls_connector->VerificationResultCacheForTesting()->size(), 0);
+}
+
 TEST_F(TlsSecurityConnectorTest,
        ServerSecurityConnectorWithAsyncExternalVerifierSucceeds) {
   auto* async_verifier = new AsyncExternalVerifier(true);
@@ -0,0 +1,134 @@
+//
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+
+#include "src/core/lib/security/credentials/tls/tls_verification_result_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "absl/status/status.h"
+#include "absl/types/optional.h"
+
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+TEST(TlsVerificationResultCacheTest, ReturnsCachedResults) {
+  ExecCtx exec_ctx;
+  TlsVerificationResultCache cache(10);
+  EXPECT_EQ(cache.Get("chain_a", 0), absl::nullopt);
+  cache.Put("chain_a", 0, absl::OkStatus());
+  cache.Put("chain_b", 0, absl::UnauthenticatedError("rejected"));
+  EXPECT_EQ(cache.Get("chain_a", 0), absl::OkStatus());
+  EXPECT_EQ(cache.Get("chain_b", 0), absl::UnauthenticatedError("rejected"));
+  EXPECT_EQ(cache.Get("chain_c", 0), absl::nullopt);
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(TlsVerificationResultCacheTest, ReplacesExistingResult) {
+  ExecCtx exec_ctx;
+  TlsVerificationResultCache cache(10);
+  cache.Put("chain_a", 0, absl::UnauthenticatedError("rejected"));
+  cache.Put("chain_a", 0, absl::OkStatus());
+  EXPECT_EQ(cache.Get("chain_a", 0), absl::OkStatus());
+  EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(TlsVerificationResultCacheTest, CachesOnlyDefinitiveResults) {
+  ExecCtx exec_ctx;
+  TlsVerificationResultCache cache(10);
+  cache.Put("chain_a", 0, absl::OkStatus());
+  cache.Put("chain_b", 0, absl::UnauthenticatedError("rejected"));
+  cache.Put("chain_c", 0, absl::PermissionDeniedError("rejected"));
+  EXPECT_EQ(cache.size(), 3);
+  // Errors that may not recur are not cached...
+  cache.Put("chain_d", 0, absl::UnavailableError("backend down"));
+  cache.Put("chain_e", 0, absl::CancelledError("cancelled"));
+  cache.Put("chain_f", 0, absl::DeadlineExceededError("timed out"));
+  cache.Put("chain_g", 0, absl::InternalError("bug"));
+  EXPECT_EQ(cache.size(), 3);
+  EXPECT_EQ(cache.Get("chain_d", 0), absl::nullopt);
+  EXPECT_EQ(cache.Get("chain_e", 0), absl::nullopt);
+  // ...and do not replace a cached result.
+  cache.Put("chain_a", 0, absl::UnavailableError("backend down"));
+  EXPECT_EQ(cache.Get("chain_a", 0), absl::OkStatus());
+}
+
+TEST(TlsVerificationResultCacheTest, EvictsLeastRecentlyUsed) {
+  ExecCtx exec_ctx;
+  TlsVerificationResultCache cache(2);
+  cache.Put("chain_a", 0, absl::OkStatus());
+  cache.Put("chain_b", 0, absl::OkStatus());
+  // Makes chain_a the most recently used.
+  EXPECT_TRUE(cache.Get("chain_a", 0).has_value());
+  cache.Put("chain_c", 0, absl::OkStatus());
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_TRUE(cache.Get("chain_a", 0).has_value());
+  EXPECT_FALSE(cache.Get("chain_b", 0).has_value());
+  EXPECT_TRUE(cache.Get("chain_c", 0).has_value());
+}
+
+TEST(TlsVerificationResultCacheTest, NewTrustBundleVersionDropsResults) {
+  ExecCtx exec_ctx;
+  TlsVerificationResultCache cache(10);
+  cache.Put("chain_a", 0, absl::OkStatus());
+  cache.Put("chain_b", 0, absl::OkStatus());
+  EXPECT_EQ(cache.Get("chain_a", 1), absl::nullopt);
+  EXPECT_EQ(cache.size(), 0);
+  cache.Put("chain_a", 1, absl::OkStatus());
+  EXPECT_TRUE(cache.Get("chain_a", 1).has_value());
+}
+
+TEST(TlsVerificationResultCacheTest, IgnoresOldTrustBundleVersion) {
+  ExecCtx exec_ctx;
+  TlsVerificationResultCache cache(10);
+  cache.Put("chain_a", 1, absl::OkStatus());
+  // A result computed before the roots changed is not cached...
+  cache.Put("chain_b", 0, absl::OkStatus());
+  EXPECT_EQ(cache.size(), 1);
+  // ...and lookups with the old version do not return newer results.
+  EXPECT_EQ(cache.Get("chain_a", 0), absl::nullopt);
+  EXPECT_TRUE(cache.Get("chain_a", 1).has_value());
+}
+
+TEST(TlsVerificationResultCacheTest, RecordsHitsAndMisses) {
+  ExecCtx exec_ctx;
+  TlsVerificationResultCache cache(10);
+  auto before = global_stats().Collect();
+  cache.Get("chain_a", 0);
+  cache.Put("chain_a", 0, absl::OkStatus());
+  cache.Get("chain_a", 0);
+  cache.Get("chain_a", 0);
+  auto diff = global_stats().Collect()->Diff(*before);
+  EXPECT_EQ(diff->tls_verification_cache_hits, 2);
+  EXPECT_EQ(diff->tls_verification_cache_misses, 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/lib/security/transport/tsi_handshake_executor.h"
+
+#include <atomic>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include <grpc/grpc.h>
+
+#include "src/core/lib/gprpp/notification.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace {
+
+TEST(TsiHandshakeExecutorTest, RunsSteps) {
+  ExecCtx exec_ctx;
+  std::atomic<int> steps_run{0};
+  Notification done;
+  {
+    TsiHandshakeExecutor executor(2, 100);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_TRUE(executor.Run([&steps_run, &done]() {
+        if (steps_run.fetch_add(1) + 1 == 100) done.Notify();
+      }));
+    }
+    done.WaitForNotification();
+  }
+  EXPECT_EQ(steps_run.load(), 100);
+}
+
+TEST(TsiHandshakeExecutorTest, RejectsStepsWhenQueueIsFull) {
+  ExecCtx exec_ctx;
+  Notification started;
+  Notification unblock;
+  TsiHandshakeExecutor executor(1, 2);
+  // Occupy the only thread.
+  EXPECT_TRUE(executor.Run([&started, &unblock]() {
+    started.Notify();
+    unblock.WaitForNotification();
+  }));
+  started.WaitForNotification();
+  EXPECT_EQ(executor.queue_depth(), 0);
+  std::atomic<int> steps_run{0};
+  EXPECT_TRUE(executor.Run([&steps_run]() { steps_run.fetch_add(1); }));
+  EXPECT_TRUE(executor.Run([&steps_run]() { steps_run.fetch_add(1); }));
+  EXPECT_EQ(executor.queue_depth(), 2);
+  EXPECT_FALSE(executor.Run([&steps_run]() { steps_run.fetch_add(1); }));
+  unblock.Notify();
+  Notification done;
+  // Runs after the two queued steps, since there is only one thread.
+  while (!executor.Run([&done]() { done.Notify(); })) {
+  }
+  done.WaitForNotification();
+  EXPECT_EQ(steps_run.load(), 2);
+  EXPECT_EQ(executor.queue_depth(), 0);
+}
+
+TEST(TsiHandshakeExecutorTest, DrainsQueueOnDestruction) {
+  ExecCtx exec_ctx;
+  std::atomic<int> steps_run{0};
+  Notification unblock;
+  {
+    TsiHandshakeExecutor executor(1, 10);
+    EXPECT_TRUE(executor.Run([&unblock]() { unblock.WaitForNotification(); }));
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_TRUE(executor.Run([&steps_run]() { steps_run.fetch_add(1); }));
+    }
+    unblock.Notify();
+  }
+  EXPECT_EQ(steps_run.load(), 5);
+}
+
+TEST(TsiHandshakeExecutorTest, SharedExecutorIsProcessWide) {
+  EXPECT_EQ(TsiHandshakeExecutor::Get(), TsiHandshakeExecutor::Get());
+}
+
+}  // namespace
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
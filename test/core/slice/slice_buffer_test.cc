@@ -78,6 +78,43 @@ TEST(SliceBufferTest, SliceRefTest) {
   sb.Clear();
 }
 
+// Short copied strings would be inlined (and merged) by Append, so build
+// refcounted slices explicitly.
+Slice MakeRefcountedSlice(const char* s) {
+  const size_t len = strlen(s);
+  char* contents = static_cast<char*>(gpr_malloc(len));
+  memcpy(contents, s, len);
+  return Slice(grpc_slice_new(contents, len, gpr_free));
+}
+
+// Builds a buffer holding "0123456789abcdefghij" split across three
+// refcounted slices of lengths 5, 10 and 5.
+SliceBuffer MakeSegmentedBuffer() {
+  SliceBuffer sb;
+  sb.Append(MakeRefcountedSlice("01234"));
+  sb.Append(MakeRefcountedSlice("56789abcde"));
+  sb.Append(MakeRefcountedSlice("fghij"));
+  return sb;
+}
+
+TEST(SliceBufferTest, DiscardFirst) {
+  SliceBuffer sb = MakeSegmentedBuffer();
+  grpc_slice_buffer_discard_first(sb.c_slice_buffer(), 0);
+  EXPECT_EQ(sb.Length(), 20);
+  grpc_slice_buffer_discard_first(sb.c_slice_buffer(), 3);
+  EXPECT_EQ(sb.Count(), 3);
+  EXPECT_EQ(sb.JoinIntoString(), "3456789abcdefghij");
+  grpc_slice_buffer_discard_first(sb.c_slice_buffer(), 2);
+  EXPECT_EQ(sb.Count(), 2);
+  EXPECT_EQ(sb.JoinIntoString(), "56789abcdefghij");
+  grpc_slice_buffer_discard_first(sb.c_slice_buffer(), 12);
+  EXPECT_EQ(sb.Count(), 1);
+  EXPECT_EQ(sb.JoinIntoString(), "hij");
+  grpc_slice_buffer_discard_first(sb.c_slice_buffer(), 3);
+  EXPECT_EQ(sb.Count(), 0);
+  EXPECT_EQ(sb.Length(), 0);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,247 @@
+//
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//
+
+// Races application-requested calls against incoming calls on a server with
+// several completion queues, so that requests and calls each get queued and
+// claimed from many threads at once.
+
+#include <string.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+#include <grpc/grpc.h>
+#include <grpc/grpc_security.h>
+#include <grpc/slice.h>
+#include <grpc/status.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+namespace {
+
+constexpr int kNumServerCqs = 4;
+constexpr int kNumClientThreads = 8;
+constexpr int kCallsPerClientThread = 200;
+
+// One outstanding grpc_server_request_call() and, once matched, the reply to
+// the call it was matched with.
+struct RequestedCall {
+  grpc_call* call = nullptr;
+  grpc_call_details details;
+  grpc_metadata_array request_metadata;
+  int was_cancelled = 0;
+  bool replying = false;
+};
+
+class ServerThread {
+ public:
+  // Keeps max_outstanding requests queued on cq, so that with few of them
+  // incoming calls have to wait as pending, and with many, requests wait for
+  // calls.
+  ServerThread(grpc_server* server, grpc_completion_queue* cq,
+               int max_outstanding)
+      : server_(server), cq_(cq), requests_(max_outstanding) {}
+
+  void Start() {
+    for (RequestedCall& rc : requests_) Request(&rc);
+    thread_ = std::thread([this]() { Run(); });
+  }
+
+  void Join() { thread_.join(); }
+
+  int calls_served() const { return calls_served_; }
+
+ private:
+  void Request(RequestedCall* rc) {
+    grpc_call_details_init(&rc->details);
+    grpc_metadata_array_init(&rc->request_metadata);
+    rc->replying = false;
+    ASSERT_EQ(GRPC_CALL_OK,
+              grpc_server_request_call(server_, &rc->call, &rc->details,
+                                       &rc->request_metadata, cq_, cq_, rc));
+    ++outstanding_;
+  }
+
+  void Reply(RequestedCall* rc) {
+    grpc_op ops[3];
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[1].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+    ops[1].data.recv_close_on_server.cancelled = &rc->was_cancelled;
+    ops[2].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+    ops[2].data.send_status_from_server.status = GRPC_STATUS_OK;
+    rc->replying = true;
+    ASSERT_EQ(GRPC_CALL_OK, grpc_call_start_batch(rc->call, ops, 3, rc,
+                                                  nullptr));
+  }
+
+  void Run() {
+    while (outstanding_ > 0) {
+      grpc_event ev = grpc_completion_queue_next(
+          cq_, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr);
+      ASSERT_EQ(ev.type, GRPC_OP_COMPLETE);
+      RequestedCall* rc = static_cast<RequestedCall*>(ev.tag);
+      if (!rc->replying) {
+        if (!ev.success) {
+          // The server is shutting down.
+          grpc_call_details_destroy(&rc->details);
+          grpc_metadata_array_destroy(&rc->request_metadata);
+          --outstanding_;
+          continue;
+        }
+        Reply(rc);
+        continue;
+      }
+      EXPECT_TRUE(ev.success);
+      grpc_call_unref(rc->call);
+      grpc_call_details_destroy(&rc->details);
+      grpc_metadata_array_destroy(&rc->request_metadata);
+      ++calls_served_;
+      --outstanding_;
+      Request(rc);
+    }
+  }
+
+  grpc_server* const server_;
+  grpc_completion_queue* const cq_;
+  std::vector<RequestedCall> requests_;
+  int outstanding_ = 0;
+  std::atomic<int> calls_served_{0};
+  std::thread thread_;
+};
+
+void RunClient(const std::string& target) {
+  grpc_channel_credentials* creds = grpc_insecure_credentials_create();
+  grpc_channel* channel = grpc_channel_create(target.c_str(), creds, nullptr);
+  grpc_channel_credentials_release(creds);
+  grpc_completion_queue* cq = grpc_completion_queue_create_for_next(nullptr);
+  for (int i = 0; i < kCallsPerClientThread; i++) {
+    gpr_timespec deadline = grpc_timeout_seconds_to_deadline(30);
+    grpc_call* call = grpc_channel_create_call(
+        channel, nullptr, GRPC_PROPAGATE_DEFAULTS, cq,
+        grpc_slice_from_static_string("/foo"), nullptr, deadline, nullptr);
+    grpc_metadata_array initial_metadata;
+    grpc_metadata_array trailing_metadata;
+    grpc_metadata_array_init(&initial_metadata);
+    grpc_metadata_array_init(&trailing_metadata);
+    grpc_status_code status;
+    grpc_slice details;
+    grpc_op ops[4];
+    memset(ops, 0, sizeof(ops));
+    ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+    ops[1].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+    ops[2].op = GRPC_OP_RECV_INITIAL_METADATA;
+    ops[2].data.recv_initial_metadata.recv_initial_metadata = &initial_metadata;
+    ops[3].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+    ops[3].data.recv_status_on_client.trailing_metadata = &trailing_metadata;
+    ops[3].data.recv_status_on_client.status = &status;
+    ops[3].data.recv_status_on_client.status_details = &details;
+    ASSERT_EQ(GRPC_CALL_OK,
+              grpc_call_start_batch(call, ops, 4, call, nullptr));
+    grpc_event ev = grpc_completion_queue_next(cq, deadline, nullptr);
+    ASSERT_EQ(ev.type, GRPC_OP_COMPLETE);
+    EXPECT_EQ(ev.tag, call);
+    EXPECT_TRUE(ev.success);
+    EXPECT_EQ(status, GRPC_STATUS_OK);
+    grpc_slice_unref(details);
+    grpc_metadata_array_destroy(&initial_metadata);
+    grpc_metadata_array_destroy(&trailing_metadata);
+    grpc_call_unref(call);
+  }
+  grpc_channel_destroy(channel);
+  grpc_completion_queue_shutdown(cq);
+  while (grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                    nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(cq);
+}
+
+TEST(RequestMatcherStressTest, ConcurrentRequestsAndCalls) {
+  grpc_server* server = grpc_server_create(nullptr, nullptr);
+  std::vector<grpc_completion_queue*> cqs;
+  for (int i = 0; i < kNumServerCqs; i++) {
+    cqs.push_back(grpc_completion_queue_create_for_next(nullptr));
+    grpc_server_register_completion_queue(server, cqs.back(), nullptr);
+  }
+  grpc_completion_queue* shutdown_cq =
+      grpc_completion_queue_create_for_pluck(nullptr);
+  grpc_server_register_completion_queue(server, shutdown_cq, nullptr);
+  const std::string target =
+      absl::StrCat("localhost:", grpc_pick_unused_port_or_die());
+  grpc_server_credentials* server_creds =
+      grpc_insecure_server_credentials_create();
+  ASSERT_TRUE(
+      grpc_server_add_http2_port(server, target.c_str(), server_creds));
+  grpc_server_credentials_release(server_creds);
+  grpc_server_start(server);
+  std::vector<std::unique_ptr<ServerThread>> server_threads;
+  for (int i = 0; i < kNumServerCqs; i++) {
+    server_threads.push_back(
+        std::make_unique<ServerThread>(server, cqs[i], i % 2 == 0 ? 1 : 8));
+    server_threads.back()->Start();
+  }
+  std::vector<std::thread> client_threads;
+  for (int i = 0; i < kNumClientThreads; i++) {
+    client_threads.emplace_back([&target]() { RunClient(target); });
+  }
+  for (auto& thread : client_threads) thread.join();
+  grpc_server_shutdown_and_notify(server, shutdown_cq, nullptr);
+  ASSERT_EQ(grpc_completion_queue_pluck(shutdown_cq, nullptr,
+                                        grpc_timeout_seconds_to_deadline(30),
+                                        nullptr)
+                .type,
+            GRPC_OP_COMPLETE);
+  int calls_served = 0;
+  for (auto& server_thread : server_threads) {
+    server_thread->Join();
+    calls_served += server_thread->calls_served();
+  }
+  EXPECT_EQ(calls_served, kNumClientThreads * kCallsPerClientThread);
+  grpc_server_destroy(server);
+  for (grpc_completion_queue* cq : cqs) {
+    grpc_completion_queue_shutdown(cq);
+    while (grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(cq);
+  }
+  grpc_completion_queue_shutdown(shutdown_cq);
+  grpc_completion_queue_destroy(shutdown_cq);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int result = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return result;
+}
@@ -18,6 +18,8 @@
 
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
@@ -32,6 +34,7 @@
 #include "src/core/lib/resource_quota/resource_quota.h"
 #include "src/core/lib/slice/slice.h"
 #include "src/core/lib/transport/metadata_batch.h"
+#include "src/core/lib/transport/metadata_key_table.h"
 #include "test/core/util/test_config.h"
 
 namespace grpc_core {
@@ -141,6 +144,251 @@ TEST_F(MetadataMapTest, NonEncodableTrait) {
   EXPECT_EQ(map.DebugString(), "GrpcStreamNetworkState: not sent on wire");
 }
 
+static void CrashOnAppendError(absl::string_view, const Slice&) { abort(); }
+
+TEST_F(MetadataMapTest, UnknownMetadataEncodeTest) {
+  FakeEncoder encoder;
+  auto arena = MakeScopedArena(1024, &memory_allocator_);
+  TimeoutOnlyMetadataMap map(arena.get());
+  map.Append("x-custom-header", Slice::FromCopiedString("value1"),
+             CrashOnAppendError);
+  map.Append(std::string(MetadataKeyTable::kMaxKeyLength + 1, 'k'),
+             Slice::FromCopiedString("value2"), CrashOnAppendError);
+  map.Encode(&encoder);
+  EXPECT_EQ(encoder.output(),
+            absl::StrCat("UNKNOWN METADATUM: key=x-custom-header value=value1\n",
+                         "UNKNOWN METADATUM: key=",
+                         std::string(MetadataKeyTable::kMaxKeyLength + 1, 'k'),
+                         " value=value2\n"));
+}
+
+TEST_F(MetadataMapTest, UnknownMetadataCopyAndRemove) {
+  auto arena = MakeScopedArena(1024, &memory_allocator_);
+  TimeoutOnlyMetadataMap map(arena.get());
+  map.Append("x-forwarded-a", Slice::FromCopiedString("a"),
+             CrashOnAppendError);
+  map.Append("x-forwarded-b", Slice::FromCopiedString(std::string(100, 'b')),
+             CrashOnAppendError);
+  map.Append("x-forwarded-a", Slice::FromCopiedString("c"),
+             CrashOnAppendError);
+  TimeoutOnlyMetadataMap copy = map.Copy();
+  std::string buffer;
+  EXPECT_EQ(copy.GetStringValue("x-forwarded-a", &buffer), "a,c");
+  EXPECT_EQ(copy.GetStringValue("x-forwarded-b", &buffer),
+            std::string(100, 'b'));
+  EXPECT_EQ(copy.count(), 3);
+  copy.Remove("x-forwarded-a");
+  EXPECT_EQ(copy.GetStringValue("x-forwarded-a", &buffer), absl::nullopt);
+  EXPECT_EQ(copy.count(), 1);
+  // The original is untouched.
+  EXPECT_EQ(map.GetStringValue("x-forwarded-a", &buffer), "a,c");
+  EXPECT_EQ(map.count(), 3);
+}
+
+TEST_F(MetadataMapTest, CopiesShareUnknownMetadataUntilModified) {
+  auto arena = MakeScopedArena(1024, &memory_allocator_);
+  TimeoutOnlyMetadataMap map(arena.get());
+  for (int i = 0; i < 20; i++) {
+    map.Append(absl::StrCat("x-header-", i),
+               Slice::FromCopiedString(absl::StrCat("value-", i)),
+               CrashOnAppendError);
+  }
+  TimeoutOnlyMetadataMap copy1 = map.Copy();
+  TimeoutOnlyMetadataMap copy2 = copy1.Copy();
+  // Appending to one map is invisible to the others.
+  map.Append("x-header-0", Slice::FromCopiedString("again"),
+             CrashOnAppendError);
+  copy1.Append("x-copy-only", Slice::FromCopiedString("1"),
+               CrashOnAppendError);
+  // Removing from a copy doesn't affect the maps it shares with.
+  copy2.Remove("x-header-5");
+  std::string buffer;
+  EXPECT_EQ(map.GetStringValue("x-header-0", &buffer), "value-0,again");
+  EXPECT_EQ(map.GetStringValue("x-copy-only", &buffer), absl::nullopt);
+  EXPECT_EQ(map.GetStringValue("x-header-5", &buffer), "value-5");
+  EXPECT_EQ(map.count(), 21);
+  EXPECT_EQ(copy1.GetStringValue("x-header-0", &buffer), "value-0");
+  EXPECT_EQ(copy1.GetStringValue("x-copy-only", &buffer), "1");
+  EXPECT_EQ(copy1.GetStringValue("x-header-5", &buffer), "value-5");
+  EXPECT_EQ(copy1.count(), 21);
+  EXPECT_EQ(copy2.GetStringValue("x-header-0", &buffer), "value-0");
+  EXPECT_EQ(copy2.GetStringValue("x-header-5", &buffer), absl::nullopt);
+  EXPECT_EQ(copy2.GetStringValue("x-header-19", &buffer), "value-19");
+  EXPECT_EQ(copy2.count(), 19);
+  // Order is preserved when appending past the shared elements.
+  FakeEncoder encoder;
+  copy1.Encode(&encoder);
+  std::string expected;
+  for (int i = 0; i < 20; i++) {
+    absl::StrAppend(&expected, "UNKNOWN METADATUM: key=x-header-", i,
+                    " value=value-", i, "\n");
+  }
+  absl::StrAppend(&expected, "UNKNOWN METADATUM: key=x-copy-only value=1\n");
+  EXPECT_EQ(encoder.output(), expected);
+  map.Clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(copy1.count(), 21);
+}
+
+TEST_F(MetadataMapTest, ClearedMapCanBeRefilled) {
+  auto arena = MakeScopedArena(1024, &memory_allocator_);
+  TimeoutOnlyMetadataMap map(arena.get());
+  std::string buffer;
+  for (int round = 0; round < 3; round++) {
+    for (int i = 0; i < 20; i++) {
+      map.Append(absl::StrCat("x-header-", i),
+                 Slice::FromCopiedString(absl::StrCat("value-", round)),
+                 CrashOnAppendError);
+    }
+    EXPECT_EQ(map.count(), 20);
+    EXPECT_EQ(map.GetStringValue("x-header-19", &buffer),
+              absl::StrCat("value-", round));
+    if (round == 1) {
+      // A copy taken before clearing keeps its elements.
+      TimeoutOnlyMetadataMap copy = map.Copy();
+      map.Clear();
+      EXPECT_EQ(copy.count(), 20);
+      EXPECT_EQ(copy.GetStringValue("x-header-0", &buffer), "value-1");
+    } else {
+      map.Clear();
+    }
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.GetStringValue("x-header-0", &buffer), absl::nullopt);
+  }
+}
+
+TEST_F(MetadataMapTest, ConcurrentCopiesOfConstMap) {
+  auto arena = MakeScopedArena(1024, &memory_allocator_);
+  TimeoutOnlyMetadataMap map(arena.get());
+  for (int i = 0; i < 5; i++) {
+    map.Append(absl::StrCat("x-header-", i),
+               Slice::FromCopiedString(absl::StrCat("value-", i)),
+               CrashOnAppendError);
+  }
+  const TimeoutOnlyMetadataMap& source = map;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&source, t]() {
+      std::string buffer;
+      for (int i = 0; i < 100; i++) {
+        // Copies race to append into the block they share with the source.
+        TimeoutOnlyMetadataMap copy = source.Copy();
+        copy.Append("x-thread", Slice::FromCopiedString(absl::StrCat(t)),
+                    CrashOnAppendError);
+        EXPECT_EQ(copy.GetStringValue("x-thread", &buffer), absl::StrCat(t));
+        copy.Remove("x-header-1");
+        EXPECT_EQ(copy.count(), 5);
+        EXPECT_EQ(source.GetStringValue("x-header-1", &buffer), "value-1");
+        EXPECT_EQ(source.GetStringValue("x-thread", &buffer), absl::nullopt);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(map.count(), 5);
+}
+
+TEST(MetadataKeyTableTest, InternIsStable) {
+  const auto id = MetadataKeyTable::Intern("x-interned-key");
+  ASSERT_NE(id, MetadataKeyTable::kNotInterned);
+  EXPECT_EQ(MetadataKeyTable::Intern("x-interned-key"), id);
+  EXPECT_EQ(MetadataKeyTable::Find("x-interned-key"), id);
+  EXPECT_EQ(MetadataKeyTable::Key(id).as_string_view(), "x-interned-key");
+  EXPECT_NE(MetadataKeyTable::Intern("x-other-interned-key"), id);
+  EXPECT_EQ(MetadataKeyTable::Find("x-never-interned-key"),
+            MetadataKeyTable::kNotInterned);
+}
+
+TEST(MetadataKeyTableTest, LongKeysAreNotInterned) {
+  const std::string key(MetadataKeyTable::kMaxKeyLength + 1, 'x');
+  EXPECT_EQ(MetadataKeyTable::Intern(key), MetadataKeyTable::kNotInterned);
+  MetadataKey metadata_key(key);
+  EXPECT_FALSE(metadata_key.interned());
+  EXPECT_EQ(metadata_key.as_string_view(), key);
+  EXPECT_EQ(MetadataKey(metadata_key), metadata_key);
+}
+
+TEST(MetadataKeyTableTest, KeyComparison) {
+  MetadataKey a = MetadataKey::Intern("x-compare-a");
+  MetadataKey b = MetadataKey::Intern("x-compare-b");
+  MetadataKey c("x-compare-c");
+  EXPECT_TRUE(a.interned());
+  EXPECT_FALSE(c.interned());
+  EXPECT_EQ(a, MetadataKey("x-compare-a"));
+  EXPECT_FALSE(a == b);
+  EXPECT_FALSE(a == c);
+  EXPECT_EQ(c, MetadataKey("x-compare-c"));
+  EXPECT_EQ(sizeof(MetadataKey), sizeof(void*));
+}
+
+TEST_F(MetadataMapTest, PeerKeysAreNotInterned) {
+  auto arena = MakeScopedArena(1024, &memory_allocator_);
+  // Parsing, as the transports do for metadata received from a peer, only
+  // uses keys that are already interned.
+  const size_t size = MetadataKeyTable::Size();
+  TimeoutOnlyMetadataMap map(arena.get());
+  map.Set(TimeoutOnlyMetadataMap::Parse("x-peer-key",
+                                        Slice::FromCopiedString("value"), 0,
+                                        CrashOnAppendError));
+  EXPECT_EQ(MetadataKeyTable::Find("x-peer-key"),
+            MetadataKeyTable::kNotInterned);
+  EXPECT_EQ(MetadataKeyTable::Size(), size);
+  std::string buffer;
+  EXPECT_EQ(map.GetStringValue("x-peer-key", &buffer), "value");
+  // Appending may also see key names from a peer, e.g. headers forwarded by
+  // a proxy, so it does not intern either.
+  map.Append("x-local-key", Slice::FromCopiedString("value"),
+             CrashOnAppendError);
+  EXPECT_EQ(MetadataKeyTable::Find("x-local-key"),
+            MetadataKeyTable::kNotInterned);
+  EXPECT_EQ(MetadataKeyTable::Size(), size);
+  EXPECT_EQ(map.GetStringValue("x-local-key", &buffer), "value");
+  // Key names fixed in the source are interned.
+  map.AppendStaticKey("x-static-key", Slice::FromCopiedString("value"),
+                      CrashOnAppendError);
+  EXPECT_NE(MetadataKeyTable::Find("x-static-key"),
+            MetadataKeyTable::kNotInterned);
+  EXPECT_EQ(map.GetStringValue("x-static-key", &buffer), "value");
+}
+
+TEST(MetadataKeyTableTest, MovedFromKeyIsEmpty) {
+  MetadataKey interned = MetadataKey::Intern("x-moved-interned");
+  MetadataKey copied("x-moved-copied");
+  for (MetadataKey* key : {&interned, &copied}) {
+    MetadataKey moved(std::move(*key));
+    EXPECT_FALSE(key->interned());
+    EXPECT_EQ(key->as_string_view(), "");
+    EXPECT_EQ(key->size(), 0);
+    EXPECT_TRUE(key->slice().empty());
+    MetadataKey copy(*key);
+    EXPECT_EQ(copy.as_string_view(), "");
+    *key = moved;
+    EXPECT_EQ(*key, moved);
+  }
+  EXPECT_EQ(interned.as_string_view(), "x-moved-interned");
+  EXPECT_EQ(copied.as_string_view(), "x-moved-copied");
+}
+
+TEST(MetadataKeyTableTest, ConcurrentInternAndFind) {
+  std::vector<std::thread> threads;
+  std::vector<std::vector<MetadataKeyTable::Id>> ids(4);
+  for (size_t t = 0; t < ids.size(); ++t) {
+    threads.emplace_back([t, &ids]() {
+      for (int i = 0; i < 100; ++i) {
+        std::string key = absl::StrCat("x-concurrent-", i);
+        MetadataKeyTable::Find(key);
+        ids[t].push_back(MetadataKeyTable::Intern(key));
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (size_t t = 1; t < ids.size(); ++t) EXPECT_EQ(ids[t], ids[0]);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_NE(ids[0][i], MetadataKeyTable::kNotInterned);
+    EXPECT_EQ(MetadataKeyTable::Key(ids[0][i]).as_string_view(),
+              absl::StrCat("x-concurrent-", i));
+  }
+}
+
 TEST(DebugStringBuilderTest, AddOne) {
   metadata_detail::DebugStringBuilder b;
   b.Add("a", "b");
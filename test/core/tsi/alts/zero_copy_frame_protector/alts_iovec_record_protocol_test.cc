@@ -28,6 +28,7 @@
 constexpr size_t kMaxDataSize = 1024;
 constexpr size_t kMaxSlices = 10;
 constexpr size_t kSealRepeatTimes = 5;
+constexpr size_t kBatchFrames = 6;
 constexpr size_t kTagLength = 16;
 
 // Test fixtures for each test cases.
@@ -509,6 +510,127 @@ static void privacy_integrity_unsync_seal_unseal(
   alts_iovec_record_protocol_test_var_destroy(var);
 }
 
+static void privacy_integrity_batch_seal_unseal(
+    alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
+  for (size_t i = 0; i < kSealRepeatTimes; i++) {
+    alts_iovec_record_protocol_test_var* vars[kBatchFrames];
+    size_t frame_vec_lengths[kBatchFrames];
+    size_t total_vec_length = 0;
+    size_t protected_length = 0;
+    for (size_t j = 0; j < kBatchFrames; j++) {
+      vars[j] = alts_iovec_record_protocol_test_var_create();
+      frame_vec_lengths[j] = vars[j]->data_iovec_length;
+      total_vec_length += vars[j]->data_iovec_length;
+      protected_length += vars[j]->protected_iovec.iov_len;
+    }
+    auto* data_iovec =
+        static_cast<iovec_t*>(gpr_malloc(total_vec_length * sizeof(iovec_t)));
+    size_t vec_index = 0;
+    for (size_t j = 0; j < kBatchFrames; j++) {
+      memcpy(data_iovec + vec_index, vars[j]->data_iovec,
+             vars[j]->data_iovec_length * sizeof(iovec_t));
+      vec_index += vars[j]->data_iovec_length;
+    }
+    // Seals all of the frames at once.
+    auto* protected_buf = static_cast<uint8_t*>(gpr_malloc(protected_length));
+    iovec_t protected_iovec = {protected_buf, protected_length};
+    ASSERT_EQ(alts_iovec_record_protocol_privacy_integrity_protect_batch(
+                  sender, data_iovec, frame_vec_lengths, kBatchFrames,
+                  protected_iovec, nullptr),
+              GRPC_STATUS_OK);
+    // The first frames are unsealed one at a time, which shows that the batch
+    // produced ordinary frames.
+    const size_t num_single_frames = kBatchFrames / 2;
+    uint8_t* frame = protected_buf;
+    for (size_t j = 0; j < num_single_frames; j++) {
+      iovec_t header_iovec = {frame, vars[j]->header_length};
+      iovec_t frame_iovec = {frame + vars[j]->header_length,
+                             vars[j]->data_length + vars[j]->tag_length};
+      ASSERT_EQ(alts_iovec_record_protocol_privacy_integrity_unprotect(
+                    receiver, header_iovec, &frame_iovec, 1,
+                    vars[j]->unprotected_iovec, nullptr),
+                GRPC_STATUS_OK);
+      ASSERT_EQ(
+          memcmp(vars[j]->data_buf, vars[j]->dup_buf, vars[j]->data_length),
+          0);
+      frame += vars[j]->protected_iovec.iov_len;
+    }
+    // The remaining frames are unsealed at once.
+    const size_t num_batch_frames = kBatchFrames - num_single_frames;
+    iovec_t headers[kBatchFrames];
+    iovec_t frame_iovecs[kBatchFrames];
+    size_t frame_iovec_lengths[kBatchFrames];
+    size_t unprotected_length = 0;
+    for (size_t j = 0; j < num_batch_frames; j++) {
+      alts_iovec_record_protocol_test_var* var = vars[num_single_frames + j];
+      headers[j] = {frame, var->header_length};
+      frame_iovecs[j] = {frame + var->header_length,
+                         var->data_length + var->tag_length};
+      frame_iovec_lengths[j] = 1;
+      unprotected_length += var->data_length;
+      frame += var->protected_iovec.iov_len;
+    }
+    auto* unprotected_buf =
+        static_cast<uint8_t*>(gpr_malloc(unprotected_length));
+    iovec_t unprotected_iovec = {unprotected_buf, unprotected_length};
+    ASSERT_EQ(alts_iovec_record_protocol_privacy_integrity_unprotect_batch(
+                  receiver, headers, frame_iovecs, frame_iovec_lengths,
+                  num_batch_frames, unprotected_iovec, nullptr),
+              GRPC_STATUS_OK);
+    uint8_t* data = unprotected_buf;
+    for (size_t j = num_single_frames; j < kBatchFrames; j++) {
+      ASSERT_EQ(memcmp(data, vars[j]->dup_buf, vars[j]->data_length), 0);
+      data += vars[j]->data_length;
+    }
+    gpr_free(unprotected_buf);
+    gpr_free(protected_buf);
+    gpr_free(data_iovec);
+    for (size_t j = 0; j < kBatchFrames; j++) {
+      alts_iovec_record_protocol_test_var_destroy(vars[j]);
+    }
+  }
+}
+
+static void privacy_integrity_batch_corrupted_data(
+    alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
+  alts_iovec_record_protocol_test_var* vars[kBatchFrames];
+  iovec_t headers[kBatchFrames];
+  iovec_t frame_iovecs[kBatchFrames];
+  size_t frame_iovec_lengths[kBatchFrames];
+  size_t unprotected_length = 0;
+  for (size_t j = 0; j < kBatchFrames; j++) {
+    vars[j] = alts_iovec_record_protocol_test_var_create();
+    ASSERT_EQ(alts_iovec_record_protocol_privacy_integrity_protect(
+                  sender, vars[j]->data_iovec, vars[j]->data_iovec_length,
+                  vars[j]->protected_iovec, nullptr),
+              GRPC_STATUS_OK);
+    headers[j] = {vars[j]->protected_buf, vars[j]->header_length};
+    frame_iovecs[j] = {vars[j]->protected_buf + vars[j]->header_length,
+                       vars[j]->data_length + vars[j]->tag_length};
+    frame_iovec_lengths[j] = 1;
+    unprotected_length += vars[j]->data_length;
+  }
+  // Corrupts the last frame, so that the batch fails only after the other
+  // frames have been opened.
+  alter_random_byte(
+      static_cast<uint8_t*>(frame_iovecs[kBatchFrames - 1].iov_base),
+      frame_iovecs[kBatchFrames - 1].iov_len);
+  auto* unprotected_buf = static_cast<uint8_t*>(gpr_malloc(unprotected_length));
+  iovec_t unprotected_iovec = {unprotected_buf, unprotected_length};
+  char* error_message = nullptr;
+  grpc_status_code status =
+      alts_iovec_record_protocol_privacy_integrity_unprotect_batch(
+          receiver, headers, frame_iovecs, frame_iovec_lengths, kBatchFrames,
+          unprotected_iovec, &error_message);
+  ASSERT_TRUE(gsec_test_expect_compare_code_and_substr(
+      status, GRPC_STATUS_INTERNAL, error_message, "Frame decryption failed."));
+  gpr_free(error_message);
+  gpr_free(unprotected_buf);
+  for (size_t j = 0; j < kBatchFrames; j++) {
+    alts_iovec_record_protocol_test_var_destroy(vars[j]);
+  }
+}
+
 static void privacy_integrity_corrupted_data(
     alts_iovec_record_protocol* sender, alts_iovec_record_protocol* receiver) {
   // Seals the data first.
@@ -772,6 +894,29 @@ TEST(AltsIovecRecordProtocolTest,
   alts_iovec_record_protocol_test_fixture_destroy(fixture);
 }
 
+TEST(AltsIovecRecordProtocolTest, AltsIovecRecordProtocolBatchSealUnsealTests) {
+  alts_iovec_record_protocol_test_fixture* fixture =
+      alts_iovec_record_protocol_test_fixture_create(
+          /*rekey=*/false, /*integrity_only=*/false);
+  privacy_integrity_batch_seal_unseal(fixture->client_protect,
+                                      fixture->server_unprotect);
+  privacy_integrity_batch_seal_unseal(fixture->server_protect,
+                                      fixture->client_unprotect);
+  privacy_integrity_batch_corrupted_data(fixture->client_protect,
+                                         fixture->server_unprotect);
+  alts_iovec_record_protocol_test_fixture_destroy(fixture);
+
+  fixture = alts_iovec_record_protocol_test_fixture_create(
+      /*rekey=*/true, /*integrity_only=*/false);
+  privacy_integrity_batch_seal_unseal(fixture->client_protect,
+                                      fixture->server_unprotect);
+  privacy_integrity_batch_seal_unseal(fixture->server_protect,
+                                      fixture->client_unprotect);
+  privacy_integrity_batch_corrupted_data(fixture->client_protect,
+                                         fixture->server_unprotect);
+  alts_iovec_record_protocol_test_fixture_destroy(fixture);
+}
+
 TEST(AltsIovecRecordProtocolTest, AltsIovecRecordProtocolEmptySealUnsealTests) {
   alts_iovec_record_protocol_test_fixture* fixture =
       alts_iovec_record_protocol_test_fixture_create(
@@ -0,0 +1,177 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares sealing and opening ALTS frames one at a time against doing so in
+// batches, for frames of a few RPC-sized payloads up to full 16 KiB frames.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <grpc/grpc.h>
+#include <grpc/slice.h>
+#include <grpc/slice_buffer.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/tsi/alts/crypt/gsec.h"
+#include "src/core/tsi/alts/zero_copy_frame_protector/alts_grpc_privacy_integrity_record_protocol.h"
+#include "src/core/tsi/alts/zero_copy_frame_protector/alts_grpc_record_protocol.h"
+#include "src/core/tsi/alts/zero_copy_frame_protector/alts_iovec_record_protocol.h"
+
+namespace grpc_core {
+namespace {
+
+constexpr size_t kFrameOverhead = kZeroCopyFrameHeaderSize + kAesGcmTagLength;
+// The payload of a frame of the zero-copy protector's default frame length.
+constexpr size_t kMaxFrameDataSize = 16 * 1024 - kFrameOverhead;
+
+alts_grpc_record_protocol* CreateRecordProtocol(bool is_client,
+                                                bool is_protect) {
+  uint8_t key[kAes128GcmKeyLength];
+  memset(key, 0x5a, sizeof(key));
+  gsec_aead_crypter* crypter = nullptr;
+  GPR_ASSERT(gsec_aes_gcm_aead_crypter_create(
+                 key, sizeof(key), kAesGcmNonceLength, kAesGcmTagLength,
+                 /*rekey=*/false, &crypter, nullptr) == GRPC_STATUS_OK);
+  alts_grpc_record_protocol* rp = nullptr;
+  GPR_ASSERT(alts_grpc_privacy_integrity_record_protocol_create(
+                 crypter, 8, is_client, is_protect, &rp) == TSI_OK);
+  return rp;
+}
+
+class RecordProtocolPair {
+ public:
+  RecordProtocolPair()
+      : sender_(CreateRecordProtocol(/*is_client=*/true, /*is_protect=*/true)),
+        receiver_(
+            CreateRecordProtocol(/*is_client=*/false, /*is_protect=*/false)) {
+    grpc_slice_buffer_init(&unprotected_sb_);
+    grpc_slice_buffer_init(&protected_sb_);
+    grpc_slice_buffer_init(&frame_sb_);
+    grpc_slice_buffer_init(&received_sb_);
+  }
+
+  ~RecordProtocolPair() {
+    grpc_slice_buffer_destroy(&unprotected_sb_);
+    grpc_slice_buffer_destroy(&protected_sb_);
+    grpc_slice_buffer_destroy(&frame_sb_);
+    grpc_slice_buffer_destroy(&received_sb_);
+    alts_grpc_record_protocol_destroy(sender_);
+    alts_grpc_record_protocol_destroy(receiver_);
+  }
+
+  void AddData(size_t frame_data_size, size_t num_frames) {
+    grpc_slice slice = GRPC_SLICE_MALLOC(num_frames * frame_data_size);
+    memset(GRPC_SLICE_START_PTR(slice), 0x33, GRPC_SLICE_LENGTH(slice));
+    grpc_slice_buffer_add(&unprotected_sb_, slice);
+  }
+
+  void SealOpenPerFrame(size_t frame_data_size, size_t num_frames) {
+    AddData(frame_data_size, num_frames);
+    for (size_t i = 0; i < num_frames; ++i) {
+      grpc_slice_buffer_move_first(&unprotected_sb_, frame_data_size,
+                                   &frame_sb_);
+      GPR_ASSERT(alts_grpc_record_protocol_protect(sender_, &frame_sb_,
+                                                   &protected_sb_) == TSI_OK);
+    }
+    for (size_t i = 0; i < num_frames; ++i) {
+      grpc_slice_buffer_move_first(
+          &protected_sb_, frame_data_size + kFrameOverhead, &frame_sb_);
+      GPR_ASSERT(alts_grpc_record_protocol_unprotect(
+                     receiver_, &frame_sb_, &received_sb_) == TSI_OK);
+    }
+    GPR_ASSERT(received_sb_.length == num_frames * frame_data_size);
+    grpc_slice_buffer_reset_and_unref(&received_sb_);
+  }
+
+  void SealOpenBatch(size_t frame_data_size, size_t num_frames) {
+    AddData(frame_data_size, num_frames);
+    GPR_ASSERT(alts_grpc_record_protocol_protect_frames(
+                   sender_, &unprotected_sb_, frame_data_size,
+                   &protected_sb_) == TSI_OK);
+    std::vector<size_t> frame_sizes(num_frames,
+                                    frame_data_size + kFrameOverhead);
+    GPR_ASSERT(alts_grpc_record_protocol_unprotect_frames(
+                   receiver_, &protected_sb_, frame_sizes.data(), num_frames,
+                   &received_sb_) == TSI_OK);
+    GPR_ASSERT(received_sb_.length == num_frames * frame_data_size);
+    grpc_slice_buffer_reset_and_unref(&received_sb_);
+  }
+
+ private:
+  alts_grpc_record_protocol* sender_;
+  alts_grpc_record_protocol* receiver_;
+  grpc_slice_buffer unprotected_sb_;
+  grpc_slice_buffer protected_sb_;
+  grpc_slice_buffer frame_sb_;
+  grpc_slice_buffer received_sb_;
+};
+
+// Arguments are the payload size of each frame and the number of frames.
+void FrameMixArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"frame_data_size", "num_frames"});
+  // Small unary RPCs, each written as its own frame.
+  b->Args({256, 16});
+  b->Args({1024, 16});
+  // Streaming messages.
+  b->Args({4096, 16});
+  // Large writes split into full frames, of which the zero-copy protector
+  // batches at most 64 KiB.
+  b->Args({kMaxFrameDataSize, 4});
+}
+
+void BM_AltsSealOpenPerFrame(benchmark::State& state) {
+  ExecCtx exec_ctx;
+  RecordProtocolPair pair;
+  for (auto _ : state) {
+    pair.SealOpenPerFrame(state.range(0), state.range(1));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+BENCHMARK(BM_AltsSealOpenPerFrame)->Apply(FrameMixArgs);
+
+void BM_AltsSealOpenBatch(benchmark::State& state) {
+  ExecCtx exec_ctx;
+  RecordProtocolPair pair;
+  for (auto _ : state) {
+    pair.SealOpenBatch(state.range(0), state.range(1));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+BENCHMARK(BM_AltsSealOpenBatch)->Apply(FrameMixArgs);
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc_init();
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
@@ -40,6 +40,12 @@ constexpr size_t kSmallBufferSize = 16;
 constexpr size_t kLargeBufferSize = 16384;
 constexpr size_t kChannelMaxSize = 2048;
 constexpr size_t kChannelMinSize = 128;
+// More than the number of frames the protector opens in one batch.
+constexpr size_t kNumSmallFrames = 40;
+// Large enough frames that the protector's batches are limited by their size
+// rather than by their number of frames.
+constexpr size_t kLargeFrameSize = 16384;
+constexpr size_t kManyLargeFramesBufferSize = 16 * kLargeFrameSize;
 
 // Test fixtures for each test cases.
 struct alts_zero_copy_grpc_protector_test_fixture {
@@ -104,16 +110,15 @@ static bool are_slice_buffers_equal(grpc_slice_buffer* first,
 }
 
 static alts_zero_copy_grpc_protector_test_fixture*
-alts_zero_copy_grpc_protector_test_fixture_create(bool rekey,
-                                                  bool integrity_only,
-                                                  bool enable_extra_copy) {
+alts_zero_copy_grpc_protector_test_fixture_create(
+    bool rekey, bool integrity_only, bool enable_extra_copy,
+    size_t max_protected_frame_size = 1024) {
   alts_zero_copy_grpc_protector_test_fixture* fixture =
       static_cast<alts_zero_copy_grpc_protector_test_fixture*>(
           gpr_zalloc(sizeof(alts_zero_copy_grpc_protector_test_fixture)));
   grpc_core::ExecCtx exec_ctx;
   size_t key_length = rekey ? kAes128GcmRekeyKeyLength : kAes128GcmKeyLength;
   uint8_t* key;
-  size_t max_protected_frame_size = 1024;
   size_t actual_max_protected_frame_size;
   gsec_test_random_array(&key, key_length);
   EXPECT_EQ(alts_zero_copy_grpc_protector_create(
@@ -221,6 +226,37 @@ static void seal_unseal_small_buffer(tsi_zero_copy_grpc_protector* sender,
   grpc_core::ExecCtx::Get()->Flush();
 }
 
+static void seal_unseal_many_small_buffers(
+    tsi_zero_copy_grpc_protector* sender,
+    tsi_zero_copy_grpc_protector* receiver) {
+  grpc_core::ExecCtx exec_ctx;
+  int min_progress_size;
+  alts_zero_copy_grpc_protector_test_var* var =
+      alts_zero_copy_grpc_protector_test_var_create();
+  // Protects each small buffer into its own frame.
+  for (size_t i = 0; i < kNumSmallFrames; i++) {
+    grpc_slice_buffer original_sb;
+    grpc_slice_buffer_init(&original_sb);
+    create_random_slice_buffer(&original_sb, &var->duplicate_sb,
+                               kSmallBufferSize);
+    ASSERT_EQ(tsi_zero_copy_grpc_protector_protect(sender, &original_sb,
+                                                   &var->protected_sb),
+              TSI_OK);
+    grpc_slice_buffer_destroy(&original_sb);
+  }
+  // Unprotects all of the frames at once, as if they arrived in one read.
+  ASSERT_EQ(tsi_zero_copy_grpc_protector_unprotect(
+                receiver, &var->protected_sb, &var->unprotected_sb,
+                &min_progress_size),
+            TSI_OK);
+  ASSERT_EQ(var->protected_sb.length, 0);
+  ASSERT_TRUE(
+      are_slice_buffers_equal(&var->unprotected_sb, &var->duplicate_sb));
+  ASSERT_EQ(min_progress_size, 1);
+  alts_zero_copy_grpc_protector_test_var_destroy(var);
+  grpc_core::ExecCtx::Get()->Flush();
+}
+
 static void seal_unseal_large_buffer(tsi_zero_copy_grpc_protector* sender,
                                      tsi_zero_copy_grpc_protector* receiver) {
   grpc_core::ExecCtx exec_ctx;
@@ -256,6 +292,30 @@ static void seal_unseal_large_buffer(tsi_zero_copy_grpc_protector* sender,
   grpc_core::ExecCtx::Get()->Flush();
 }
 
+static void seal_unseal_many_large_frames(
+    tsi_zero_copy_grpc_protector* sender,
+    tsi_zero_copy_grpc_protector* receiver) {
+  grpc_core::ExecCtx exec_ctx;
+  int min_progress_size;
+  alts_zero_copy_grpc_protector_test_var* var =
+      alts_zero_copy_grpc_protector_test_var_create();
+  create_random_slice_buffer(&var->original_sb, &var->duplicate_sb,
+                             kManyLargeFramesBufferSize);
+  ASSERT_EQ(tsi_zero_copy_grpc_protector_protect(sender, &var->original_sb,
+                                                 &var->protected_sb),
+            TSI_OK);
+  // Unprotects all of the frames at once, as if they arrived in one read.
+  ASSERT_EQ(tsi_zero_copy_grpc_protector_unprotect(
+                receiver, &var->protected_sb, &var->unprotected_sb,
+                &min_progress_size),
+            TSI_OK);
+  ASSERT_EQ(var->protected_sb.length, 0);
+  ASSERT_TRUE(
+      are_slice_buffers_equal(&var->unprotected_sb, &var->duplicate_sb));
+  alts_zero_copy_grpc_protector_test_var_destroy(var);
+  grpc_core::ExecCtx::Get()->Flush();
+}
+
 // --- Test cases. ---
 
 static void alts_zero_copy_protector_seal_unseal_small_buffer_tests(
@@ -265,24 +325,32 @@ static void alts_zero_copy_protector_seal_unseal_small_buffer_tests(
           /*rekey=*/false, /*integrity_only=*/true, enable_extra_copy);
   seal_unseal_small_buffer(fixture->client, fixture->server);
   seal_unseal_small_buffer(fixture->server, fixture->client);
+  seal_unseal_many_small_buffers(fixture->client, fixture->server);
+  seal_unseal_many_small_buffers(fixture->server, fixture->client);
   alts_zero_copy_grpc_protector_test_fixture_destroy(fixture);
 
   fixture = alts_zero_copy_grpc_protector_test_fixture_create(
       /*rekey=*/false, /*integrity_only=*/false, enable_extra_copy);
   seal_unseal_small_buffer(fixture->client, fixture->server);
   seal_unseal_small_buffer(fixture->server, fixture->client);
+  seal_unseal_many_small_buffers(fixture->client, fixture->server);
+  seal_unseal_many_small_buffers(fixture->server, fixture->client);
   alts_zero_copy_grpc_protector_test_fixture_destroy(fixture);
 
   fixture = alts_zero_copy_grpc_protector_test_fixture_create(
       /*rekey=*/true, /*integrity_only=*/true, enable_extra_copy);
   seal_unseal_small_buffer(fixture->client, fixture->server);
   seal_unseal_small_buffer(fixture->server, fixture->client);
+  seal_unseal_many_small_buffers(fixture->client, fixture->server);
+  seal_unseal_many_small_buffers(fixture->server, fixture->client);
   alts_zero_copy_grpc_protector_test_fixture_destroy(fixture);
 
   fixture = alts_zero_copy_grpc_protector_test_fixture_create(
       /*rekey=*/true, /*integrity_only=*/false, enable_extra_copy);
   seal_unseal_small_buffer(fixture->client, fixture->server);
   seal_unseal_small_buffer(fixture->server, fixture->client);
+  seal_unseal_many_small_buffers(fixture->client, fixture->server);
+  seal_unseal_many_small_buffers(fixture->server, fixture->client);
   alts_zero_copy_grpc_protector_test_fixture_destroy(fixture);
 }
 
@@ -312,6 +380,13 @@ static void alts_zero_copy_protector_seal_unseal_large_buffer_tests(
   seal_unseal_large_buffer(fixture->client, fixture->server);
   seal_unseal_large_buffer(fixture->server, fixture->client);
   alts_zero_copy_grpc_protector_test_fixture_destroy(fixture);
+
+  fixture = alts_zero_copy_grpc_protector_test_fixture_create(
+      /*rekey=*/false, /*integrity_only=*/false, enable_extra_copy,
+      kLargeFrameSize);
+  seal_unseal_many_large_frames(fixture->client, fixture->server);
+  seal_unseal_many_large_frames(fixture->server, fixture->client);
+  alts_zero_copy_grpc_protector_test_fixture_destroy(fixture);
 }
 
 TEST(AltsZeroCopyGrpcProtectorTest, MainTest) {
@@ -45,13 +45,14 @@ class SessionTracker {
 
   ~SessionTracker() { SSL_CTX_free(ssl_context_); }
 
-  tsi::SslSessionPtr NewSession(long id) {
+  tsi::SslSessionPtr NewSession(long id, int version = TLS1_2_VERSION) {
     static int ex_data_id = SSL_SESSION_get_ex_new_index(
         0, nullptr, nullptr, nullptr, DestroyExData);
     GPR_ASSERT(ex_data_id != -1);
     // OpenSSL and different version of BoringSSL don't agree on API
     // so try both.
     tsi::SslSessionPtr session = NewSessionInternal(SSL_SESSION_new);
+    EXPECT_EQ(SSL_SESSION_set_protocol_version(session.get(), version), 1);
     SessionExDataId* data = new SessionExDataId{this, id};
     int result = SSL_SESSION_set_ex_data(session.get(), ex_data_id, data);
     EXPECT_EQ(result, 1);
@@ -142,6 +143,86 @@ TEST(SslSessionCacheTest, LruCache) {
   EXPECT_EQ(tracker.AliveCount(), 0);
 }
 
+TEST(SslSessionCacheTest, Tls13TicketsAreSingleUse) {
+  SessionTracker tracker;
+  {
+    RefCountedPtr<tsi::SslSessionLRUCache> cache =
+        tsi::SslSessionLRUCache::Create(3);
+    tsi::SslSessionPtr sess1 = tracker.NewSession(1, TLS1_3_VERSION);
+    SSL_SESSION* sess1_ptr = sess1.get();
+    tsi::SslSessionPtr sess2 = tracker.NewSession(2, TLS1_3_VERSION);
+    SSL_SESSION* sess2_ptr = sess2.get();
+    cache->Put("first.dropbox.com", std::move(sess1));
+    cache->Put("first.dropbox.com", std::move(sess2));
+    EXPECT_EQ(cache->Size(), 1);
+    EXPECT_EQ(tracker.AliveCount(), 2);
+    // The newest ticket is handed out first, and each only once.
+    tsi::SslSessionPtr got = cache->Get("first.dropbox.com");
+    EXPECT_EQ(got.get(), sess2_ptr);
+    got = cache->Get("first.dropbox.com");
+    EXPECT_EQ(got.get(), sess1_ptr);
+    EXPECT_FALSE(tracker.IsAlive(2));
+    got.reset();
+    EXPECT_EQ(cache->Get("first.dropbox.com"), nullptr);
+    EXPECT_EQ(cache->Size(), 0);
+    EXPECT_EQ(tracker.AliveCount(), 0);
+  }
+}
+
+TEST(SslSessionCacheTest, Tls13TicketsPerKeyAreLimited) {
+  SessionTracker tracker;
+  {
+    RefCountedPtr<tsi::SslSessionLRUCache> cache =
+        tsi::SslSessionLRUCache::Create(3);
+    const long num_tickets = tsi::SslSessionLRUCache::kMaxTicketsPerKey + 2;
+    for (long id = 1; id <= num_tickets; id++) {
+      cache->Put("first.dropbox.com", tracker.NewSession(id, TLS1_3_VERSION));
+    }
+    // The oldest tickets are discarded.
+    EXPECT_EQ(tracker.AliveCount(), tsi::SslSessionLRUCache::kMaxTicketsPerKey);
+    EXPECT_FALSE(tracker.IsAlive(1));
+    EXPECT_FALSE(tracker.IsAlive(2));
+    EXPECT_TRUE(tracker.IsAlive(num_tickets));
+    // A session of an earlier version replaces the tickets, and is reused.
+    tsi::SslSessionPtr sess = tracker.NewSession(num_tickets + 1);
+    SSL_SESSION* sess_ptr = sess.get();
+    cache->Put("first.dropbox.com", std::move(sess));
+    EXPECT_EQ(tracker.AliveCount(), 1);
+    EXPECT_EQ(cache->Get("first.dropbox.com").get(), sess_ptr);
+    EXPECT_EQ(cache->Get("first.dropbox.com").get(), sess_ptr);
+    // And the other way around.
+    cache->Put("first.dropbox.com",
+               tracker.NewSession(num_tickets + 2, TLS1_3_VERSION));
+    EXPECT_FALSE(tracker.IsAlive(num_tickets + 1));
+    EXPECT_EQ(tracker.AliveCount(), 1);
+  }
+  EXPECT_EQ(tracker.AliveCount(), 0);
+}
+
+TEST(SslSessionCacheTest, ShardedCacheRespectsCapacity) {
+  SessionTracker tracker;
+  {
+    RefCountedPtr<tsi::SslSessionLRUCache> cache =
+        tsi::SslSessionLRUCache::Create(1024);
+    for (long id = 0; id < 4096; id++) {
+      std::string domain = std::to_string(id) + ".random.domain";
+      cache->Put(domain.c_str(), tracker.NewSession(id));
+      // The most recent session is always found.
+      EXPECT_NE(cache->Get(domain.c_str()), nullptr);
+    }
+    EXPECT_LE(cache->Size(), 1024);
+    EXPECT_GT(cache->Size(), 512);
+    EXPECT_EQ(tracker.AliveCount(), cache->Size());
+  }
+  EXPECT_EQ(tracker.AliveCount(), 0);
+}
+
+TEST(SslSessionCacheTest, SharedCacheIsProcessWide) {
+  tsi::SslSessionLRUCache* cache = tsi::SslSessionLRUCache::Shared();
+  EXPECT_NE(cache, nullptr);
+  EXPECT_EQ(cache, tsi::SslSessionLRUCache::Shared());
+}
+
 }  // namespace
 }  // namespace grpc_core
 
@@ -18,24 +18,41 @@
 
 #include "src/core/tsi/ssl_transport_security.h"
 
+#include <netinet/in.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
 #include <openssl/pem.h>
 
+#include "absl/strings/string_view.h"
+
 #include <grpc/grpc.h>
+#include <grpc/slice.h>
+#include <grpc/slice_buffer.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
+#include "src/core/lib/experiments/experiments.h"
 #include "src/core/lib/gprpp/memory.h"
 #include "src/core/lib/iomgr/load_file.h"
 #include "src/core/lib/security/security_connector/security_connector.h"
+#include "src/core/lib/slice/slice_internal.h"
 #include "src/core/tsi/transport_security.h"
+#include "src/core/tsi/transport_security_grpc.h"
 #include "src/core/tsi/transport_security_interface.h"
 #include "test/core/tsi/transport_security_test_lib.h"
 #include "test/core/util/build.h"
@@ -759,6 +776,400 @@ void ssl_tsi_test_do_round_trip_odd_buffer_size() {
   }
 }
 
+// Protects a message made of slices of the given sizes with the zero-copy
+// protector. Returns the protected bytes and sets *message to the plaintext.
+static std::string ssl_tsi_test_zero_copy_protect(
+    tsi_zero_copy_grpc_protector* protector,
+    const std::vector<size_t>& slice_sizes, char first_char,
+    std::string* message) {
+  grpc_slice_buffer unprotected_slices;
+  grpc_slice_buffer protected_slices;
+  grpc_slice_buffer_init(&unprotected_slices);
+  grpc_slice_buffer_init(&protected_slices);
+  message->clear();
+  for (size_t i = 0; i < slice_sizes.size(); i++) {
+    std::string part(slice_sizes[i], static_cast<char>(first_char + i));
+    *message += part;
+    grpc_slice_buffer_add(
+        &unprotected_slices,
+        grpc_slice_from_copied_buffer(part.data(), part.size()));
+  }
+  EXPECT_EQ(tsi_zero_copy_grpc_protector_protect(protector, &unprotected_slices,
+                                                 &protected_slices),
+            TSI_OK);
+  EXPECT_EQ(unprotected_slices.length, 0);
+  std::string protected_bytes;
+  for (size_t i = 0; i < protected_slices.count; i++) {
+    protected_bytes +=
+        std::string(grpc_core::StringViewFromSlice(protected_slices.slices[i]));
+  }
+  EXPECT_GT(protected_bytes.size(), message->size());
+  grpc_slice_buffer_destroy(&unprotected_slices);
+  grpc_slice_buffer_destroy(&protected_slices);
+  return protected_bytes;
+}
+
+// Unprotects protected_bytes with the zero-copy protector, delivering them in
+// pieces of delivery_size bytes, which split records at arbitrary points.
+// Returns the plaintext.
+static std::string ssl_tsi_test_zero_copy_unprotect(
+    tsi_zero_copy_grpc_protector* protector, absl::string_view protected_bytes,
+    size_t delivery_size) {
+  grpc_slice_buffer received_slices;
+  grpc_slice_buffer_init(&received_slices);
+  while (!protected_bytes.empty()) {
+    absl::string_view piece = protected_bytes.substr(0, delivery_size);
+    protected_bytes.remove_prefix(piece.size());
+    grpc_slice_buffer delivered_slices;
+    grpc_slice_buffer_init(&delivered_slices);
+    grpc_slice_buffer_add(
+        &delivered_slices,
+        grpc_slice_from_copied_buffer(piece.data(), piece.size()));
+    int min_progress_size = 0;
+    EXPECT_EQ(
+        tsi_zero_copy_grpc_protector_unprotect(
+            protector, &delivered_slices, &received_slices, &min_progress_size),
+        TSI_OK);
+    EXPECT_EQ(delivered_slices.length, 0);
+    EXPECT_GE(min_progress_size, 1);
+    grpc_slice_buffer_destroy(&delivered_slices);
+  }
+  std::string received;
+  for (size_t i = 0; i < received_slices.count; i++) {
+    received +=
+        std::string(grpc_core::StringViewFromSlice(received_slices.slices[i]));
+  }
+  grpc_slice_buffer_destroy(&received_slices);
+  return received;
+}
+
+// Returns the bytes the client (or server) has been sent but has not read,
+// such as TLS 1.3 session tickets that arrived after the handshake, and marks
+// them read.
+static std::string ssl_tsi_test_take_unread_bytes(tsi_test_channel* channel,
+                                                  bool is_client) {
+  const uint8_t* bytes =
+      is_client ? channel->client_channel : channel->server_channel;
+  size_t* bytes_read = is_client ? &channel->bytes_read_from_client_channel
+                                 : &channel->bytes_read_from_server_channel;
+  size_t bytes_written = is_client ? channel->bytes_written_to_client_channel
+                                   : channel->bytes_written_to_server_channel;
+  std::string unread(reinterpret_cast<const char*>(bytes) + *bytes_read,
+                     bytes_written - *bytes_read);
+  *bytes_read = bytes_written;
+  return unread;
+}
+
+void ssl_tsi_test_do_zero_copy_round_trip() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_zero_copy_round_trip");
+  tsi_test_fixture* fixture = ssl_tsi_test_fixture_create();
+  tsi_test_do_handshake(fixture);
+  // The zero-copy protector is only offered under its experiment.
+  tsi_frame_protector_type frame_protector_type;
+  ASSERT_EQ(tsi_handshaker_result_get_frame_protector_type(
+                fixture->client_result, &frame_protector_type),
+            TSI_OK);
+  EXPECT_EQ(frame_protector_type,
+            grpc_core::IsSslZeroCopyFrameProtectorEnabled()
+                ? TSI_FRAME_PROTECTOR_NORMAL_OR_ZERO_COPY
+                : TSI_FRAME_PROTECTOR_NORMAL);
+  tsi_zero_copy_grpc_protector* client_protector = nullptr;
+  tsi_zero_copy_grpc_protector* server_protector = nullptr;
+  // Frame sizes outside the supported range are clamped.
+  size_t client_max_frame_size = 100;
+  ASSERT_EQ(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                fixture->client_result, &client_max_frame_size,
+                &client_protector),
+            TSI_OK);
+  EXPECT_EQ(client_max_frame_size, 1024);
+  ASSERT_EQ(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                fixture->server_result, nullptr, &server_protector),
+            TSI_OK);
+  size_t server_max_frame_size = 0;
+  ASSERT_EQ(tsi_zero_copy_grpc_protector_max_frame_size(
+                server_protector, &server_max_frame_size),
+            TSI_OK);
+  EXPECT_EQ(server_max_frame_size, 16384);
+  std::string client_unread =
+      ssl_tsi_test_take_unread_bytes(fixture->channel, /*is_client=*/true);
+  std::string server_unread =
+      ssl_tsi_test_take_unread_bytes(fixture->channel, /*is_client=*/false);
+  // Small slices are coalesced, large ones sealed in place, and a slice larger
+  // than a record is split. Each message goes over the same protectors, so
+  // that state left over from one message is exercised by the next.
+  const std::vector<size_t> slice_sizes = {1,    10,    100,   1000,
+                                           5000, 20000, 40000, 3};
+  const size_t delivery_sizes[] = {7, 1000, std::string::npos};
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(delivery_sizes); i++) {
+    std::string message;
+    std::string protected_bytes = ssl_tsi_test_zero_copy_protect(
+        client_protector, slice_sizes, 'a', &message);
+    EXPECT_EQ(ssl_tsi_test_zero_copy_unprotect(
+                  server_protector, server_unread + protected_bytes,
+                  delivery_sizes[i]),
+              message);
+    protected_bytes = ssl_tsi_test_zero_copy_protect(
+        server_protector, slice_sizes, 'A', &message);
+    EXPECT_EQ(ssl_tsi_test_zero_copy_unprotect(
+                  client_protector, client_unread + protected_bytes,
+                  delivery_sizes[i]),
+              message);
+    client_unread.clear();
+    server_unread.clear();
+  }
+  tsi_zero_copy_grpc_protector_destroy(client_protector);
+  tsi_zero_copy_grpc_protector_destroy(server_protector);
+  tsi_test_fixture_destroy(fixture);
+}
+
+// The experiment may be enabled on only one side of a connection, so the
+// zero-copy protector must interoperate with the normal one.
+void ssl_tsi_test_do_zero_copy_interop_with_frame_protector() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_zero_copy_interop_with_frame_protector");
+  tsi_test_fixture* fixture = ssl_tsi_test_fixture_create();
+  tsi_test_do_handshake(fixture);
+  tsi_zero_copy_grpc_protector* client_protector = nullptr;
+  tsi_frame_protector* server_protector = nullptr;
+  ASSERT_EQ(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                fixture->client_result, nullptr, &client_protector),
+            TSI_OK);
+  ASSERT_EQ(tsi_handshaker_result_create_frame_protector(
+                fixture->server_result, nullptr, &server_protector),
+            TSI_OK);
+  tsi_test_channel* channel = fixture->channel;
+  tsi_test_frame_protector_config* config = fixture->config;
+  // Client to server. The message must fit in the test channel.
+  std::string message;
+  std::string protected_bytes = ssl_tsi_test_zero_copy_protect(
+      client_protector, {1, 100, 5000, 10000, 3}, 'a', &message);
+  ASSERT_LE(channel->bytes_written_to_server_channel + protected_bytes.size(),
+            TSI_TEST_DEFAULT_CHANNEL_SIZE);
+  memcpy(channel->server_channel + channel->bytes_written_to_server_channel,
+         protected_bytes.data(), protected_bytes.size());
+  channel->bytes_written_to_server_channel += protected_bytes.size();
+  std::string received(message.size(), '\0');
+  size_t received_size = 0;
+  tsi_test_frame_protector_receive_message_from_peer(
+      config, channel, server_protector,
+      reinterpret_cast<unsigned char*>(&received[0]), &received_size,
+      /*is_client=*/false);
+  EXPECT_EQ(received_size, message.size());
+  EXPECT_EQ(received, message);
+  // Server to client.
+  tsi_test_frame_protector_send_message_to_peer(config, channel,
+                                                server_protector,
+                                                /*is_client=*/false);
+  EXPECT_EQ(ssl_tsi_test_zero_copy_unprotect(
+                client_protector,
+                ssl_tsi_test_take_unread_bytes(channel, /*is_client=*/true),
+                1000),
+            std::string(reinterpret_cast<const char*>(config->server_message),
+                        config->server_message_size));
+  tsi_zero_copy_grpc_protector_destroy(client_protector);
+  tsi_frame_protector_destroy(server_protector);
+  tsi_test_fixture_destroy(fixture);
+}
+
+// Connects two TCP sockets over the loopback interface.
+static void ssl_tsi_test_connect_loopback(int* client_fd, int* server_fd) {
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(listen_fd, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  ASSERT_EQ(bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), addr_len), 0);
+  ASSERT_EQ(listen(listen_fd, 1), 0);
+  ASSERT_EQ(
+      getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len),
+      0);
+  *client_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(*client_fd, 0);
+  ASSERT_EQ(connect(*client_fd, reinterpret_cast<sockaddr*>(&addr), addr_len),
+            0);
+  *server_fd = accept(listen_fd, nullptr, nullptr);
+  ASSERT_GE(*server_fd, 0);
+  close(listen_fd);
+}
+
+// Protects slices of the given sizes and returns the bytes to write to the
+// socket: TLS records, or the plaintext itself once the kernel seals them.
+static std::string ssl_tsi_test_protect_for_socket(
+    tsi_zero_copy_grpc_protector* protector,
+    const std::vector<size_t>& slice_sizes, char first_char,
+    std::string* message) {
+  grpc_slice_buffer unprotected_slices;
+  grpc_slice_buffer protected_slices;
+  grpc_slice_buffer_init(&unprotected_slices);
+  grpc_slice_buffer_init(&protected_slices);
+  message->clear();
+  for (size_t i = 0; i < slice_sizes.size(); i++) {
+    std::string part(slice_sizes[i], static_cast<char>(first_char + i));
+    *message += part;
+    grpc_slice_buffer_add(
+        &unprotected_slices,
+        grpc_slice_from_copied_buffer(part.data(), part.size()));
+  }
+  EXPECT_EQ(tsi_zero_copy_grpc_protector_protect(protector, &unprotected_slices,
+                                                 &protected_slices),
+            TSI_OK);
+  std::string protected_bytes;
+  for (size_t i = 0; i < protected_slices.count; i++) {
+    protected_bytes +=
+        std::string(grpc_core::StringViewFromSlice(protected_slices.slices[i]));
+  }
+  grpc_slice_buffer_destroy(&unprotected_slices);
+  grpc_slice_buffer_destroy(&protected_slices);
+  return protected_bytes;
+}
+
+static void ssl_tsi_test_send_all(int fd, absl::string_view bytes) {
+  while (!bytes.empty()) {
+    ssize_t n = send(fd, bytes.data(), bytes.size(), 0);
+    ASSERT_GT(n, 0);
+    bytes.remove_prefix(static_cast<size_t>(n));
+  }
+}
+
+// Reads TLS records from fd and unprotects them, after the bytes in unread,
+// until size bytes of plaintext have come out. Returns the plaintext and, in
+// wire_bytes, what was read from fd.
+static std::string ssl_tsi_test_receive(tsi_zero_copy_grpc_protector* protector,
+                                        int fd, absl::string_view unread,
+                                        size_t size, std::string* wire_bytes) {
+  std::string received =
+      ssl_tsi_test_zero_copy_unprotect(protector, unread, std::string::npos);
+  wire_bytes->clear();
+  while (received.size() < size) {
+    char buffer[4096];
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    EXPECT_GT(n, 0);
+    if (n <= 0) break;
+    wire_bytes->append(buffer, static_cast<size_t>(n));
+    received += ssl_tsi_test_zero_copy_unprotect(
+        protector, absl::string_view(buffer, static_cast<size_t>(n)),
+        std::string::npos);
+  }
+  return received;
+}
+
+// Both sides hand record encryption to the kernel when the platform supports
+// it, and keep encrypting in user space otherwise. Either way, what they
+// write to their sockets must be TLS records that the peer can read.
+void ssl_tsi_test_do_zero_copy_kernel_tx_offload() {
+  gpr_log(GPR_INFO, "ssl_tsi_test_do_zero_copy_kernel_tx_offload");
+  tsi_test_fixture* fixture = ssl_tsi_test_fixture_create();
+  tsi_test_do_handshake(fixture);
+  tsi_zero_copy_grpc_protector* client_protector = nullptr;
+  tsi_zero_copy_grpc_protector* server_protector = nullptr;
+  ASSERT_EQ(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                fixture->client_result, nullptr, &client_protector),
+            TSI_OK);
+  ASSERT_EQ(tsi_handshaker_result_create_zero_copy_grpc_protector(
+                fixture->server_result, nullptr, &server_protector),
+            TSI_OK);
+  std::string client_unread =
+      ssl_tsi_test_take_unread_bytes(fixture->channel, /*is_client=*/true);
+  std::string server_unread =
+      ssl_tsi_test_take_unread_bytes(fixture->channel, /*is_client=*/false);
+  // Offload needs a connected TCP socket.
+  EXPECT_EQ(
+      tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(client_protector,
+                                                            -1),
+      TSI_INVALID_ARGUMENT);
+  int unconnected_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(unconnected_fd, 0);
+  EXPECT_NE(tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(
+                client_protector, unconnected_fd),
+            TSI_OK);
+  close(unconnected_fd);
+  int client_fd = -1;
+  int server_fd = -1;
+  ssl_tsi_test_connect_loopback(&client_fd, &server_fd);
+  // Offload needs BoringSSL, an AES-GCM cipher and the kernel's tls module.
+  tsi_result client_offload_result =
+      tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(client_protector,
+                                                            client_fd);
+  EXPECT_TRUE(client_offload_result == TSI_OK ||
+              client_offload_result == TSI_UNIMPLEMENTED);
+  if (client_offload_result == TSI_OK) {
+    EXPECT_EQ(tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(
+                  client_protector, client_fd),
+              TSI_OK);
+  }
+  // A TLS 1.3 server sends the session tickets that SSL held back on its
+  // socket, ahead of everything that the kernel seals.
+  tsi_result server_offload_result =
+      tsi_zero_copy_grpc_protector_enable_kernel_tx_offload(server_protector,
+                                                            server_fd);
+  EXPECT_TRUE(server_offload_result == TSI_OK ||
+              server_offload_result == TSI_UNIMPLEMENTED);
+  // Client to server.
+  std::string message;
+  std::string protected_bytes = ssl_tsi_test_protect_for_socket(
+      client_protector, {1, 100, 5000, 20000, 3}, 'a', &message);
+  if (client_offload_result == TSI_OK) {
+    // The kernel seals what is written to the socket.
+    EXPECT_EQ(protected_bytes, message);
+  } else {
+    EXPECT_GT(protected_bytes.size(), message.size());
+  }
+  ssl_tsi_test_send_all(client_fd, protected_bytes);
+  std::string wire_bytes;
+  EXPECT_EQ(ssl_tsi_test_receive(server_protector, server_fd, server_unread,
+                                 message.size(), &wire_bytes),
+            message);
+  EXPECT_GT(wire_bytes.size(), message.size());
+  // Server to client.
+  protected_bytes = ssl_tsi_test_protect_for_socket(
+      server_protector, {1, 100, 5000}, 'A', &message);
+  if (server_offload_result == TSI_OK) {
+    EXPECT_EQ(protected_bytes, message);
+  } else {
+    EXPECT_GT(protected_bytes.size(), message.size());
+  }
+  ssl_tsi_test_send_all(server_fd, protected_bytes);
+  EXPECT_EQ(ssl_tsi_test_receive(client_protector, client_fd, client_unread,
+                                 message.size(), &wire_bytes),
+            message);
+  EXPECT_GT(wire_bytes.size(), message.size());
+  // A corrupted record makes SSL produce a fatal alert. The client's
+  // unprotect fails, whether or not SSL could send the alert.
+  protected_bytes =
+      ssl_tsi_test_protect_for_socket(server_protector, {100}, 'A', &message);
+  ssl_tsi_test_send_all(server_fd, protected_bytes);
+  // Read exactly one record: a 5-byte header with the length at the end.
+  std::string record;
+  while (record.size() < 5 ||
+         record.size() < 5 + ((static_cast<uint8_t>(record[3]) << 8) |
+                              static_cast<uint8_t>(record[4]))) {
+    char c;
+    ASSERT_EQ(recv(client_fd, &c, 1, 0), 1);
+    record.push_back(c);
+  }
+  record.back() ^= 1;
+  grpc_slice_buffer protected_slices;
+  grpc_slice_buffer unprotected_slices;
+  grpc_slice_buffer_init(&protected_slices);
+  grpc_slice_buffer_init(&unprotected_slices);
+  grpc_slice_buffer_add(
+      &protected_slices,
+      grpc_slice_from_copied_buffer(record.data(), record.size()));
+  EXPECT_NE(tsi_zero_copy_grpc_protector_unprotect(
+                client_protector, &protected_slices, &unprotected_slices,
+                nullptr),
+            TSI_OK);
+  EXPECT_EQ(unprotected_slices.length, 0);
+  grpc_slice_buffer_destroy(&protected_slices);
+  grpc_slice_buffer_destroy(&unprotected_slices);
+  close(client_fd);
+  close(server_fd);
+  tsi_zero_copy_grpc_protector_destroy(client_protector);
+  tsi_zero_copy_grpc_protector_destroy(server_protector);
+  tsi_test_fixture_destroy(fixture);
+}
+
 void ssl_tsi_test_do_handshake_session_cache() {
   gpr_log(GPR_INFO, "ssl_tsi_test_do_handshake_session_cache");
   tsi_ssl_session_cache* session_cache = tsi_ssl_session_cache_create_lru(16);
@@ -778,6 +1189,8 @@ void ssl_tsi_test_do_handshake_session_cache() {
     tsi_test_do_round_trip(&ssl_fixture->base);
     tsi_test_fixture_destroy(fixture);
   };
+  std::unique_ptr<grpc_core::GlobalStats> stats_before =
+      grpc_core::global_stats().Collect();
   memset(session_ticket_key, 'a', sizeof(session_ticket_key));
   do_handshake(false);
   do_handshake(true);
@@ -790,6 +1203,12 @@ void ssl_tsi_test_do_handshake_session_cache() {
   do_handshake(false);
   do_handshake(true);
   tsi_ssl_session_cache_unref(session_cache);
+  // Only the first handshake finds the cache empty.
+  std::unique_ptr<grpc_core::GlobalStats> stats =
+      grpc_core::global_stats().Collect()->Diff(*stats_before);
+  EXPECT_EQ(stats->ssl_session_cache_misses, 1);
+  EXPECT_EQ(stats->ssl_session_cache_hits, 6);
+  EXPECT_EQ(stats->ssl_sessions_resumed, 4);
 }
 
 static const tsi_ssl_handshaker_factory_vtable* original_vtable;
@@ -1119,6 +1538,9 @@ TEST(SslTransportSecurityTest, MainTest) {
     ssl_tsi_test_do_round_trip_for_all_configs();
     ssl_tsi_test_do_round_trip_with_error_on_stack();
     ssl_tsi_test_do_round_trip_odd_buffer_size();
+    ssl_tsi_test_do_zero_copy_round_trip();
+    ssl_tsi_test_do_zero_copy_interop_with_frame_protector();
+    ssl_tsi_test_do_zero_copy_kernel_tx_offload();
     ssl_tsi_test_handshaker_factory_internals();
     ssl_tsi_test_duplicate_root_certificates();
     ssl_tsi_test_extract_x509_subject_names();
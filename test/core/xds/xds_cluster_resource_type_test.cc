@@ -732,6 +732,71 @@ TEST_F(LbPolicyTest, EnumLbPolicyRingHashUnsupportedHashFunction) {
       << decode_result.resource.status();
 }
 
+TEST_F(LbPolicyTest, EnumLbPolicyMaglev) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_MAGLEV");
+  Cluster cluster;
+  cluster.set_name("foo");
+  cluster.set_type(cluster.EDS);
+  cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_self();
+  cluster.set_lb_policy(cluster.MAGLEV);
+  std::string serialized_resource;
+  ASSERT_TRUE(cluster.SerializeToString(&serialized_resource));
+  auto* resource_type = XdsClusterResourceType::Get();
+  auto decode_result =
+      resource_type->Decode(decode_context_, serialized_resource);
+  ASSERT_TRUE(decode_result.resource.ok()) << decode_result.resource.status();
+  ASSERT_TRUE(decode_result.name.has_value());
+  EXPECT_EQ(*decode_result.name, "foo");
+  auto& resource = static_cast<XdsClusterResource&>(**decode_result.resource);
+  EXPECT_EQ(Json{resource.lb_policy_config}.Dump(),
+            "[{\"maglev_experimental\":{\"tableSize\":65537}}]");
+}
+
+TEST_F(LbPolicyTest, EnumLbPolicyMaglevSetTableSize) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_MAGLEV");
+  Cluster cluster;
+  cluster.set_name("foo");
+  cluster.set_type(cluster.EDS);
+  cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_self();
+  cluster.set_lb_policy(cluster.MAGLEV);
+  cluster.mutable_maglev_lb_config()->mutable_table_size()->set_value(251);
+  std::string serialized_resource;
+  ASSERT_TRUE(cluster.SerializeToString(&serialized_resource));
+  auto* resource_type = XdsClusterResourceType::Get();
+  auto decode_result =
+      resource_type->Decode(decode_context_, serialized_resource);
+  ASSERT_TRUE(decode_result.resource.ok()) << decode_result.resource.status();
+  ASSERT_TRUE(decode_result.name.has_value());
+  EXPECT_EQ(*decode_result.name, "foo");
+  auto& resource = static_cast<XdsClusterResource&>(**decode_result.resource);
+  EXPECT_EQ(Json{resource.lb_policy_config}.Dump(),
+            "[{\"maglev_experimental\":{\"tableSize\":251}}]");
+}
+
+TEST_F(LbPolicyTest, EnumLbPolicyMaglevTableSizeNotPrime) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_MAGLEV");
+  Cluster cluster;
+  cluster.set_name("foo");
+  cluster.set_type(cluster.EDS);
+  cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_self();
+  cluster.set_lb_policy(cluster.MAGLEV);
+  cluster.mutable_maglev_lb_config()->mutable_table_size()->set_value(65536);
+  std::string serialized_resource;
+  ASSERT_TRUE(cluster.SerializeToString(&serialized_resource));
+  auto* resource_type = XdsClusterResourceType::Get();
+  auto decode_result =
+      resource_type->Decode(decode_context_, serialized_resource);
+  ASSERT_TRUE(decode_result.name.has_value());
+  EXPECT_EQ(*decode_result.name, "foo");
+  EXPECT_EQ(decode_result.resource.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(decode_result.resource.status().message(),
+            "errors validating Cluster resource: ["
+            "field:maglev_lb_config.table_size "
+            "error:must be a prime number no larger than 5000011]")
+      << decode_result.resource.status();
+}
+
 TEST_F(LbPolicyTest, EnumUnsupportedPolicy) {
   Cluster cluster;
   cluster.set_name("foo");
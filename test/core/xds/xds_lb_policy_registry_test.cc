@@ -44,10 +44,13 @@
 #include "src/core/lib/load_balancing/lb_policy_factory.h"
 #include "src/proto/grpc/testing/xds/v3/cluster.pb.h"
 #include "src/proto/grpc/testing/xds/v3/extension.pb.h"
+#include "src/proto/grpc/testing/xds/v3/least_request.pb.h"
+#include "src/proto/grpc/testing/xds/v3/maglev.pb.h"
 #include "src/proto/grpc/testing/xds/v3/ring_hash.pb.h"
 #include "src/proto/grpc/testing/xds/v3/round_robin.pb.h"
 #include "src/proto/grpc/testing/xds/v3/typed_struct.pb.h"
 #include "src/proto/grpc/testing/xds/v3/wrr_locality.pb.h"
+#include "test/core/util/scoped_env_var.h"
 #include "test/core/util/test_config.h"
 
 namespace grpc_core {
@@ -56,6 +59,9 @@ namespace {
 
 using LoadBalancingPolicyProto =
     ::envoy::config::cluster::v3::LoadBalancingPolicy;
+using ::envoy::extensions::load_balancing_policies::least_request::v3::
+    LeastRequest;
+using ::envoy::extensions::load_balancing_policies::maglev::v3::Maglev;
 using ::envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash;
 using ::envoy::extensions::load_balancing_policies::round_robin::v3::RoundRobin;
 using ::envoy::extensions::load_balancing_policies::wrr_locality::v3::
@@ -115,6 +121,134 @@ TEST(RoundRobin, Basic) {
   EXPECT_EQ(*result, "{\"round_robin\":{}}");
 }
 
+//
+// LeastRequest
+//
+
+TEST(LeastRequestConfig, DefaultConfig) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_LEAST_REQUEST");
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(LeastRequest());
+  auto result = ConvertXdsPolicy(policy);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(*result, "{\"least_request\":{\"choiceCount\":2}}");
+}
+
+TEST(LeastRequestConfig, FieldsExplicitlySet) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_LEAST_REQUEST");
+  LeastRequest least_request;
+  least_request.mutable_choice_count()->set_value(3);
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(least_request);
+  auto result = ConvertXdsPolicy(policy);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(*result, "{\"least_request\":{\"choiceCount\":3}}");
+}
+
+TEST(LeastRequestConfig, ChoiceCountTooLow) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_LEAST_REQUEST");
+  LeastRequest least_request;
+  least_request.mutable_choice_count()->set_value(1);
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(least_request);
+  auto result = ConvertXdsPolicy(policy);
+  EXPECT_EQ(result.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(result.status().message(),
+            "validation errors: ["
+            "field:load_balancing_policy.policies[0].typed_extension_config"
+            ".typed_config.value[envoy.extensions.load_balancing_policies"
+            ".least_request.v3.LeastRequest].choice_count "
+            "error:must be at least 2]")
+      << result.status();
+}
+
+TEST(LeastRequestConfig, NotSupportedWithoutEnvVar) {
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(LeastRequest());
+  auto result = ConvertXdsPolicy(policy);
+  EXPECT_EQ(result.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(result.status().message(),
+            "validation errors: [field:load_balancing_policy "
+            "error:no supported load balancing policy config found]")
+      << result.status();
+}
+
+//
+// Maglev
+//
+
+TEST(MaglevConfig, DefaultConfig) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_MAGLEV");
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(Maglev());
+  auto result = ConvertXdsPolicy(policy);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(*result, "{\"maglev_experimental\":{\"tableSize\":65537}}");
+}
+
+TEST(MaglevConfig, FieldsExplicitlySet) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_MAGLEV");
+  Maglev maglev;
+  maglev.mutable_table_size()->set_value(251);
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(maglev);
+  auto result = ConvertXdsPolicy(policy);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(*result, "{\"maglev_experimental\":{\"tableSize\":251}}");
+}
+
+TEST(MaglevConfig, TableSizeNotPrime) {
+  ScopedExperimentalEnvVar env_var("GRPC_EXPERIMENTAL_ENABLE_MAGLEV");
+  Maglev maglev;
+  maglev.mutable_table_size()->set_value(65536);
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(maglev);
+  auto result = ConvertXdsPolicy(policy);
+  EXPECT_EQ(result.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(result.status().message(),
+            "validation errors: ["
+            "field:load_balancing_policy.policies[0].typed_extension_config"
+            ".typed_config.value[envoy.extensions.load_balancing_policies"
+            ".maglev.v3.Maglev].table_size "
+            "error:must be a prime number no larger than 5000011]")
+      << result.status();
+}
+
+TEST(MaglevConfig, NotSupportedWithoutEnvVar) {
+  LoadBalancingPolicyProto policy;
+  policy.add_policies()
+      ->mutable_typed_extension_config()
+      ->mutable_typed_config()
+      ->PackFrom(Maglev());
+  auto result = ConvertXdsPolicy(policy);
+  EXPECT_EQ(result.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(result.status().message(),
+            "validation errors: [field:load_balancing_policy "
+            "error:no supported load balancing policy config found]")
+      << result.status();
+}
+
 //
 // RingHash
 //
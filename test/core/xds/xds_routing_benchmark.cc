@@ -0,0 +1,189 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares looking up virtual hosts and routes with the compiled
+// XdsRouting::VirtualHostListMatcher and XdsRouting::RouteListMatcher against
+// the linear scans of XdsRouting::FindVirtualHostForDomain() and
+// XdsRouting::GetRouteForRequest().
+
+#include <stddef.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/ext/xds/xds_route_config.h"
+#include "src/core/ext/xds/xds_routing.h"
+#include "src/core/lib/matchers/matchers.h"
+
+namespace grpc_core {
+namespace {
+
+constexpr int kNumEntriesLow = 8;
+constexpr int kNumEntriesHigh = 4096;
+
+class VirtualHostListIterator : public XdsRouting::VirtualHostListIterator {
+ public:
+  explicit VirtualHostListIterator(
+      const std::vector<std::vector<std::string>>* domains)
+      : domains_(domains) {}
+
+  size_t Size() const override { return domains_->size(); }
+
+  const std::vector<std::string>& GetDomainsForVirtualHost(
+      size_t index) const override {
+    return (*domains_)[index];
+  }
+
+ private:
+  const std::vector<std::vector<std::string>>* domains_;
+};
+
+class RouteListIterator : public XdsRouting::RouteListIterator {
+ public:
+  explicit RouteListIterator(
+      const std::vector<XdsRouteConfigResource::Route::Matchers>* matchers)
+      : matchers_(matchers) {}
+
+  size_t Size() const override { return matchers_->size(); }
+
+  const XdsRouteConfigResource::Route::Matchers& GetMatchersForRoute(
+      size_t index) const override {
+    return (*matchers_)[index];
+  }
+
+ private:
+  const std::vector<XdsRouteConfigResource::Route::Matchers>* matchers_;
+};
+
+// Virtual hosts with exact, suffix and prefix domain patterns, followed by a
+// default virtual host.
+std::vector<std::vector<std::string>> MakeDomains(int num_vhosts) {
+  std::vector<std::vector<std::string>> domains;
+  for (int i = 0; i < num_vhosts; ++i) {
+    domains.push_back({absl::StrCat("service", i, ".example.com"),
+                       absl::StrCat("*.service", i, ".example.com"),
+                       absl::StrCat("service", i, ".*")});
+  }
+  domains.push_back({"*"});
+  return domains;
+}
+
+// Routes that each match the methods of one service, by exact path, prefix or
+// regex.
+std::vector<XdsRouteConfigResource::Route::Matchers> MakeRoutes(
+    int num_routes) {
+  std::vector<XdsRouteConfigResource::Route::Matchers> routes;
+  for (int i = 0; i < num_routes; ++i) {
+    XdsRouteConfigResource::Route::Matchers matchers;
+    switch (i % 3) {
+      case 0:
+        matchers.path_matcher = std::move(*StringMatcher::Create(
+            StringMatcher::Type::kExact,
+            absl::StrCat("/pkg.Service", i, "/Method")));
+        break;
+      case 1:
+        matchers.path_matcher = std::move(
+            *StringMatcher::Create(StringMatcher::Type::kPrefix,
+                                   absl::StrCat("/pkg.Service", i, "/")));
+        break;
+      default:
+        matchers.path_matcher = std::move(*StringMatcher::Create(
+            StringMatcher::Type::kSafeRegex,
+            absl::StrCat("/pkg\\.Service", i, "/(Get|Method)")));
+    }
+    routes.push_back(std::move(matchers));
+  }
+  return routes;
+}
+
+// The domain and path of a request that only matches the last virtual host
+// or route, so that the linear scans have to check each of them.
+std::string LastDomain(int num_vhosts) {
+  return absl::StrCat("service", num_vhosts - 1, ".example.com");
+}
+
+std::string LastPath(int num_routes) {
+  return absl::StrCat("/pkg.Service", num_routes - 1, "/Method");
+}
+
+void BM_FindVirtualHostForDomain(benchmark::State& state) {
+  auto domains = MakeDomains(state.range(0));
+  std::string domain = LastDomain(state.range(0));
+  for (auto _ : state) {
+    auto vhost_index = XdsRouting::FindVirtualHostForDomain(
+        VirtualHostListIterator(&domains), domain);
+    GPR_ASSERT(vhost_index == static_cast<size_t>(state.range(0) - 1));
+  }
+}
+BENCHMARK(BM_FindVirtualHostForDomain)->Range(kNumEntriesLow, kNumEntriesHigh);
+
+void BM_VirtualHostListMatcher(benchmark::State& state) {
+  auto domains = MakeDomains(state.range(0));
+  XdsRouting::VirtualHostListMatcher matcher(
+      (VirtualHostListIterator(&domains)));
+  std::string domain = LastDomain(state.range(0));
+  for (auto _ : state) {
+    auto vhost_index = matcher.FindVirtualHostForDomain(domain);
+    GPR_ASSERT(vhost_index == static_cast<size_t>(state.range(0) - 1));
+  }
+}
+BENCHMARK(BM_VirtualHostListMatcher)->Range(kNumEntriesLow, kNumEntriesHigh);
+
+void BM_GetRouteForRequest(benchmark::State& state) {
+  auto routes = MakeRoutes(state.range(0));
+  std::string path = LastPath(state.range(0));
+  for (auto _ : state) {
+    // The routes have no header matchers, so no metadata is needed.
+    auto route_index = XdsRouting::GetRouteForRequest(
+        RouteListIterator(&routes), path, nullptr);
+    GPR_ASSERT(route_index == static_cast<size_t>(state.range(0) - 1));
+  }
+}
+BENCHMARK(BM_GetRouteForRequest)->Range(kNumEntriesLow, kNumEntriesHigh);
+
+void BM_RouteListMatcher(benchmark::State& state) {
+  auto routes = MakeRoutes(state.range(0));
+  XdsRouting::RouteListMatcher matcher((RouteListIterator(&routes)));
+  std::string path = LastPath(state.range(0));
+  for (auto _ : state) {
+    auto route_index = matcher.GetRouteForRequest(path, nullptr);
+    GPR_ASSERT(route_index == static_cast<size_t>(state.range(0) - 1));
+  }
+}
+BENCHMARK(BM_RouteListMatcher)->Range(kNumEntriesLow, kNumEntriesHigh);
+
+}  // namespace
+}  // namespace grpc_core
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  grpc_init();
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunTheBenchmarksNamespaced();
+  grpc_shutdown();
+  return 0;
+}
@@ -0,0 +1,450 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "src/core/ext/xds/xds_routing.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+#include <grpc/event_engine/memory_allocator.h>
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/ext/xds/xds_route_config.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/matchers/matchers.h"
+#include "src/core/lib/resource_quota/arena.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
+#include "src/core/lib/resource_quota/resource_quota.h"
+#include "src/core/lib/slice/slice.h"
+#include "src/core/lib/transport/metadata_batch.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace testing {
+namespace {
+
+using Matchers = XdsRouteConfigResource::Route::Matchers;
+using Headers = std::vector<std::pair<std::string, std::string>>;
+
+class VirtualHostListIterator : public XdsRouting::VirtualHostListIterator {
+ public:
+  explicit VirtualHostListIterator(
+      const std::vector<std::vector<std::string>>* domains)
+      : domains_(domains) {}
+
+  size_t Size() const override { return domains_->size(); }
+
+  const std::vector<std::string>& GetDomainsForVirtualHost(
+      size_t index) const override {
+    return (*domains_)[index];
+  }
+
+ private:
+  const std::vector<std::vector<std::string>>* domains_;
+};
+
+class VirtualHostListMatcherTest : public ::testing::Test {
+ protected:
+  // Returns the virtual host that VirtualHostListMatcher selects for
+  // domain, and expects XdsRouting::FindVirtualHostForDomain() to select the
+  // same one.
+  absl::optional<size_t> FindVirtualHost(absl::string_view domain) {
+    XdsRouting::VirtualHostListMatcher matcher(
+        (VirtualHostListIterator(&domains_)));
+    absl::optional<size_t> vhost = matcher.FindVirtualHostForDomain(domain);
+    EXPECT_EQ(vhost, XdsRouting::FindVirtualHostForDomain(
+                         VirtualHostListIterator(&domains_), domain))
+        << domain;
+    return vhost;
+  }
+
+  std::vector<std::vector<std::string>> domains_;
+};
+
+TEST_F(VirtualHostListMatcherTest, NoVirtualHosts) {
+  EXPECT_EQ(FindVirtualHost("foo.example.com"), absl::nullopt);
+}
+
+TEST_F(VirtualHostListMatcherTest, MatchTypeOrder) {
+  // Listed in the reverse of the order in which the match types are tried.
+  domains_ = {{"*"}, {"foo.*"}, {"*.example.com"}, {"foo.example.com"}};
+  EXPECT_EQ(FindVirtualHost("foo.example.com"), 3);
+  EXPECT_EQ(FindVirtualHost("bar.example.com"), 2);
+  EXPECT_EQ(FindVirtualHost("foo.example.org"), 1);
+  EXPECT_EQ(FindVirtualHost("bar.example.org"), 0);
+  // A longer pattern of a later match type does not win.
+  domains_ = {{"*.com"}, {"foo.example.*"}};
+  EXPECT_EQ(FindVirtualHost("foo.example.com"), 0);
+}
+
+TEST_F(VirtualHostListMatcherTest, LongestPatternWins) {
+  domains_ = {{"*.com"},
+              {"*.example.com"},
+              {"*.foo.example.com"},
+              {"foo.*"},
+              {"foo.example.*"},
+              {"foo.example.org.*"}};
+  EXPECT_EQ(FindVirtualHost("a.foo.example.com"), 2);
+  EXPECT_EQ(FindVirtualHost("bar.example.com"), 1);
+  EXPECT_EQ(FindVirtualHost("bar.test.com"), 0);
+  EXPECT_EQ(FindVirtualHost("foo.example.org.uk"), 5);
+  EXPECT_EQ(FindVirtualHost("foo.example.net"), 4);
+  EXPECT_EQ(FindVirtualHost("foo.test.net"), 3);
+  EXPECT_EQ(FindVirtualHost("bar.test.net"), absl::nullopt);
+}
+
+TEST_F(VirtualHostListMatcherTest, AsteriskMatchesAtLeastOneChar) {
+  domains_ = {{"*.example.com"}, {"foo.*"}, {"*"}};
+  EXPECT_EQ(FindVirtualHost("a.example.com"), 0);
+  EXPECT_EQ(FindVirtualHost(".example.com"), 2);
+  EXPECT_EQ(FindVirtualHost("foo.a"), 1);
+  EXPECT_EQ(FindVirtualHost("foo."), 2);
+}
+
+TEST_F(VirtualHostListMatcherTest, FirstVirtualHostWinsTies) {
+  domains_ = {{"bar.example.com", "*.example.com"},
+              {"foo.example.com", "*.example.com"},
+              {"foo.example.com"},
+              {"*"},
+              {"*"}};
+  EXPECT_EQ(FindVirtualHost("foo.example.com"), 1);
+  EXPECT_EQ(FindVirtualHost("baz.example.com"), 0);
+  EXPECT_EQ(FindVirtualHost("baz.example.org"), 3);
+  // Patterns of the same type and length.
+  domains_ = {{"*.example.com"}, {"*.example.org"}, {"*.example.com"}};
+  EXPECT_EQ(FindVirtualHost("foo.example.com"), 0);
+  EXPECT_EQ(FindVirtualHost("foo.example.org"), 1);
+}
+
+TEST_F(VirtualHostListMatcherTest, MixedCase) {
+  domains_ = {{"Foo.Example.COM"}, {"*.EXAMPLE.org"}, {"BAR.*"}};
+  EXPECT_EQ(FindVirtualHost("foo.example.com"), 0);
+  EXPECT_EQ(FindVirtualHost("FOO.EXAMPLE.COM"), 0);
+  EXPECT_EQ(FindVirtualHost("foo.Example.Org"), 1);
+  EXPECT_EQ(FindVirtualHost("bar.example.net"), 2);
+  EXPECT_EQ(FindVirtualHost("Bar.Example.Net"), 2);
+  EXPECT_EQ(FindVirtualHost("baz.example.net"), absl::nullopt);
+}
+
+// Random virtual hosts built from a small set of labels, so that many
+// patterns of every type and length match the same domains.
+TEST_F(VirtualHostListMatcherTest, SameVirtualHostAsLinearScan) {
+  const char* kLabels[] = {"a", "B", "ab", "com", "Example"};
+  std::mt19937 rng(42);
+  auto random_name = [&](int num_labels) {
+    std::string name;
+    for (int i = 0; i < num_labels; ++i) {
+      if (i > 0) name += ".";
+      name += kLabels[rng() % GPR_ARRAY_SIZE(kLabels)];
+    }
+    return name;
+  };
+  for (int iteration = 0; iteration < 50; ++iteration) {
+    domains_.clear();
+    const int num_vhosts = 1 + rng() % 8;
+    for (int i = 0; i < num_vhosts; ++i) {
+      std::vector<std::string> patterns;
+      const int num_patterns = 1 + rng() % 3;
+      for (int j = 0; j < num_patterns; ++j) {
+        const int num_labels = 1 + rng() % 3;
+        switch (rng() % 7) {
+          case 0:
+            patterns.push_back("*");
+            break;
+          case 1:
+          case 2:
+            patterns.push_back(absl::StrCat("*.", random_name(num_labels)));
+            break;
+          case 3:
+          case 4:
+            patterns.push_back(absl::StrCat(random_name(num_labels), ".*"));
+            break;
+          default:
+            patterns.push_back(random_name(num_labels));
+        }
+      }
+      domains_.push_back(std::move(patterns));
+    }
+    for (int j = 0; j < 20; ++j) FindVirtualHost(random_name(1 + rng() % 4));
+  }
+}
+
+class RouteListIterator : public XdsRouting::RouteListIterator {
+ public:
+  explicit RouteListIterator(const std::vector<Matchers>* matchers)
+      : matchers_(matchers) {}
+
+  size_t Size() const override { return matchers_->size(); }
+
+  const Matchers& GetMatchersForRoute(size_t index) const override {
+    return (*matchers_)[index];
+  }
+
+ private:
+  const std::vector<Matchers>* matchers_;
+};
+
+HeaderMatcher MakeHeaderMatcher(absl::string_view name,
+                                HeaderMatcher::Type type,
+                                absl::string_view value = "",
+                                bool invert_match = false) {
+  auto header_matcher =
+      HeaderMatcher::Create(name, type, value, 0, 0,
+                            /*present_match=*/true, invert_match);
+  GPR_ASSERT(header_matcher.ok());
+  return std::move(*header_matcher);
+}
+
+Matchers MakeRoute(StringMatcher::Type path_type, absl::string_view path,
+                   std::vector<HeaderMatcher> header_matchers = {},
+                   absl::optional<uint32_t> fraction_per_million =
+                       absl::nullopt) {
+  Matchers matchers;
+  auto path_matcher = StringMatcher::Create(path_type, path);
+  GPR_ASSERT(path_matcher.ok());
+  matchers.path_matcher = std::move(*path_matcher);
+  matchers.header_matchers = std::move(header_matchers);
+  matchers.fraction_per_million = fraction_per_million;
+  return matchers;
+}
+
+class RouteListMatcherTest : public ::testing::Test {
+ protected:
+  // Returns the route that RouteListMatcher selects for a request, and
+  // expects XdsRouting::GetRouteForRequest() to select the same one.
+  absl::optional<size_t> GetRoute(absl::string_view path,
+                                  const Headers& headers = {}) {
+    auto arena = MakeScopedArena(1024, &memory_allocator_);
+    grpc_metadata_batch initial_metadata(arena.get());
+    for (const auto& header : headers) {
+      initial_metadata.Append(header.first,
+                              Slice::FromCopiedString(header.second),
+                              [](absl::string_view, const Slice&) {
+                                GPR_ASSERT(false);
+                              });
+    }
+    XdsRouting::RouteListMatcher matcher((RouteListIterator(&routes_)));
+    absl::optional<size_t> route =
+        matcher.GetRouteForRequest(path, &initial_metadata);
+    EXPECT_EQ(route, XdsRouting::GetRouteForRequest(RouteListIterator(&routes_),
+                                                    path, &initial_metadata))
+        << path;
+    return route;
+  }
+
+  MemoryAllocator memory_allocator_ = MemoryAllocator(
+      ResourceQuota::Default()->memory_quota()->CreateMemoryAllocator("test"));
+  std::vector<Matchers> routes_;
+};
+
+TEST_F(RouteListMatcherTest, NoRoutes) {
+  EXPECT_EQ(GetRoute("/pkg.Service/Method"), absl::nullopt);
+}
+
+TEST_F(RouteListMatcherTest, FirstMatchingRouteWins) {
+  routes_.push_back(MakeRoute(
+      StringMatcher::Type::kPrefix, "/pkg.Service/",
+      {MakeHeaderMatcher("x-env", HeaderMatcher::Type::kExact, "canary")}));
+  routes_.push_back(MakeRoute(StringMatcher::Type::kExact,
+                              "/pkg.Service/Method", {}, 0));
+  routes_.push_back(MakeRoute(
+      StringMatcher::Type::kSafeRegex, "/pkg\\.Service/.*",
+      {MakeHeaderMatcher("x-env", HeaderMatcher::Type::kPresent)}));
+  routes_.push_back(MakeRoute(StringMatcher::Type::kPrefix, "/"));
+  EXPECT_EQ(GetRoute("/pkg.Service/Method", {{"x-env", "canary"}}), 0);
+  // Route 1 matches the path but never the runtime fraction.
+  EXPECT_EQ(GetRoute("/pkg.Service/Method", {{"x-env", "prod"}}), 2);
+  EXPECT_EQ(GetRoute("/pkg.Service/Method"), 3);
+  EXPECT_EQ(GetRoute("/other.Service/Method", {{"x-env", "canary"}}), 3);
+}
+
+TEST_F(RouteListMatcherTest, PathMatchers) {
+  routes_.push_back(
+      MakeRoute(StringMatcher::Type::kExact, "/pkg.Service/Method"));
+  routes_.push_back(MakeRoute(StringMatcher::Type::kPrefix, "/pkg.Service/"));
+  routes_.push_back(
+      MakeRoute(StringMatcher::Type::kSafeRegex, "/pkg\\.(Foo|Bar)/.*"));
+  EXPECT_EQ(GetRoute("/pkg.Service/Method"), 0);
+  EXPECT_EQ(GetRoute("/pkg.Service/Other"), 1);
+  EXPECT_EQ(GetRoute("/pkg.Bar/Method"), 2);
+  EXPECT_EQ(GetRoute("/pkg.service/Method"), absl::nullopt);
+}
+
+TEST_F(RouteListMatcherTest, HeaderMatchersOnSharedHeaders) {
+  routes_.push_back(MakeRoute(
+      StringMatcher::Type::kPrefix, "/",
+      {MakeHeaderMatcher("x-a", HeaderMatcher::Type::kExact, "1"),
+       MakeHeaderMatcher("x-b", HeaderMatcher::Type::kExact, "2")}));
+  routes_.push_back(MakeRoute(
+      StringMatcher::Type::kPrefix, "/",
+      {MakeHeaderMatcher("x-a", HeaderMatcher::Type::kPrefix, "1"),
+       MakeHeaderMatcher("x-b", HeaderMatcher::Type::kExact, "2",
+                         /*invert_match=*/true)}));
+  routes_.push_back(
+      MakeRoute(StringMatcher::Type::kPrefix, "/",
+                {MakeHeaderMatcher("x-b", HeaderMatcher::Type::kPresent)}));
+  routes_.push_back(MakeRoute(
+      StringMatcher::Type::kPrefix, "/",
+      {MakeHeaderMatcher("x-a", HeaderMatcher::Type::kSuffix, "9")}));
+  EXPECT_EQ(GetRoute("/", {{"x-a", "1"}, {"x-b", "2"}}), 0);
+  EXPECT_EQ(GetRoute("/", {{"x-a", "12"}, {"x-b", "3"}}), 1);
+  EXPECT_EQ(GetRoute("/", {{"x-a", "12"}, {"x-b", "2"}}), 2);
+  // An inverted matcher does not match an absent header.
+  EXPECT_EQ(GetRoute("/", {{"x-a", "19"}}), 3);
+  EXPECT_EQ(GetRoute("/", {{"x-a", "12"}}), absl::nullopt);
+  EXPECT_EQ(GetRoute("/"), absl::nullopt);
+}
+
+TEST_F(RouteListMatcherTest, RuntimeFraction) {
+  routes_.push_back(MakeRoute(StringMatcher::Type::kExact,
+                              "/pkg.Service/Method", {}, 0));
+  routes_.push_back(MakeRoute(
+      StringMatcher::Type::kExact, "/pkg.Service/Method",
+      {MakeHeaderMatcher("x-a", HeaderMatcher::Type::kPresent)}, 1000000));
+  routes_.push_back(MakeRoute(StringMatcher::Type::kPrefix, "/", {}, 1000000));
+  EXPECT_EQ(GetRoute("/pkg.Service/Method", {{"x-a", "1"}}), 1);
+  EXPECT_EQ(GetRoute("/pkg.Service/Method"), 2);
+  EXPECT_EQ(GetRoute("/other.Service/Method", {{"x-a", "1"}}), 2);
+}
+
+// More headers and header matchers than RouteListMatcher keeps inline.
+TEST_F(RouteListMatcherTest, ManyHeaders) {
+  constexpr int kNumRoutes = 100;
+  for (int i = 0; i < kNumRoutes; ++i) {
+    routes_.push_back(MakeRoute(
+        StringMatcher::Type::kPrefix, "/",
+        {MakeHeaderMatcher(absl::StrCat("x-", i), HeaderMatcher::Type::kExact,
+                           "1"),
+         MakeHeaderMatcher("x-all", HeaderMatcher::Type::kPresent)}));
+  }
+  EXPECT_EQ(GetRoute("/", {{"x-99", "1"}, {"x-all", ""}}), 99);
+  EXPECT_EQ(GetRoute("/", {{"x-42", "1"}, {"x-99", "1"}, {"x-all", ""}}), 42);
+  EXPECT_EQ(GetRoute("/", {{"x-42", "1"}}), absl::nullopt);
+}
+
+// Every combination of a path, header and runtime fraction matcher, in
+// several orders. The selected route must be the first one whose matchers
+// all match.
+TEST_F(RouteListMatcherTest, FirstMatchAcrossCombinations) {
+  struct RouteSpec {
+    int path;
+    int header;
+    int fraction;
+  };
+  const StringMatcher::Type kPathTypes[] = {StringMatcher::Type::kExact,
+                                            StringMatcher::Type::kPrefix,
+                                            StringMatcher::Type::kSafeRegex};
+  const char* kPaths[] = {"/pkg.Service/Method", "/pkg.", "/other/.*"};
+  const absl::optional<uint32_t> kFractions[] = {absl::nullopt, 0, 1000000};
+  std::vector<RouteSpec> specs;
+  for (int path = 0; path < 3; ++path) {
+    for (int header = 0; header < 3; ++header) {
+      for (int fraction = 0; fraction < 3; ++fraction) {
+        specs.push_back(RouteSpec{path, header, fraction});
+      }
+    }
+  }
+  auto spec_matches = [](const RouteSpec& spec, absl::string_view path,
+                         const Headers& headers) {
+    auto header_value = [&](absl::string_view name) -> const std::string* {
+      for (const auto& header : headers) {
+        if (header.first == name) return &header.second;
+      }
+      return nullptr;
+    };
+    bool path_matches =
+        spec.path == 0   ? path == "/pkg.Service/Method"
+        : spec.path == 1 ? absl::StartsWith(path, "/pkg.")
+                         : absl::StartsWith(path, "/other/");
+    const std::string* env = header_value("x-env");
+    const std::string* version = header_value("x-version");
+    bool header_matches =
+        spec.header == 0   ? true
+        : spec.header == 1 ? env != nullptr && *env == "canary"
+                           : version != nullptr &&
+                                 absl::StartsWith(*version, "v2");
+    return path_matches && header_matches && spec.fraction != 1;
+  };
+  const char* kRequestPaths[] = {"/pkg.Service/Method", "/pkg.Service/Other",
+                                 "/other/Method", "/unknown/Method"};
+  const Headers kRequestHeaders[] = {
+      {},
+      {{"x-env", "canary"}},
+      {{"x-env", "canary"}, {"x-version", "v2.1"}},
+      {{"x-env", "prod"}, {"x-version", "v1"}},
+      {{"x-version", "v2"}}};
+  std::mt19937 rng(42);
+  for (int order = 0; order < 8; ++order) {
+    if (order == 1) {
+      std::reverse(specs.begin(), specs.end());
+    } else if (order > 1) {
+      std::shuffle(specs.begin(), specs.end(), rng);
+    }
+    routes_.clear();
+    for (const RouteSpec& spec : specs) {
+      std::vector<HeaderMatcher> header_matchers;
+      if (spec.header == 1) {
+        header_matchers.push_back(
+            MakeHeaderMatcher("x-env", HeaderMatcher::Type::kExact, "canary"));
+      } else if (spec.header == 2) {
+        header_matchers.push_back(
+            MakeHeaderMatcher("x-version", HeaderMatcher::Type::kPrefix, "v2"));
+      }
+      routes_.push_back(MakeRoute(kPathTypes[spec.path], kPaths[spec.path],
+                                  std::move(header_matchers),
+                                  kFractions[spec.fraction]));
+    }
+    for (const char* path : kRequestPaths) {
+      for (const Headers& headers : kRequestHeaders) {
+        absl::optional<size_t> expected;
+        for (size_t i = 0; i < specs.size(); ++i) {
+          if (spec_matches(specs[i], path, headers)) {
+            expected = i;
+            break;
+          }
+        }
+        EXPECT_EQ(GetRoute(path, headers), expected)
+            << "order " << order << " path " << path;
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  grpc::testing::TestEnvironment env(&argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_init();
+  int ret = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return ret;
+}
@@ -1642,6 +1642,46 @@ TEST_F(RoundRobinTest, ManyUpdates) {
   EXPECT_EQ("round_robin", channel->GetLoadBalancingPolicyName());
 }
 
+TEST_F(RoundRobinTest, PicksRaceWithPickerUpdates) {
+  const int kNumServers = 3;
+  const int kNumThreads = 4;
+  const int kNumRpcsPerThread = 100;
+  StartServers(kNumServers);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("round_robin", response_generator);
+  auto stub = BuildStub(channel);
+  std::vector<int> ports = GetServersPorts();
+  response_generator.SetNextResolution(ports);
+  WaitForServers(DEBUG_LOCATION, stub);
+  ResetCounters();
+  // Send RPCs from several threads while the main thread keeps sending
+  // resolver updates, each of which makes the policy publish a new picker.
+  // Picks that race with a picker swap must neither be lost nor run against
+  // a picker that has been freed.
+  std::atomic<int> threads_done{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < kNumRpcsPerThread; ++j) {
+        CheckRpcSendOk(DEBUG_LOCATION, stub, /*wait_for_ready=*/true);
+      }
+      threads_done.fetch_add(1);
+    });
+  }
+  std::mt19937 rng(std::random_device{}());
+  while (threads_done.load() < kNumThreads) {
+    std::shuffle(ports.begin(), ports.end(), rng);
+    response_generator.SetNextResolution(ports);
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  for (auto& thread : threads) thread.join();
+  int num_requests = 0;
+  for (const auto& server : servers_) {
+    num_requests += server->service_.request_count();
+  }
+  EXPECT_EQ(num_requests, kNumThreads * kNumRpcsPerThread);
+}
+
 TEST_F(RoundRobinTest, ReresolveOnSubchannelConnectionFailure) {
   // Start 3 servers.
   StartServers(3);
@@ -2173,6 +2213,128 @@ TEST_F(RoundRobinTest,
   EnableDefaultHealthCheckService(false);
 }
 
+//
+// tests for subchannels with more than one connection
+//
+
+class SubchannelConnectionsTest : public ClientLbEnd2endTest {
+ protected:
+  static constexpr int kSlowRpcSleepUs = 2000000;
+
+  // Starts an RPC that the server holds for kSlowRpcSleepUs.
+  std::thread StartSlowRpc(
+      const std::unique_ptr<grpc::testing::EchoTestService::Stub>& stub) {
+    return std::thread([this, &stub]() {
+      EchoRequest request;
+      request.mutable_param()->set_server_sleep_us(kSlowRpcSleepUs);
+      Status status =
+          SendRpc(stub, /*response=*/nullptr,
+                  /*timeout_ms=*/10000 * grpc_test_slowdown_factor(),
+                  /*wait_for_ready=*/true, &request);
+      EXPECT_TRUE(status.ok()) << status.error_message();
+    });
+  }
+
+  // Waits until the server has seen at least num_rpcs Echo RPCs.
+  void WaitForServerRpcs(int num_rpcs) {
+    const absl::Time deadline =
+        absl::Now() + absl::Seconds(5 * grpc_test_slowdown_factor());
+    while (servers_[0]->service_.request_count() < num_rpcs) {
+      ASSERT_LT(absl::Now(), deadline);
+      absl::SleepFor(absl::Milliseconds(10));
+    }
+  }
+};
+
+TEST_F(SubchannelConnectionsTest, UsesOneConnectionByDefault) {
+  StartServers(1);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("pick_first", response_generator);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts());
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; ++i) threads.push_back(StartSlowRpc(stub));
+  WaitForServerRpcs(3);
+  for (int i = 0; i < 5; ++i) CheckRpcSendOk(DEBUG_LOCATION, stub);
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(servers_[0]->service_.clients().size(), 1UL);
+}
+
+TEST_F(SubchannelConnectionsTest, AddsConnectionWhenSaturated) {
+  StartServers(1);
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS, 2);
+  args.SetInt(GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION, 1);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("pick_first", response_generator, args);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts());
+  // While the slow RPC saturates the first connection, the subchannel
+  // opens a second one, and new RPCs go to it.
+  std::thread slow_rpc = StartSlowRpc(stub);
+  WaitForServerRpcs(1);
+  const absl::Time deadline =
+      absl::Now() + absl::Seconds(5 * grpc_test_slowdown_factor());
+  while (servers_[0]->service_.clients().size() < 2) {
+    ASSERT_LT(absl::Now(), deadline);
+    CheckRpcSendOk(DEBUG_LOCATION, stub);
+  }
+  EXPECT_EQ(channel->GetState(false), GRPC_CHANNEL_READY);
+  slow_rpc.join();
+}
+
+TEST_F(SubchannelConnectionsTest, DoesNotExceedMaxConnections) {
+  StartServers(1);
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS, 2);
+  args.SetInt(GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION, 1);
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("pick_first", response_generator, args);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts());
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(StartSlowRpc(stub));
+    WaitForServerRpcs(i + 1);
+  }
+  for (int i = 0; i < 5; ++i) CheckRpcSendOk(DEBUG_LOCATION, stub);
+  for (auto& thread : threads) thread.join();
+  EXPECT_LE(servers_[0]->service_.clients().size(), 2UL);
+}
+
+TEST_F(SubchannelConnectionsTest, HealthCheckingWithSeveralConnections) {
+  EnableDefaultHealthCheckService(true);
+  StartServers(1);
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS, 2);
+  args.SetInt(GRPC_ARG_SUBCHANNEL_STREAMS_PER_CONNECTION, 1);
+  const char* kServiceConfigJson =
+      "{\"healthCheckConfig\": "
+      "{\"serviceName\": \"health_check_service_name\"}}";
+  auto response_generator = BuildResolverResponseGenerator();
+  auto channel = BuildChannel("round_robin", response_generator, args);
+  auto stub = BuildStub(channel);
+  response_generator.SetNextResolution(GetServersPorts(), kServiceConfigJson);
+  servers_[0]->SetServingStatus("health_check_service_name", true);
+  EXPECT_TRUE(WaitForChannelReady(channel.get(), 1 /* timeout_seconds */));
+  // The health check stream saturates the first connection, so RPCs get
+  // a second one.
+  const absl::Time deadline =
+      absl::Now() + absl::Seconds(5 * grpc_test_slowdown_factor());
+  while (servers_[0]->service_.clients().size() < 2) {
+    ASSERT_LT(absl::Now(), deadline);
+    CheckRpcSendOk(DEBUG_LOCATION, stub);
+  }
+  // Health status changes are still seen.
+  servers_[0]->SetServingStatus("health_check_service_name", false);
+  EXPECT_TRUE(WaitForChannelNotReady(channel.get()));
+  servers_[0]->SetServingStatus("health_check_service_name", true);
+  EXPECT_TRUE(WaitForChannelReady(channel.get(), 1 /* timeout_seconds */));
+  CheckRpcSendOk(DEBUG_LOCATION, stub);
+  // Clean up.
+  EnableDefaultHealthCheckService(false);
+}
+
 //
 // LB policy pick args
 //
@@ -154,13 +154,21 @@ TEST_F(OrcaServiceEnd2endTest, Basic) {
     EXPECT_EQ(response.mem_utilization(), 0.4);
     EXPECT_THAT(response.utilization(), ::testing::UnorderedElementsAre());
   });
-  // Unset CPU and memory utilization and set a named utilization.
+  // Set a fractional QPS.
+  orca_service_.SetQps(2.5);
+  ReadResponses([](const OrcaLoadReport& response) {
+    EXPECT_EQ(response.rps(), 2);
+    EXPECT_EQ(response.rps_fractional(), 2.5);
+  });
+  // Unset CPU and memory utilization and QPS and set a named utilization.
   orca_service_.DeleteCpuUtilization();
   orca_service_.DeleteMemoryUtilization();
+  orca_service_.DeleteQps();
   orca_service_.SetNamedUtilization(kMetricName1, 0.3);
   ReadResponses([&](const OrcaLoadReport& response) {
     EXPECT_EQ(response.cpu_utilization(), 0);
     EXPECT_EQ(response.mem_utilization(), 0);
+    EXPECT_EQ(response.rps_fractional(), 0);
     EXPECT_THAT(
         response.utilization(),
         ::testing::UnorderedElementsAre(::testing::Pair(kMetricName1, 0.3)));
@@ -43,6 +43,8 @@
 #include "src/core/lib/channel/channel_stack_builder_impl.h"
 #include "src/core/lib/channel/connected_channel.h"
 #include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/debug/stats_data.h"
 #include "src/core/lib/iomgr/call_combiner.h"
 #include "src/core/lib/resource_quota/resource_quota.h"
 #include "src/core/lib/surface/channel.h"
@@ -101,6 +103,21 @@ class InsecureChannel : public BaseChannelFixture {
   InsecureChannel() : BaseChannelFixture(CreateChannel()) {}
 };
 
+static grpc_channel* CreatePooledChannel() {
+  grpc_arg arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_ARG_EXPERIMENTAL_CALL_ARENA_POOL_SIZE), 16);
+  grpc_channel_args args = {1, &arg};
+  grpc_channel_credentials* creds = grpc_insecure_credentials_create();
+  grpc_channel* channel = grpc_channel_create("localhost:1234", creds, &args);
+  grpc_channel_credentials_release(creds);
+  return channel;
+}
+
+class PooledInsecureChannel : public BaseChannelFixture {
+ public:
+  PooledInsecureChannel() : BaseChannelFixture(CreatePooledChannel()) {}
+};
+
 class LameChannel : public BaseChannelFixture {
  public:
   LameChannel()
@@ -115,15 +132,24 @@ static void BM_CallCreateDestroy(benchmark::State& state) {
   gpr_timespec deadline = gpr_inf_future(GPR_CLOCK_MONOTONIC);
   void* method_hdl = grpc_channel_register_call(fixture.channel(), "/foo/bar",
                                                 nullptr, nullptr);
+  auto stats_before = grpc_core::global_stats().Collect();
   for (auto _ : state) {
     grpc_call_unref(grpc_channel_create_registered_call(
         fixture.channel(), nullptr, GRPC_PROPAGATE_DEFAULTS, cq, method_hdl,
         deadline, nullptr));
   }
+  // Every call allocates its arena unless it reuses one from the channel's
+  // pool.
+  auto stats = grpc_core::global_stats().Collect()->Diff(*stats_before);
+  state.counters["arena_mallocs_per_call"] = benchmark::Counter(
+      static_cast<double>(stats->client_calls_created -
+                          stats->call_arena_pool_hits),
+      benchmark::Counter::kAvgIterations);
   grpc_completion_queue_destroy(cq);
 }
 
 BENCHMARK_TEMPLATE(BM_CallCreateDestroy, InsecureChannel);
+BENCHMARK_TEMPLATE(BM_CallCreateDestroy, PooledInsecureChannel);
 BENCHMARK_TEMPLATE(BM_CallCreateDestroy, LameChannel);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include "absl/strings/str_cat.h"
+
 #include <grpc/slice.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
@@ -284,6 +286,21 @@ class RepresentativeServerTrailingMetadata {
   }
 };
 
+// Headers a proxy forwards on behalf of the application: a few dozen custom
+// keys with short values.
+class ProxyForwardedMetadata {
+ public:
+  static constexpr bool kEnableTrueBinary = true;
+  static void Prepare(grpc_metadata_batch* b) {
+    RepresentativeClientInitialMetadata::Prepare(b);
+    for (int i = 0; i < 32; i++) {
+      b->Append(absl::StrCat("x-forwarded-header-", i),
+                grpc_core::Slice::FromCopiedString(absl::StrCat("value-", i)),
+                CrashOnAppendError);
+    }
+  }
+};
+
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, EmptyBatch)->Args({0, 16384});
 // test with eof (shouldn't affect anything)
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, EmptyBatch)->Args({1, 16384});
@@ -317,6 +334,8 @@ BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
                    RepresentativeServerTrailingMetadata)
     ->Args({1, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, ProxyForwardedMetadata)
+    ->Args({0, 16384});
 
 }  // namespace hpack_encoder_fixtures
 
@@ -605,6 +624,8 @@ using RepresentativeServerTrailingMetadata = FromEncoderFixture<
     hpack_encoder_fixtures::RepresentativeServerTrailingMetadata>;
 using MoreRepresentativeClientInitialMetadata = FromEncoderFixture<
     hpack_encoder_fixtures::MoreRepresentativeClientInitialMetadata>;
+using ProxyForwardedMetadata =
+    FromEncoderFixture<hpack_encoder_fixtures::ProxyForwardedMetadata>;
 
 // Send the same deadline repeatedly
 class SameDeadline {
@@ -653,9 +674,35 @@ BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeServerInitialMetadata);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, SameDeadline);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, ProxyForwardedMetadata);
 
 }  // namespace hpack_parser_fixtures
 
+////////////////////////////////////////////////////////////////////////////////
+// Metadata forwarding
+//
+
+// A proxy copies each received batch into the call it forwards to.
+template <class Fixture>
+static void BM_MetadataBatchCopy(benchmark::State& state) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::MemoryAllocator memory_allocator =
+      grpc_core::MemoryAllocator(grpc_core::ResourceQuota::Default()
+                                     ->memory_quota()
+                                     ->CreateMemoryAllocator("test"));
+  auto arena = grpc_core::MakeScopedArena(1024, &memory_allocator);
+  grpc_metadata_batch b(arena.get());
+  Fixture::Prepare(&b);
+  for (auto _ : state) {
+    grpc_metadata_batch copy = b.Copy();
+    benchmark::DoNotOptimize(copy.count());
+  }
+}
+BENCHMARK_TEMPLATE(BM_MetadataBatchCopy,
+                   hpack_encoder_fixtures::RepresentativeClientInitialMetadata);
+BENCHMARK_TEMPLATE(BM_MetadataBatchCopy,
+                   hpack_encoder_fixtures::ProxyForwardedMetadata);
+
 // Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
 // and others do not. This allows us to support both modes.
 namespace benchmark {
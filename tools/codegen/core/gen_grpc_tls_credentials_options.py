@@ -160,7 +160,16 @@ _DATA_MEMBERS = [
         setter_move_semantics=True,
         test_name="DifferentCrlDirectory",
         test_value_1="\"crl_directory_1\"",
-        test_value_2="\"crl_directory_2\"")
+        test_value_2="\"crl_directory_2\""),
+    DataMember(
+        name='verification_result_cache_size',
+        type='size_t',
+        default_initializer='0',
+        setter_comment=
+        'Maximum number of peer certificate chains whose custom verification results are cached on the server side. The default value is 0, which disables the cache.',
+        test_name="DifferentVerificationResultCacheSize",
+        test_value_1="0",
+        test_value_2="100")
 ]
 
 